@@ -57,6 +57,7 @@ keypad_dispatcher/CCKeypadDelegate.cpp \
 keypad_dispatcher/CCKeypadDispatcher.cpp \
 label_nodes/CCLabelAtlas.cpp \
 label_nodes/CCLabelBMFont.cpp \
+label_nodes/CCLabelGlyphAtlas.cpp \
 label_nodes/CCLabelTTF.cpp \
 layers_scenes_transitions_nodes/CCLayer.cpp \
 layers_scenes_transitions_nodes/CCScene.cpp \
@@ -102,11 +103,15 @@ sprite_nodes/CCSpriteFrame.cpp \
 sprite_nodes/CCSpriteFrameCache.cpp \
 support/CCNotificationCenter.cpp \
 support/CCProfiling.cpp \
+support/CCRenderQueue.cpp \
+support/CCCulling.cpp \
+support/CCJobSystem.cpp \
 support/CCPointExtension.cpp \
 support/TransformUtils.cpp \
 support/CCUserDefault.cpp \
 support/base64.cpp \
 support/ccUtils.cpp \
+support/ccPixelConversion.cpp \
 support/CCVertex.cpp \
 support/data_support/ccCArray.cpp \
 support/image_support/TGAlib.cpp \
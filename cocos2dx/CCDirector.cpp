@@ -38,9 +38,11 @@ THE SOFTWARE.
 #include "cocoa/CCAutoreleasePool.h"
 #include "platform/platform.h"
 #include "platform/CCFileUtils.h"
+#include "platform/CCImage.h"
 #include "CCApplication.h"
 #include "label_nodes/CCLabelBMFont.h"
 #include "label_nodes/CCLabelAtlas.h"
+#include "label_nodes/CCLabelGlyphAtlas.h"
 #include "actions/CCActionManager.h"
 #include "CCConfiguration.h"
 #include "keypad_dispatcher/CCKeypadDispatcher.h"
@@ -53,6 +55,9 @@ THE SOFTWARE.
 #include "kazmath/kazmath.h"
 #include "kazmath/GL/matrix.h"
 #include "support/CCProfiling.h"
+#include "support/CCRenderQueue.h"
+#include "support/CCCulling.h"
+#include "support/CCJobSystem.h"
 #include "CCEGLView.h"
 #include <string>
 
@@ -68,6 +73,7 @@ THE SOFTWARE.
 using namespace std;
 
 unsigned int g_uNumberOfDraws = 0;
+unsigned int g_uNumberOfUploadedBytes = 0;
 
 NS_CC_BEGIN
 // XXX it shoul be a Director ivar. Move it there once support for multiple directors is added
@@ -123,8 +129,17 @@ bool CCDirector::init(void)
     m_pDrawsLabel = NULL;
     m_bDisplayStats = false;
     m_uTotalFrames = m_uFrames = 0;
+    m_uUploadedBytes = 0;
+
+    m_bCullingEnabled = false;
+    m_uCulledNodes = 0;
+    m_uDrawnNodes = 0;
     m_pszFPS = new char[10];
     m_pLastUpdate = new struct cc_timeval();
+    m_fSimulatedDeltaTime = 0;
+    m_fFixedTimeStep = 0;
+    m_dFixedTimeAccumulator = 0;
+    m_fFixedTimeStepAlpha = 0;
 
     // paused ?
     m_bPaused = false;
@@ -209,7 +224,15 @@ void CCDirector::drawScene(void)
     //tick before glClear: issue #533
     if (! m_bPaused)
     {
-        m_pScheduler->update(m_fDeltaTime);
+        CC_FRAME_PROFILER_SCOPE("scheduler");
+        if (m_fFixedTimeStep > 0)
+        {
+            updateFixedTimeSteps();
+        }
+        else
+        {
+            m_pScheduler->update(m_fDeltaTime);
+        }
     }
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -226,7 +249,28 @@ void CCDirector::drawScene(void)
     // draw the scene
     if (m_pRunningScene)
     {
+        CC_FRAME_PROFILER_SCOPE("visit");
+        if (m_bCullingEnabled)
+        {
+            kmMat4 sceneTransform;
+            kmGLGetMatrix(KM_GL_MODELVIEW, &sceneTransform);
+            CCPoint origin = getVisibleOrigin();
+            CCSize size = getVisibleSize();
+            CCCulling::begin(CCRectMake(origin.x, origin.y, size.width, size.height), &sceneTransform);
+        }
+
         m_pRunningScene->visit();
+
+        if (m_bCullingEnabled)
+        {
+            CCCulling::end();
+            m_uCulledNodes = CCCulling::getNumberOfCulled();
+            m_uDrawnNodes = CCCulling::getNumberOfDrawn();
+        }
+        else
+        {
+            m_uCulledNodes = m_uDrawnNodes = 0;
+        }
     }
 
     // draw the notifications node
@@ -240,6 +284,15 @@ void CCDirector::drawScene(void)
         showStats();
     }
 
+    // draw the quads that are still batched before presenting the frame
+    CCRenderQueue::sharedRenderQueue()->flush();
+
+    m_uUploadedBytes = g_uNumberOfUploadedBytes;
+    g_uNumberOfUploadedBytes = 0;
+
+    // track the textures used in this frame, and evict the old ones if the cache is over budget
+    CCTextureCache::sharedTextureCache()->updateResidency();
+
     kmGLPopMatrix();
 
     m_uTotalFrames++;
@@ -247,6 +300,7 @@ void CCDirector::drawScene(void)
     // swap buffers
     if (m_pobOpenGLView)
     {
+        CC_FRAME_PROFILER_SCOPE("swap buffers");
         m_pobOpenGLView->swapBuffers();
     }
     
@@ -260,7 +314,7 @@ void CCDirector::calculateDeltaTime(void)
 {
     struct cc_timeval now;
 
-    if (CCTime::gettimeofdayCocos2d(&now, NULL) != 0)
+    if (CCTime::getMonotonicTime(&now) != 0)
     {
         CCLOG("error in gettimeofday");
         m_fDeltaTime = 0;
@@ -273,6 +327,10 @@ void CCDirector::calculateDeltaTime(void)
         m_fDeltaTime = 0;
         m_bNextDeltaTimeZero = false;
     }
+    else if (m_fSimulatedDeltaTime > 0)
+    {
+        m_fDeltaTime = m_fSimulatedDeltaTime;
+    }
     else
     {
         m_fDeltaTime = (now.tv_sec - m_pLastUpdate->tv_sec) + (now.tv_usec - m_pLastUpdate->tv_usec) / 1000000.0f;
@@ -290,6 +348,34 @@ void CCDirector::calculateDeltaTime(void)
     *m_pLastUpdate = now;
 }
 
+void CCDirector::updateFixedTimeSteps(void)
+{
+    m_dFixedTimeAccumulator += m_fDeltaTime;
+
+    unsigned int uSteps = 0;
+    while (m_dFixedTimeAccumulator >= m_fFixedTimeStep && uSteps < CC_DIRECTOR_MAX_FIXED_TIME_STEPS)
+    {
+        m_pScheduler->update(m_fFixedTimeStep);
+        m_dFixedTimeAccumulator -= m_fFixedTimeStep;
+        ++uSteps;
+    }
+
+    // the time that couldn't be simulated in this frame is dropped
+    if (m_dFixedTimeAccumulator >= m_fFixedTimeStep)
+    {
+        m_dFixedTimeAccumulator = 0;
+    }
+
+    m_fFixedTimeStepAlpha = (float)(m_dFixedTimeAccumulator / m_fFixedTimeStep);
+}
+
+void CCDirector::setFixedTimeStep(float fFixedTimeStep)
+{
+    m_fFixedTimeStep = MAX(fFixedTimeStep, 0);
+    m_dFixedTimeAccumulator = 0;
+    m_fFixedTimeStepAlpha = 0;
+}
+
 
 // m_pobOpenGLView
 
@@ -333,6 +419,8 @@ void CCDirector::setNextDeltaTimeZero(bool bNextDeltaTimeZero)
 
 void CCDirector::setProjection(ccDirectorProjection kProjection)
 {
+    CCRenderQueue::sharedRenderQueue()->flush();
+
     CCSize size = m_obWinSizeInPixels;
     CCSize sizePoint = m_obWinSizeInPoints;
 
@@ -395,13 +483,18 @@ void CCDirector::setProjection(ccDirectorProjection kProjection)
 
     m_eProjection = kProjection;
     ccSetProjectionMatrixDirty();
+    CCNode::invalidateModelViewStack();
 }
 
 void CCDirector::purgeCachedData(void)
 {
     CCLabelBMFont::purgeCachedData();
+    CCGlyphAtlas::purgeSharedGlyphAtlases();
     CCTextureCache::sharedTextureCache()->removeUnusedTextures();
     CCFileUtils::sharedFileUtils()->purgeCachedEntries();
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    CCImage::purgeFontCache();
+#endif
 }
 
 float CCDirector::getZEye(void)
@@ -411,6 +504,8 @@ float CCDirector::getZEye(void)
 
 void CCDirector::setAlphaBlending(bool bOn)
 {
+    CCRenderQueue::sharedRenderQueue()->flush();
+
     if (bOn)
     {
         ccGLEnable(CC_GL_BLEND);
@@ -426,6 +521,8 @@ void CCDirector::setAlphaBlending(bool bOn)
 
 void CCDirector::setDepthTest(bool bOn)
 {
+    CCRenderQueue::sharedRenderQueue()->flush();
+
     if (bOn)
     {
         glClearDepth(1.0f);
@@ -620,23 +717,34 @@ void CCDirector::purgeDirector()
 
     // purge bitmap cache
     CCLabelBMFont::purgeCachedData();
+    CCGlyphAtlas::purgeSharedGlyphAtlases();
 
     // purge all managed caches
     CCAnimationCache::purgeSharedAnimationCache();
     CCSpriteFrameCache::purgeSharedSpriteFrameCache();
     CCTextureCache::purgeSharedTextureCache();
     CCShaderCache::purgeSharedShaderCache();
+    CCRenderQueue::purgeSharedRenderQueue();
+    CCJobSystem::purgeSharedJobSystem();
     CCFileUtils::purgeFileUtils();
     CCConfiguration::purgeConfiguration();
 
     // cocos2d-x specific data structures
     CCUserDefault::purgeSharedUserDefault();
     CCNotificationCenter::purgeNotificationCenter();
+    CCNode::purgeSortBuffer();
 
     ccGLInvalidateStateCache();
     
     CHECK_GL_ERROR_DEBUG();
-    
+
+#if CC_HEADLESS
+    // reads the recorded frames, so before the profiler is purged
+    m_pobOpenGLView->logReport();
+#endif
+    // before the view, whose end() doesn't return on some platforms
+    CCFrameProfiler::purgeSharedFrameProfiler();
+
     // OpenGL view
     m_pobOpenGLView->end();
     m_pobOpenGLView = NULL;
@@ -701,7 +809,7 @@ void CCDirector::resume(void)
 
     setAnimationInterval(m_dOldAnimationInterval);
 
-    if (CCTime::gettimeofdayCocos2d(m_pLastUpdate, NULL) != 0)
+    if (CCTime::getMonotonicTime(m_pLastUpdate) != 0)
     {
         CCLOG("cocos2d: Director: Error in gettimeofday");
     }
@@ -744,12 +852,13 @@ void CCDirector::showStats(void)
     }    
     
     g_uNumberOfDraws = 0;
+    CCRenderQueue::sharedRenderQueue()->resetStats();
 }
 
 void CCDirector::calculateMPF()
 {
     struct cc_timeval now;
-    CCTime::gettimeofdayCocos2d(&now, NULL);
+    CCTime::getMonotonicTime(&now);
     
     m_fSecondsPerFrame = (now.tv_sec - m_pLastUpdate->tv_sec) + (now.tv_usec - m_pLastUpdate->tv_usec) / 1000000.0f;
 }
@@ -947,7 +1056,7 @@ CCAccelerometer* CCDirector::getAccelerometer()
 // so we now only support DisplayLinkDirector
 void CCDisplayLinkDirector::startAnimation(void)
 {
-    if (CCTime::gettimeofdayCocos2d(m_pLastUpdate, NULL) != 0)
+    if (CCTime::getMonotonicTime(m_pLastUpdate) != 0)
     {
         CCLOG("cocos2d: DisplayLinkDirector: Error on gettimeofday");
     }
@@ -965,10 +1074,17 @@ void CCDisplayLinkDirector::mainLoop(void)
     }
     else if (! m_bInvalid)
      {
+         CC_FRAME_PROFILER_BEGIN_FRAME();
+
          drawScene();
      
          // release the objects
-         CCPoolManager::sharedPoolManager()->pop();        
+         {
+             CC_FRAME_PROFILER_SCOPE("autorelease pool");
+             CCPoolManager::sharedPoolManager()->pop();
+         }
+
+         CC_FRAME_PROFILER_END_FRAME();
      }
 }
 
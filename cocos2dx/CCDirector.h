@@ -130,11 +130,52 @@ public:
     inline bool isNextDeltaTimeZero(void) { return m_bNextDeltaTimeZero; }
     void setNextDeltaTimeZero(bool bNextDeltaTimeZero);
 
+    /** The delta time passed to the scheduler at every frame, instead of the time elapsed since the
+     previous frame. Frames are then simulated the same way however long they take, which makes
+     benchmarks and headless runs reproducible. 0, the default, uses the elapsed time.
+     @since v2.1
+     */
+    inline float getSimulatedDeltaTime(void) { return m_fSimulatedDeltaTime; }
+    inline void setSimulatedDeltaTime(float fSimulatedDeltaTime) { m_fSimulatedDeltaTime = fSimulatedDeltaTime; }
+
+    /** Runs the scheduler in steps of fFixedTimeStep seconds instead of once per frame: the elapsed time
+     is accumulated, and as many steps as it holds are run before drawing, at most CC_DIRECTOR_MAX_FIXED_TIME_STEPS.
+     Physics and movements are then independent of the frame rate. 0, the default, runs the scheduler once per frame.
+     @since v2.1
+     */
+    void setFixedTimeStep(float fFixedTimeStep);
+    inline float getFixedTimeStep(void) { return m_fFixedTimeStep; }
+
+    /** The time accumulated since the last fixed time step, as a fraction of the step between 0 and 1.
+     A node moved by the fixed steps can be drawn at previous + (current - previous) * alpha to move smoothly.
+     @since v2.1
+     */
+    inline float getFixedTimeStepAlpha(void) { return m_fFixedTimeStepAlpha; }
+
     /** Whether or not the Director is paused */
     inline bool isPaused(void) { return m_bPaused; }
 
     /** How many frames were called since the director started */
     inline unsigned int getTotalFrames(void) { return m_uTotalFrames; }
+
+    /** How many bytes were uploaded to vertex buffers during the last frame
+     @since v2.1
+     */
+    inline unsigned int getNumberOfUploadedBytes(void) { return m_uUploadedBytes; }
+
+    /** Whether or not the nodes and the batched sprites that are outside of the screen are skipped when
+     the running scene is drawn (see CCCulling). Nodes that draw outside of their content size should not
+     be culled, so it is disabled by default.
+     @since v2.1
+     */
+    inline bool isCullingEnabled(void) { return m_bCullingEnabled; }
+    inline void setCullingEnabled(bool bCullingEnabled) { m_bCullingEnabled = bCullingEnabled; }
+
+    /** How many nodes and batched sprites were skipped / drawn by the culling during the last frame
+     @since v2.1
+     */
+    inline unsigned int getNumberOfCulledNodes(void) { return m_uCulledNodes; }
+    inline unsigned int getNumberOfDrawnNodes(void) { return m_uDrawnNodes; }
     
     /** Sets an OpenGL projection
      @since v0.8.2
@@ -340,6 +381,9 @@ protected:
 
     /** calculates delta time since last time it was called */    
     void calculateDeltaTime();
+
+    /** runs the scheduler in fixed time steps */
+    void updateFixedTimeSteps();
 protected:
     /* The CCEGLView, where everything is rendered */
     CCEGLView    *m_pobOpenGLView;
@@ -365,6 +409,14 @@ protected:
     unsigned int m_uTotalFrames;
     unsigned int m_uFrames;
     float m_fSecondsPerFrame;
+
+    /* bytes uploaded to vertex buffers during the last frame */
+    unsigned int m_uUploadedBytes;
+
+    /* whether or not the nodes outside of the screen are drawn, and the counts of the last frame */
+    bool m_bCullingEnabled;
+    unsigned int m_uCulledNodes;
+    unsigned int m_uDrawnNodes;
      
     /* The running scene */
     CCScene *m_pRunningScene;
@@ -387,6 +439,17 @@ protected:
 
     /* whether or not the next delta time will be zero */
     bool m_bNextDeltaTimeZero;
+
+    /* delta time of every frame, 0 to use the elapsed time */
+    float m_fSimulatedDeltaTime;
+
+    /* fixed time step of the scheduler, 0 to update it once per frame */
+    float m_fFixedTimeStep;
+
+    /* time that is left after the last fixed time step */
+    double m_dFixedTimeAccumulator;
+
+    float m_fFixedTimeStepAlpha;
     
     /* projection used */
     ccDirectorProjection m_eProjection;
@@ -49,9 +49,18 @@ typedef struct _listEntry
     
 } tListEntry;
 
+// All the "updates" that share the same priority. The buckets are kept sorted by priority
+typedef struct _priorityBucket
+{
+    struct    _priorityBucket    *prev, *next;
+    tListEntry            *entries;    // called in the order they were scheduled
+    int                    priority;    // hash key
+    UT_hash_handle        hh;
+} tPriorityBucket;
+
 typedef struct _hashUpdateEntry
 {
-    tListEntry            **list;        // Which list does it belong to ?
+    tPriorityBucket        *bucket;    // Which bucket does it belong to ? NULL while pending
     tListEntry            *entry;        // entry in the list
     CCObject    *target;        // hash key (retained)
     UT_hash_handle        hh;
@@ -226,15 +235,15 @@ void CCTimer::update(float dt)
 
 CCScheduler::CCScheduler(void)
 : m_fTimeScale(1.0f)
-, m_pUpdatesNegList(NULL)
-, m_pUpdates0List(NULL)
-, m_pUpdatesPosList(NULL)
+, m_pUpdateBuckets(NULL)
+, m_pHashForBuckets(NULL)
+, m_pPendingUpdates(NULL)
 , m_pHashForUpdates(NULL)
 , m_pHashForSelectors(NULL)
 , m_pCurrentTarget(NULL)
 , m_bCurrentTargetSalvaged(false)
-, m_pScriptHandlerEntries(NULL)
 , m_bUpdateHashLocked(false)
+, m_pScriptHandlerEntries(NULL)
 {
 
 }
@@ -265,7 +274,7 @@ void CCScheduler::scheduleSelector(SEL_SCHEDULE pfnSelector, CCObject *pTarget,
     CCAssert(pTarget, "Argument target must be non-NULL");
 
     tHashSelectorEntry *pElement = NULL;
-    HASH_FIND_INT(m_pHashForSelectors, &pTarget, pElement);
+    HASH_FIND_PTR(m_pHashForSelectors, &pTarget, pElement);
 
     if (! pElement)
     {
@@ -275,7 +284,7 @@ void CCScheduler::scheduleSelector(SEL_SCHEDULE pfnSelector, CCObject *pTarget,
         {
             pTarget->retain();
         }
-        HASH_ADD_INT(m_pHashForSelectors, target, pElement);
+        HASH_ADD_PTR(m_pHashForSelectors, target, pElement);
 
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
         pElement->paused = bPaused;
@@ -323,7 +332,7 @@ void CCScheduler::unscheduleSelector(SEL_SCHEDULE pfnSelector, CCObject *pTarget
     //CCAssert(pfnSelector);
 
     tHashSelectorEntry *pElement = NULL;
-    HASH_FIND_INT(m_pHashForSelectors, &pTarget, pElement);
+    HASH_FIND_PTR(m_pHashForSelectors, &pTarget, pElement);
 
     if (pElement)
     {
@@ -365,87 +374,61 @@ void CCScheduler::unscheduleSelector(SEL_SCHEDULE pfnSelector, CCObject *pTarget
     }
 }
 
-void CCScheduler::priorityIn(tListEntry **ppList, CCObject *pTarget, int nPriority, bool bPaused)
+tPriorityBucket* CCScheduler::bucketForPriority(int nPriority)
 {
-    tListEntry *pListElement = (tListEntry *)malloc(sizeof(*pListElement));
+    tPriorityBucket *pBucket = NULL;
+    HASH_FIND_INT(m_pHashForBuckets, &nPriority, pBucket);
+    if (pBucket)
+    {
+        return pBucket;
+    }
 
-    pListElement->target = pTarget;
-    pListElement->priority = nPriority;
-    pListElement->paused = bPaused;
-    pListElement->next = pListElement->prev = NULL;
-    pListElement->markedForDeletion = false;
+    pBucket = (tPriorityBucket *)calloc(sizeof(*pBucket), 1);
+    pBucket->priority = nPriority;
+    HASH_ADD_INT(m_pHashForBuckets, priority, pBucket);
+
+    // only a new priority walks the buckets, and there are just a few different priorities.
+    // Search from the end: targets are usually scheduled with increasing priorities
+    tPriorityBucket *pPrev = m_pUpdateBuckets ? m_pUpdateBuckets->prev : NULL;
+    while (pPrev && pPrev->priority > nPriority)
+    {
+        pPrev = (pPrev == m_pUpdateBuckets) ? NULL : pPrev->prev;
+    }
 
-    // empey list ?
-    if (! *ppList)
+    if (! pPrev)
+    {
+        DL_PREPEND(m_pUpdateBuckets, pBucket);
+    }
+    else if (pPrev->next == NULL)
     {
-        DL_APPEND(*ppList, pListElement);
+        DL_APPEND(m_pUpdateBuckets, pBucket);
     }
     else
     {
-        bool bAdded = false;
-
-        for (tListEntry *pElement = *ppList; pElement; pElement = pElement->next)
-        {
-            if (nPriority < pElement->priority)
-            {
-                if (pElement == *ppList)
-                {
-                    DL_PREPEND(*ppList, pListElement);
-                }
-                else
-                {
-                    pListElement->next = pElement;
-                    pListElement->prev = pElement->prev;
-
-                    pElement->prev->next = pListElement;
-                    pElement->prev = pListElement;
-                }
-
-                bAdded = true;
-                break;
-            }
-        }
-
-        // Not added? priority has the higher value. Append it.
-        if (! bAdded)
-        {
-            DL_APPEND(*ppList, pListElement);
-        }
+        pBucket->prev = pPrev;
+        pBucket->next = pPrev->next;
+        pPrev->next->prev = pBucket;
+        pPrev->next = pBucket;
     }
 
-    // update hash entry for quick access
-    tHashUpdateEntry *pHashElement = (tHashUpdateEntry *)calloc(sizeof(*pHashElement), 1);
-    pHashElement->target = pTarget;
-    pTarget->retain();
-    pHashElement->list = ppList;
-    pHashElement->entry = pListElement;
-    HASH_ADD_INT(m_pHashForUpdates, target, pHashElement);
+    return pBucket;
 }
 
-void CCScheduler::appendIn(_listEntry **ppList, CCObject *pTarget, bool bPaused)
+void CCScheduler::appendIn(tPriorityBucket *pBucket, tListEntry *pEntry)
 {
-    tListEntry *pListElement = (tListEntry *)malloc(sizeof(*pListElement));
-
-    pListElement->target = pTarget;
-    pListElement->paused = bPaused;
-    pListElement->markedForDeletion = false;
+    DL_APPEND(pBucket->entries, pEntry);
 
-    DL_APPEND(*ppList, pListElement);
-
-    // update hash entry for quicker access
-    tHashUpdateEntry *pHashElement = (tHashUpdateEntry *)calloc(sizeof(*pHashElement), 1);
-    pHashElement->target = pTarget;
-    pTarget->retain();
-    pHashElement->list = ppList;
-    pHashElement->entry = pListElement;
-    HASH_ADD_INT(m_pHashForUpdates, target, pHashElement);
+    tHashUpdateEntry *pHashElement = NULL;
+    HASH_FIND_PTR(m_pHashForUpdates, &pEntry->target, pHashElement);
+    CCAssert(pHashElement != NULL, "");
+    pHashElement->bucket = pBucket;
 }
 
 void CCScheduler::scheduleUpdateForTarget(CCObject *pTarget, int nPriority, bool bPaused)
 {
 
     tHashUpdateEntry *pHashElement = NULL;
-    HASH_FIND_INT(m_pHashForUpdates, &pTarget, pHashElement);
+    HASH_FIND_PTR(m_pHashForUpdates, &pTarget, pHashElement);
     if (pHashElement)
     {
 #if COCOS2D_DEBUG >= 1
@@ -457,45 +440,106 @@ void CCScheduler::scheduleUpdateForTarget(CCObject *pTarget, int nPriority, bool
         return;
     }
 
-    // most of the updates are going to be 0, that's way there
-    // is an special list for updates with priority 0
-    if (nPriority == 0)
+    tListEntry *pListElement = (tListEntry *)calloc(sizeof(*pListElement), 1);
+    pListElement->target = pTarget;
+    pListElement->priority = nPriority;
+    pListElement->paused = bPaused;
+
+    // update hash entry for quick access
+    pHashElement = (tHashUpdateEntry *)calloc(sizeof(*pHashElement), 1);
+    pHashElement->target = pTarget;
+    pTarget->retain();
+    pHashElement->entry = pListElement;
+    HASH_ADD_PTR(m_pHashForUpdates, target, pHashElement);
+
+    if (m_bUpdateHashLocked)
     {
-        appendIn(&m_pUpdates0List, pTarget, bPaused);
-    } else
-    if (nPriority < 0)
+        // the buckets are being iterated. The entry is added at the end of the tick
+        DL_APPEND(m_pPendingUpdates, pListElement);
+    }
+    else
     {
-        priorityIn(&m_pUpdatesNegList, pTarget, nPriority, bPaused);
+        appendIn(bucketForPriority(nPriority), pListElement);
+    }
+}
+
+tListEntry* CCScheduler::unlinkUpdate(tHashUpdateEntry *pElement)
+{
+    // list entry
+    tListEntry *pEntry = pElement->entry;
+    tPriorityBucket *pBucket = pElement->bucket;
+    if (pBucket)
+    {
+        DL_DELETE(pBucket->entries, pEntry);
+        if (! pBucket->entries)
+        {
+            DL_DELETE(m_pUpdateBuckets, pBucket);
+            HASH_DEL(m_pHashForBuckets, pBucket);
+            free(pBucket);
+        }
     }
     else
     {
-        // priority > 0
-        priorityIn(&m_pUpdatesPosList, pTarget, nPriority, bPaused);
+        DL_DELETE(m_pPendingUpdates, pEntry);
     }
+    pEntry->prev = pEntry->next = NULL;
+
+    // hash entry
+    HASH_DEL(m_pHashForUpdates, pElement);
+    free(pElement);
+
+    return pEntry;
 }
 
-void CCScheduler::removeUpdateFromHash(struct _listEntry *entry)
+void CCScheduler::removeUpdateFromHash(tHashUpdateEntry *pElement)
 {
-    tHashUpdateEntry *element = NULL;
+    tListEntry *pEntry = unlinkUpdate(pElement);
+    CCObject* pTarget = pEntry->target;
+    free(pEntry);
 
-    HASH_FIND_INT(m_pHashForUpdates, &entry->target, element);
-    if (element)
+    // target#release should be the last one to prevent
+    // a possible double-free. eg: If the [target dealloc] might want to remove it itself from there
+    pTarget->release();
+}
+
+void CCScheduler::removeMarkedUpdates(void)
+{
+    // unlink all the marked entries first: a target destructor may unschedule other targets,
+    // so no target is released while the hash is iterated
+    tListEntry *pRemoved = NULL;
+    tHashUpdateEntry *pElement = NULL;
+    tHashUpdateEntry *pNextElement = NULL;
+    for (pElement = m_pHashForUpdates; pElement != NULL; pElement = pNextElement)
     {
-        // list entry
-        DL_DELETE(*element->list, element->entry);
-        free(element->entry);
+        pNextElement = (tHashUpdateEntry *)pElement->hh.next;
+        if (pElement->entry->markedForDeletion)
+        {
+            tListEntry *pEntry = unlinkUpdate(pElement);
+            DL_APPEND(pRemoved, pEntry);
+        }
+    }
 
-        // hash entry
-        CCObject* pTarget = element->target;
-        HASH_DEL(m_pHashForUpdates, element);
-        free(element);
+    while (pRemoved)
+    {
+        tListEntry *pEntry = pRemoved;
+        DL_DELETE(pRemoved, pEntry);
 
-        // target#release should be the last one to prevent
-        // a possible double-free. eg: If the [target dealloc] might want to remove it itself from there
+        CCObject* pTarget = pEntry->target;
+        free(pEntry);
         pTarget->release();
     }
 }
 
+void CCScheduler::addPendingUpdates(void)
+{
+    while (m_pPendingUpdates)
+    {
+        tListEntry *pEntry = m_pPendingUpdates;
+        DL_DELETE(m_pPendingUpdates, pEntry);
+        appendIn(bucketForPriority(pEntry->priority), pEntry);
+    }
+}
+
 void CCScheduler::unscheduleUpdateForTarget(const CCObject *pTarget)
 {
     if (pTarget == NULL)
@@ -504,7 +548,7 @@ void CCScheduler::unscheduleUpdateForTarget(const CCObject *pTarget)
     }
 
     tHashUpdateEntry *pElement = NULL;
-    HASH_FIND_INT(m_pHashForUpdates, &pTarget, pElement);
+    HASH_FIND_PTR(m_pHashForUpdates, &pTarget, pElement);
     if (pElement)
     {
         if (m_bUpdateHashLocked)
@@ -513,7 +557,7 @@ void CCScheduler::unscheduleUpdateForTarget(const CCObject *pTarget)
         }
         else
         {
-            this->removeUpdateFromHash(pElement->entry);
+            this->removeUpdateFromHash(pElement);
         }
     }
 }
@@ -538,32 +582,18 @@ void CCScheduler::unscheduleAllSelectorsWithMinPriority(int nMinPriority)
     }
 
     // Updates selectors
-    tListEntry *pEntry, *pTmp;
-    if(nMinPriority < 0) 
+    // mark them first and remove them afterwards, so no list is modified while it is iterated
+    for (tHashUpdateEntry *pUpdate = m_pHashForUpdates; pUpdate != NULL; pUpdate = (tHashUpdateEntry *)pUpdate->hh.next)
     {
-        DL_FOREACH_SAFE(m_pUpdatesNegList, pEntry, pTmp)
+        if (pUpdate->entry->priority >= nMinPriority)
         {
-            if(pEntry->priority >= nMinPriority) 
-            {
-                unscheduleUpdateForTarget(pEntry->target);
-            }
+            pUpdate->entry->markedForDeletion = true;
         }
     }
 
-    if(nMinPriority <= 0) 
+    if (! m_bUpdateHashLocked)
     {
-        DL_FOREACH_SAFE(m_pUpdates0List, pEntry, pTmp)
-        {
-            unscheduleUpdateForTarget(pEntry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE(m_pUpdatesPosList, pEntry, pTmp)
-    {
-        if(pEntry->priority >= nMinPriority) 
-        {
-            unscheduleUpdateForTarget(pEntry->target);
-        }
+        removeMarkedUpdates();
     }
 
     if (m_pScriptHandlerEntries)
@@ -582,7 +612,7 @@ void CCScheduler::unscheduleAllSelectorsForTarget(CCObject *pTarget)
 
     // Custom Selectors
     tHashSelectorEntry *pElement = NULL;
-    HASH_FIND_INT(m_pHashForSelectors, &pTarget, pElement);
+    HASH_FIND_PTR(m_pHashForSelectors, &pTarget, pElement);
 
     if (pElement)
     {
@@ -639,7 +669,7 @@ void CCScheduler::resumeTarget(CCObject *pTarget)
 
     // custom selectors
     tHashSelectorEntry *pElement = NULL;
-    HASH_FIND_INT(m_pHashForSelectors, &pTarget, pElement);
+    HASH_FIND_PTR(m_pHashForSelectors, &pTarget, pElement);
     if (pElement)
     {
         pElement->paused = false;
@@ -647,7 +677,7 @@ void CCScheduler::resumeTarget(CCObject *pTarget)
 
     // update selector
     tHashUpdateEntry *pElementUpdate = NULL;
-    HASH_FIND_INT(m_pHashForUpdates, &pTarget, pElementUpdate);
+    HASH_FIND_PTR(m_pHashForUpdates, &pTarget, pElementUpdate);
     if (pElementUpdate)
     {
         CCAssert(pElementUpdate->entry != NULL, "");
@@ -661,7 +691,7 @@ void CCScheduler::pauseTarget(CCObject *pTarget)
 
     // custom selectors
     tHashSelectorEntry *pElement = NULL;
-    HASH_FIND_INT(m_pHashForSelectors, &pTarget, pElement);
+    HASH_FIND_PTR(m_pHashForSelectors, &pTarget, pElement);
     if (pElement)
     {
         pElement->paused = true;
@@ -669,7 +699,7 @@ void CCScheduler::pauseTarget(CCObject *pTarget)
 
     // update selector
     tHashUpdateEntry *pElementUpdate = NULL;
-    HASH_FIND_INT(m_pHashForUpdates, &pTarget, pElementUpdate);
+    HASH_FIND_PTR(m_pHashForUpdates, &pTarget, pElementUpdate);
     if (pElementUpdate)
     {
         CCAssert(pElementUpdate->entry != NULL, "");
@@ -683,7 +713,7 @@ bool CCScheduler::isTargetPaused(CCObject *pTarget)
 
     // Custom selectors
     tHashSelectorEntry *pElement = NULL;
-    HASH_FIND_INT(m_pHashForSelectors, &pTarget, pElement);
+    HASH_FIND_PTR(m_pHashForSelectors, &pTarget, pElement);
     if( pElement )
     {
         return pElement->paused;
@@ -710,34 +740,13 @@ CCSet* CCScheduler::pauseAllTargetsWithMinPriority(int nMinPriority)
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(nMinPriority < 0) 
-    {
-        DL_FOREACH_SAFE( m_pUpdatesNegList, entry, tmp ) 
-        {
-            if(entry->priority >= nMinPriority) 
-            {
-                entry->paused = true;
-                idsWithSelectors->addObject(entry->target);
-            }
-        }
-    }
-
-    if(nMinPriority <= 0) 
-    {
-        DL_FOREACH_SAFE( m_pUpdates0List, entry, tmp )
-        {
-            entry->paused = true;
-            idsWithSelectors->addObject(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE( m_pUpdatesPosList, entry, tmp ) 
+    for (tHashUpdateEntry *element = m_pHashForUpdates; element != NULL;
+        element = (tHashUpdateEntry*)element->hh.next)
     {
-        if(entry->priority >= nMinPriority) 
+        if (element->entry->priority >= nMinPriority)
         {
-            entry->paused = true;
-            idsWithSelectors->addObject(entry->target);
+            element->entry->paused = true;
+            idsWithSelectors->addObject(element->target);
         }
     }
 
@@ -763,39 +772,25 @@ void CCScheduler::update(float dt)
         dt *= m_fTimeScale;
     }
 
-    // Iterate all over the Updates selectors
-    tListEntry *pEntry, *pTmp;
-
-    // updates with priority < 0
-    DL_FOREACH_SAFE(m_pUpdatesNegList, pEntry, pTmp)
-    {
-        if ((! pEntry->paused) && (! pEntry->markedForDeletion))
-        {
-            pEntry->target->update(dt);
-        }
-    }
+    // Iterate all over the Updates selectors, in priority order.
+    // While locked, nothing is added to or removed from the buckets
+    CCScriptEngineProtocol* pEngine = CCScriptEngineManager::sharedManager()->getScriptEngine();
+    bool bJavascript = (pEngine != NULL && kScriptTypeJavascript == pEngine->getScriptType());
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(m_pUpdates0List, pEntry, pTmp)
+    for (tPriorityBucket *pBucket = m_pUpdateBuckets; pBucket != NULL; pBucket = pBucket->next)
     {
-        if ((! pEntry->paused) && (! pEntry->markedForDeletion))
+        for (tListEntry *pEntry = pBucket->entries; pEntry != NULL; pEntry = pEntry->next)
         {
-            CCScriptEngineProtocol* pEngine = CCScriptEngineManager::sharedManager()->getScriptEngine();
-            if (pEngine != NULL && kScriptTypeJavascript == pEngine->getScriptType())
+            if ((! pEntry->paused) && (! pEntry->markedForDeletion))
             {
-                CCScriptEngineManager::sharedManager()->getScriptEngine()->executeSchedule(1, dt, (CCNode *)pEntry->target);
-            }
-            
-            pEntry->target->update(dt);            
-        }
-    }
+                // updates with priority == 0 are forwarded to javascript too
+                if (bJavascript && pBucket->priority == 0)
+                {
+                    pEngine->executeSchedule(1, dt, (CCNode *)pEntry->target);
+                }
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(m_pUpdatesPosList, pEntry, pTmp)
-    {
-        if ((! pEntry->paused) && (! pEntry->markedForDeletion))
-        {
-            pEntry->target->update(dt);            
+                pEntry->target->update(dt);
+            }
         }
     }
 
@@ -855,37 +850,13 @@ void CCScheduler::update(float dt)
         }
     }
 
-    // delete all updates that are morked for deletion
-    // updates with priority < 0
-    DL_FOREACH_SAFE(m_pUpdatesNegList, pEntry, pTmp)
-    {
-        if (pEntry->markedForDeletion)
-        {
-            this->removeUpdateFromHash(pEntry);
-        }
-    }
-
-    // updates with priority == 0
-    DL_FOREACH_SAFE(m_pUpdates0List, pEntry, pTmp)
-    {
-        if (pEntry->markedForDeletion)
-        {
-            this->removeUpdateFromHash(pEntry);
-        }
-    }
-
-    // updates with priority > 0
-    DL_FOREACH_SAFE(m_pUpdatesPosList, pEntry, pTmp)
-    {
-        if (pEntry->markedForDeletion)
-        {
-            this->removeUpdateFromHash(pEntry);
-        }
-    }
-
     m_bUpdateHashLocked = false;
 
     m_pCurrentTarget = NULL;
+
+    // delete all updates that are marked for deletion, and add the ones scheduled during the tick
+    removeMarkedUpdates();
+    addPendingUpdates();
 }
 
 
@@ -101,6 +101,7 @@ protected:
 // CCScheduler
 //
 struct _listEntry;
+struct _priorityBucket;
 struct _hashSelectorEntry;
 struct _hashUpdateEntry;
 
@@ -116,6 +117,11 @@ There are 2 different types of callbacks (selectors):
 
 The 'custom selectors' should be avoided when possible. It is faster, and consumes less memory to use the 'update selector'.
 
+Targets are looked up by pointer, and the 'update' selectors are grouped in one bucket per priority,
+so scheduling and unscheduling don't depend on the number of scheduled targets.
+Targets that are scheduled or unscheduled while the scheduler is ticking are added / removed
+once the tick is over.
+
 */
 class CC_DLL CCScheduler : public CCObject
 {
@@ -237,12 +243,15 @@ public:
 
 private:
     void removeHashElement(struct _hashSelectorEntry *pElement);
-    void removeUpdateFromHash(struct _listEntry *entry);
+    void removeUpdateFromHash(struct _hashUpdateEntry *pElement);
+    struct _listEntry* unlinkUpdate(struct _hashUpdateEntry *pElement);
 
     // update specific
 
-    void priorityIn(struct _listEntry **ppList, CCObject *pTarget, int nPriority, bool bPaused);
-    void appendIn(struct _listEntry **ppList, CCObject *pTarget, bool bPaused);
+    struct _priorityBucket* bucketForPriority(int nPriority);
+    void appendIn(struct _priorityBucket *pBucket, struct _listEntry *pEntry);
+    void removeMarkedUpdates(void);
+    void addPendingUpdates(void);
 
 protected:
     float m_fTimeScale;
@@ -250,9 +259,9 @@ protected:
     //
     // "updates with priority" stuff
     //
-    struct _listEntry *m_pUpdatesNegList;        // list of priority < 0
-    struct _listEntry *m_pUpdates0List;            // list priority == 0
-    struct _listEntry *m_pUpdatesPosList;        // list priority > 0
+    struct _priorityBucket *m_pUpdateBuckets;    // one list of entries per priority, sorted by priority
+    struct _priorityBucket *m_pHashForBuckets;   // hash used to fetch quickly the bucket of a priority
+    struct _listEntry *m_pPendingUpdates;        // entries scheduled while the scheduler was ticking
     struct _hashUpdateEntry *m_pHashForUpdates; // hash used to fetch quickly the list entries for pause,delete,etc
 
     // Used for "selectors with interval"
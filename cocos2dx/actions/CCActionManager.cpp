@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "support/data_support/ccCArray.h"
 #include "support/data_support/uthash.h"
 #include "cocoa/CCSet.h"
+#include "support/CCProfiling.h"
 
 NS_CC_BEGIN
 //
@@ -338,6 +339,8 @@ unsigned int CCActionManager::numberOfRunningActionsInTarget(CCObject *pTarget)
 // main loop
 void CCActionManager::update(float dt)
 {
+    CC_FRAME_PROFILER_SCOPE("actions");
+
     for (tHashElement *elt = m_pTargets; elt != NULL; )
     {
         m_pCurrentTarget = elt;
@@ -26,6 +26,7 @@ THE SOFTWARE.
 
 #include "CCAtlasNode.h"
 #include "textures/CCTextureAtlas.h"
+#include "textures/CCTextureCache.h"
 #include "CCDirector.h"
 #include "shaders/CCGLProgram.h"
 #include "shaders/CCShaderCache.h"
@@ -83,6 +84,14 @@ bool CCAtlasNode::initWithTileFile(const char *tile, unsigned int tileWidth, uns
                                    unsigned int itemsToRender)
 {
     CCAssert(tile != NULL, "title should not be null");
+    CCTexture2D *texture = CCTextureCache::sharedTextureCache()->addImage(tile);
+    return initWithTexture(texture, tileWidth, tileHeight, itemsToRender);
+}
+
+bool CCAtlasNode::initWithTexture(CCTexture2D* texture, unsigned int tileWidth, unsigned int tileHeight,
+                                  unsigned int itemsToRender)
+{
+    CCAssert(texture != NULL, "texture should not be null");
     m_uItemWidth  = tileWidth;
     m_uItemHeight = tileHeight;
 
@@ -94,7 +103,7 @@ bool CCAtlasNode::initWithTileFile(const char *tile, unsigned int tileWidth, uns
     m_tBlendFunc.dst = CC_BLEND_DST;
 
     CCTextureAtlas* pNewAtlas= new CCTextureAtlas();
-    pNewAtlas->initWithFile(tile, itemsToRender);
+    pNewAtlas->initWithTexture(texture, itemsToRender);
     setTextureAtlas(pNewAtlas);
     pNewAtlas->release();
 
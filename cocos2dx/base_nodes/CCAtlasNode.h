@@ -97,6 +97,11 @@ public:
     /** initializes an CCAtlasNode  with an Atlas file the width and height of each item and the quantity of items to render*/
     bool initWithTileFile(const char* tile, unsigned int tileWidth, unsigned int tileHeight, unsigned int itemsToRender);
 
+    /** initializes an CCAtlasNode  with a texture the width and height of each item measured in points and the quantity of items to render
+     @since v2.1
+     */
+    bool initWithTexture(CCTexture2D* texture, unsigned int tileWidth, unsigned int tileHeight, unsigned int itemsToRender);
+
     /** updates the Atlas (indexed vertex array).
     * Shall be overriden in subclasses
     */
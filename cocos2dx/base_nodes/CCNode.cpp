@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "CCNode.h"
 #include "support/CCPointExtension.h"
 #include "support/TransformUtils.h"
+#include "support/CCCulling.h"
 #include "CCCamera.h"
 #include "effects/CCGrid.h"
 #include "CCDirector.h"
@@ -38,6 +39,8 @@ THE SOFTWARE.
 #include "shaders/CCGLProgram.h"
 // externals
 #include "kazmath/GL/matrix.h"
+#include <string.h>
+#include <stdlib.h>
 
 
 #if CC_NODE_RENDER_SUBPIXEL
@@ -51,6 +54,18 @@ NS_CC_BEGIN
 // XXX: Yes, nodes might have a sort problem once every 15 days if the game runs at 60 FPS and each frame sprites are reordered.
 static int s_globalOrderOfArrival = 1;
 
+// scratch memory used by sortChildrenByZOrder. Only used from the main thread
+static CCNode** s_pSortBuffer = NULL;
+static unsigned int s_uSortBufferCapacity = 0;
+
+// node whose model-view matrix is on top of the matrix stack, NULL if unknown
+static CCNode* s_pModelViewNode = NULL;
+// last stamp given to a model-view matrix. 0 is never used
+static unsigned int s_uModelViewStamp = 0;
+
+// below this size, merge sort falls back to insertion sort
+#define CC_NODE_INSERTION_SORT_SIZE 16
+
 CCNode::CCNode(void)
 : m_nZOrder(0)
 , m_fVertexZ(0.0f)
@@ -77,6 +92,8 @@ CCNode::CCNode(void)
 // userData is always inited as nil
 , m_pUserData(NULL)
 , m_pUserObject(NULL)
+, m_uModelViewStamp(0)
+, m_uParentModelViewStamp(0)
 , m_bIsTransformDirty(true)
 , m_bIsInverseDirty(true)
 , m_nScriptHandler(0)
@@ -84,6 +101,7 @@ CCNode::CCNode(void)
 , m_nOrderOfArrival(0)
 , m_glServerState(CC_GL_BLEND)
 , m_bReorderChildDirty(false)
+, m_bIsZOrderDirty(false)
 {
     // set default scheduler and actionManager
     CCDirector *director = CCDirector::sharedDirector();
@@ -100,6 +118,11 @@ CCNode::~CCNode(void)
 {
     CCLOGINFO( "cocos2d: deallocing" );
 
+    if (s_pModelViewNode == this)
+    {
+        s_pModelViewNode = NULL;
+    }
+
     CC_SAFE_RELEASE(m_pActionManager);
     CC_SAFE_RELEASE(m_pScheduler);
     // attributes
@@ -182,6 +205,7 @@ float CCNode::getVertexZ()
 void CCNode::setVertexZ(float var)
 {
     m_fVertexZ = var;
+    m_uParentModelViewStamp = 0;
 }
 
 
@@ -598,6 +622,7 @@ void CCNode::removeAllChildrenWithCleanup(bool cleanup)
                 }
                 // set parent nil at the end
                 pNode->setParent(NULL);
+                pNode->m_bIsZOrderDirty = false;
             }
         }
         
@@ -626,6 +651,7 @@ void CCNode::detachChild(CCNode *child, bool doCleanup)
 
     // set parent nil at the end
     child->setParent(NULL);
+    child->m_bIsZOrderDirty = false;
 
     m_pChildren->removeObject(child);
 }
@@ -637,6 +663,7 @@ void CCNode::insertChild(CCNode* child, int z)
     m_bReorderChildDirty = true;
     ccArrayAppendObjectWithResize(m_pChildren->data, child);
     child->_setZOrder(z);
+    child->m_bIsZOrderDirty = true;
 }
 
 void CCNode::reorderChild(CCNode *child, int zOrder)
@@ -645,34 +672,140 @@ void CCNode::reorderChild(CCNode *child, int zOrder)
     m_bReorderChildDirty = true;
     child->setOrderOfArrival(s_globalOrderOfArrival++);
     child->_setZOrder(zOrder);
+    child->m_bIsZOrderDirty = true;
 }
 
 void CCNode::sortAllChildren()
 {
     if (m_bReorderChildDirty)
     {
-        int i,j,length = m_pChildren->data->num;
-        CCNode ** x = (CCNode**)m_pChildren->data->arr;
-        CCNode *tempItem;
+        sortChildrenByZOrder();
 
-        // insertion sort
-        for(i=1; i<length; i++)
+        //don't need to check children recursively, that's done in visit of each child
+
+        m_bReorderChildDirty = false;
+    }
+}
+
+void CCNode::mergeSortNodes(CCNode** pNodes, CCNode** pBuffer, unsigned int uCount)
+{
+    if (uCount <= CC_NODE_INSERTION_SORT_SIZE)
+    {
+        for (unsigned int i = 1; i < uCount; i++)
         {
-            tempItem = x[i];
-            j = i-1;
+            CCNode* pItem = pNodes[i];
+            unsigned int j = i;
+            while (j > 0 && isDrawnBefore(pItem, pNodes[j-1]))
+            {
+                pNodes[j] = pNodes[j-1];
+                j--;
+            }
+            pNodes[j] = pItem;
+        }
+        return;
+    }
+
+    unsigned int uHalf = uCount / 2;
+    mergeSortNodes(pNodes, pBuffer, uHalf);
+    mergeSortNodes(pNodes + uHalf, pBuffer, uCount - uHalf);
+
+    // already in order: nothing to merge. Makes sorted runs O(n)
+    if (! isDrawnBefore(pNodes[uHalf], pNodes[uHalf-1]))
+    {
+        return;
+    }
 
-            //continue moving element downwards while zOrder is smaller or when zOrder is the same but mutatedIndex is smaller
-            while(j>=0 && ( tempItem->m_nZOrder < x[j]->m_nZOrder || ( tempItem->m_nZOrder== x[j]->m_nZOrder && tempItem->m_nOrderOfArrival < x[j]->m_nOrderOfArrival ) ) )
+    // merge the left half, moved to the buffer, with the right half in place.
+    // On equal keys the left one goes first, which keeps the sort stable
+    memcpy(pBuffer, pNodes, uHalf * sizeof(CCNode*));
+    unsigned int i = 0, j = uHalf, k = 0;
+    while (i < uHalf && j < uCount)
+    {
+        pNodes[k++] = isDrawnBefore(pNodes[j], pBuffer[i]) ? pNodes[j++] : pBuffer[i++];
+    }
+    while (i < uHalf)
+    {
+        pNodes[k++] = pBuffer[i++];
+    }
+}
+
+void CCNode::purgeSortBuffer()
+{
+    free(s_pSortBuffer);
+    s_pSortBuffer = NULL;
+    s_uSortBufferCapacity = 0;
+}
+
+void CCNode::sortChildrenByZOrder()
+{
+    if (m_pChildren == NULL)
+    {
+        return;
+    }
+
+    unsigned int uCount = m_pChildren->data->num;
+    CCNode** x = (CCNode**)m_pChildren->data->arr;
+
+    // room for the moved children, plus the merge sort buffer
+    unsigned int uNeeded = uCount + uCount / 2 + 1;
+    if (s_uSortBufferCapacity < uNeeded)
+    {
+        CCNode** pNewBuffer = (CCNode**)realloc(s_pSortBuffer, uNeeded * sizeof(CCNode*));
+        if (pNewBuffer == NULL)
+        {
+            CCLOG("cocos2d: CCNode: not enough memory to sort the children");
+            return;
+        }
+        s_pSortBuffer = pNewBuffer;
+        s_uSortBufferCapacity = uNeeded;
+    }
+    CCNode** pMoved = s_pSortBuffer;
+    CCNode** pMergeBuffer = s_pSortBuffer + uCount;
+
+    // take the children that were added or reordered out of the array. The others keep
+    // their relative order, so they are still sorted unless their keys were changed directly
+    unsigned int uKept = 0, uMoved = 0;
+    bool bKeptSorted = true;
+    for (unsigned int i = 0; i < uCount; i++)
+    {
+        CCNode* pNode = x[i];
+        if (pNode->m_bIsZOrderDirty)
+        {
+            pNode->m_bIsZOrderDirty = false;
+            pMoved[uMoved++] = pNode;
+        }
+        else
+        {
+            if (uKept > 0 && isDrawnBefore(pNode, x[uKept-1]))
             {
-                x[j+1] = x[j];
-                j = j-1;
+                bKeptSorted = false;
             }
-            x[j+1] = tempItem;
+            x[uKept++] = pNode;
         }
+    }
 
-        //don't need to check children recursively, that's done in visit of each child
+    if (! bKeptSorted)
+    {
+        // orderOfArrival / zOrder were modified without reorderChild: sort everything
+        memcpy(x + uKept, pMoved, uMoved * sizeof(CCNode*));
+        mergeSortNodes(x, pMergeBuffer, uCount);
+        return;
+    }
 
-        m_bReorderChildDirty = false;
+    mergeSortNodes(pMoved, pMergeBuffer, uMoved);
+
+    // merge from the back, so the kept children are only moved once
+    int i = (int)uKept - 1, j = (int)uMoved - 1, k = (int)uCount - 1;
+    while (j >= 0)
+    {
+        if (i >= 0 && isDrawnBefore(pMoved[j], x[i]))
+        {
+            x[k--] = x[i--];
+        }
+        else
+        {
+            x[k--] = pMoved[j--];
+        }
     }
 }
 
@@ -692,15 +825,34 @@ void CCNode::visit()
     {
         return;
     }
+    CCNode* pModelViewNode = s_pModelViewNode;
     kmGLPushMatrix();
 
-     if (m_pGrid && m_pGrid->isActive())
+    // the grid renders the node into a texture, the screen rect doesn't apply to it
+    bool bGridActive = m_pGrid && m_pGrid->isActive();
+     if (bGridActive)
      {
          m_pGrid->beforeDraw();
+         CCCulling::suspend();
      }
 
     this->transform();
 
+    // skip the draw of the nodes that are outside of the screen. Their children might not be
+    bool bDraw = true;
+    if (CCCulling::isActive() && m_tContentSize.width > 0 && m_tContentSize.height > 0)
+    {
+        bDraw = ! CCCulling::isRectOutside(CCRectMake(0, 0, m_tContentSize.width, m_tContentSize.height), &m_tModelViewTransform);
+        if (bDraw)
+        {
+            CCCulling::addDrawn(1);
+        }
+        else
+        {
+            CCCulling::addCulled(1);
+        }
+    }
+
     CCNode* pNode = NULL;
     unsigned int i = 0;
 
@@ -723,7 +875,10 @@ void CCNode::visit()
             }
         }
         // self draw
-        this->draw();
+        if (bDraw)
+        {
+            this->draw();
+        }
 
         for( ; i < arrayData->num; i++ )
         {
@@ -734,7 +889,7 @@ void CCNode::visit()
             }
         }        
     }
-    else
+    else if (bDraw)
     {
         this->draw();
     }
@@ -742,12 +897,14 @@ void CCNode::visit()
     // reset for next frame
     m_nOrderOfArrival = 0;
 
-     if (m_pGrid && m_pGrid->isActive())
+     if (bGridActive)
      {
+         CCCulling::resume();
          m_pGrid->afterDraw(this);
     }
  
     kmGLPopMatrix();
+    s_pModelViewNode = pModelViewNode;
 }
 
 void CCNode::transformAncestors()
@@ -759,8 +916,30 @@ void CCNode::transformAncestors()
     }
 }
 
+void CCNode::invalidateModelViewStack()
+{
+    s_pModelViewNode = NULL;
+}
+
 void CCNode::transform()
 {    
+    // a grid or a camera changes the matrix the node is drawn with, it isn't cached
+    bool bGridActive = ( m_pGrid != NULL && m_pGrid->isActive() );
+    bool bCameraActive = ( m_pCamera != NULL && !bGridActive );
+
+    // the parent's matrix is on top of the stack when the node is visited by its parent.
+    // Roots and nodes visited from somewhere else are computed again
+    bool bParentOnStack = ( m_pParent != NULL && m_pParent == s_pModelViewNode && !bGridActive && !bCameraActive );
+
+    // Quick path: neither the local transform nor the parent's matrix changed since the last call.
+    // Physics sprites override nodeToParentTransform() and never clear m_bIsTransformDirty
+    if (bParentOnStack && ! m_bIsTransformDirty && m_uParentModelViewStamp == m_pParent->m_uModelViewStamp)
+    {
+        kmGLLoadMatrix(&m_tModelViewTransform);
+        s_pModelViewNode = this;
+        return;
+    }
+
     kmMat4 transfrom4x4;
 
     // Convert 3x3 into 4x4 matrix
@@ -774,7 +953,7 @@ void CCNode::transform()
 
 
     // XXX: Expensive calls. Camera should be integrated into the cached affine matrix
-    if ( m_pCamera != NULL && !(m_pGrid != NULL && m_pGrid->isActive()) )
+    if ( bCameraActive )
     {
         bool translate = (m_tAnchorPointInPoints.x != 0.0f || m_tAnchorPointInPoints.y != 0.0f);
 
@@ -787,6 +966,20 @@ void CCNode::transform()
             kmGLTranslatef(RENDER_IN_SUBPIXEL(-m_tAnchorPointInPoints.x), RENDER_IN_SUBPIXEL(-m_tAnchorPointInPoints.y), 0 );
     }
 
+    // the children keep their cached matrices while the result doesn't change, eg: for the roots
+    kmMat4 modelView;
+    kmGLGetMatrix(KM_GL_MODELVIEW, &modelView);
+    if (m_uModelViewStamp == 0 || memcmp(modelView.mat, m_tModelViewTransform.mat, sizeof(modelView.mat)) != 0)
+    {
+        m_tModelViewTransform = modelView;
+        if (++s_uModelViewStamp == 0)
+        {
+            ++s_uModelViewStamp;
+        }
+        m_uModelViewStamp = s_uModelViewStamp;
+    }
+    m_uParentModelViewStamp = bParentOnStack ? m_pParent->m_uModelViewStamp : 0;
+    s_pModelViewNode = this;
 }
 
 
@@ -1045,6 +1238,8 @@ CCAffineTransform CCNode::nodeToParentTransform(void)
         }
 
         m_bIsTransformDirty = false;
+        // the cached model-view matrix is out of date
+        m_uParentModelViewStamp = 0;
     }
 
     return m_tTransform;
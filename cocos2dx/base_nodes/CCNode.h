@@ -284,10 +284,19 @@ protected:
     // transform
     CCAffineTransform m_tTransform, m_tInverse;
 
+    // model-view matrix cached by transform()
+    kmMat4 m_tModelViewTransform;
+    // changes each time m_tModelViewTransform changes
+    unsigned int m_uModelViewStamp;
+    // stamp of the parent's matrix m_tModelViewTransform was computed from, 0 if it must be computed again
+    unsigned int m_uParentModelViewStamp;
+
     // To reduce memory, place bools that are not properties here:
     bool m_bIsTransformDirty;
     bool m_bIsInverseDirty;
     bool m_bReorderChildDirty;
+    // set when the zOrder or orderOfArrival changed since the parent sorted its children
+    bool m_bIsZOrderDirty;
     int m_nScriptHandler;
     ccScriptType m_eScriptType;
 private:
@@ -297,6 +306,15 @@ private:
     //! helper that reorder a child
     void insertChild(CCNode* child, int z);
 
+    //! true if pA is drawn before pB: lower zOrder first, then lower orderOfArrival
+    static inline bool isDrawnBefore(CCNode* pA, CCNode* pB)
+    {
+        return pA->m_nZOrder < pB->m_nZOrder || (pA->m_nZOrder == pB->m_nZOrder && pA->m_nOrderOfArrival < pB->m_nOrderOfArrival);
+    }
+
+    //! stable merge sort of uCount nodes. pBuffer must hold at least uCount / 2 nodes
+    static void mergeSortNodes(CCNode** pNodes, CCNode** pBuffer, unsigned int uCount);
+
     //! used internally to alter the zOrder variable. DON'T call this method manually
     void setZOrder(int z);
     
@@ -404,7 +422,7 @@ public:
      @return returns a CCNode object
      @since v0.7.1
      */
-    CCNode * getChildByTag(int tag);
+    virtual CCNode * getChildByTag(int tag);
 
     /** Reorders a child according to a new z value.
      * The child MUST be already added.
@@ -415,6 +433,19 @@ public:
      don't call this manually unless a child added needs to be removed in the same frame */
     virtual void sortAllChildren();
 
+    /** Sorts the children array by zOrder and orderOfArrival. Stable, O(n log n) worst case.
+     Only the children that were added or reordered since the last sort are sorted; they are
+     then merged back into the others in a single pass, so re-sorting after a few changes is O(n).
+     Used by the sortAllChildren implementations. Doesn't check nor reset m_bReorderChildDirty.
+     @since v2.1
+     */
+    void sortChildrenByZOrder();
+
+    /** Frees the scratch memory used by sortChildrenByZOrder. It is called by CCDirector::purgeDirector.
+     @since v2.1
+     */
+    static void purgeSortBuffer(void);
+
     /** Stops all running actions and schedulers
      @since v0.8
      */
@@ -440,9 +471,29 @@ public:
 
     // transformations
 
-    /** performs OpenGL view-matrix transformation based on position, scale, rotation and other attributes. */
+    /** performs OpenGL view-matrix transformation based on position, scale, rotation and other attributes.
+     The resulting model-view matrix is cached: when it is called from the visit() of the parent, and
+     neither the node nor the parent's matrix changed since the last call, the cached matrix is loaded
+     instead of being computed again.
+     Nodes that override nodeToParentTransform() without calling CCNode::nodeToParentTransform() (eg:
+     physics sprites) are computed at each call.
+     */
     void transform(void);
 
+    /** Returns the model-view matrix computed by the last transform() call.
+     It is the matrix that is on top of the model-view stack when draw() is called.
+     @since v2.1
+     */
+    inline const kmMat4& getModelViewTransform(void) { return m_tModelViewTransform; }
+
+    /** Tells the nodes that the matrix on top of the model-view stack is not the one of the node
+     being visited anymore, so the next transform() can't use its cached matrix.
+     It is called by CCDirector::setProjection, CCRenderTexture::begin and the grids. Call it if you
+     change the model-view stack and then visit nodes.
+     @since v2.1
+     */
+    static void invalidateModelViewStack(void);
+
     /** performs OpenGL view-matrix transformation of it's ancestors.
      Generally the ancestors are already transformed, but in certain cases (eg: attaching a FBO)
      it's necessary to transform the ancestors again.
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "CCGL.h"
 #include "support/CCPointExtension.h"
 #include "support/TransformUtils.h"
+#include "support/CCRenderQueue.h"
 #include "kazmath/kazmath.h"
 #include "kazmath/GL/matrix.h"
 
@@ -203,6 +204,7 @@ void CCGridBase::set2DProjection()
 
     kmGLMatrixMode(KM_GL_MODELVIEW);
     kmGLLoadIdentity();
+    CCNode::invalidateModelViewStack();
 
 
     ccSetProjectionMatrixDirty();
@@ -210,6 +212,9 @@ void CCGridBase::set2DProjection()
 
 void CCGridBase::beforeDraw(void)
 {
+    // the batched quads belong to the previous render target
+    CCRenderQueue::sharedRenderQueue()->flush();
+
     // save projection
     CCDirector *director = CCDirector::sharedDirector();
     m_directorProjection = director->getProjection();
@@ -222,6 +227,7 @@ void CCGridBase::beforeDraw(void)
 
 void CCGridBase::afterDraw(cocos2d::CCNode *pTarget)
 {
+    CCRenderQueue::sharedRenderQueue()->flush();
     m_pGrabber->afterRender(m_pTexture);
 
     // restore projection
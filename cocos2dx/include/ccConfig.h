@@ -87,6 +87,18 @@ To enabled set it to 1. Disabled by default.
 #define CC_DIRECTOR_STATS_INTERVAL (0.1f)
 #endif
 
+/** @def CC_DIRECTOR_MAX_FIXED_TIME_STEPS
+ Maximum number of fixed time steps run in one frame, when CCDirector::setFixedTimeStep is used.
+ After a longer frame the time that is left isn't simulated, so that a slow frame doesn't make
+ the next ones slower.
+
+ Default value: 5
+ @since v2.1
+ */
+#ifndef CC_DIRECTOR_MAX_FIXED_TIME_STEPS
+#define CC_DIRECTOR_MAX_FIXED_TIME_STEPS 5
+#endif
+
 /** @def CC_DIRECTOR_FPS_POSITION
  Position of the FPS
 
@@ -174,6 +186,18 @@ Only valid for cocos2d-mac. Not supported on cocos2d-ios.
     #endif
 #endif
 
+/** @def CC_TEXTURE_ATLAS_DIRTY_RANGES
+ Maximum number of ranges of modified quads tracked by CCTextureAtlas.
+ Only the modified quads are uploaded to the VBO when the atlas is drawn. When more ranges
+ are modified, the closest ones are merged.
+
+ Default value: 8
+ @since v2.1
+ */
+#ifndef CC_TEXTURE_ATLAS_DIRTY_RANGES
+#define CC_TEXTURE_ATLAS_DIRTY_RANGES 8
+#endif
+
 
 /** @def CC_USE_LA88_LABELS
  If enabled, it will use LA88 (Luminance Alpha 16-bit textures) for CCLabelTTF objects.
@@ -234,6 +258,89 @@ To enable set it to a value different than 0. Disabled by default.
 #define CC_LABELATLAS_DEBUG_DRAW 0
 #endif
 
+/** @def CC_GLYPH_ATLAS_TEXTURE_WIDTH
+ Width, in pixels, of the textures where CCGlyphAtlas packs the glyphs used by CCLabelGlyphAtlas.
+ The textures grow in height, up to the maximum texture size, as glyphs are added.
+
+ Default value: 512
+ */
+#ifndef CC_GLYPH_ATLAS_TEXTURE_WIDTH
+#define CC_GLYPH_ATLAS_TEXTURE_WIDTH 512
+#endif
+
+/** @def CC_TEXTURE_CACHE_ASYNC_THREADS
+ Number of threads that decode the images requested with CCTextureCache::addImageAsync.
+ It can be changed at runtime with CCTextureCache::setAsyncLoadingThreadCount.
+
+ Default value: 2
+ */
+#ifndef CC_TEXTURE_CACHE_ASYNC_THREADS
+#define CC_TEXTURE_CACHE_ASYNC_THREADS 2
+#endif
+
+/** @def CC_TEXTURE_CACHE_ASYNC_UPLOAD_BUDGET
+ Time, in milliseconds, that CCTextureCache may spend per frame creating the textures of the
+ images decoded by the async loading threads. At least one texture is created per frame.
+ It can be changed at runtime with CCTextureCache::setAsyncUploadTimeBudget.
+
+ Default value: 8 milliseconds
+ */
+#ifndef CC_TEXTURE_CACHE_ASYNC_UPLOAD_BUDGET
+#define CC_TEXTURE_CACHE_ASYNC_UPLOAD_BUDGET (8.0f)
+#endif
+
+/** @def CC_TEXTURE_CACHE_MEMORY_BUDGET
+ Video memory, in bytes, that the textures of CCTextureCache may use before the least recently used
+ textures that are only retained by the cache are evicted.
+ It can be changed at runtime with CCTextureCache::setMemoryBudget.
+
+ To disable the eviction set it to 0. Disabled by default.
+ */
+#ifndef CC_TEXTURE_CACHE_MEMORY_BUDGET
+#define CC_TEXTURE_CACHE_MEMORY_BUDGET 0
+#endif
+
+/** @def CC_JOB_SYSTEM_THREADS
+ Number of worker threads of CCJobSystem. The thread that runs the jobs takes part too.
+ 0 uses one worker thread less than the number of processors.
+ It can be changed at runtime with CCJobSystem::setWorkerThreadCount.
+
+ Default value: 0
+ */
+#ifndef CC_JOB_SYSTEM_THREADS
+#define CC_JOB_SYSTEM_THREADS 0
+#endif
+
+/** @def CC_SPRITE_BATCH_NODE_SPRITES_PER_JOB
+ Minimum number of children that each job updates when a CCSpriteBatchNode updates its sprites in
+ parallel (see CCSpriteBatchNode::setParallelUpdateEnabled). Smaller batches are updated by the main thread.
+
+ Default value: 256
+ */
+#ifndef CC_SPRITE_BATCH_NODE_SPRITES_PER_JOB
+#define CC_SPRITE_BATCH_NODE_SPRITES_PER_JOB 256
+#endif
+
+/** @def CC_FONT_CACHE_MAX_FACES
+ Number of font faces, one per font file and size, that the Linux CCImage text renderer keeps open.
+ When a new face is needed the least recently used one is closed.
+
+ Default value: 8
+ */
+#ifndef CC_FONT_CACHE_MAX_FACES
+#define CC_FONT_CACHE_MAX_FACES 8
+#endif
+
+/** @def CC_FONT_CACHE_GLYPH_MEMORY
+ Memory, in bytes, that the Linux CCImage text renderer may use to keep rendered glyphs.
+ When it is exceeded the glyphs of the least recently used faces are released.
+
+ Default value: 256 KB
+ */
+#ifndef CC_FONT_CACHE_GLYPH_MEMORY
+#define CC_FONT_CACHE_GLYPH_MEMORY (256 * 1024)
+#endif
+
 /** @def CC_ENABLE_PROFILERS
  If enabled, will activate various profilers withing cocos2d. This statistical data will be output to the console
  once per second showing average time (in milliseconds) required to execute the specific routine(s).
@@ -245,6 +352,43 @@ To enable set it to a value different than 0. Disabled by default.
 #define CC_ENABLE_PROFILERS 0
 #endif
 
+/** @def CC_ENABLE_FRAME_PROFILER
+ If enabled, the phases of each frame (scheduler, actions, visit, draw, texture uploads,
+ autorelease pool) are recorded by CCFrameProfiler while it is started, and can be exported
+ as a Chrome trace. A span costs a branch while the profiler isn't recording, so it can be
+ left enabled in release builds.
+
+ To disable set it to 0. Enabled by default.
+ @since v2.1
+ */
+#ifndef CC_ENABLE_FRAME_PROFILER
+#define CC_ENABLE_FRAME_PROFILER 1
+#endif
+
+/** @def CC_FRAME_PROFILER_CAPACITY
+ Number of spans kept by CCFrameProfiler. When more spans are recorded the oldest ones are overwritten.
+ Each span takes 32 bytes.
+
+ Default value: 65536
+ @since v2.1
+ */
+#ifndef CC_FRAME_PROFILER_CAPACITY
+#define CC_FRAME_PROFILER_CAPACITY 65536
+#endif
+
+/** @def CC_HEADLESS
+ Linux only. If enabled, nothing is displayed: CCEGLView doesn't open a window, OpenGL is
+ replaced by the null implementation of platform/linux/CCNullGL.cpp, and CCApplication::run
+ runs the frames as fast as possible. It is used to benchmark the engine on machines
+ without a GPU. Build with "make HEADLESS=1".
+
+ Disabled by default.
+ @since v2.1
+ */
+#ifndef CC_HEADLESS
+#define CC_HEADLESS 0
+#endif
+
 /** Enable Lua engine debug log */
 #ifndef CC_LUA_ENGINE_DEBUG
 #define CC_LUA_ENGINE_DEBUG 0
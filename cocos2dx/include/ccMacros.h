@@ -84,10 +84,10 @@ default gl blend src function. Compatible with premultiplied alpha images.
  */
 #define CC_NODE_DRAW_SETUP() \
 do { \
-    ccGLEnable( m_glServerState ); \
     CCAssert(getShaderProgram(), "No shader program set for this node"); \
     { \
         getShaderProgram()->use(); \
+        ccGLEnable( m_glServerState ); \
         getShaderProgram()->setUniformForModelViewProjectionMatrix(); \
     } \
 } while(0)
@@ -218,6 +218,20 @@ It should work same as apples CFSwapInt32LittleToHost(..)
 
 #endif
 
+/** @def CC_FRAME_PROFILER_SCOPE
+ Records a CCFrameProfiler span named __name__ until the end of the enclosing block.
+ __name__ must stay valid, usually it is a string literal.
+ */
+#if CC_ENABLE_FRAME_PROFILER
+#define CC_FRAME_PROFILER_SCOPE(__name__) CCFrameProfilerScope __ccFrameProfilerScope(__name__)
+#define CC_FRAME_PROFILER_BEGIN_FRAME() do{ if(CCFrameProfiler::isRecording()) CCFrameProfiler::sharedFrameProfiler()->beginFrame(); } while(0)
+#define CC_FRAME_PROFILER_END_FRAME() do{ if(CCFrameProfiler::isRecording()) CCFrameProfiler::sharedFrameProfiler()->endFrame(); } while(0)
+#else
+#define CC_FRAME_PROFILER_SCOPE(__name__) do {} while(0)
+#define CC_FRAME_PROFILER_BEGIN_FRAME() do {} while(0)
+#define CC_FRAME_PROFILER_END_FRAME() do {} while(0)
+#endif
+
 #if !defined(COCOS2D_DEBUG) || COCOS2D_DEBUG == 0
 #define CHECK_GL_ERROR_DEBUG()
 #else
@@ -237,6 +251,13 @@ It should work same as apples CFSwapInt32LittleToHost(..)
 extern unsigned int CC_DLL g_uNumberOfDraws;
 #define CC_INCREMENT_GL_DRAWS(__n__) g_uNumberOfDraws += __n__
 
+/** @def CC_INCREMENT_GL_UPLOADED_BYTES
+ Increments the number of bytes uploaded to GL buffers.
+ The bytes uploaded during the last frame are returned by CCDirector::getNumberOfUploadedBytes().
+ */
+extern unsigned int CC_DLL g_uNumberOfUploadedBytes;
+#define CC_INCREMENT_GL_UPLOADED_BYTES(__n__) g_uNumberOfUploadedBytes += __n__
+
 /*******************/
 /** Notifications **/
 /*******************/
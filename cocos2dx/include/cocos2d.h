@@ -92,6 +92,7 @@ THE SOFTWARE.
 #include "label_nodes/CCLabelAtlas.h"
 #include "label_nodes/CCLabelTTF.h"
 #include "label_nodes/CCLabelBMFont.h"
+#include "label_nodes/CCLabelGlyphAtlas.h"
 
 // layers_scenes_transitions_nodes
 #include "layers_scenes_transitions_nodes/CCLayer.h"
@@ -196,6 +197,9 @@ THE SOFTWARE.
 #include "support/CCNotificationCenter.h"
 #include "support/CCPointExtension.h"
 #include "support/CCProfiling.h"
+#include "support/CCRenderQueue.h"
+#include "support/CCCulling.h"
+#include "support/CCJobSystem.h"
 #include "support/CCUserDefault.h"
 #include "support/CCVertex.h"
 
@@ -48,13 +48,6 @@ using namespace std;
 
 NS_CC_BEGIN
 
-typedef struct _FontDefHashElement
-{
-    unsigned int    key;        // key. Font Unicode value
-    ccBMFontDef        fontDef;    // font definition
-    UT_hash_handle    hh;
-} tFontDefHashElement;
-
 static int cc_wcslen(const unsigned short* str)
 {
     int i=0;
@@ -426,7 +419,7 @@ CCBMFontConfiguration * CCBMFontConfiguration::create(const char *FNTfile)
 bool CCBMFontConfiguration::initWithFNTfile(const char *FNTfile)
 {
     m_pKerningDictionary = NULL;
-    m_pFontDefDictionary = NULL;
+    this->purgeFontDefDictionary();
     if (! this->parseConfigFile(FNTfile))
     {
         return false;
@@ -436,11 +429,12 @@ bool CCBMFontConfiguration::initWithFNTfile(const char *FNTfile)
 }
 
 CCBMFontConfiguration::CCBMFontConfiguration()
-    : m_pFontDefDictionary(NULL)
+    : m_pFontDefIndex(NULL)
+    , m_uFontDefIndexSize(0)
     , m_nCommonHeight(0)
     , m_pKerningDictionary(NULL)
 {
-
+    memset(&m_tPadding, 0, sizeof(m_tPadding));
 }
 
 CCBMFontConfiguration::~CCBMFontConfiguration()
@@ -456,7 +450,7 @@ const char* CCBMFontConfiguration::description(void)
     return CCString::createWithFormat(
         "<CCBMFontConfiguration = %08X | Glphys:%d Kernings:%d | Image = %s>",
         this,
-        HASH_COUNT(m_pFontDefDictionary),
+        (int)m_obFontDefs.size(),
         HASH_COUNT(m_pKerningDictionary),
         m_sAtlasName.c_str()
     )->getCString();
@@ -475,235 +469,482 @@ void CCBMFontConfiguration::purgeKerningDictionary()
 
 void CCBMFontConfiguration::purgeFontDefDictionary()
 {    
-    tFontDefHashElement *current, *tmp;
+    std::vector<ccBMFontDef>().swap(m_obFontDefs);
 
-    HASH_ITER(hh, m_pFontDefDictionary, current, tmp) {
-        HASH_DEL(m_pFontDefDictionary, current);
-        free(current);
+    free(m_pFontDefIndex);
+    m_pFontDefIndex = NULL;
+    m_uFontDefIndexSize = 0;
+}
+
+void CCBMFontConfiguration::reserveFontDefs(unsigned int uCount)
+{
+    m_obFontDefs.reserve(uCount);
+}
+
+ccBMFontDef* CCBMFontConfiguration::addFontDef()
+{
+    m_obFontDefs.push_back(ccBMFontDef());
+    return &m_obFontDefs.back();
+}
+
+void CCBMFontConfiguration::buildFontDefIndex()
+{
+    // the strings of CCLabelBMFont are UTF-16, so only the BMP range is indexed
+    unsigned int uSize = 0;
+    for (unsigned int i = 0; i < m_obFontDefs.size(); ++i)
+    {
+        unsigned int charID = m_obFontDefs[i].charID;
+        if (charID <= 0xffff && charID >= uSize)
+        {
+            uSize = charID + 1;
+        }
+    }
+
+    free(m_pFontDefIndex);
+    m_pFontDefIndex = (int*)malloc(uSize * sizeof(int));
+    m_uFontDefIndexSize = uSize;
+    memset(m_pFontDefIndex, 0xff, uSize * sizeof(int));
+
+    for (unsigned int i = 0; i < m_obFontDefs.size(); ++i)
+    {
+        unsigned int charID = m_obFontDefs[i].charID;
+        if (charID < uSize)
+        {
+            m_pFontDefIndex[charID] = (int)i;
+        }
     }
 }
 
+const ccBMFontDef* CCBMFontConfiguration::fontDefOutsideIndex(unsigned int charID)
+{
+    if (charID <= 0xffff)
+    {
+        return NULL;
+    }
+
+    for (unsigned int i = 0; i < m_obFontDefs.size(); ++i)
+    {
+        if (m_obFontDefs[i].charID == charID)
+        {
+            return &m_obFontDefs[i];
+        }
+    }
+    return NULL;
+}
 
 bool CCBMFontConfiguration::parseConfigFile(const char *controlFile)
 {    
     std::string fullpath = CCFileUtils::sharedFileUtils()->fullPathFromRelativePath(controlFile);
-    CCString *contents = CCString::createWithContentsOfFile(fullpath.c_str());
+    unsigned long nSize = 0;
+    unsigned char *pData = CCFileUtils::sharedFileUtils()->getFileData(fullpath.c_str(), "rb", &nSize);
 
-    CCAssert(contents, "CCBMFontConfiguration::parseConfigFile | Open file error.");
+    CCAssert(pData, "CCBMFontConfiguration::parseConfigFile | Open file error.");
 
-    if (!contents)
+    if (!pData)
     {
         CCLOG("cocos2d: Error parsing FNTfile %s", controlFile);
         return false;
     }
 
-    // parse spacing / padding
-    std::string line;
-    std::string strLeft = contents->getCString();
-    while (strLeft.length() > 0)
+    bool bRet = false;
+    if (nSize >= 4 && memcmp(pData, "BMFB", 4) == 0)
+    {
+        bRet = this->parseBinaryFile(pData, nSize, controlFile);
+    }
+    else
+    {
+        bRet = this->parseTextFile((const char*)pData, nSize, controlFile);
+    }
+    CC_SAFE_DELETE_ARRAY(pData);
+
+    if (bRet)
     {
-        int pos = strLeft.find('\n');
+        this->buildFontDefIndex();
+    }
+    else
+    {
+        CCLOG("cocos2d: Error parsing FNTfile %s", controlFile);
+    }
+    return bRet;
+}
 
-        if (pos != (int)std::string::npos)
-        {
-            // the data is more than a line.get one line
-            line = strLeft.substr(0, pos);
-            strLeft = strLeft.substr(pos + 1);
-        }
-        else
+//
+// .fnt text format
+//
+
+// A key=value pair of a line. Both point in the file buffer, they are not null terminated.
+typedef struct _FNTPair
+{
+    const char      *key;
+    unsigned int    keyLength;
+    const char      *value;
+    unsigned int    valueLength;
+} tFNTPair;
+
+static inline bool fntIsBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool fntEquals(const char *p, unsigned int uLength, const char *pszWord)
+{
+    for (unsigned int i = 0; i < uLength; ++i)
+    {
+        // also stops at the end of pszWord
+        if (p[i] != pszWord[i])
         {
-            // get the left data
-            line = strLeft;
-            strLeft.erase();
+            return false;
         }
+    }
+    return pszWord[uLength] == '\0';
+}
+
+// Reads the pair at p and moves p after it. Returns false at the end of the line.
+static bool fntNextPair(const char *&p, const char *end, tFNTPair *pPair)
+{
+    while (p < end && fntIsBlank(*p))
+    {
+        ++p;
+    }
+    if (p >= end || *p == '\n')
+    {
+        return false;
+    }
 
-        if(line.substr(0,strlen("info face")) == "info face") 
+    pPair->key = p;
+    while (p < end && *p != '=' && *p != '\n' && !fntIsBlank(*p))
+    {
+        ++p;
+    }
+    pPair->keyLength = p - pPair->key;
+    pPair->value = p;
+    pPair->valueLength = 0;
+
+    if (p < end && *p == '=')
+    {
+        ++p;
+        bool bQuoted = (p < end && *p == '"');
+        if (bQuoted)
         {
-            // XXX: info parsing is incomplete
-            // Not needed for the Hiero editors, but needed for the AngelCode editor
-            //            [self parseInfoArguments:line];
-            this->parseInfoArguments(line);
+            ++p;
         }
-        // Check to see if the start of the line is something we are interested in
-        else if(line.substr(0,strlen("common lineHeight")) == "common lineHeight")
+        pPair->value = p;
+        while (p < end && *p != '\n' && (bQuoted ? *p != '"' : !fntIsBlank(*p)))
         {
-            this->parseCommonArguments(line);
+            ++p;
         }
-        else if(line.substr(0,strlen("page id")) == "page id")
+        pPair->valueLength = p - pPair->value;
+        if (bQuoted && p < end && *p == '"')
         {
-            this->parseImageFileName(line, controlFile);
+            ++p;
         }
-        else if(line.substr(0,strlen("chars c")) == "chars c")
+    }
+    return true;
+}
+
+// Parses up to uCount integers separated by commas, such as "1,4,3,2". Returns how many were read.
+static unsigned int fntToInts(const char *p, unsigned int uLength, int *pValues, unsigned int uCount)
+{
+    const char *end = p + uLength;
+    unsigned int n = 0;
+    while (n < uCount && p < end)
+    {
+        bool bNegative = (*p == '-');
+        if (bNegative)
         {
-            // Ignore this line
+            ++p;
         }
-        else if(line.substr(0,strlen("char")) == "char")
+        int value = 0;
+        while (p < end && *p >= '0' && *p <= '9')
         {
-            // Parse the current line and create a new CharDef
-            tFontDefHashElement* element = (tFontDefHashElement*)malloc( sizeof(*element) );
-            this->parseCharacterDefinition(line, &element->fontDef);
+            value = value * 10 + (*p - '0');
+            ++p;
+        }
+        pValues[n++] = bNegative ? -value : value;
 
-            element->key = element->fontDef.charID;
-            HASH_ADD_INT(m_pFontDefDictionary, key, element);
+        while (p < end && *p != ',')
+        {
+            ++p;
         }
-//        else if(line.substr(0,strlen("kernings count")) == "kernings count")
-//        {
-//            this->parseKerningCapacity(line);
-//        }
-        else if(line.substr(0,strlen("kerning first")) == "kerning first")
+        if (p < end)
         {
-            this->parseKerningEntry(line);
+            ++p;
         }
     }
-    
-    return true;
+    return n;
+}
+
+static inline int fntToInt(const tFNTPair &pair)
+{
+    int value = 0;
+    fntToInts(pair.value, pair.valueLength, &value, 1);
+    return value;
 }
 
-void CCBMFontConfiguration::parseImageFileName(std::string line, const char *fntFile)
+bool CCBMFontConfiguration::parseTextFile(const char *pData, unsigned long nSize, const char *controlFile)
 {
     //////////////////////////////////////////////////////////////////////////
-    // line to parse:
+    // lines to parse:
+    // info face="Script" size=32 bold=0 italic=0 charset="" unicode=1 stretchH=100 smooth=1 aa=1 padding=1,4,3,2 spacing=0,0 outline=0
+    // common lineHeight=104 base=26 scaleW=1024 scaleH=512 pages=1 packed=0
     // page id=0 file="bitmapFontTest.png"
+    // chars count=95
+    // char id=32   x=0     y=0     width=0     height=0     xoffset=0     yoffset=44    xadvance=14     page=0  chnl=0 
+    // kerning first=121  second=44  amount=-7
+    //
+    // The file is read once, pair by pair, without copying the lines.
     //////////////////////////////////////////////////////////////////////////
 
-    // page ID. Sanity check
-    int index = line.find('=')+1;
-    int index2 = line.find(' ', index);
-    std::string value = line.substr(index, index2-index);
-    CCAssert(atoi(value.c_str()) == 0, "LabelBMFont file could not be found");
-    // file 
-    index = line.find('"')+1;
-    index2 = line.find('"', index);
-    value = line.substr(index, index2-index);
+    const char *p = pData;
+    const char *end = pData + nSize;
+    tFNTPair pair;
+
+    while (p < end)
+    {
+        while (p < end && fntIsBlank(*p))
+        {
+            ++p;
+        }
+        const char *tag = p;
+        while (p < end && *p != '\n' && !fntIsBlank(*p))
+        {
+            ++p;
+        }
+        unsigned int tagLength = p - tag;
+
+        if (fntEquals(tag, tagLength, "char"))
+        {
+            ccBMFontDef *pDef = this->addFontDef();
+            while (fntNextPair(p, end, &pair))
+            {
+                if (fntEquals(pair.key, pair.keyLength, "id"))
+                {
+                    pDef->charID = (unsigned int)fntToInt(pair);
+                }
+                else if (fntEquals(pair.key, pair.keyLength, "x"))
+                {
+                    pDef->rect.origin.x = (float)fntToInt(pair);
+                }
+                else if (fntEquals(pair.key, pair.keyLength, "y"))
+                {
+                    pDef->rect.origin.y = (float)fntToInt(pair);
+                }
+                else if (fntEquals(pair.key, pair.keyLength, "width"))
+                {
+                    pDef->rect.size.width = (float)fntToInt(pair);
+                }
+                else if (fntEquals(pair.key, pair.keyLength, "height"))
+                {
+                    pDef->rect.size.height = (float)fntToInt(pair);
+                }
+                else if (fntEquals(pair.key, pair.keyLength, "xoffset"))
+                {
+                    pDef->xOffset = (short)fntToInt(pair);
+                }
+                else if (fntEquals(pair.key, pair.keyLength, "yoffset"))
+                {
+                    pDef->yOffset = (short)fntToInt(pair);
+                }
+                else if (fntEquals(pair.key, pair.keyLength, "xadvance"))
+                {
+                    pDef->xAdvance = (short)fntToInt(pair);
+                }
+            }
+        }
+        else if (fntEquals(tag, tagLength, "kerning"))
+        {
+            int first = 0, second = 0, amount = 0;
+            while (fntNextPair(p, end, &pair))
+            {
+                if (fntEquals(pair.key, pair.keyLength, "first"))
+                {
+                    first = fntToInt(pair);
+                }
+                else if (fntEquals(pair.key, pair.keyLength, "second"))
+                {
+                    second = fntToInt(pair);
+                }
+                else if (fntEquals(pair.key, pair.keyLength, "amount"))
+                {
+                    amount = fntToInt(pair);
+                }
+            }
+            this->addKerningEntry(first, second, amount);
+        }
+        else if (fntEquals(tag, tagLength, "chars"))
+        {
+            while (fntNextPair(p, end, &pair))
+            {
+                if (fntEquals(pair.key, pair.keyLength, "count"))
+                {
+                    this->reserveFontDefs((unsigned int)fntToInt(pair));
+                }
+            }
+        }
+        else if (fntEquals(tag, tagLength, "common"))
+        {
+            while (fntNextPair(p, end, &pair))
+            {
+                if (fntEquals(pair.key, pair.keyLength, "lineHeight"))
+                {
+                    m_nCommonHeight = fntToInt(pair);
+                }
+                else if (fntEquals(pair.key, pair.keyLength, "scaleW") || fntEquals(pair.key, pair.keyLength, "scaleH"))
+                {
+                    CCAssert(fntToInt(pair) <= (int)CCConfiguration::sharedConfiguration()->getMaxTextureSize(), "CCLabelBMFont: page can't be larger than supported");
+                }
+                else if (fntEquals(pair.key, pair.keyLength, "pages"))
+                {
+                    CCAssert(fntToInt(pair) == 1, "CCBitfontAtlas: only supports 1 page");
+                }
+            }
+        }
+        else if (fntEquals(tag, tagLength, "page"))
+        {
+            while (fntNextPair(p, end, &pair))
+            {
+                if (fntEquals(pair.key, pair.keyLength, "id"))
+                {
+                    CCAssert(fntToInt(pair) == 0, "LabelBMFont file could not be found");
+                }
+                else if (fntEquals(pair.key, pair.keyLength, "file"))
+                {
+                    std::string value(pair.value, pair.valueLength);
+                    m_sAtlasName = CCFileUtils::sharedFileUtils()->fullPathFromRelativeFile(value.c_str(), controlFile);
+                }
+            }
+        }
+        else if (fntEquals(tag, tagLength, "info"))
+        {
+            while (fntNextPair(p, end, &pair))
+            {
+                if (fntEquals(pair.key, pair.keyLength, "padding"))
+                {
+                    int padding[4] = { 0, 0, 0, 0 };
+                    fntToInts(pair.value, pair.valueLength, padding, 4);
+                    m_tPadding.top = padding[0];
+                    m_tPadding.right = padding[1];
+                    m_tPadding.bottom = padding[2];
+                    m_tPadding.left = padding[3];
+                    CCLOG("cocos2d: padding: %d,%d,%d,%d", m_tPadding.left, m_tPadding.top, m_tPadding.right, m_tPadding.bottom);
+                }
+            }
+        }
+
+        // skip what is left of the line
+        while (p < end && *p != '\n')
+        {
+            ++p;
+        }
+        ++p;
+    }
 
-    m_sAtlasName = CCFileUtils::sharedFileUtils()->fullPathFromRelativeFile(value.c_str(), fntFile);
+    return true;
 }
 
-void CCBMFontConfiguration::parseInfoArguments(std::string line)
+//
+// binary format, written by tools/bmfont_binary/fnt2bin.py. All the values are little endian.
+//
+// header, 36 bytes:
+//   char[4] magic "BMFB", u16 version, u16 pages, u16 scaleW, u16 scaleH, s16 lineHeight, s16 base,
+//   s16 padding top, right, bottom, left, u32 charCount, u32 kerningCount, u32 atlasNameLength
+// charCount chars, 20 bytes each:
+//   u32 id, u16 x, y, width, height, s16 xoffset, yoffset, xadvance, u16 page
+// kerningCount kernings, 8 bytes each:
+//   u16 first, u16 second, s16 amount, u16 reserved
+// atlasNameLength bytes of the name of the texture, relative to the font file
+//
+
+#define BMFB_VERSION            1
+#define BMFB_HEADER_SIZE        36
+#define BMFB_CHAR_SIZE          20
+#define BMFB_KERNING_SIZE       8
+
+static inline unsigned int bmfbU16(const unsigned char *p)
 {
-    //////////////////////////////////////////////////////////////////////////
-    // possible lines to parse:
-    // info face="Script" size=32 bold=0 italic=0 charset="" unicode=1 stretchH=100 smooth=1 aa=1 padding=1,4,3,2 spacing=0,0 outline=0
-    // info face="Cracked" size=36 bold=0 italic=0 charset="" unicode=0 stretchH=100 smooth=1 aa=1 padding=0,0,0,0 spacing=1,1
-    //////////////////////////////////////////////////////////////////////////
+    return p[0] | (p[1] << 8);
+}
 
-    // padding
-    int index = line.find("padding=");
-    int index2 = line.find(' ', index);
-    std::string value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "padding=%d,%d,%d,%d", &m_tPadding.top, &m_tPadding.right, &m_tPadding.bottom, &m_tPadding.left);
-    CCLOG("cocos2d: padding: %d,%d,%d,%d", m_tPadding.left, m_tPadding.top, m_tPadding.right, m_tPadding.bottom);
+static inline int bmfbS16(const unsigned char *p)
+{
+    return (short)bmfbU16(p);
 }
 
-void CCBMFontConfiguration::parseCommonArguments(std::string line)
+static inline unsigned int bmfbU32(const unsigned char *p)
 {
-    //////////////////////////////////////////////////////////////////////////
-    // line to parse:
-    // common lineHeight=104 base=26 scaleW=1024 scaleH=512 pages=1 packed=0
-    //////////////////////////////////////////////////////////////////////////
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
 
-    // Height
-    int index = line.find("lineHeight=");
-    int index2 = line.find(' ', index);
-    std::string value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "lineHeight=%d", &m_nCommonHeight);
-    // scaleW. sanity check
-    index = line.find("scaleW=") + strlen("scaleW=");
-    index2 = line.find(' ', index);
-    value = line.substr(index, index2-index);
-    CCAssert(atoi(value.c_str()) <= CCConfiguration::sharedConfiguration()->getMaxTextureSize(), "CCLabelBMFont: page can't be larger than supported");
-    // scaleH. sanity check
-    index = line.find("scaleH=") + strlen("scaleH=");
-    index2 = line.find(' ', index);
-    value = line.substr(index, index2-index);
-    CCAssert(atoi(value.c_str()) <= CCConfiguration::sharedConfiguration()->getMaxTextureSize(), "CCLabelBMFont: page can't be larger than supported");
-    // pages. sanity check
-    index = line.find("pages=") + strlen("pages=");
-    index2 = line.find(' ', index);
-    value = line.substr(index, index2-index);
-    CCAssert(atoi(value.c_str()) == 1, "CCBitfontAtlas: only supports 1 page");
-
-    // packed (ignore) What does this mean ??
-}
-
-void CCBMFontConfiguration::parseCharacterDefinition(std::string line, ccBMFontDef *characterDefinition)
-{    
-    //////////////////////////////////////////////////////////////////////////
-    // line to parse:
-    // char id=32   x=0     y=0     width=0     height=0     xoffset=0     yoffset=44    xadvance=14     page=0  chnl=0 
-    //////////////////////////////////////////////////////////////////////////
+bool CCBMFontConfiguration::parseBinaryFile(const unsigned char *pData, unsigned long nSize, const char *controlFile)
+{
+    if (nSize < BMFB_HEADER_SIZE || bmfbU16(pData + 4) != BMFB_VERSION)
+    {
+        CCLOG("cocos2d: CCBMFontConfiguration: unsupported binary font version");
+        return false;
+    }
 
-    // Character ID
-    int index = line.find("id=");
-    int index2 = line.find(' ', index);
-    std::string value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "id=%u", &characterDefinition->charID);
-
-    // Character x
-    index = line.find("x=");
-    index2 = line.find(' ', index);
-    value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "x=%f", &characterDefinition->rect.origin.x);
-    // Character y
-    index = line.find("y=");
-    index2 = line.find(' ', index);
-    value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "y=%f", &characterDefinition->rect.origin.y);
-    // Character width
-    index = line.find("width=");
-    index2 = line.find(' ', index);
-    value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "width=%f", &characterDefinition->rect.size.width);
-    // Character height
-    index = line.find("height=");
-    index2 = line.find(' ', index);
-    value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "height=%f", &characterDefinition->rect.size.height);
-    // Character xoffset
-    index = line.find("xoffset=");
-    index2 = line.find(' ', index);
-    value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "xoffset=%hd", &characterDefinition->xOffset);
-    // Character yoffset
-    index = line.find("yoffset=");
-    index2 = line.find(' ', index);
-    value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "yoffset=%hd", &characterDefinition->yOffset);
-    // Character xadvance
-    index = line.find("xadvance=");
-    index2 = line.find(' ', index);
-    value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "xadvance=%hd", &characterDefinition->xAdvance);
-}
-
-void CCBMFontConfiguration::parseKerningEntry(std::string line)
-{        
-    //////////////////////////////////////////////////////////////////////////
-    // line to parse:
-    // kerning first=121  second=44  amount=-7
-    //////////////////////////////////////////////////////////////////////////
+    CCAssert(bmfbU16(pData + 6) == 1, "CCBitfontAtlas: only supports 1 page");
+    CCAssert((int)bmfbU16(pData + 8) <= CCConfiguration::sharedConfiguration()->getMaxTextureSize(), "CCLabelBMFont: page can't be larger than supported");
+    CCAssert((int)bmfbU16(pData + 10) <= CCConfiguration::sharedConfiguration()->getMaxTextureSize(), "CCLabelBMFont: page can't be larger than supported");
+
+    m_nCommonHeight = bmfbS16(pData + 12);
+    m_tPadding.top = bmfbS16(pData + 16);
+    m_tPadding.right = bmfbS16(pData + 18);
+    m_tPadding.bottom = bmfbS16(pData + 20);
+    m_tPadding.left = bmfbS16(pData + 22);
 
-    // first
-    int first;
-    int index = line.find("first=");
-    int index2 = line.find(' ', index);
-    std::string value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "first=%d", &first);
-
-    // second
-    int second;
-    index = line.find("second=");
-    index2 = line.find(' ', index);
-    value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "second=%d", &second);
-
-    // amount
-    int amount;
-    index = line.find("amount=");
-    index2 = line.find(' ', index);
-    value = line.substr(index, index2-index);
-    sscanf(value.c_str(), "amount=%d", &amount);
+    unsigned int uCharCount = bmfbU32(pData + 24);
+    unsigned int uKerningCount = bmfbU32(pData + 28);
+    unsigned int uNameLength = bmfbU32(pData + 32);
 
+    // each count is checked against what is left of the file, a sum of the sizes could wrap around
+    unsigned long nRemaining = nSize - BMFB_HEADER_SIZE;
+    bool bTruncated = uCharCount > nRemaining / BMFB_CHAR_SIZE;
+    if (! bTruncated)
+    {
+        nRemaining -= uCharCount * BMFB_CHAR_SIZE;
+        bTruncated = uKerningCount > nRemaining / BMFB_KERNING_SIZE;
+    }
+    if (! bTruncated)
+    {
+        nRemaining -= uKerningCount * BMFB_KERNING_SIZE;
+        bTruncated = uNameLength > nRemaining;
+    }
+    if (bTruncated)
+    {
+        CCLOG("cocos2d: CCBMFontConfiguration: truncated binary font");
+        return false;
+    }
+
+    const unsigned char *p = pData + BMFB_HEADER_SIZE;
+
+    this->reserveFontDefs(uCharCount);
+    for (unsigned int i = 0; i < uCharCount; ++i, p += BMFB_CHAR_SIZE)
+    {
+        ccBMFontDef *pDef = this->addFontDef();
+        pDef->charID = bmfbU32(p);
+        pDef->rect.origin.x = (float)bmfbU16(p + 4);
+        pDef->rect.origin.y = (float)bmfbU16(p + 6);
+        pDef->rect.size.width = (float)bmfbU16(p + 8);
+        pDef->rect.size.height = (float)bmfbU16(p + 10);
+        pDef->xOffset = (short)bmfbS16(p + 12);
+        pDef->yOffset = (short)bmfbS16(p + 14);
+        pDef->xAdvance = (short)bmfbS16(p + 16);
+    }
+
+    for (unsigned int i = 0; i < uKerningCount; ++i, p += BMFB_KERNING_SIZE)
+    {
+        this->addKerningEntry(bmfbU16(p), bmfbU16(p + 2), bmfbS16(p + 4));
+    }
+
+    std::string value((const char*)p, uNameLength);
+    m_sAtlasName = CCFileUtils::sharedFileUtils()->fullPathFromRelativeFile(value.c_str(), controlFile);
+
+    return true;
+}
+
+void CCBMFontConfiguration::addKerningEntry(int first, int second, int amount)
+{
     tKerningHashElement *element = (tKerningHashElement *)calloc( sizeof( *element ), 1 );
     element->amount = amount;
     element->key = (first<<16) | (second&0xffff);
@@ -813,6 +1054,8 @@ CCLabelBMFont::CCLabelBMFont()
 , m_sString(NULL)
 , m_bLineBreakWithoutSpaces(false)
 , m_tImageOffset(CCPointZero)
+, m_bCharacterSprites(false)
+, m_uNewlines(0)
 {
 
 }
@@ -840,6 +1083,12 @@ int CCLabelBMFont::kerningAmountForFirst(unsigned short first, unsigned short se
 
 void CCLabelBMFont::createFontChars()
 {
+    if (! m_bCharacterSprites)
+    {
+        this->useCharacterSprites();
+        return;
+    }
+
     int nextFontPositionX = 0;
     int nextFontPositionY = 0;
     //unsigned short prev = -1;
@@ -881,14 +1130,14 @@ void CCLabelBMFont::createFontChars()
             continue;
         }
 
-        tFontDefHashElement *element = NULL;
-
-        // unichar is a short, and an int is needed on HASH_FIND_INT
-        unsigned int key = c;
-        HASH_FIND_INT(m_pConfiguration->m_pFontDefDictionary, &key, element);
-        CCAssert(element, "FontDefinition could not be found!");
+        const ccBMFontDef *pFontDef = m_pConfiguration->fontDefForCharacter(c);
+        CCAssert(pFontDef, "FontDefinition could not be found!");
+        if (! pFontDef)
+        {
+            continue;
+        }
 
-        ccBMFontDef fontDef = element->fontDef;
+        const ccBMFontDef &fontDef = *pFontDef;
 
         CCRect rect = fontDef.rect;
         rect = CC_RECT_PIXELS_TO_POINTS(rect);
@@ -951,6 +1200,333 @@ void CCLabelBMFont::createFontChars()
     
 }
 
+// LabelBMFont - Quads
+void CCLabelBMFont::resetQuads()
+{
+    m_tLetters.clear();
+    m_tLines.clear();
+    m_uNewlines = 0;
+}
+
+void CCLabelBMFont::useCharacterSprites()
+{
+    m_bCharacterSprites = true;
+    this->resetQuads();
+    m_pobTextureAtlas->removeAllQuads();
+
+    this->updateString(false);
+}
+
+void CCLabelBMFont::updateQuads()
+{
+    unsigned int uLength = (m_sString && m_pConfiguration) ? cc_wcslen(m_sString) : 0;
+    if (uLength == 0)
+    {
+        this->resetQuads();
+        m_pobTextureAtlas->removeAllQuads();
+        this->setContentSize(CCSizeZero);
+        return;
+    }
+
+    unsigned int uOldLength = m_tLetters.size();
+
+    // characters that didn't change at the start, and at the end when the length is the same
+    unsigned int uShortest = MIN(uLength, uOldLength);
+    unsigned int uFirst = 0;
+    while (uFirst < uShortest && m_tLetters[uFirst].character == m_sString[uFirst])
+    {
+        uFirst++;
+    }
+    unsigned int uSuffix = 0;
+    if (uLength == uOldLength)
+    {
+        while (uSuffix < uLength - uFirst && m_tLetters[uLength - 1 - uSuffix].character == m_sString[uLength - 1 - uSuffix])
+        {
+            uSuffix++;
+        }
+    }
+
+    // a trailing line break doesn't add a line
+    unsigned int uNewlines = m_uNewlines;
+    for (unsigned int i = uFirst; i < uOldLength - uSuffix; ++i)
+    {
+        if (m_tLetters[i].character == '\n')
+        {
+            uNewlines--;
+        }
+    }
+    for (unsigned int i = uFirst; i < uLength - uSuffix; ++i)
+    {
+        if (m_sString[i] == '\n')
+        {
+            uNewlines++;
+        }
+    }
+    unsigned int uOldLines = uOldLength ? m_uNewlines + 1 - (m_tLetters[uOldLength - 1].character == '\n' ? 1 : 0) : 0;
+    unsigned int uLines = uNewlines + 1 - (m_sString[uLength - 1] == '\n' ? 1 : 0);
+    m_uNewlines = uNewlines;
+
+    // the characters are placed from the top line, so all of them move when the number of lines changes
+    bool bAllMoved = (uLines != uOldLines);
+    if (bAllMoved)
+    {
+        uFirst = 0;
+        uSuffix = 0;
+    }
+
+    if (uLength > m_pobTextureAtlas->getCapacity())
+    {
+        m_pobTextureAtlas->resizeCapacity(uLength);
+    }
+    unsigned int uTotalQuads = m_pobTextureAtlas->getTotalQuads();
+    if (uLength > uTotalQuads)
+    {
+        m_pobTextureAtlas->increaseTotalQuadsWith(uLength - uTotalQuads);
+    }
+    else if (uLength < uTotalQuads)
+    {
+        m_pobTextureAtlas->removeQuadsAtIndex(uLength, uTotalQuads - uLength);
+    }
+
+    // new letters have no character, so they get a quad
+    ccBMFontLetter tEmptyLetter = { 0, 0, 0 };
+    m_tLetters.resize(uLength, tEmptyLetter);
+    ccBMFontLine tEmptyLine = { 0, 0, 0.0f };
+    m_tLines.resize(uNewlines + 1, tEmptyLine);
+
+    // pen position where the first changed character starts
+    unsigned int uLine = 0;
+    int nPen = 0;
+    int nLineWidth = 0;
+    int nLineRight = 0;
+    if (uFirst > 0)
+    {
+        const ccBMFontLetter &prev = m_tLetters[uFirst - 1];
+        if (prev.character == '\n')
+        {
+            uLine = prev.line + 1;
+        }
+        else
+        {
+            const ccBMFontDef *pPrevDef = m_pConfiguration->fontDefForCharacter(prev.character);
+            uLine = prev.line;
+            nPen = prev.x;
+            if (pPrevDef)
+            {
+                nLineRight = nPen + pPrevDef->xOffset + (int)pPrevDef->rect.size.width;
+                nPen += pPrevDef->xAdvance;
+            }
+            nLineWidth = nPen;
+        }
+    }
+
+    const float fScale = CC_CONTENT_SCALE_FACTOR();
+    const int nCommonHeight = m_pConfiguration->m_nCommonHeight;
+    CCTexture2D *pTexture = m_pobTextureAtlas->getTexture();
+    float fTextureWide = (float)pTexture->getPixelsWide();
+    float fTextureHigh = (float)pTexture->getPixelsHigh();
+    ccColor4B tColor = { m_tColor.r, m_tColor.g, m_tColor.b, m_cOpacity };
+    if (m_bIsOpacityModifyRGB)
+    {
+        tColor.r = tColor.r * m_cOpacity / 255;
+        tColor.g = tColor.g * m_cOpacity / 255;
+        tColor.b = tColor.b * m_cOpacity / 255;
+    }
+
+    // only the quads written below are marked dirty
+    ccV3F_C4B_T2F_Quad *pQuads = m_pobTextureAtlas->getQuadsAtIndex(0, 0);
+    unsigned int uDirtyStart = uLength;
+    unsigned int uDirtyEnd = 0;
+
+    unsigned int i = uFirst;
+    for (; i < uLength; ++i)
+    {
+        unsigned short c = m_sString[i];
+        ccBMFontLetter &letter = m_tLetters[i];
+
+        // the unchanged characters at the end are where they were as soon as one of them didn't move
+        if (i >= uLength - uSuffix && c != '\n' && letter.x == nPen)
+        {
+            break;
+        }
+
+        bool bNewCharacter = (letter.character != c);
+        bool bMoved = bAllMoved || bNewCharacter || letter.x != nPen || letter.line != uLine;
+        letter.character = c;
+        letter.x = nPen;
+        letter.line = (unsigned short)uLine;
+
+        const ccBMFontDef *pFontDef = NULL;
+        if (c == '\n')
+        {
+            m_tLines[uLine].width = nLineWidth;
+            m_tLines[uLine].right = nLineRight;
+            uLine++;
+            nPen = 0;
+            nLineWidth = 0;
+            nLineRight = 0;
+        }
+        else
+        {
+            pFontDef = m_pConfiguration->fontDefForCharacter(c);
+            CCAssert(pFontDef, "FontDefinition could not be found!");
+        }
+
+        if (! pFontDef)
+        {
+            if (bNewCharacter)
+            {
+                memset(&pQuads[i], 0, sizeof(pQuads[i]));
+                uDirtyStart = MIN(uDirtyStart, i);
+                uDirtyEnd = i + 1;
+            }
+            continue;
+        }
+
+        ccV3F_C4B_T2F_Quad &quad = pQuads[i];
+        if (bNewCharacter)
+        {
+            CCRect rect = pFontDef->rect;
+            rect.origin.x += m_tImageOffset.x * fScale;
+            rect.origin.y += m_tImageOffset.y * fScale;
+#if CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+            float left      = (2 * rect.origin.x + 1) / (2 * fTextureWide);
+            float right     = left + (rect.size.width * 2 - 2) / (2 * fTextureWide);
+            float top       = (2 * rect.origin.y + 1) / (2 * fTextureHigh);
+            float bottom    = top + (rect.size.height * 2 - 2) / (2 * fTextureHigh);
+#else
+            float left      = rect.origin.x / fTextureWide;
+            float right     = (rect.origin.x + rect.size.width) / fTextureWide;
+            float top       = rect.origin.y / fTextureHigh;
+            float bottom    = (rect.origin.y + rect.size.height) / fTextureHigh;
+#endif // ! CC_FIX_ARTIFACTS_BY_STRECHING_TEXEL
+            quad.bl.texCoords.u = left;
+            quad.bl.texCoords.v = bottom;
+            quad.br.texCoords.u = right;
+            quad.br.texCoords.v = bottom;
+            quad.tl.texCoords.u = left;
+            quad.tl.texCoords.v = top;
+            quad.tr.texCoords.u = right;
+            quad.tr.texCoords.v = top;
+
+            quad.bl.colors = tColor;
+            quad.br.colors = tColor;
+            quad.tl.colors = tColor;
+            quad.tr.colors = tColor;
+        }
+
+        if (bMoved)
+        {
+            // same place as the sprite of the character, see createFontChars
+            float x1 = (nPen + pFontDef->xOffset) / fScale + m_tLines[uLine].shift;
+            float y2 = (float)(nCommonHeight * ((int)uLines - 1 - (int)uLine) + nCommonHeight - pFontDef->yOffset) / fScale;
+            float x2 = x1 + pFontDef->rect.size.width / fScale;
+            float y1 = y2 - pFontDef->rect.size.height / fScale;
+            quad.bl.vertices = vertex3(x1, y1, 0);
+            quad.br.vertices = vertex3(x2, y1, 0);
+            quad.tl.vertices = vertex3(x1, y2, 0);
+            quad.tr.vertices = vertex3(x2, y2, 0);
+        }
+
+        if (bNewCharacter || bMoved)
+        {
+            uDirtyStart = MIN(uDirtyStart, i);
+            uDirtyEnd = i + 1;
+        }
+
+        nLineRight = nPen + pFontDef->xOffset + (int)pFontDef->rect.size.width;
+        nPen += pFontDef->xAdvance;
+        nLineWidth = MAX(nLineWidth, nPen);
+    }
+
+    if (i == uLength)
+    {
+        m_tLines[uLine].width = nLineWidth;
+        m_tLines[uLine].right = nLineRight;
+    }
+
+    int nLongestLine = 0;
+    for (unsigned int l = 0; l < m_tLines.size(); ++l)
+    {
+        nLongestLine = MAX(nLongestLine, m_tLines[l].width);
+    }
+    CCSize tmpSize = CCSizeMake((float)nLongestLine, (float)(nCommonHeight * uLines));
+    this->setContentSize(CC_SIZE_PIXELS_TO_POINTS(tmpSize));
+
+    // alignment: the lines whose shift changed are moved by the difference
+    static std::vector<float> s_tShiftDeltas;
+    s_tShiftDeltas.resize(m_tLines.size());
+    bool bShiftChanged = false;
+    for (unsigned int l = 0; l < m_tLines.size(); ++l)
+    {
+        float fLineWidth = m_tLines[l].right / fScale;
+        float fShift = 0;
+        switch (m_pAlignment)
+        {
+        case kCCTextAlignmentCenter:
+            fShift = m_tContentSize.width / 2.0f - fLineWidth / 2.0f;
+            break;
+        case kCCTextAlignmentRight:
+            fShift = m_tContentSize.width - fLineWidth;
+            break;
+        default:
+            break;
+        }
+        s_tShiftDeltas[l] = fShift - m_tLines[l].shift;
+        m_tLines[l].shift = fShift;
+        bShiftChanged = bShiftChanged || s_tShiftDeltas[l] != 0;
+    }
+
+    if (bShiftChanged)
+    {
+        for (unsigned int j = 0; j < uLength; ++j)
+        {
+            float fDelta = s_tShiftDeltas[m_tLetters[j].line];
+            if (fDelta != 0 && m_tLetters[j].character != '\n')
+            {
+                ccV3F_C4B_T2F_Quad &quad = pQuads[j];
+                quad.bl.vertices.x += fDelta;
+                quad.br.vertices.x += fDelta;
+                quad.tl.vertices.x += fDelta;
+                quad.tr.vertices.x += fDelta;
+                uDirtyStart = MIN(uDirtyStart, j);
+                uDirtyEnd = MAX(uDirtyEnd, j + 1);
+            }
+        }
+    }
+
+    if (uDirtyStart < uDirtyEnd)
+    {
+        m_pobTextureAtlas->setDirty(uDirtyStart, uDirtyEnd - uDirtyStart);
+    }
+}
+
+void CCLabelBMFont::updateQuadColors()
+{
+    unsigned int uTotalQuads = m_pobTextureAtlas->getTotalQuads();
+    if (uTotalQuads == 0)
+    {
+        return;
+    }
+
+    ccColor4B tColor = { m_tColor.r, m_tColor.g, m_tColor.b, m_cOpacity };
+    if (m_bIsOpacityModifyRGB)
+    {
+        tColor.r = tColor.r * m_cOpacity / 255;
+        tColor.g = tColor.g * m_cOpacity / 255;
+        tColor.b = tColor.b * m_cOpacity / 255;
+    }
+
+    ccV3F_C4B_T2F_Quad *pQuads = m_pobTextureAtlas->getQuadsAtIndex(0, uTotalQuads);
+    for (unsigned int i = 0; i < uTotalQuads; ++i)
+    {
+        pQuads[i].bl.colors = tColor;
+        pQuads[i].br.colors = tColor;
+        pQuads[i].tl.colors = tColor;
+        pQuads[i].tr.colors = tColor;
+    }
+}
+
 //LabelBMFont - CCLabelProtocol protocol
 void CCLabelBMFont::setString(const char *newString)
 {
@@ -968,6 +1544,20 @@ void CCLabelBMFont::setString(const char *newString, bool fromUpdate)
 
 void CCLabelBMFont::updateString(bool fromUpdate)
 {
+    if (! m_bCharacterSprites)
+    {
+        if (m_fWidth <= 0)
+        {
+            this->updateQuads();
+        }
+        else
+        {
+            // lines are broken by updateLabel, which works on the character sprites
+            this->useCharacterSprites();
+        }
+        return;
+    }
+
     if (m_pChildren && m_pChildren->count() != 0)
     {
         CCObject* child;
@@ -1000,6 +1590,10 @@ void CCLabelBMFont::setCString(const char *label)
 void CCLabelBMFont::setColor(const ccColor3B& var)
 {
     m_tColor = var;
+    if (! m_bCharacterSprites)
+    {
+        this->updateQuadColors();
+    }
     if (m_pChildren && m_pChildren->count() != 0)
     {
         CCObject* child;
@@ -1020,6 +1614,10 @@ const ccColor3B& CCLabelBMFont::getColor()
 void CCLabelBMFont::setOpacity(GLubyte var)
 {
     m_cOpacity = var;
+    if (! m_bCharacterSprites)
+    {
+        this->updateQuadColors();
+    }
 
     if (m_pChildren && m_pChildren->count() != 0)
     {
@@ -1045,6 +1643,10 @@ GLubyte CCLabelBMFont::getOpacity()
 void CCLabelBMFont::setOpacityModifyRGB(bool var)
 {
     m_bIsOpacityModifyRGB = var;
+    if (! m_bCharacterSprites)
+    {
+        this->updateQuadColors();
+    }
     if (m_pChildren && m_pChildren->count() != 0)
     {
         CCObject* child;
@@ -1080,6 +1682,12 @@ void CCLabelBMFont::setAnchorPoint(const CCPoint& point)
 // LabelBMFont - Alignment
 void CCLabelBMFont::updateLabel()
 {
+    if (! m_bCharacterSprites)
+    {
+        this->updateString(true);
+        return;
+    }
+
     this->setString(m_sInitialString.c_str(), true);
 
     if (m_fWidth > 0)
@@ -1261,11 +1869,16 @@ void CCLabelBMFont::updateLabel()
                 float lineWidth = 0.0f;
                 unsigned int line_length = last_line.size();
                 int index = i + line_length - 1 + lineNumber;
-                if (index < 0) continue;
 
-                CCSprite* lastChar = (CCSprite*)getChildByTag(index);
+                // empty lines have no character to align, but they still count
+                CCSprite* lastChar = (line_length > 0 && index >= 0) ? (CCSprite*)getChildByTag(index) : NULL;
                 if ( lastChar == NULL )
+                {
+                    i += line_length;
+                    lineNumber++;
+                    last_line.clear();
                     continue;
+                }
 
                 lineWidth = lastChar->getPosition().x + lastChar->getContentSize().width/2.0f;
 
@@ -1290,6 +1903,7 @@ void CCLabelBMFont::updateLabel()
                         if (index < 0) continue;
 
                         CCSprite* characterSprite = (CCSprite*)getChildByTag(index);
+                        if (characterSprite == NULL) continue;
                         characterSprite->setPosition(ccpAdd(characterSprite->getPosition(), ccp(shift, 0.0f)));
                     }
                 }
@@ -1353,6 +1967,45 @@ float CCLabelBMFont::getLetterPosXRight( CCSprite* sp )
     return sp->getPosition().x * m_fScaleX + (sp->getContentSize().width * m_fScaleX * sp->getAnchorPoint().x);
 }
 
+// LabelBMFont - Character sprites
+void CCLabelBMFont::addChild(CCNode * child)
+{
+    CCSpriteBatchNode::addChild(child);
+}
+
+void CCLabelBMFont::addChild(CCNode * child, int zOrder)
+{
+    CCSpriteBatchNode::addChild(child, zOrder);
+}
+
+void CCLabelBMFont::addChild(CCNode * child, int zOrder, int tag)
+{
+    // the quads of the characters would be mixed with the ones of the new sprite
+    if (! m_bCharacterSprites)
+    {
+        this->useCharacterSprites();
+    }
+    CCSpriteBatchNode::addChild(child, zOrder, tag);
+}
+
+CCNode* CCLabelBMFont::getChildByTag(int tag)
+{
+    if (! m_bCharacterSprites)
+    {
+        this->useCharacterSprites();
+    }
+    return CCSpriteBatchNode::getChildByTag(tag);
+}
+
+CCArray* CCLabelBMFont::getChildren()
+{
+    if (! m_bCharacterSprites)
+    {
+        this->useCharacterSprites();
+    }
+    return CCSpriteBatchNode::getChildren();
+}
+
 // LabelBMFont - FntFile
 void CCLabelBMFont::setFntFile(const char* fntFile)
 {
@@ -1369,7 +2022,15 @@ void CCLabelBMFont::setFntFile(const char* fntFile)
         m_pConfiguration = newConf;
 
         this->setTexture(CCTextureCache::sharedTextureCache()->addImage(m_pConfiguration->getAtlasName()));
-        this->createFontChars();
+        if (m_bCharacterSprites)
+        {
+            this->createFontChars();
+        }
+        else
+        {
+            this->resetQuads();
+            this->updateQuads();
+        }
     }
 }
 
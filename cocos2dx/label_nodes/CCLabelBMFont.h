@@ -53,7 +53,6 @@ enum {
 };
 
 struct _KerningHashElement;
-struct _FontDefHashElement;
 
 /**
 @struct ccBMFontDef
@@ -72,6 +71,32 @@ typedef struct _BMFontDef {
     short xAdvance;
 } ccBMFontDef;
 
+/** @struct ccBMFontLetter
+Layout of a character of a CCLabelBMFont drawn without sprite
+@since v2.1
+*/
+typedef struct _BMFontLetter {
+    //! the character, or 0 if it has no quad yet
+    unsigned short character;
+    //! line of the character
+    unsigned short line;
+    //! pen position before the character (in pixels)
+    int x;
+} ccBMFontLetter;
+
+/** @struct ccBMFontLine
+Layout of a line of a CCLabelBMFont drawn without sprite
+@since v2.1
+*/
+typedef struct _BMFontLine {
+    //! pen position at the end of the line (in pixels)
+    int width;
+    //! right edge of the last character of the line (in pixels)
+    int right;
+    //! horizontal shift of the line due to the alignment (in points)
+    float shift;
+} ccBMFontLine;
+
 /** @struct ccBMFontPadding
 BMFont padding
 @since v0.8.2
@@ -89,14 +114,25 @@ typedef struct _BMFontPadding {
 
 
 /** @brief CCBMFontConfiguration has parsed configuration of the the .fnt file
+
+Besides the AngelCode text format, it loads the binary format written by
+tools/bmfont_binary/fnt2bin.py, which is recognized by its "BMFB" magic whatever
+the extension of the file is.
+
+Since v2.1 the character definitions are stored in m_obFontDefs and looked up with
+fontDefForCharacter(). m_pFontDefDictionary, a hash of a type that was private to
+CCLabelBMFont.cpp, was removed.
 @since v0.8
 */
 class CC_DLL CCBMFontConfiguration : public CCObject
 {
     // XXX: Creating a public interface so that the bitmapFontArray[] is accesible
 public://@public
-    // BMFont definitions
-    struct _FontDefHashElement* m_pFontDefDictionary;
+    //! BMFont definitions, in the order of the file
+    std::vector<ccBMFontDef> m_obFontDefs;
+    //! position in m_obFontDefs of each character below m_uFontDefIndexSize, or -1
+    int* m_pFontDefIndex;
+    unsigned int m_uFontDefIndexSize;
 
     //! FNTConfig: Common Height Should be signed (issue #1343)
     int m_nCommonHeight;
@@ -123,13 +159,28 @@ public:
     
     inline const char* getAtlasName(){ return m_sAtlasName.c_str(); }
     inline void setAtlasName(const char* atlasName) { m_sAtlasName = atlasName; }
+
+    /** returns the definition of a character, or NULL if the font doesn't have it
+    @since v2.1
+    */
+    inline const ccBMFontDef* fontDefForCharacter(unsigned int charID)
+    {
+        if (charID < m_uFontDefIndexSize)
+        {
+            int index = m_pFontDefIndex[charID];
+            return index >= 0 ? &m_obFontDefs[index] : NULL;
+        }
+        return fontDefOutsideIndex(charID);
+    }
 private:
     bool parseConfigFile(const char *controlFile);
-    void parseCharacterDefinition(std::string line, ccBMFontDef *characterDefinition);
-    void parseInfoArguments(std::string line);
-    void parseCommonArguments(std::string line);
-    void parseImageFileName(std::string line, const char *fntFile);
-    void parseKerningEntry(std::string line);
+    bool parseTextFile(const char *pData, unsigned long nSize, const char *controlFile);
+    bool parseBinaryFile(const unsigned char *pData, unsigned long nSize, const char *controlFile);
+    void addKerningEntry(int first, int second, int amount);
+    void reserveFontDefs(unsigned int uCount);
+    ccBMFontDef* addFontDef();
+    void buildFontDefIndex();
+    const ccBMFontDef* fontDefOutsideIndex(unsigned int charID);
     void purgeKerningDictionary();
     void purgeFontDefDictionary();
 };
@@ -151,6 +202,10 @@ Limitations:
 - All inner characters are using an anchorPoint of (0.5f, 0.5f) and it is not recommend to change it
 because it might affect the rendering
 
+Until a character is needed as a CCSprite (getChildByTag, getChildren, addChild) or a width is set,
+the label writes the quads of the characters straight in its texture atlas and setString only updates
+the quads of the characters that changed or moved. Once the sprites are created the label keeps them.
+
 CCLabelBMFont implements the protocol CCLabelProtocol, like CCLabel and CCLabelAtlas.
 CCLabelBMFont has the flexibility of CCLabel, the speed of CCLabelAtlas and all the features of CCSprite.
 If in doubt, use CCLabelBMFont instead of CCLabelAtlas / CCLabel.
@@ -193,6 +248,13 @@ protected:
     bool m_bLineBreakWithoutSpaces;
     // offset of the texture atlas
     CCPoint    m_tImageOffset;
+
+    // whether the characters are CCSprite children, or quads written by updateQuads
+    bool m_bCharacterSprites;
+    // layout of the quads, to update only the characters that change
+    std::vector<ccBMFontLetter> m_tLetters;
+    std::vector<ccBMFontLine> m_tLines;
+    unsigned int m_uNewlines;
 public:
     CCLabelBMFont();
 
@@ -250,6 +312,11 @@ public:
     virtual void setScale(float scale);
     virtual void setScaleX(float scaleX);
     virtual void setScaleY(float scaleY);
+    virtual void addChild(CCNode * child);
+    virtual void addChild(CCNode * child, int zOrder);
+    virtual void addChild(CCNode * child, int zOrder, int tag);
+    virtual CCNode* getChildByTag(int tag);
+    virtual CCArray* getChildren();
 
     void setFntFile(const char* fntFile);
     const char* getFntFile();
@@ -257,6 +324,10 @@ public:
     virtual void draw();
 #endif // CC_LABELBMFONT_DEBUG_DRAW
 private:
+    void updateQuads();
+    void resetQuads();
+    void updateQuadColors();
+    void useCharacterSprites();
     char * atlasNameFromFntFile(const char *fntFile);
     int kerningAmountForFirst(unsigned short first, unsigned short second);
     float getLetterPosXLeft( CCSprite* characterSprite );
@@ -0,0 +1,537 @@
+/****************************************************************************
+Copyright (c) 2012      cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#include "CCLabelGlyphAtlas.h"
+#include "textures/CCTextureAtlas.h"
+#include "textures/CCTexture2D.h"
+#include "textures/CCTextureCache.h"
+#include "support/CCPointExtension.h"
+#include "CCDirector.h"
+#include "platform/CCImage.h"
+#include "cocoa/CCDictionary.h"
+#include "support/ccUtils.h"
+#include "CCConfiguration.h"
+#include "ccConfig.h"
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+
+NS_CC_BEGIN
+
+// empty pixels kept around each glyph, so linear filtering doesn't sample the neighbours
+#define kCCGlyphAtlasPadding    1
+// the texture never starts smaller than this
+#define kCCGlyphAtlasMinHeight  64
+
+static CCDictionary* s_pGlyphAtlases = NULL;
+
+//
+// CCGlyphAtlas
+//
+
+CCGlyphAtlas::CCGlyphAtlas()
+: m_fFontSize(0)
+, m_fLineHeight(0)
+, m_bHasPremultipliedAlpha(false)
+, m_nReferenceWidth(0)
+, m_nReferencePairWidth(-1)
+, m_pPixels(NULL)
+, m_uPixelsWide(0)
+, m_uPixelsHigh(0)
+, m_pTexture(NULL)
+, m_uGeneration(0)
+, m_uShelfX(0)
+, m_uShelfY(0)
+, m_uShelfHeight(0)
+{
+}
+
+CCGlyphAtlas::~CCGlyphAtlas()
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    if (m_pTexture)
+    {
+        VolatileTexture::removeTexture(m_pTexture);
+    }
+#endif
+    CC_SAFE_RELEASE(m_pTexture);
+    CC_SAFE_FREE(m_pPixels);
+}
+
+CCGlyphAtlas* CCGlyphAtlas::sharedGlyphAtlas(const char *fontName, float fontSizeInPixels)
+{
+    if (s_pGlyphAtlases == NULL)
+    {
+        s_pGlyphAtlases = new CCDictionary();
+    }
+
+    char szSize[32];
+    sprintf(szSize, "|%.2f", fontSizeInPixels);
+    std::string sKey = std::string(fontName) + szSize;
+
+    CCGlyphAtlas *pRet = (CCGlyphAtlas*)s_pGlyphAtlases->objectForKey(sKey);
+    if (pRet == NULL)
+    {
+        pRet = CCGlyphAtlas::create(fontName, fontSizeInPixels);
+        if (pRet)
+        {
+            s_pGlyphAtlases->setObject(pRet, sKey);
+        }
+    }
+
+    return pRet;
+}
+
+void CCGlyphAtlas::purgeSharedGlyphAtlases()
+{
+    if (s_pGlyphAtlases)
+    {
+        s_pGlyphAtlases->removeAllObjects();
+        CC_SAFE_RELEASE_NULL(s_pGlyphAtlases);
+    }
+}
+
+CCGlyphAtlas* CCGlyphAtlas::create(const char *fontName, float fontSizeInPixels)
+{
+    CCGlyphAtlas *pRet = new CCGlyphAtlas();
+    if (pRet && pRet->initWithFont(fontName, fontSizeInPixels))
+    {
+        pRet->autorelease();
+        return pRet;
+    }
+    CC_SAFE_DELETE(pRet);
+    return NULL;
+}
+
+bool CCGlyphAtlas::initWithFont(const char *fontName, float fontSizeInPixels)
+{
+    CCAssert(fontName != NULL, "fontName should not be null");
+    m_sFontName = fontName;
+    m_fFontSize = fontSizeInPixels;
+
+    // every glyph image is one line high, a reference glyph gives the height of the lines
+    CCImage image;
+    if (! image.initWithString("X", 0, 0, CCImage::kAlignTopLeft, fontName, (int)fontSizeInPixels))
+    {
+        CCLOG("cocos2d: CCGlyphAtlas: can't render the font %s", fontName);
+        return false;
+    }
+    m_fLineHeight = (float)image.getHeight();
+    m_bHasPremultipliedAlpha = image.isPremultipliedAlpha();
+    m_nReferenceWidth = image.getWidth();
+    m_nReferencePairWidth = textWidth("XX");
+
+    m_uPixelsWide = CC_GLYPH_ATLAS_TEXTURE_WIDTH;
+    unsigned int uHeight = ccNextPOT(2 * (image.getHeight() + kCCGlyphAtlasPadding));
+    return resizeTexture(MAX(uHeight, kCCGlyphAtlasMinHeight));
+}
+
+int CCGlyphAtlas::textWidth(const std::string& sText)
+{
+    CCImage image;
+    if (! image.initWithString(sText.c_str(), 0, 0, CCImage::kAlignTopLeft, m_sFontName.c_str(), (int)m_fFontSize))
+    {
+        return -1;
+    }
+    return image.getWidth();
+}
+
+const ccGlyphAtlasDef* CCGlyphAtlas::glyphForCharacter(const char *pszChar, unsigned int uLength)
+{
+    CCAssert(uLength > 0 && uLength <= 4, "CCGlyphAtlas: invalid UTF-8 character");
+
+    unsigned int uKey = 0;
+    for (unsigned int i = 0; i < uLength; i++)
+    {
+        uKey = (uKey << 8) | (unsigned char)pszChar[i];
+    }
+
+    std::map<unsigned int, ccGlyphAtlasDef>::iterator it = m_tGlyphs.find(uKey);
+    if (it != m_tGlyphs.end())
+    {
+        return &it->second;
+    }
+
+    ccGlyphAtlasDef tGlyph;
+    tGlyph.rect = CCRectZero;
+    tGlyph.xAdvance = 0;
+    tGlyph.xOffset = 0;
+
+    std::string sChar(pszChar, uLength);
+    CCImage image;
+    if (! image.initWithString(sChar.c_str(), 0, 0, CCImage::kAlignTopLeft, m_sFontName.c_str(), (int)m_fFontSize)
+        || ! image.hasAlpha() || image.getBitsPerComponent() != 8)
+    {
+        // remembered as an empty glyph, so it isn't rendered again
+        CCLOG("cocos2d: CCGlyphAtlas: can't render the character '%s'", sChar.c_str());
+        return &(m_tGlyphs[uKey] = tGlyph);
+    }
+
+    unsigned int uWidth = image.getWidth();
+    unsigned int uHeight = image.getHeight();
+    unsigned int uX = 0, uY = 0;
+    if (! packGlyph(uWidth + kCCGlyphAtlasPadding, uHeight + kCCGlyphAtlasPadding, &uX, &uY))
+    {
+        CCLOG("cocos2d: CCGlyphAtlas: no room left for the character '%s'", sChar.c_str());
+        return NULL;
+    }
+
+    const unsigned char *pData = image.getData();
+    for (unsigned int i = 0; i < uHeight; i++)
+    {
+        memcpy(m_pPixels + ((uY + i) * m_uPixelsWide + uX) * 4, pData + i * uWidth * 4, uWidth * 4);
+    }
+    m_pTexture->updateWithData(pData, uX, uY, uWidth, uHeight);
+
+    tGlyph.rect = CCRectMake((float)uX, (float)uY, (float)uWidth, (float)uHeight);
+
+    // the image of a lone character may be cropped to its ink (a space is almost empty), so the
+    // metrics come from strings where it is between two X: whatever the renderer adds before
+    // the first and after the last character cancels out
+    int nBetween = textWidth("X" + sChar + "X");
+    int nAfter = textWidth("X" + sChar);
+    if (nBetween >= 0 && nAfter >= 0 && m_nReferencePairWidth >= 0)
+    {
+        tGlyph.xAdvance = (float)(nBetween - m_nReferencePairWidth);
+        tGlyph.xOffset = (float)(nAfter - m_nReferencePairWidth + m_nReferenceWidth - (int)uWidth);
+    }
+    else
+    {
+        tGlyph.xAdvance = (float)uWidth;
+    }
+    m_fLineHeight = MAX(m_fLineHeight, (float)uHeight);
+    return &(m_tGlyphs[uKey] = tGlyph);
+}
+
+bool CCGlyphAtlas::packGlyph(unsigned int uWidth, unsigned int uHeight, unsigned int *pX, unsigned int *pY)
+{
+    if (uWidth > m_uPixelsWide)
+    {
+        return false;
+    }
+
+    if (m_uShelfX + uWidth > m_uPixelsWide)
+    {
+        m_uShelfY += m_uShelfHeight;
+        m_uShelfX = 0;
+        m_uShelfHeight = 0;
+    }
+
+    while (m_uShelfY + uHeight > m_uPixelsHigh)
+    {
+        if (! resizeTexture(m_uPixelsHigh * 2))
+        {
+            return false;
+        }
+    }
+
+    *pX = m_uShelfX;
+    *pY = m_uShelfY;
+    m_uShelfX += uWidth;
+    m_uShelfHeight = MAX(m_uShelfHeight, uHeight);
+    return true;
+}
+
+bool CCGlyphAtlas::resizeTexture(unsigned int uHeight)
+{
+    if (uHeight > (unsigned int)CCConfiguration::sharedConfiguration()->getMaxTextureSize())
+    {
+        return false;
+    }
+
+    unsigned char *pPixels = (unsigned char*)realloc(m_pPixels, m_uPixelsWide * uHeight * 4);
+    if (! pPixels)
+    {
+        return false;
+    }
+    memset(pPixels + m_uPixelsWide * m_uPixelsHigh * 4, 0, m_uPixelsWide * (uHeight - m_uPixelsHigh) * 4);
+    m_pPixels = pPixels;
+    m_uPixelsHigh = uHeight;
+
+    CCTexture2D *pTexture = new CCTexture2D();
+    CCSize size = CCSizeMake((float)m_uPixelsWide, (float)m_uPixelsHigh);
+    pTexture->initWithData(m_pPixels, kCCTexture2DPixelFormat_RGBA8888, m_uPixelsWide, m_uPixelsHigh, size);
+
+    if (m_pTexture)
+    {
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        // the labels may keep the old texture until they draw, it must not be reloaded from m_pPixels
+        VolatileTexture::removeTexture(m_pTexture);
+#endif
+        m_pTexture->release();
+    }
+    m_pTexture = pTexture;
+    m_uGeneration++;
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    VolatileTexture::addDataTexture(m_pTexture, m_pPixels, kCCTexture2DPixelFormat_RGBA8888, size);
+#endif
+
+    return true;
+}
+
+//
+// CCLabelGlyphAtlas
+//
+
+// number of bytes of the UTF-8 character starting with the byte c
+static inline unsigned int cc_utf8_char_length(unsigned char c)
+{
+    return c < 0xc0 ? 1 : c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+}
+
+CCLabelGlyphAtlas::CCLabelGlyphAtlas()
+: m_sString("")
+, m_eAlignment(kCCTextAlignmentLeft)
+, m_pGlyphAtlas(NULL)
+, m_uAtlasGeneration(0)
+{
+}
+
+CCLabelGlyphAtlas::~CCLabelGlyphAtlas()
+{
+    CC_SAFE_RELEASE(m_pGlyphAtlas);
+}
+
+CCLabelGlyphAtlas* CCLabelGlyphAtlas::create(const char *string, const char *fontName, float fontSize, CCTextAlignment alignment/* = kCCTextAlignmentLeft*/)
+{
+    CCLabelGlyphAtlas *pRet = new CCLabelGlyphAtlas();
+    if (pRet && pRet->initWithString(string, fontName, fontSize, alignment))
+    {
+        pRet->autorelease();
+        return pRet;
+    }
+    CC_SAFE_DELETE(pRet);
+    return NULL;
+}
+
+bool CCLabelGlyphAtlas::initWithString(const char *string, const char *fontName, float fontSize, CCTextAlignment alignment/* = kCCTextAlignmentLeft*/)
+{
+    CCAssert(string != NULL, "");
+    CCGlyphAtlas *pGlyphAtlas = CCGlyphAtlas::sharedGlyphAtlas(fontName, fontSize * CC_CONTENT_SCALE_FACTOR());
+    if (! pGlyphAtlas)
+    {
+        return false;
+    }
+
+    // the glyphs don't have a fixed size, the item size of CCAtlasNode isn't used
+    if (CCAtlasNode::initWithTexture(pGlyphAtlas->getTexture(), 1, 1, strlen(string)))
+    {
+        pGlyphAtlas->retain();
+        m_pGlyphAtlas = pGlyphAtlas;
+        m_uAtlasGeneration = pGlyphAtlas->getGeneration();
+        m_eAlignment = alignment;
+        this->updateBlendFuncForAtlas();
+
+        this->setAnchorPoint(ccp(0.5f, 0.5f));
+        this->setString(string);
+        return true;
+    }
+    return false;
+}
+
+void CCLabelGlyphAtlas::setAlignment(CCTextAlignment alignment)
+{
+    if (m_eAlignment != alignment)
+    {
+        m_eAlignment = alignment;
+        this->updateAtlasValues();
+    }
+}
+
+//CCLabelGlyphAtlas - Atlas generation
+void CCLabelGlyphAtlas::updateAtlasValues()
+{
+    // the glyphs are looked up before building the quads, packing new glyphs may replace the texture
+    static std::vector<const ccGlyphAtlasDef*> s_vGlyphs;
+    static std::vector<float> s_vLineWidths;
+    s_vGlyphs.clear();
+    s_vLineWidths.clear();
+
+    const char *s = m_sString.c_str();
+    unsigned int n = m_sString.length();
+    unsigned int uQuads = 0;
+    float fLineWidth = 0;
+    float fMaxLineWidth = 0;
+
+    for (unsigned int i = 0; i < n; )
+    {
+        if (s[i] == '\n')
+        {
+            // NULL ends a line
+            s_vGlyphs.push_back(NULL);
+            s_vLineWidths.push_back(fLineWidth);
+            fMaxLineWidth = MAX(fMaxLineWidth, fLineWidth);
+            fLineWidth = 0;
+            i++;
+            continue;
+        }
+
+        unsigned int uCharLength = MIN(cc_utf8_char_length((unsigned char)s[i]), n - i);
+        const ccGlyphAtlasDef *pGlyph = m_pGlyphAtlas->glyphForCharacter(s + i, uCharLength);
+        i += uCharLength;
+        if (! pGlyph)
+        {
+            continue;
+        }
+
+        s_vGlyphs.push_back(pGlyph);
+        fLineWidth += pGlyph->xAdvance;
+        if (pGlyph->rect.size.width > 0)
+        {
+            uQuads++;
+        }
+    }
+    s_vLineWidths.push_back(fLineWidth);
+    fMaxLineWidth = MAX(fMaxLineWidth, fLineWidth);
+
+    if (m_uAtlasGeneration != m_pGlyphAtlas->getGeneration())
+    {
+        m_uAtlasGeneration = m_pGlyphAtlas->getGeneration();
+        this->setTexture(m_pGlyphAtlas->getTexture());
+    }
+
+    if (uQuads > m_pTextureAtlas->getCapacity())
+    {
+        m_pTextureAtlas->resizeCapacity(uQuads);
+    }
+
+    float fScale = CC_CONTENT_SCALE_FACTOR();
+    float fLineHeight = m_pGlyphAtlas->getLineHeight();
+    float fTextureWide = (float)m_pGlyphAtlas->getTexture()->getPixelsWide();
+    float fTextureHigh = (float)m_pGlyphAtlas->getTexture()->getPixelsHigh();
+
+    ccV3F_C4B_T2F_Quad quad;
+    ccColor4B c = { m_tColor.r, m_tColor.g, m_tColor.b, m_cOpacity };
+    quad.tl.colors = c;
+    quad.tr.colors = c;
+    quad.bl.colors = c;
+    quad.br.colors = c;
+
+    unsigned int uLine = 0;
+    unsigned int uQuad = 0;
+    float fTop = s_vLineWidths.size() * fLineHeight;
+    float fX = 0;
+    bool bStartLine = true;
+
+    for (unsigned int i = 0; i < s_vGlyphs.size(); i++)
+    {
+        if (bStartLine)
+        {
+            float fSpace = fMaxLineWidth - s_vLineWidths[uLine];
+            fX = m_eAlignment == kCCTextAlignmentCenter ? fSpace / 2 : m_eAlignment == kCCTextAlignmentRight ? fSpace : 0;
+            bStartLine = false;
+        }
+
+        const ccGlyphAtlasDef *pGlyph = s_vGlyphs[i];
+        if (! pGlyph)
+        {
+            uLine++;
+            fTop -= fLineHeight;
+            bStartLine = true;
+            continue;
+        }
+
+        const CCRect& rect = pGlyph->rect;
+        if (rect.size.width > 0)
+        {
+            float left      = rect.origin.x / fTextureWide;
+            float right     = (rect.origin.x + rect.size.width) / fTextureWide;
+            float top       = rect.origin.y / fTextureHigh;
+            float bottom    = (rect.origin.y + rect.size.height) / fTextureHigh;
+
+            quad.tl.texCoords.u = left;
+            quad.tl.texCoords.v = top;
+            quad.tr.texCoords.u = right;
+            quad.tr.texCoords.v = top;
+            quad.bl.texCoords.u = left;
+            quad.bl.texCoords.v = bottom;
+            quad.br.texCoords.u = right;
+            quad.br.texCoords.v = bottom;
+
+            float x1 = (fX + pGlyph->xOffset) / fScale;
+            float x2 = (fX + pGlyph->xOffset + rect.size.width) / fScale;
+            float y1 = (fTop - rect.size.height) / fScale;
+            float y2 = fTop / fScale;
+
+            quad.bl.vertices = vertex3(x1, y1, 0);
+            quad.br.vertices = vertex3(x2, y1, 0);
+            quad.tl.vertices = vertex3(x1, y2, 0);
+            quad.tr.vertices = vertex3(x2, y2, 0);
+
+            m_pTextureAtlas->updateQuad(&quad, uQuad++);
+        }
+
+        fX += pGlyph->xAdvance;
+    }
+
+    m_uQuadsToDraw = uQuads;
+
+    this->setContentSize(CCSizeMake(fMaxLineWidth / fScale, s_vLineWidths.size() * fLineHeight / fScale));
+}
+
+//CCLabelGlyphAtlas - CCLabelProtocol
+void CCLabelGlyphAtlas::setString(const char *label)
+{
+    CCAssert(label != NULL, "");
+    m_sString = label;
+    this->updateAtlasValues();
+}
+
+const char* CCLabelGlyphAtlas::getString(void)
+{
+    return m_sString.c_str();
+}
+
+//CCLabelGlyphAtlas - CCTextureProtocol
+void CCLabelGlyphAtlas::setTexture(CCTexture2D *texture)
+{
+    CCAtlasNode::setTexture(texture);
+    this->updateBlendFuncForAtlas();
+}
+
+void CCLabelGlyphAtlas::updateBlendFuncForAtlas()
+{
+    // the texture of the atlas is created from raw data, it doesn't know the alpha of the glyphs is premultiplied
+    if (m_pGlyphAtlas && m_pGlyphAtlas->hasPremultipliedAlpha())
+    {
+        m_tBlendFunc.src = CC_BLEND_SRC;
+        m_tBlendFunc.dst = CC_BLEND_DST;
+        this->setOpacityModifyRGB(true);
+        this->setColor(m_tColorUnmodified);
+    }
+}
+
+//CCLabelGlyphAtlas - draw
+void CCLabelGlyphAtlas::draw()
+{
+    // another label made the atlas grow since the quads were built
+    if (m_uAtlasGeneration != m_pGlyphAtlas->getGeneration())
+    {
+        this->updateAtlasValues();
+    }
+
+    CCAtlasNode::draw();
+}
+
+NS_CC_END
@@ -0,0 +1,181 @@
+/****************************************************************************
+Copyright (c) 2012      cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __CCLABEL_GLYPH_ATLAS_H__
+#define __CCLABEL_GLYPH_ATLAS_H__
+
+#include "base_nodes/CCAtlasNode.h"
+#include "cocoa/CCGeometry.h"
+#include <string>
+#include <map>
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup GUI
+ * @{
+ * @addtogroup label
+ * @{
+ */
+
+class CCTexture2D;
+
+/** @brief A glyph packed in a CCGlyphAtlas
+ @since v2.1
+ */
+typedef struct _ccGlyphAtlasDef
+{
+    //! rect of the glyph in the texture, in pixels
+    CCRect rect;
+    //! horizontal distance to the next glyph, in pixels
+    float xAdvance;
+    //! horizontal distance from the pen position to the left of the rect, in pixels
+    float xOffset;
+} ccGlyphAtlasDef;
+
+/** @brief CCGlyphAtlas rasterizes the characters of a font, one at a time, with the platform
+ text renderer (the one used by CCLabelTTF) and packs them in a texture shared by every
+ CCLabelGlyphAtlas that uses the same font and size.
+
+ The texture starts small and doubles its height when it is full. Each time it is replaced
+ the generation of the atlas changes, so the labels know they must update their quads.
+ @since v2.1
+ */
+class CC_DLL CCGlyphAtlas : public CCObject
+{
+public:
+    CCGlyphAtlas();
+    virtual ~CCGlyphAtlas();
+
+    /** returns the atlas of a font name and size in pixels, shared by all the labels */
+    static CCGlyphAtlas* sharedGlyphAtlas(const char *fontName, float fontSizeInPixels);
+
+    /** releases the shared atlases. Labels keep the atlases they use alive. */
+    static void purgeSharedGlyphAtlases();
+
+    /** creates an atlas for a font name and size in pixels */
+    static CCGlyphAtlas* create(const char *fontName, float fontSizeInPixels);
+
+    /** initializes an atlas for a font name and size in pixels */
+    bool initWithFont(const char *fontName, float fontSizeInPixels);
+
+    /** returns the glyph of the UTF-8 character of uLength bytes at pszChar, packing it
+     in the texture the first time it is used. Returns NULL if it can't be rendered or packed.
+     */
+    const ccGlyphAtlasDef* glyphForCharacter(const char *pszChar, unsigned int uLength);
+
+    /** height of a line of text, in pixels */
+    float getLineHeight() { return m_fLineHeight; }
+
+    /** whether the texture stores premultiplied alpha, as the platform text renderer does */
+    bool hasPremultipliedAlpha() { return m_bHasPremultipliedAlpha; }
+
+    CCTexture2D* getTexture() { return m_pTexture; }
+
+    /** incremented each time the texture is replaced by a bigger one */
+    unsigned int getGeneration() { return m_uGeneration; }
+
+private:
+    bool packGlyph(unsigned int uWidth, unsigned int uHeight, unsigned int *pX, unsigned int *pY);
+    bool resizeTexture(unsigned int uHeight);
+    int textWidth(const std::string& sText);
+
+    std::string         m_sFontName;
+    float               m_fFontSize;
+    float               m_fLineHeight;
+    bool                m_bHasPremultipliedAlpha;
+
+    // widths of "X" and "XX", the characters are measured between two X
+    int                 m_nReferenceWidth;
+    int                 m_nReferencePairWidth;
+
+    // packed glyphs, keyed by the UTF-8 bytes of the character
+    std::map<unsigned int, ccGlyphAtlasDef> m_tGlyphs;
+
+    // copy of the texture, to build the bigger texture when it grows
+    unsigned char       *m_pPixels;
+    unsigned int        m_uPixelsWide;
+    unsigned int        m_uPixelsHigh;
+    CCTexture2D         *m_pTexture;
+    unsigned int        m_uGeneration;
+
+    // glyphs are packed in rows ("shelves") from top to bottom
+    unsigned int        m_uShelfX;
+    unsigned int        m_uShelfY;
+    unsigned int        m_uShelfHeight;
+};
+
+/** @brief CCLabelGlyphAtlas is a label that renders any font of the platform, like CCLabelTTF,
+ but from a CCGlyphAtlas shared by all the labels with the same font and size.
+
+ Changing the string only updates the quads of the label: the characters that were already used
+ by any label are not rendered again and no texture is created.
+
+ CCLabelGlyphAtlas versus CCLabelTTF:
+ - setString is much faster, which suits scores, timers and chat text
+ - lines are only broken by '\n', there are no dimensions nor vertical alignment
+ - characters are placed with their advance and bearing, measured with the platform renderer,
+   but without kerning
+ @since v2.1
+ */
+class CC_DLL CCLabelGlyphAtlas : public CCAtlasNode, public CCLabelProtocol
+{
+public:
+    CCLabelGlyphAtlas();
+    virtual ~CCLabelGlyphAtlas();
+
+    /** creates a CCLabelGlyphAtlas from a font name, a font size in points and a horizontal alignment */
+    static CCLabelGlyphAtlas* create(const char *string, const char *fontName, float fontSize, CCTextAlignment alignment = kCCTextAlignmentLeft);
+
+    /** initializes the CCLabelGlyphAtlas with a font name, a font size in points and a horizontal alignment */
+    bool initWithString(const char *string, const char *fontName, float fontSize, CCTextAlignment alignment = kCCTextAlignmentLeft);
+
+    /** sets the alignment of the lines of the label */
+    void setAlignment(CCTextAlignment alignment);
+    CCTextAlignment getAlignment() { return m_eAlignment; }
+
+    // super methods
+    virtual void updateAtlasValues();
+    virtual void setString(const char *label);
+    virtual const char* getString(void);
+    virtual void setTexture(CCTexture2D *texture);
+    virtual void draw();
+
+protected:
+    void updateBlendFuncForAtlas();
+
+    // string to render
+    std::string         m_sString;
+    CCTextAlignment     m_eAlignment;
+    CCGlyphAtlas        *m_pGlyphAtlas;
+    // generation of the atlas the quads were built with
+    unsigned int        m_uAtlasGeneration;
+};
+
+// end of GUI group
+/// @}
+/// @}
+
+NS_CC_END
+
+#endif //__CCLABEL_GLYPH_ATLAS_H__
@@ -37,6 +37,8 @@ THE SOFTWARE.
 #include "CCGL.h"
 #include "support/CCNotificationCenter.h"
 #include "CCEventType.h"
+#include "support/CCRenderQueue.h"
+#include "support/CCCulling.h"
 // extern
 #include "kazmath/GL/matrix.h"
 
@@ -249,6 +251,12 @@ bool CCRenderTexture::initWithWidthAndHeight(int w, int h, CCTexture2DPixelForma
 
 void CCRenderTexture::begin()
 {
+    // the batched quads belong to the previous render target
+    CCRenderQueue::sharedRenderQueue()->flush();
+
+    // the nodes are drawn into the texture, not on the screen
+    CCCulling::suspend();
+
     // Save the current matrix
     kmGLPushMatrix();
 
@@ -268,6 +276,7 @@ void CCRenderTexture::begin()
     kmMat4OrthographicProjection(&orthoMatrix, (float)-1.0 / widthRatio,  (float)1.0 / widthRatio,
         (float)-1.0 / heightRatio, (float)1.0 / heightRatio, -1,1 );
     kmGLMultMatrix(&orthoMatrix);
+    CCNode::invalidateModelViewStack();
 
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &m_nOldFBO);
     glBindFramebuffer(GL_FRAMEBUFFER, m_uFBO);
@@ -332,6 +341,9 @@ void CCRenderTexture::beginWithClear(float r, float g, float b, float a, float d
 
 void CCRenderTexture::end()
 {
+    CCRenderQueue::sharedRenderQueue()->flush();
+    CCCulling::resume();
+
     glBindFramebuffer(GL_FRAMEBUFFER, m_nOldFBO);
     kmGLPopMatrix();
 
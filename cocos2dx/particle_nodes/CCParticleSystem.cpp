@@ -57,6 +57,18 @@ THE SOFTWARE.
 // opengl
 #include "CCGL.h"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define CC_PARTICLE_SIMD_SSE 1
+    #include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    #define CC_PARTICLE_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+// number of arrays in tCCParticleData
+#define kCCParticleDataFields       28
+// particles simulated before their quads are updated. The values of a block (~14KB) and its quads (~12KB) stay in L1
+#define kCCParticleUpdateBlockSize  128
 
 NS_CC_BEGIN
 
@@ -80,7 +92,6 @@ NS_CC_BEGIN
 CCParticleSystem::CCParticleSystem()
     :m_sPlistFile("")
     ,m_fElapsed(0)
-    ,m_pParticles(NULL)
     ,m_fEmitCounter(0)
     ,m_uParticleIdx(0)
     ,m_bIsActive(true)
@@ -113,6 +124,7 @@ CCParticleSystem::CCParticleSystem()
     ,m_bTransformSystemDirty(false)
     ,m_uAllocatedParticles(0)
 {
+    memset(&m_tParticles, 0, sizeof(m_tParticles));
     modeA.gravity = CCPointZero;
     modeA.speed = 0;
     modeA.speedVar = 0;
@@ -354,11 +366,7 @@ bool CCParticleSystem::initWithTotalParticles(unsigned int numberOfParticles)
 {
     m_uTotalParticles = numberOfParticles;
 
-    CC_SAFE_FREE(m_pParticles);
-    
-    m_pParticles = (tCCParticle*)calloc(m_uTotalParticles, sizeof(tCCParticle));
-
-    if( ! m_pParticles )
+    if( ! allocParticles(m_uTotalParticles) )
     {
         CCLOG("Particle system: not enough memory");
         this->release();
@@ -370,7 +378,7 @@ bool CCParticleSystem::initWithTotalParticles(unsigned int numberOfParticles)
     {
         for (unsigned int i = 0; i < m_uTotalParticles; i++)
         {
-            m_pParticles[i].atlasIndex=i;
+            m_tParticles.atlasIndex[i]=i;
         }
     }
     // default, active
@@ -406,7 +414,7 @@ bool CCParticleSystem::initWithTotalParticles(unsigned int numberOfParticles)
 CCParticleSystem::~CCParticleSystem()
 {
     unscheduleUpdate();
-    CC_SAFE_FREE(m_pParticles);
+    freeParticles();
     CC_SAFE_RELEASE(m_pTexture);
 }
 
@@ -417,8 +425,9 @@ bool CCParticleSystem::addParticle()
         return false;
     }
 
-    tCCParticle * particle = &m_pParticles[ m_uParticleCount ];
-    this->initParticle(particle);
+    tCCParticle particle;
+    this->initParticle(&particle);
+    this->storeParticle(m_uParticleCount, &particle);
     ++m_uParticleCount;
 
     return true;
@@ -546,8 +555,7 @@ void CCParticleSystem::resetSystem()
     m_fElapsed = 0;
     for (m_uParticleIdx = 0; m_uParticleIdx < m_uParticleCount; ++m_uParticleIdx)
     {
-        tCCParticle *p = &m_pParticles[m_uParticleIdx];
-        p->timeToLive = 0;
+        m_tParticles.timeToLive[m_uParticleIdx] = 0;
     }
 }
 bool CCParticleSystem::isFull()
@@ -555,6 +563,353 @@ bool CCParticleSystem::isFull()
     return (m_uParticleCount == m_uTotalParticles);
 }
 
+// ParticleSystem - particle storage
+
+bool CCParticleSystem::allocParticles(unsigned int uCapacity)
+{
+    // the simulation processes 4 particles at once
+    unsigned int uStride = (uCapacity + 3) & ~3u;
+
+    void *pMemory = calloc(uStride * kCCParticleDataFields * sizeof(float) + 15, 1);
+    if (! pMemory)
+    {
+        return false;
+    }
+
+    freeParticles();
+
+    float *p = (float*)(((size_t)pMemory + 15) & ~(size_t)15);
+    m_tParticles.pMemory = pMemory;
+    m_tParticles.pData = p;
+    m_tParticles.uStride = uStride;
+
+    m_tParticles.posX = p;             p += uStride;
+    m_tParticles.posY = p;             p += uStride;
+    m_tParticles.startPosX = p;        p += uStride;
+    m_tParticles.startPosY = p;        p += uStride;
+    m_tParticles.colorR = p;           p += uStride;
+    m_tParticles.colorG = p;           p += uStride;
+    m_tParticles.colorB = p;           p += uStride;
+    m_tParticles.colorA = p;           p += uStride;
+    m_tParticles.deltaColorR = p;      p += uStride;
+    m_tParticles.deltaColorG = p;      p += uStride;
+    m_tParticles.deltaColorB = p;      p += uStride;
+    m_tParticles.deltaColorA = p;      p += uStride;
+    m_tParticles.size = p;             p += uStride;
+    m_tParticles.deltaSize = p;        p += uStride;
+    m_tParticles.rotation = p;         p += uStride;
+    m_tParticles.deltaRotation = p;    p += uStride;
+    m_tParticles.timeToLive = p;       p += uStride;
+    m_tParticles.atlasIndex = (unsigned int*)p; p += uStride;
+    m_tParticles.dirX = p;             p += uStride;
+    m_tParticles.dirY = p;             p += uStride;
+    m_tParticles.radialAccel = p;      p += uStride;
+    m_tParticles.tangentialAccel = p;  p += uStride;
+    m_tParticles.angle = p;            p += uStride;
+    m_tParticles.degreesPerSecond = p; p += uStride;
+    m_tParticles.radius = p;           p += uStride;
+    m_tParticles.deltaRadius = p;      p += uStride;
+    m_tParticles.quadX = p;            p += uStride;
+    m_tParticles.quadY = p;            p += uStride;
+
+    CCAssert(p == (float*)m_tParticles.pData + uStride * kCCParticleDataFields, "kCCParticleDataFields doesn't match tCCParticleData");
+
+    return true;
+}
+
+void CCParticleSystem::freeParticles()
+{
+    CC_SAFE_FREE(m_tParticles.pMemory);
+    memset(&m_tParticles, 0, sizeof(m_tParticles));
+}
+
+void CCParticleSystem::storeParticle(unsigned int uIndex, const tCCParticle* particle)
+{
+    m_tParticles.posX[uIndex] = particle->pos.x;
+    m_tParticles.posY[uIndex] = particle->pos.y;
+    m_tParticles.startPosX[uIndex] = particle->startPos.x;
+    m_tParticles.startPosY[uIndex] = particle->startPos.y;
+    m_tParticles.colorR[uIndex] = particle->color.r;
+    m_tParticles.colorG[uIndex] = particle->color.g;
+    m_tParticles.colorB[uIndex] = particle->color.b;
+    m_tParticles.colorA[uIndex] = particle->color.a;
+    m_tParticles.deltaColorR[uIndex] = particle->deltaColor.r;
+    m_tParticles.deltaColorG[uIndex] = particle->deltaColor.g;
+    m_tParticles.deltaColorB[uIndex] = particle->deltaColor.b;
+    m_tParticles.deltaColorA[uIndex] = particle->deltaColor.a;
+    m_tParticles.size[uIndex] = particle->size;
+    m_tParticles.deltaSize[uIndex] = particle->deltaSize;
+    m_tParticles.rotation[uIndex] = particle->rotation;
+    m_tParticles.deltaRotation[uIndex] = particle->deltaRotation;
+    m_tParticles.timeToLive[uIndex] = particle->timeToLive;
+    m_tParticles.dirX[uIndex] = particle->modeA.dir.x;
+    m_tParticles.dirY[uIndex] = particle->modeA.dir.y;
+    m_tParticles.radialAccel[uIndex] = particle->modeA.radialAccel;
+    m_tParticles.tangentialAccel[uIndex] = particle->modeA.tangentialAccel;
+    m_tParticles.angle[uIndex] = particle->modeB.angle;
+    m_tParticles.degreesPerSecond[uIndex] = particle->modeB.degreesPerSecond;
+    m_tParticles.radius[uIndex] = particle->modeB.radius;
+    m_tParticles.deltaRadius[uIndex] = particle->modeB.deltaRadius;
+}
+
+void CCParticleSystem::loadParticle(unsigned int uIndex, tCCParticle* particle)
+{
+    particle->pos.x = m_tParticles.posX[uIndex];
+    particle->pos.y = m_tParticles.posY[uIndex];
+    particle->startPos.x = m_tParticles.startPosX[uIndex];
+    particle->startPos.y = m_tParticles.startPosY[uIndex];
+    particle->color.r = m_tParticles.colorR[uIndex];
+    particle->color.g = m_tParticles.colorG[uIndex];
+    particle->color.b = m_tParticles.colorB[uIndex];
+    particle->color.a = m_tParticles.colorA[uIndex];
+    particle->deltaColor.r = m_tParticles.deltaColorR[uIndex];
+    particle->deltaColor.g = m_tParticles.deltaColorG[uIndex];
+    particle->deltaColor.b = m_tParticles.deltaColorB[uIndex];
+    particle->deltaColor.a = m_tParticles.deltaColorA[uIndex];
+    particle->size = m_tParticles.size[uIndex];
+    particle->deltaSize = m_tParticles.deltaSize[uIndex];
+    particle->rotation = m_tParticles.rotation[uIndex];
+    particle->deltaRotation = m_tParticles.deltaRotation[uIndex];
+    particle->timeToLive = m_tParticles.timeToLive[uIndex];
+    particle->atlasIndex = m_tParticles.atlasIndex[uIndex];
+    particle->modeA.dir.x = m_tParticles.dirX[uIndex];
+    particle->modeA.dir.y = m_tParticles.dirY[uIndex];
+    particle->modeA.radialAccel = m_tParticles.radialAccel[uIndex];
+    particle->modeA.tangentialAccel = m_tParticles.tangentialAccel[uIndex];
+    particle->modeB.angle = m_tParticles.angle[uIndex];
+    particle->modeB.degreesPerSecond = m_tParticles.degreesPerSecond[uIndex];
+    particle->modeB.radius = m_tParticles.radius[uIndex];
+    particle->modeB.deltaRadius = m_tParticles.deltaRadius[uIndex];
+}
+
+void CCParticleSystem::copyParticle(unsigned int uTo, unsigned int uFrom)
+{
+    // copied as integers, so the atlas indices are copied too
+    unsigned int *pData = (unsigned int*)m_tParticles.pData;
+    unsigned int uStride = m_tParticles.uStride;
+    for (unsigned int i = 0; i < kCCParticleDataFields; ++i, pData += uStride)
+    {
+        pData[uTo] = pData[uFrom];
+    }
+}
+
+// ParticleSystem - simulation
+
+#if CC_PARTICLE_SIMD_SSE || CC_PARTICLE_SIMD_NEON
+
+#if CC_PARTICLE_SIMD_SSE
+typedef __m128 ccParticleVec;
+
+static inline ccParticleVec vecLoad(const float *p) { return _mm_load_ps(p); }
+static inline void vecStore(float *p, ccParticleVec v) { _mm_store_ps(p, v); }
+static inline ccParticleVec vecSet(float f) { return _mm_set1_ps(f); }
+static inline ccParticleVec vecAdd(ccParticleVec a, ccParticleVec b) { return _mm_add_ps(a, b); }
+static inline ccParticleVec vecSub(ccParticleVec a, ccParticleVec b) { return _mm_sub_ps(a, b); }
+static inline ccParticleVec vecMul(ccParticleVec a, ccParticleVec b) { return _mm_mul_ps(a, b); }
+// same as MAX(0, v)
+static inline ccParticleVec vecMax0(ccParticleVec v) { return _mm_max_ps(v, _mm_setzero_ps()); }
+
+// same as ccpNormalize, but (0, 0) stays (0, 0)
+static inline void vecNormalize(ccParticleVec x, ccParticleVec y, ccParticleVec &nx, ccParticleVec &ny)
+{
+    __m128 zero = _mm_setzero_ps();
+    __m128 nonZero = _mm_or_ps(_mm_cmpneq_ps(x, zero), _mm_cmpneq_ps(y, zero));
+    __m128 inv = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))));
+    nx = _mm_and_ps(nonZero, _mm_mul_ps(x, inv));
+    ny = _mm_and_ps(nonZero, _mm_mul_ps(y, inv));
+}
+#else
+typedef float32x4_t ccParticleVec;
+
+static inline ccParticleVec vecLoad(const float *p) { return vld1q_f32(p); }
+static inline void vecStore(float *p, ccParticleVec v) { vst1q_f32(p, v); }
+static inline ccParticleVec vecSet(float f) { return vdupq_n_f32(f); }
+static inline ccParticleVec vecAdd(ccParticleVec a, ccParticleVec b) { return vaddq_f32(a, b); }
+static inline ccParticleVec vecSub(ccParticleVec a, ccParticleVec b) { return vsubq_f32(a, b); }
+static inline ccParticleVec vecMul(ccParticleVec a, ccParticleVec b) { return vmulq_f32(a, b); }
+static inline ccParticleVec vecMax0(ccParticleVec v) { return vmaxq_f32(v, vdupq_n_f32(0)); }
+
+static inline void vecNormalize(ccParticleVec x, ccParticleVec y, ccParticleVec &nx, ccParticleVec &ny)
+{
+    float32x4_t zero = vdupq_n_f32(0);
+    uint32x4_t nonZero = vmvnq_u32(vandq_u32(vceqq_f32(x, zero), vceqq_f32(y, zero)));
+    float32x4_t lengthSQ = vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y));
+#if defined(__aarch64__)
+    float32x4_t inv = vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(lengthSQ));
+#else
+    // ARMv7 has no vector division: refine the reciprocal square root estimate twice
+    float32x4_t inv = vrsqrteq_f32(lengthSQ);
+    inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(lengthSQ, inv), inv));
+    inv = vmulq_f32(inv, vrsqrtsq_f32(vmulq_f32(lengthSQ, inv), inv));
+#endif
+    nx = vreinterpretq_f32_u32(vandq_u32(nonZero, vreinterpretq_u32_f32(vmulq_f32(x, inv))));
+    ny = vreinterpretq_f32_u32(vandq_u32(nonZero, vreinterpretq_u32_f32(vmulq_f32(y, inv))));
+}
+#endif
+
+void CCParticleSystem::updateParticles(unsigned int uStart, unsigned int uEnd, float dt, const CCPoint& currentPosition)
+{
+    tCCParticleData &d = m_tParticles;
+    ccParticleVec vdt = vecSet(dt);
+
+    // uStart is a multiple of 4. The arrays are padded, the extra lanes hold dead particles
+    uEnd = (uEnd + 3) & ~3u;
+
+    if (m_nEmitterMode == kCCParticleModeGravity)
+    {
+        // Mode A: gravity, direction, tangential accel & radial accel
+        ccParticleVec gravityX = vecSet(modeA.gravity.x);
+        ccParticleVec gravityY = vecSet(modeA.gravity.y);
+
+        for (unsigned int i = uStart; i < uEnd; i += 4)
+        {
+            ccParticleVec posX = vecLoad(d.posX + i);
+            ccParticleVec posY = vecLoad(d.posY + i);
+
+            ccParticleVec radialX, radialY;
+            vecNormalize(posX, posY, radialX, radialY);
+
+            // tangential = radial rotated by 90 degrees
+            ccParticleVec radialAccel = vecLoad(d.radialAccel + i);
+            ccParticleVec tangentialAccel = vecLoad(d.tangentialAccel + i);
+            ccParticleVec tmpX = vecAdd(vecSub(vecMul(radialX, radialAccel), vecMul(radialY, tangentialAccel)), gravityX);
+            ccParticleVec tmpY = vecAdd(vecAdd(vecMul(radialY, radialAccel), vecMul(radialX, tangentialAccel)), gravityY);
+
+            ccParticleVec dirX = vecAdd(vecLoad(d.dirX + i), vecMul(tmpX, vdt));
+            ccParticleVec dirY = vecAdd(vecLoad(d.dirY + i), vecMul(tmpY, vdt));
+            vecStore(d.dirX + i, dirX);
+            vecStore(d.dirY + i, dirY);
+
+            vecStore(d.posX + i, vecAdd(posX, vecMul(dirX, vdt)));
+            vecStore(d.posY + i, vecAdd(posY, vecMul(dirY, vdt)));
+        }
+    }
+    else
+    {
+        // Mode B: radius movement
+        for (unsigned int i = uStart; i < uEnd; i += 4)
+        {
+            vecStore(d.angle + i, vecAdd(vecLoad(d.angle + i), vecMul(vecLoad(d.degreesPerSecond + i), vdt)));
+            vecStore(d.radius + i, vecAdd(vecLoad(d.radius + i), vecMul(vecLoad(d.deltaRadius + i), vdt)));
+        }
+        for (unsigned int i = uStart; i < uEnd; ++i)
+        {
+            d.posX[i] = - cosf(d.angle[i]) * d.radius[i];
+            d.posY[i] = - sinf(d.angle[i]) * d.radius[i];
+        }
+    }
+
+    bool bMoveWithEmitter = (m_ePositionType == kCCPositionTypeFree || m_ePositionType == kCCPositionTypeRelative);
+    ccParticleVec currentX = vecSet(currentPosition.x);
+    ccParticleVec currentY = vecSet(currentPosition.y);
+    // translate the quads to the correct position, since matrix transform isn't performed in batchnode
+    ccParticleVec offsetX = vecSet(m_pBatchNode ? m_tPosition.x : 0);
+    ccParticleVec offsetY = vecSet(m_pBatchNode ? m_tPosition.y : 0);
+
+    for (unsigned int i = uStart; i < uEnd; i += 4)
+    {
+        // color
+        vecStore(d.colorR + i, vecAdd(vecLoad(d.colorR + i), vecMul(vecLoad(d.deltaColorR + i), vdt)));
+        vecStore(d.colorG + i, vecAdd(vecLoad(d.colorG + i), vecMul(vecLoad(d.deltaColorG + i), vdt)));
+        vecStore(d.colorB + i, vecAdd(vecLoad(d.colorB + i), vecMul(vecLoad(d.deltaColorB + i), vdt)));
+        vecStore(d.colorA + i, vecAdd(vecLoad(d.colorA + i), vecMul(vecLoad(d.deltaColorA + i), vdt)));
+
+        // size
+        vecStore(d.size + i, vecMax0(vecAdd(vecLoad(d.size + i), vecMul(vecLoad(d.deltaSize + i), vdt))));
+
+        // angle
+        vecStore(d.rotation + i, vecAdd(vecLoad(d.rotation + i), vecMul(vecLoad(d.deltaRotation + i), vdt)));
+
+        // position of the quad
+        ccParticleVec quadX = vecLoad(d.posX + i);
+        ccParticleVec quadY = vecLoad(d.posY + i);
+        if (bMoveWithEmitter)
+        {
+            quadX = vecSub(quadX, vecSub(currentX, vecLoad(d.startPosX + i)));
+            quadY = vecSub(quadY, vecSub(currentY, vecLoad(d.startPosY + i)));
+        }
+        vecStore(d.quadX + i, vecAdd(quadX, offsetX));
+        vecStore(d.quadY + i, vecAdd(quadY, offsetY));
+    }
+}
+
+#else
+
+void CCParticleSystem::updateParticles(unsigned int uStart, unsigned int uEnd, float dt, const CCPoint& currentPosition)
+{
+    tCCParticleData &d = m_tParticles;
+
+    if (m_nEmitterMode == kCCParticleModeGravity)
+    {
+        // Mode A: gravity, direction, tangential accel & radial accel
+        for (unsigned int i = uStart; i < uEnd; ++i)
+        {
+            float radialX = 0, radialY = 0;
+            if (d.posX[i] || d.posY[i])
+            {
+                float inv = 1.0f / sqrtf(d.posX[i] * d.posX[i] + d.posY[i] * d.posY[i]);
+                radialX = d.posX[i] * inv;
+                radialY = d.posY[i] * inv;
+            }
+
+            // tangential = radial rotated by 90 degrees
+            float tmpX = radialX * d.radialAccel[i] - radialY * d.tangentialAccel[i] + modeA.gravity.x;
+            float tmpY = radialY * d.radialAccel[i] + radialX * d.tangentialAccel[i] + modeA.gravity.y;
+
+            d.dirX[i] += tmpX * dt;
+            d.dirY[i] += tmpY * dt;
+            d.posX[i] += d.dirX[i] * dt;
+            d.posY[i] += d.dirY[i] * dt;
+        }
+    }
+    else
+    {
+        // Mode B: radius movement
+        for (unsigned int i = uStart; i < uEnd; ++i)
+        {
+            d.angle[i] += d.degreesPerSecond[i] * dt;
+            d.radius[i] += d.deltaRadius[i] * dt;
+
+            d.posX[i] = - cosf(d.angle[i]) * d.radius[i];
+            d.posY[i] = - sinf(d.angle[i]) * d.radius[i];
+        }
+    }
+
+    bool bMoveWithEmitter = (m_ePositionType == kCCPositionTypeFree || m_ePositionType == kCCPositionTypeRelative);
+    // translate the quads to the correct position, since matrix transform isn't performed in batchnode
+    float offsetX = m_pBatchNode ? m_tPosition.x : 0;
+    float offsetY = m_pBatchNode ? m_tPosition.y : 0;
+
+    for (unsigned int i = uStart; i < uEnd; ++i)
+    {
+        // color
+        d.colorR[i] += d.deltaColorR[i] * dt;
+        d.colorG[i] += d.deltaColorG[i] * dt;
+        d.colorB[i] += d.deltaColorB[i] * dt;
+        d.colorA[i] += d.deltaColorA[i] * dt;
+
+        // size
+        d.size[i] += d.deltaSize[i] * dt;
+        d.size[i] = MAX(0, d.size[i]);
+
+        // angle
+        d.rotation[i] += d.deltaRotation[i] * dt;
+
+        // position of the quad
+        float quadX = d.posX[i];
+        float quadY = d.posY[i];
+        if (bMoveWithEmitter)
+        {
+            quadX -= currentPosition.x - d.startPosX[i];
+            quadY -= currentPosition.y - d.startPosY[i];
+        }
+        d.quadX[i] = quadX + offsetX;
+        d.quadY[i] = quadY + offsetY;
+    }
+}
+
+#endif // CC_PARTICLE_SIMD_SSE || CC_PARTICLE_SIMD_NEON
+
 // ParticleSystem - MainLoop
 void CCParticleSystem::update(float dt)
 {
@@ -596,125 +951,56 @@ void CCParticleSystem::update(float dt)
 
     if (m_bIsVisible)
     {
-        while (m_uParticleIdx < m_uParticleCount)
+        // life
+        float *timeToLive = m_tParticles.timeToLive;
+        for (unsigned int i = 0; i < m_uParticleCount; ++i)
         {
-            tCCParticle *p = &m_pParticles[m_uParticleIdx];
-
-            // life
-            p->timeToLive -= dt;
+            timeToLive[i] -= dt;
+        }
 
-            if (p->timeToLive > 0) 
+        // dead particles are replaced by the last particle
+        while (m_uParticleIdx < m_uParticleCount)
+        {
+            if (timeToLive[m_uParticleIdx] > 0)
             {
-                // Mode A: gravity, direction, tangential accel & radial accel
-                if (m_nEmitterMode == kCCParticleModeGravity) 
-                {
-                    CCPoint tmp, radial, tangential;
-
-                    radial = CCPointZero;
-                    // radial acceleration
-                    if (p->pos.x || p->pos.y)
-                    {
-                        radial = ccpNormalize(p->pos);
-                    }
-                    tangential = radial;
-                    radial = ccpMult(radial, p->modeA.radialAccel);
-
-                    // tangential acceleration
-                    float newy = tangential.x;
-                    tangential.x = -tangential.y;
-                    tangential.y = newy;
-                    tangential = ccpMult(tangential, p->modeA.tangentialAccel);
-
-                    // (gravity + radial + tangential) * dt
-                    tmp = ccpAdd( ccpAdd( radial, tangential), modeA.gravity);
-                    tmp = ccpMult( tmp, dt);
-                    p->modeA.dir = ccpAdd( p->modeA.dir, tmp);
-                    tmp = ccpMult(p->modeA.dir, dt);
-                    p->pos = ccpAdd( p->pos, tmp );
-                }
-
-                // Mode B: radius movement
-                else 
-                {                
-                    // Update the angle and radius of the particle.
-                    p->modeB.angle += p->modeB.degreesPerSecond * dt;
-                    p->modeB.radius += p->modeB.deltaRadius * dt;
-
-                    p->pos.x = - cosf(p->modeB.angle) * p->modeB.radius;
-                    p->pos.y = - sinf(p->modeB.angle) * p->modeB.radius;
-                }
-
-                // color
-                p->color.r += (p->deltaColor.r * dt);
-                p->color.g += (p->deltaColor.g * dt);
-                p->color.b += (p->deltaColor.b * dt);
-                p->color.a += (p->deltaColor.a * dt);
-
-                // size
-                p->size += (p->deltaSize * dt);
-                p->size = MAX( 0, p->size );
-
-                // angle
-                p->rotation += (p->deltaRotation * dt);
-
-                //
-                // update values in quad
-                //
-
-                CCPoint    newPos;
+                ++m_uParticleIdx;
+                continue;
+            }
 
-                if (m_ePositionType == kCCPositionTypeFree || m_ePositionType == kCCPositionTypeRelative) 
-                {
-                    CCPoint diff = ccpSub( currentPosition, p->startPos );
-                    newPos = ccpSub(p->pos, diff);
-                } 
-                else
-                {
-                    newPos = p->pos;
-                }
+            // life < 0
+            unsigned int currentIndex = m_tParticles.atlasIndex[m_uParticleIdx];
+            if( m_uParticleIdx != m_uParticleCount-1 )
+            {
+                copyParticle(m_uParticleIdx, m_uParticleCount-1);
+            }
+            if (m_pBatchNode)
+            {
+                //disable the switched particle
+                m_pBatchNode->disableParticle(m_uAtlasIndex+currentIndex);
 
-                // translate newPos to correct position, since matrix transform isn't performed in batchnode
-                // don't update the particle with the new position information, it will interfere with the radius and tangential calculations
-                if (m_pBatchNode)
-                {
-                    newPos.x+=m_tPosition.x;
-                    newPos.y+=m_tPosition.y;
-                }
+                //switch indexes
+                m_tParticles.atlasIndex[m_uParticleCount-1] = currentIndex;
+            }
 
-                updateQuadWithParticle(p, newPos);
-                //updateParticleImp(self, updateParticleSel, p, newPos);
+            --m_uParticleCount;
 
-                // update particle counter
-                ++m_uParticleIdx;
-            } 
-            else 
+            if( m_uParticleCount == 0 && m_bIsAutoRemoveOnFinish )
             {
-                // life < 0
-                int currentIndex = p->atlasIndex;
-                if( m_uParticleIdx != m_uParticleCount-1 )
-                {
-                    m_pParticles[m_uParticleIdx] = m_pParticles[m_uParticleCount-1];
-                }
-                if (m_pBatchNode)
-                {
-                    //disable the switched particle
-                    m_pBatchNode->disableParticle(m_uAtlasIndex+currentIndex);
-
-                    //switch indexes
-                    m_pParticles[m_uParticleCount-1].atlasIndex = currentIndex;
-                }
-
+                this->unscheduleUpdate();
+                m_pParent->removeChild(this, true);
+                return;
+            }
+        }
 
-                --m_uParticleCount;
+        // simulate a block of particles, then update its quads while its values are still in the cache
+        for (unsigned int uStart = 0; uStart < m_uParticleCount; uStart += kCCParticleUpdateBlockSize)
+        {
+            unsigned int uEnd = MIN(uStart + kCCParticleUpdateBlockSize, m_uParticleCount);
+            updateParticles(uStart, uEnd, dt, currentPosition);
+            updateQuadsWithParticles(uStart, uEnd);
+        }
+        m_uParticleIdx = m_uParticleCount;
 
-                if( m_uParticleCount == 0 && m_bIsAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    m_pParent->removeChild(this, true);
-                    return;
-                }
-            }
-        } //while
         m_bTransformSystemDirty = false;
     }
     if (! m_pBatchNode)
@@ -737,6 +1023,18 @@ void CCParticleSystem::updateQuadWithParticle(tCCParticle* particle, const CCPoi
     // should be overriden
 }
 
+void CCParticleSystem::updateQuadsWithParticles(unsigned int uStart, unsigned int uEnd)
+{
+    tCCParticle particle;
+    for (m_uParticleIdx = uStart; m_uParticleIdx < uEnd; ++m_uParticleIdx)
+    {
+        loadParticle(m_uParticleIdx, &particle);
+        updateQuadWithParticle(&particle, ccp(m_tParticles.quadX[m_uParticleIdx], m_tParticles.quadY[m_uParticleIdx]));
+        // the particle may have been modified
+        storeParticle(m_uParticleIdx, &particle);
+    }
+}
+
 void CCParticleSystem::postStep()
 {
     // should be overriden
@@ -1261,7 +1559,7 @@ void CCParticleSystem::setBatchNode(CCParticleBatchNode* batchNode)
             //each particle needs a unique index
             for (unsigned int i = 0; i < m_uTotalParticles; i++)
             {
-                m_pParticles[i].atlasIndex=i;
+                m_tParticles.atlasIndex[i]=i;
             }
         }
     }
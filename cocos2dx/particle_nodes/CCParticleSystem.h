@@ -125,6 +125,51 @@ typedef struct sCCParticle {
 
 }tCCParticle;
 
+/** @brief Structure of arrays that contains the values of all the particles of a system.
+The values of the particle at index i are posX[i], posY[i], colorR[i]...
+All the arrays are parts of a single 16 bytes aligned allocation and their length is a multiple of 4,
+so the simulation can process 4 particles at once with SSE / NEON instructions.
+@since v2.1
+*/
+typedef struct sCCParticleData {
+    float        *posX, *posY;
+    float        *startPosX, *startPosY;
+
+    float        *colorR, *colorG, *colorB, *colorA;
+    float        *deltaColorR, *deltaColorG, *deltaColorB, *deltaColorA;
+
+    float        *size;
+    float        *deltaSize;
+
+    float        *rotation;
+    float        *deltaRotation;
+
+    float        *timeToLive;
+
+    unsigned int *atlasIndex;
+
+    //! Mode A: direction, radial accel, tangential accel
+    float        *dirX, *dirY;
+    float        *radialAccel;
+    float        *tangentialAccel;
+
+    //! Mode B: radius mode
+    float        *angle;
+    float        *degreesPerSecond;
+    float        *radius;
+    float        *deltaRadius;
+
+    //! position of the quad of each particle, computed by the last update
+    float        *quadX, *quadY;
+
+    //! length of each array
+    unsigned int uStride;
+    //! first array of the block
+    void         *pData;
+    //! allocated memory
+    void         *pMemory;
+}tCCParticleData;
+
 //typedef void (*CC_UPDATE_PARTICLE_IMP)(id, SEL, tCCParticle*, CCPoint);
 
 class CCTexture2D;
@@ -214,8 +259,8 @@ protected:
         float rotatePerSecondVar;
     } modeB;
 
-    //! Array of particles
-    tCCParticle *m_pParticles;
+    //! Values of the particles
+    tCCParticleData m_tParticles;
 
     // color modulate
     //    BOOL colorModulate;
@@ -414,6 +459,12 @@ public:
 
     //! should be overriden by subclasses
     virtual void updateQuadWithParticle(tCCParticle* particle, const CCPoint& newPosition);
+    /** updates the quads of the particles in [uStart, uEnd), once they were simulated.
+    The position of each quad is in m_tParticles.quadX / quadY.
+    The default implementation calls updateQuadWithParticle for each particle.
+    @since v2.1
+    */
+    virtual void updateQuadsWithParticles(unsigned int uStart, unsigned int uEnd);
     //! should be overriden by subclasses
     virtual void postStep();
 
@@ -422,6 +473,20 @@ public:
 
 protected:
     virtual void updateBlendFunc();
+
+    /** allocates zeroed storage for uCapacity particles. The previous particles are discarded.
+    @return false if there is not enough memory. In that case the previous storage is kept.
+    */
+    bool allocParticles(unsigned int uCapacity);
+    void freeParticles();
+    //! copies a particle into the arrays. The atlas index of the slot is not changed
+    void storeParticle(unsigned int uIndex, const tCCParticle* particle);
+    //! copies a particle out of the arrays
+    void loadParticle(unsigned int uIndex, tCCParticle* particle);
+    //! copies all the values, atlas index included, of the particle at uFrom to uTo
+    void copyParticle(unsigned int uTo, unsigned int uFrom);
+    //! integrates the living particles in [uStart, uEnd) and computes the position of their quads
+    void updateParticles(unsigned int uStart, unsigned int uEnd, float dt, const CCPoint& currentPosition);
 };
 
 // end of particle_nodes group
@@ -229,41 +229,24 @@ void CCParticleSystemQuad::setupIndices()
     }
 }
 
-void CCParticleSystemQuad::updateQuadWithParticle(tCCParticle* particle, const CCPoint& newPosition)
+static inline void updateQuad(ccV3F_C4B_T2F_Quad *quad, const ccColor4B& color, float size, float rotation, float x, float y)
 {
-    ccV3F_C4B_T2F_Quad *quad;
-
-    if (m_pBatchNode)
-    {
-        ccV3F_C4B_T2F_Quad *batchQuads = m_pBatchNode->getTextureAtlas()->getQuads();
-        quad = &(batchQuads[m_uAtlasIndex+particle->atlasIndex]);
-    }
-    else
-    {
-        quad = &(m_pQuads[m_uParticleIdx]);
-    }
-    ccColor4B color = (m_bOpacityModifyRGB)
-        ? ccc4( particle->color.r*particle->color.a*255, particle->color.g*particle->color.a*255, particle->color.b*particle->color.a*255, particle->color.a*255)
-        : ccc4( particle->color.r*255, particle->color.g*255, particle->color.b*255, particle->color.a*255);
-
     quad->bl.colors = color;
     quad->br.colors = color;
     quad->tl.colors = color;
     quad->tr.colors = color;
 
     // vertices
-    GLfloat size_2 = particle->size/2;
-    if (particle->rotation) 
+    GLfloat size_2 = size/2;
+    if (rotation) 
     {
         GLfloat x1 = -size_2;
         GLfloat y1 = -size_2;
 
         GLfloat x2 = size_2;
         GLfloat y2 = size_2;
-        GLfloat x = newPosition.x;
-        GLfloat y = newPosition.y;
 
-        GLfloat r = (GLfloat)-CC_DEGREES_TO_RADIANS(particle->rotation);
+        GLfloat r = (GLfloat)-CC_DEGREES_TO_RADIANS(rotation);
         GLfloat cr = cosf(r);
         GLfloat sr = sinf(r);
         GLfloat ax = x1 * cr - y1 * sr + x;
@@ -294,28 +277,81 @@ void CCParticleSystemQuad::updateQuadWithParticle(tCCParticle* particle, const C
     else 
     {
         // bottom-left vertex:
-        quad->bl.vertices.x = newPosition.x - size_2;
-        quad->bl.vertices.y = newPosition.y - size_2;
+        quad->bl.vertices.x = x - size_2;
+        quad->bl.vertices.y = y - size_2;
 
         // bottom-right vertex:
-        quad->br.vertices.x = newPosition.x + size_2;
-        quad->br.vertices.y = newPosition.y - size_2;
+        quad->br.vertices.x = x + size_2;
+        quad->br.vertices.y = y - size_2;
 
         // top-left vertex:
-        quad->tl.vertices.x = newPosition.x - size_2;
-        quad->tl.vertices.y = newPosition.y + size_2;
+        quad->tl.vertices.x = x - size_2;
+        quad->tl.vertices.y = y + size_2;
 
         // top-right vertex:
-        quad->tr.vertices.x = newPosition.x + size_2;
-        quad->tr.vertices.y = newPosition.y + size_2;                
+        quad->tr.vertices.x = x + size_2;
+        quad->tr.vertices.y = y + size_2;                
+    }
+}
+
+static inline ccColor4B quadColor(float r, float g, float b, float a, bool bOpacityModifyRGB)
+{
+    return (bOpacityModifyRGB)
+        ? ccc4( r*a*255, g*a*255, b*a*255, a*255)
+        : ccc4( r*255, g*255, b*255, a*255);
+}
+
+void CCParticleSystemQuad::updateQuadWithParticle(tCCParticle* particle, const CCPoint& newPosition)
+{
+    ccV3F_C4B_T2F_Quad *quad;
+
+    if (m_pBatchNode)
+    {
+        quad = m_pBatchNode->getTextureAtlas()->getQuadsAtIndex(m_uAtlasIndex+particle->atlasIndex, 1);
+    }
+    else
+    {
+        quad = &(m_pQuads[m_uParticleIdx]);
+    }
+    ccColor4B color = quadColor(particle->color.r, particle->color.g, particle->color.b, particle->color.a, m_bOpacityModifyRGB);
+
+    updateQuad(quad, color, particle->size, particle->rotation, newPosition.x, newPosition.y);
+}
+
+void CCParticleSystemQuad::updateQuadsWithParticles(unsigned int uStart, unsigned int uEnd)
+{
+    const tCCParticleData &d = m_tParticles;
+
+    if (m_pBatchNode)
+    {
+        // only the quads of this system are uploaded by the batch node
+        ccV3F_C4B_T2F_Quad *batchQuads = m_pBatchNode->getTextureAtlas()->getQuadsAtIndex(m_uAtlasIndex, m_uTotalParticles);
+        for (unsigned int i = uStart; i < uEnd; ++i)
+        {
+            ccColor4B color = quadColor(d.colorR[i], d.colorG[i], d.colorB[i], d.colorA[i], m_bOpacityModifyRGB);
+            updateQuad(&batchQuads[d.atlasIndex[i]], color, d.size[i], d.rotation[i], d.quadX[i], d.quadY[i]);
+        }
+    }
+    else
+    {
+        for (unsigned int i = uStart; i < uEnd; ++i)
+        {
+            ccColor4B color = quadColor(d.colorR[i], d.colorG[i], d.colorB[i], d.colorA[i], m_bOpacityModifyRGB);
+            updateQuad(&m_pQuads[i], color, d.size[i], d.rotation[i], d.quadX[i], d.quadY[i]);
+        }
     }
 }
+
 void CCParticleSystemQuad::postStep()
 {
     glBindBuffer(GL_ARRAY_BUFFER, m_pBuffersVBO[0] );
+    // every living particle moved: orphan the buffer, so the driver doesn't wait for the GPU to release the previous storage
+    glBufferData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0])*m_uTotalParticles, NULL, GL_DYNAMIC_DRAW);
     glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(m_pQuads[0])*m_uParticleCount, m_pQuads);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+    CC_INCREMENT_GL_UPLOADED_BYTES(sizeof(m_pQuads[0])*m_uParticleCount);
+
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -386,23 +422,20 @@ void CCParticleSystemQuad::setTotalParticles(unsigned int tp)
     if( tp > m_uAllocatedParticles )
     {
         // Allocate new memory
-        size_t particlesSize = tp * sizeof(tCCParticle);
         size_t quadsSize = sizeof(m_pQuads[0]) * tp * 1;
         size_t indicesSize = sizeof(m_pIndices[0]) * tp * 6 * 1;
 
-        tCCParticle* particlesNew = (tCCParticle*)realloc(m_pParticles, particlesSize);
+        bool particlesNew = allocParticles(tp);
         ccV3F_C4B_T2F_Quad* quadsNew = (ccV3F_C4B_T2F_Quad*)realloc(m_pQuads, quadsSize);
         GLushort* indicesNew = (GLushort*)realloc(m_pIndices, indicesSize);
 
         if (particlesNew && quadsNew && indicesNew)
         {
             // Assign pointers
-            m_pParticles = particlesNew;
             m_pQuads = quadsNew;
             m_pIndices = indicesNew;
 
-            // Clear the memory
-            memset(m_pParticles, 0, particlesSize);
+            // Clear the memory, the particles are already cleared
             memset(m_pQuads, 0, quadsSize);
             memset(m_pIndices, 0, indicesSize);
 
@@ -411,7 +444,6 @@ void CCParticleSystemQuad::setTotalParticles(unsigned int tp)
         else
         {
             // Out of memory, failed to resize some array
-            if (particlesNew) m_pParticles = particlesNew;
             if (quadsNew) m_pQuads = quadsNew;
             if (indicesNew) m_pIndices = indicesNew;
 
@@ -426,7 +458,7 @@ void CCParticleSystemQuad::setTotalParticles(unsigned int tp)
         {
             for (unsigned int i = 0; i < m_uTotalParticles; i++)
             {
-                m_pParticles[i].atlasIndex=i;
+                m_tParticles.atlasIndex[i]=i;
             }
         }
 
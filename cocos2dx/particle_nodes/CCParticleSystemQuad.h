@@ -97,6 +97,10 @@ public:
     virtual bool initWithTotalParticles(unsigned int numberOfParticles);
     virtual void setTexture(CCTexture2D* texture);
     virtual void updateQuadWithParticle(tCCParticle* particle, const CCPoint& newPosition);
+    /** writes the quads straight from the particle arrays, updateQuadWithParticle is not called.
+    Subclasses that override updateQuadWithParticle should override this method too.
+    */
+    virtual void updateQuadsWithParticles(unsigned int uStart, unsigned int uEnd);
     virtual void postStep();
     virtual void draw();
     virtual void setBatchNode(CCParticleBatchNode* batchNode);
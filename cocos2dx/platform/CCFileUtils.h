@@ -25,6 +25,7 @@ THE SOFTWARE.
 #define __CC_FILEUTILS_PLATFORM_H__
 
 #include <string>
+#include <vector>
 #include "CCPlatformMacros.h"
 #include "ccTypes.h"
 
@@ -62,6 +63,25 @@ public:
     */
     unsigned char* getFileDataFromZip(const char* pszZipFilePath, const char* pszFileName, unsigned long * pSize);
 
+    /**
+    @brief  Adds a zip archive to the search path of getFileData.
+    File names are looked up in the archives, in the order they were added, before the file system.
+    Full paths are looked up with the resource root path (the bundle on iOS and Mac) removed, so
+    the archives mirror the resource directory.
+    The archive is opened once and its directory is indexed, see ZipFile.
+    @param pszZipFilePath   Path of the archive
+    @param pszPrefix        Prepended to the file names to get the entry names, e.g. "assets/". Can be NULL
+    @return false if the archive can't be opened
+    @since v2.1
+    */
+    bool addSearchArchive(const char* pszZipFilePath, const char* pszPrefix = NULL);
+
+    /**
+    @brief  Removes the archives added with addSearchArchive
+    @since v2.1
+    */
+    void removeAllSearchArchives();
+
     /**
     @brief   Generate the absolute path of the file.
     @param   pszRelativePath     The relative path of the file.
@@ -100,7 +120,19 @@ public:
     bool isPopupNotify();
     
 protected:
+    /// @cond
+    unsigned char* getFileDataFromSearchArchives(const char* pszFileName, const char* pszRootPath, unsigned long * pSize);
+
+    struct SearchArchive
+    {
+        // looked up with ZipFile::sharedZipFile, that opens the archive again if it changed
+        std::string strPath;
+        std::string strPrefix;
+    };
+    /// @endcond
+
     std::string m_obDirectory;
+    std::vector<SearchArchive> m_obSearchArchives;
 };
 
 // end of platform group
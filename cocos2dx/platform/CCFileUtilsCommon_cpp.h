@@ -34,8 +34,10 @@ THE SOFTWARE.
 #include "cocoa/CCString.h"
 #include "CCSAXParser.h"
 #include "support/zip_support/unzip.h"
+#include "support/zip_support/ZipUtils.h"
 
 #include <stack>
+#include <algorithm>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <libxml/xmlmemory.h>
@@ -341,6 +343,14 @@ unsigned char* CCFileUtils::getFileDataFromZip(const char* pszZipFilePath, const
         CC_BREAK_IF(!pszZipFilePath || !pszFileName);
         CC_BREAK_IF(strlen(pszZipFilePath) == 0);
 
+        // the archive is indexed once and stays open
+        ZipFile* pZipFile = ZipFile::sharedZipFile(pszZipFilePath);
+        if (pZipFile)
+        {
+            return pZipFile->getFileData(pszFileName, pSize);
+        }
+
+        // archives that ZipFile can't map are read with minizip
         pFile = unzOpen(pszZipFilePath);
         CC_BREAK_IF(!pFile);
 
@@ -372,6 +382,65 @@ unsigned char* CCFileUtils::getFileDataFromZip(const char* pszZipFilePath, const
     return pBuffer;
 }
 
+bool CCFileUtils::addSearchArchive(const char* pszZipFilePath, const char* pszPrefix)
+{
+    ZipFile* pZipFile = ZipFile::sharedZipFile(pszZipFilePath);
+    if (! pZipFile)
+    {
+        CCLOG("cocos2d: CCFileUtils: can't open the archive %s", pszZipFilePath ? pszZipFilePath : "");
+        return false;
+    }
+
+    SearchArchive archive;
+    archive.strPath = pszZipFilePath;
+    archive.strPrefix = pszPrefix ? pszPrefix : "";
+    m_obSearchArchives.push_back(archive);
+    return true;
+}
+
+void CCFileUtils::removeAllSearchArchives()
+{
+    m_obSearchArchives.clear();
+}
+
+unsigned char* CCFileUtils::getFileDataFromSearchArchives(const char* pszFileName, const char* pszRootPath, unsigned long * pSize)
+{
+    // fullPathFromRelativePath prepends the resource root: the entries are relative to it
+    const char* pszRelativePath = pszFileName;
+    size_t uRootLength = pszRootPath ? strlen(pszRootPath) : 0;
+    if (uRootLength > 0 && strncmp(pszFileName, pszRootPath, uRootLength) == 0)
+    {
+        pszRelativePath += uRootLength;
+    }
+
+    // other absolute paths, e.g. in the writeable path, can't be in the archives
+    if (pszRelativePath[0] == '/' || pszRelativePath[0] == '\\' || (pszRelativePath[0] && pszRelativePath[1] == ':'))
+    {
+        return NULL;
+    }
+
+    std::string entryName;
+    for (std::vector<SearchArchive>::iterator it = m_obSearchArchives.begin(); it != m_obSearchArchives.end(); ++it)
+    {
+        ZipFile* pZipFile = ZipFile::sharedZipFile(it->strPath.c_str());
+        if (! pZipFile)
+        {
+            continue;
+        }
+
+        entryName = it->strPrefix;
+        entryName += pszRelativePath;
+        // zip entry names always use '/'
+        std::replace(entryName.begin(), entryName.end(), '\\', '/');
+        unsigned char* pData = pZipFile->getFileData(entryName.c_str(), pSize);
+        if (pData)
+        {
+            return pData;
+        }
+    }
+    return NULL;
+}
+
 void CCFileUtils::setResourceDirectory(const char* pszResourceDirectory)
 {
     m_obDirectory = pszResourceDirectory;
@@ -34,6 +34,22 @@ NS_CC_BEGIN
  * @{
  */
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+/** Counters of the FreeType face and glyph cache used by CCImage::initWithString.
+ @since v2.1
+ */
+typedef struct _ccFontCacheStats
+{
+    unsigned int faces;         ///< font faces currently open
+    unsigned int faceHits;      ///< strings rendered with an already open face
+    unsigned int faceMisses;    ///< strings that had to open their face
+    unsigned int glyphs;        ///< glyphs currently cached
+    unsigned int glyphBytes;    ///< memory used by the cached glyphs
+    unsigned int glyphHits;     ///< glyph lookups served by the cache
+    unsigned int glyphMisses;   ///< glyph lookups that rasterized the glyph
+} ccFontCacheStats;
+#endif
+
 class CC_DLL CCImage : public CCObject
 {
 public:
@@ -125,6 +141,18 @@ public:
     */
     bool saveToFile(const char *pszFilePath, bool bIsToRGB = true);
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    /** Fills pStats with the counters of the font face and glyph cache.
+     @since v2.1
+     */
+    static void getFontCacheStats(ccFontCacheStats* pStats);
+
+    /** Closes the cached font faces and releases their glyphs.
+     @since v2.1
+     */
+    static void purgeFontCache();
+#endif
+
     CC_SYNTHESIZE_READONLY(unsigned short,   m_nWidth,       Width);
     CC_SYNTHESIZE_READONLY(unsigned short,   m_nHeight,      Height);
     CC_SYNTHESIZE_READONLY(int,     m_nBitsPerComponent,   BitsPerComponent);
@@ -56,6 +56,7 @@ void CCFileUtils::purgeFileUtils()
     }
 
     CC_SAFE_DELETE(s_pFileUtils);
+    ZipFile::purgeSharedZipFiles();
 }
 
 void CCFileUtils::purgeCachedEntries()
@@ -88,6 +89,17 @@ unsigned char* CCFileUtils::getFileData(const char* pszFileName, const char* psz
         return 0;
     }
 
+    // look in the archives added with addSearchArchive first. Resources are read from the apk,
+    // fullPathFromRelativePath doesn't prepend a root to their names
+    if (! m_obSearchArchives.empty())
+    {
+        pData = getFileDataFromSearchArchives(pszFileName, NULL, pSize);
+        if (pData)
+        {
+            return pData;
+        }
+    }
+
     if (pszFileName[0] != '/')
     {
         // read from apk
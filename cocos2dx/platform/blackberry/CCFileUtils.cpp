@@ -49,6 +49,7 @@ void CCFileUtils::purgeFileUtils()
     }
 
     CC_SAFE_DELETE(theFileUtils);
+    ZipFile::purgeSharedZipFiles();
 }
 
 void CCFileUtils::purgeCachedEntries()
@@ -147,6 +148,16 @@ unsigned char* CCFileUtils::getFileData(const char* pszFileName, const char* psz
 		return 0;
 	}
 
+	// look in the archives added with addSearchArchive first
+	if (! m_obSearchArchives.empty())
+	{
+		buffer = getFileDataFromSearchArchives(pszFileName, CCApplication::sharedApplication()->getResourceRootPath(), pSize);
+		if (buffer)
+		{
+			return buffer;
+		}
+	}
+
 	do
 	{
 		full_path = fullPathFromRelativePathThreadSafe(full_path.c_str());
@@ -27,6 +27,7 @@ THE SOFTWARE.
 
 #include <string>
 #include <stack>
+#include <algorithm>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <libxml/xmlmemory.h>
@@ -36,6 +37,7 @@ THE SOFTWARE.
 #include "CCSAXParser.h"
 #include "CCDictionary.h"
 #include "support/zip_support/unzip.h"
+#include "support/zip_support/ZipUtils.h"
 
 #define MAX_PATH 260
 
@@ -161,6 +163,7 @@ void CCFileUtils::purgeFileUtils()
     }
 
     CC_SAFE_DELETE(s_pFileUtils);
+    ZipFile::purgeSharedZipFiles();
 }
 
 void CCFileUtils::purgeCachedEntries()
@@ -266,6 +269,19 @@ unsigned char* CCFileUtils::getFileData(const char* pszFileName, const char* psz
     unsigned char * pBuffer = NULL;
     CCAssert(pszFileName != NULL && pSize != NULL && pszMode != NULL, "Invaild parameters.");
     *pSize = 0;
+
+    // look in the archives added with addSearchArchive first
+    if (! m_obSearchArchives.empty())
+    {
+        std::string strBundlePath = [[[NSBundle mainBundle] resourcePath] UTF8String];
+        strBundlePath += "/";
+        pBuffer = getFileDataFromSearchArchives(pszFileName, strBundlePath.c_str(), pSize);
+        if (pBuffer)
+        {
+            return pBuffer;
+        }
+    }
+
     do 
     {
         // read the file from hardware
@@ -324,7 +340,15 @@ unsigned char* CCFileUtils::getFileDataFromZip(const char* pszZipFilePath, const
         {
             CC_BREAK_IF(!pszZipFilePath || !pszFileName);
             CC_BREAK_IF(strlen(pszZipFilePath) == 0);
-    
+
+            // the archive is indexed once and stays open
+            ZipFile* pZipFile = ZipFile::sharedZipFile(pszZipFilePath);
+            if (pZipFile)
+            {
+                return pZipFile->getFileData(pszFileName, pSize);
+            }
+
+            // archives that ZipFile can't map are read with minizip
             pFile = unzOpen(pszZipFilePath);
             CC_BREAK_IF(!pFile);
     
@@ -356,5 +380,64 @@ unsigned char* CCFileUtils::getFileDataFromZip(const char* pszZipFilePath, const
             return pBuffer;
 }
 
+bool CCFileUtils::addSearchArchive(const char* pszZipFilePath, const char* pszPrefix)
+{
+    ZipFile* pZipFile = ZipFile::sharedZipFile(pszZipFilePath);
+    if (! pZipFile)
+    {
+        CCLOG("cocos2d: CCFileUtils: can't open the archive %s", pszZipFilePath ? pszZipFilePath : "");
+        return false;
+    }
+
+    SearchArchive archive;
+    archive.strPath = pszZipFilePath;
+    archive.strPrefix = pszPrefix ? pszPrefix : "";
+    m_obSearchArchives.push_back(archive);
+    return true;
+}
+
+void CCFileUtils::removeAllSearchArchives()
+{
+    m_obSearchArchives.clear();
+}
+
+unsigned char* CCFileUtils::getFileDataFromSearchArchives(const char* pszFileName, const char* pszRootPath, unsigned long * pSize)
+{
+    // fullPathFromRelativePath prepends the resource root: the entries are relative to it
+    const char* pszRelativePath = pszFileName;
+    size_t uRootLength = pszRootPath ? strlen(pszRootPath) : 0;
+    if (uRootLength > 0 && strncmp(pszFileName, pszRootPath, uRootLength) == 0)
+    {
+        pszRelativePath += uRootLength;
+    }
+
+    // other absolute paths, e.g. in the writeable path, can't be in the archives
+    if (pszRelativePath[0] == '/' || pszRelativePath[0] == '\\' || (pszRelativePath[0] && pszRelativePath[1] == ':'))
+    {
+        return NULL;
+    }
+
+    std::string entryName;
+    for (std::vector<SearchArchive>::iterator it = m_obSearchArchives.begin(); it != m_obSearchArchives.end(); ++it)
+    {
+        ZipFile* pZipFile = ZipFile::sharedZipFile(it->strPath.c_str());
+        if (! pZipFile)
+        {
+            continue;
+        }
+
+        entryName = it->strPrefix;
+        entryName += pszRelativePath;
+        // zip entry names always use '/'
+        std::replace(entryName.begin(), entryName.end(), '\\', '/');
+        unsigned char* pData = pZipFile->getFileData(entryName.c_str(), pSize);
+        if (pData)
+        {
+            return pData;
+        }
+    }
+    return NULL;
+}
+
 NS_CC_END
 
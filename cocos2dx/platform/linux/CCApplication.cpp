@@ -6,7 +6,9 @@
  */
 #include "CCApplication.h"
 #include <unistd.h>
-#include <sys/time.h>
+#include <time.h>
+#include <sched.h>
+#include <errno.h>
 #include <string>
 #include "CCDirector.h"
 
@@ -18,16 +20,16 @@ static std::string s_strRootResPath = "";
 // sharedApplication pointer
 CCApplication * CCApplication::sm_pSharedApplication = 0;
 
-static long getCurrentMillSecond() {
-	long lLastTime;
-	struct timeval stCurrentTime;
-
-	gettimeofday(&stCurrentTime,NULL);
-	lLastTime = stCurrentTime.tv_sec*1000+stCurrentTime.tv_usec*0.001; //millseconds
-	return lLastTime;
+// microseconds of the monotonic clock, which doesn't jump when the wall clock is set
+static long long getCurrentMicroSecond() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
 }
 
 CCApplication::CCApplication()
+: m_lAnimationInterval(1000000 / 60)
+, m_lSpinTime(1000)
 {
 	CC_ASSERT(! sm_pSharedApplication);
 	sm_pSharedApplication = this;
@@ -37,7 +39,6 @@ CCApplication::~CCApplication()
 {
 	CC_ASSERT(this == sm_pSharedApplication);
 	sm_pSharedApplication = NULL;
-	m_nAnimationInterval = 1.0f/60.0f*1000.0f;
 }
 
 int CCApplication::run()
@@ -49,22 +50,58 @@ int CCApplication::run()
 	}
 
 
+#if CC_HEADLESS
+	// nothing is displayed, the frames are run as fast as possible
+	for (;;) {
+		CCDirector::sharedDirector()->mainLoop();
+	}
+#else
+	long long lNextFrame = getCurrentMicroSecond();
 	for (;;) {
-		long iLastTime = getCurrentMillSecond();
 		CCDirector::sharedDirector()->mainLoop();
-		long iCurTime = getCurrentMillSecond();
-		if (iCurTime-iLastTime<m_nAnimationInterval){
-			usleep((m_nAnimationInterval - iCurTime+iLastTime)*1000);
-		}
 
+		// frames start every interval, so a slow frame doesn't delay the next ones
+		lNextFrame += m_lAnimationInterval;
+		long long lNow = getCurrentMicroSecond();
+		if (lNow - lNextFrame > m_lAnimationInterval)
+		{
+			// more than a frame late: start again from now rather than running the late frames back to back
+			lNextFrame = lNow;
+		}
+		waitUntil(lNextFrame);
 	}
+#endif
 	return -1;
 }
 
+void CCApplication::waitUntil(long long lTime)
+{
+	// the kernel may wake the thread up late, so it sleeps until m_lSpinTime before the frame and spins afterwards
+	long long lWakeUp = lTime - m_lSpinTime;
+	if (lWakeUp > getCurrentMicroSecond())
+	{
+		struct timespec ts;
+		ts.tv_sec = lWakeUp / 1000000;
+		ts.tv_nsec = (lWakeUp % 1000000) * 1000;
+		while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+		{
+		}
+	}
+
+	while (getCurrentMicroSecond() < lTime)
+	{
+		sched_yield();
+	}
+}
+
 void CCApplication::setAnimationInterval(double interval)
 {
-	//TODO do something else
-	m_nAnimationInterval = interval*1000.0f;
+	m_lAnimationInterval = (long long)(interval * 1000000);
+}
+
+void CCApplication::setFramePacerSpinTime(long lMicroSeconds)
+{
+	m_lSpinTime = MAX(lMicroSeconds, 0);
 }
 
 void CCApplication::setResourceRootPath(const char* pszRootResDir)
@@ -26,6 +26,14 @@ public:
 	 */
 	void setAnimationInterval(double interval);
 
+	/**
+	 @brief	The frames are paced with the monotonic clock: the loop sleeps until lMicroSeconds before
+	         the next frame, and spins until the frame is due, because the kernel may wake it up late.
+	         The default, 1000, starts the frames within a few microseconds. 0 only sleeps and uses less CPU.
+	 @since v2.1
+	 */
+	void setFramePacerSpinTime(long lMicroSeconds);
+
 	/**
 	 @brief	Run the message loop.
 	 */
@@ -51,7 +59,10 @@ public:
      */
     virtual TargetPlatform getTargetPlatform();
 protected:
-    long       m_nAnimationInterval;  //micro second
+	void waitUntil(long long lTime);
+
+    long long  m_lAnimationInterval;  //micro second
+    long       m_lSpinTime;           //micro second
 
 	static CCApplication * sm_pSharedApplication;
 };
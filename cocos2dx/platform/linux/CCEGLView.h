@@ -41,6 +41,21 @@ public:
 	 @brief	get the shared main open gl window
 	 */
 	static CCEGLView* sharedOpenGLView();
+
+#if CC_HEADLESS
+	/**
+	 @brief	Headless builds only. The director is ended after uFrames frames, 0 runs until it is ended.
+	 When the director is purged, the time spent in the phases of the frames and the OpenGL calls are logged.
+	 @since v2.1
+	 */
+	void setFrameLimit(unsigned int uFrames);
+	unsigned int getFrameLimit();
+	/** number of frames presented by the view */
+	unsigned int getFrames();
+	/** logs the frame times, the phase times recorded by CCFrameProfiler and the OpenGL counters,
+	 called by CCDirector::purgeDirector before the profiler is purged */
+	void logReport();
+#endif
 private:
     bool initGL();
     void destroyGL();
@@ -49,6 +64,11 @@ private:
 	//store current mouse point for moving, valid if and only if the mouse pressed
 	CCPoint m_mousePoint;
 	bool bIsInit;
+#if CC_HEADLESS
+	unsigned int m_uFrames;
+	unsigned int m_uFrameLimit;
+	long long m_lStartTime;
+#endif
 };
 
 NS_CC_END
@@ -0,0 +1,172 @@
+/****************************************************************************
+Copyright (c) 2010-2012 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+/*
+ * CCEGLView of the headless builds (CC_HEADLESS=1), compiled instead of CCEGLView.cpp.
+ * There is no window and no input: the frames are drawn with the null OpenGL of CCNullGL.cpp.
+ */
+
+#include "CCEGLView.h"
+#include "CCNullGL.h"
+#include "ccMacros.h"
+#include "CCDirector.h"
+#include "support/CCProfiling.h"
+
+NS_CC_BEGIN
+
+// more than the phases recorded by the engine
+#define kMaxReportedPhases 32
+
+CCEGLView::CCEGLView()
+: bIsInit(false)
+, m_uFrames(0)
+, m_uFrameLimit(0)
+, m_lStartTime(0)
+{
+}
+
+CCEGLView::~CCEGLView()
+{
+}
+
+void CCEGLView::setFrameSize(float width, float height)
+{
+	CCAssert(width!=0&&height!=0, "invalid window's size equal 0");
+
+	CCEGLViewProtocol::setFrameSize(width, height);
+	initGL();
+	bIsInit = true;
+}
+
+bool CCEGLView::isOpenGLReady()
+{
+	return bIsInit;
+}
+
+void CCEGLView::end()
+{
+	delete this;
+	exit(0);
+}
+
+void CCEGLView::swapBuffers()
+{
+	if (! bIsInit)
+	{
+		return;
+	}
+
+	m_uFrames++;
+	if (m_uFrameLimit && m_uFrames == m_uFrameLimit)
+	{
+		CCDirector::sharedDirector()->end();
+	}
+}
+
+void CCEGLView::setIMEKeyboardState(bool bOpen)
+{
+
+}
+
+bool CCEGLView::initGL()
+{
+	ccNullGLResetCounters();
+	m_lStartTime = CCFrameProfiler::now();
+#if CC_ENABLE_FRAME_PROFILER
+	CCFrameProfiler::sharedFrameProfiler()->reset();
+	CCFrameProfiler::sharedFrameProfiler()->start();
+#endif
+	CCLog("cocos2d: headless view, OpenGL calls are not executed");
+	return true;
+}
+
+void CCEGLView::destroyGL()
+{
+}
+
+void CCEGLView::setFrameLimit(unsigned int uFrames)
+{
+	m_uFrameLimit = uFrames;
+}
+
+unsigned int CCEGLView::getFrameLimit()
+{
+	return m_uFrameLimit;
+}
+
+unsigned int CCEGLView::getFrames()
+{
+	return m_uFrames;
+}
+
+void CCEGLView::logReport()
+{
+	double dElapsed = (CCFrameProfiler::now() - m_lStartTime) / 1000.0;
+	CCLog("cocos2d: %u frames in %.1f ms", m_uFrames, dElapsed);
+
+#if CC_ENABLE_FRAME_PROFILER
+	ccProfilerPhase pPhases[kMaxReportedPhases];
+	unsigned int uPhases = CCFrameProfiler::sharedFrameProfiler()->getPhaseTimes(pPhases, kMaxReportedPhases);
+
+	// the ring buffer may only hold the last frames
+	unsigned int uProfiledFrames = 0;
+	for (unsigned int i = 0; i < uPhases; ++i)
+	{
+		if (strcmp(pPhases[i].name, "frame") == 0)
+		{
+			uProfiledFrames = pPhases[i].calls;
+		}
+	}
+
+	if (uProfiledFrames)
+	{
+		CCLog("cocos2d: phase times of the last %u frames, in ms per frame (longest):", uProfiledFrames);
+		for (unsigned int i = 0; i < uPhases; ++i)
+		{
+			CCLog("  %-20s %9.4f (%.3f)", pPhases[i].name, pPhases[i].total / 1000.0 / uProfiledFrames, pPhases[i].longest / 1000.0);
+		}
+	}
+#endif
+
+	const ccNullGLCounters& counters = ccNullGLGetCounters();
+	unsigned int uFrames = MAX(m_uFrames, 1);
+	CCLog("cocos2d: OpenGL per frame: %.1f calls, %.1f draw calls, %.0f vertices, %.1f texture binds, "
+		"%.1f program changes, %.1f uniform updates, %.0f bytes of buffer uploads, %.0f bytes of texture uploads",
+		(double)counters.calls / uFrames, (double)counters.drawCalls / uFrames, (double)counters.vertices / uFrames,
+		(double)counters.textureBinds / uFrames, (double)counters.programChanges / uFrames,
+		(double)counters.uniformUpdates / uFrames, (double)counters.bufferUploadBytes / uFrames,
+		(double)counters.textureUploadBytes / uFrames);
+}
+
+CCEGLView* CCEGLView::sharedOpenGLView()
+{
+	static CCEGLView* s_pEglView = NULL;
+	if (s_pEglView == NULL)
+	{
+		s_pEglView = new CCEGLView();
+	}
+	return s_pEglView;
+}
+
+NS_CC_END
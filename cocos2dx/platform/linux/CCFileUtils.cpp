@@ -39,6 +39,7 @@ void CCFileUtils::purgeFileUtils()
     }
     
     CC_SAFE_DELETE(s_pFileUtils);
+    ZipFile::purgeSharedZipFiles();
 }
 
 void CCFileUtils::purgeCachedEntries()
@@ -104,6 +105,16 @@ unsigned char* CCFileUtils::getFileData(const char* pszFileName, const char* psz
 		return 0;
 	}
 
+	// look in the archives added with addSearchArchive first
+	if (! m_obSearchArchives.empty())
+	{
+		pData = getFileDataFromSearchArchives(pszFileName, CCApplication::sharedApplication()->getResourceRootPath(), pSize);
+		if (pData)
+		{
+			return pData;
+		}
+	}
+
 	do
 	{
 		fullPath = fullPathFromRelativePath(fullPath.c_str());
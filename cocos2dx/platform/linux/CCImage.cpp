@@ -27,6 +27,27 @@ struct TextLine {
 };
 
 NS_CC_BEGIN
+
+/** A glyph of a cached face: its metrics and its 8 bit gray bitmap. */
+struct GlyphInfo {
+	FT_Glyph_Metrics metrics;
+	int iBitmapWidth;
+	int iBitmapRows;
+	unsigned char* pBitmap;
+};
+
+/** A face opened for a font file at a pixel size, with the glyphs rendered from it. */
+struct FontFace {
+	string sFontName;
+	unsigned int uPixelSize;
+	FT_Face face;
+	// the text is rendered byte by byte, so 256 slots cover every glyph
+	GlyphInfo* pGlyphs[256];
+	unsigned int uGlyphCount;
+	unsigned int uGlyphBytes;
+	unsigned int uLastUsed;
+};
+
 class BitmapDC
 {
 public:
@@ -34,10 +55,14 @@ public:
 		libError = FT_Init_FreeType( &library );
 		iInterval = szFont_kenning;
 		m_pData = NULL;
+		m_uUseCounter = 0;
+		m_uGlyphBytes = 0;
+		memset(&m_tStats, 0, sizeof(m_tStats));
 		reset();
 	}
 
 	~BitmapDC() {
+		purgeFontCache();
 		FT_Done_FreeType(library);
 		//data will be deleted by CCImage
 //		if (m_pData) {
@@ -52,15 +77,171 @@ public:
 		vLines.clear();
 	}
 
-	void buildLine(stringstream& ss, FT_Face face, int iCurXCursor, char cLastChar) {
+	/**
+	 * return the face of the font at the pixel size, opening it on the first use
+	 * and closing the least recently used face when the cache is full
+	 */
+	FontFace* getFontFace(const char* pFontName, unsigned int uPixelSize) {
+		for (size_t i = 0; i < m_vFaces.size(); i++) {
+			FontFace* pFace = m_vFaces[i];
+			if (pFace->uPixelSize == uPixelSize && pFace->sFontName == pFontName) {
+				pFace->uLastUsed = ++m_uUseCounter;
+				m_tStats.faceHits++;
+				return pFace;
+			}
+		}
+		m_tStats.faceMisses++;
+
+		FT_Face face;
+		FT_Error iError = FT_New_Face( library, pFontName, 0, &face );
+		if (iError) {
+			//no valid font found use default
+//			CCLog("no valid font, use default %s\n", pFontName);
+			iError = FT_New_Face( library, "/usr/share/fonts/truetype/freefont/FreeSerif.ttf", 0, &face );
+		}
+		if (iError) {
+			return NULL;
+		}
+
+		//select utf8 charmap
+		if (FT_Select_Charmap(face, FT_ENCODING_UNICODE)
+				|| FT_Set_Pixel_Sizes(face, uPixelSize, uPixelSize)) {
+			FT_Done_Face(face);
+			return NULL;
+		}
+
+		if (m_vFaces.size() >= CC_FONT_CACHE_MAX_FACES) {
+			size_t uOldest = 0;
+			for (size_t i = 1; i < m_vFaces.size(); i++) {
+				if (m_vFaces[i]->uLastUsed < m_vFaces[uOldest]->uLastUsed) {
+					uOldest = i;
+				}
+			}
+			releaseFontFace(m_vFaces[uOldest]);
+			m_vFaces.erase(m_vFaces.begin() + uOldest);
+		}
+
+		FontFace* pFace = new FontFace();
+		pFace->sFontName = pFontName;
+		pFace->uPixelSize = uPixelSize;
+		pFace->face = face;
+		memset(pFace->pGlyphs, 0, sizeof(pFace->pGlyphs));
+		pFace->uGlyphCount = 0;
+		pFace->uGlyphBytes = 0;
+		pFace->uLastUsed = ++m_uUseCounter;
+		m_vFaces.push_back(pFace);
+		return pFace;
+	}
+
+	/**
+	 * return the metrics and bitmap of a character, rendering it on the first use
+	 *
+	 * the glyph stays valid until the next call of trimGlyphCache
+	 */
+	const GlyphInfo* getGlyph(FontFace* pFace, char cText) {
+		GlyphInfo* pGlyph = pFace->pGlyphs[(unsigned char)cText];
+		if (pGlyph) {
+			m_tStats.glyphHits++;
+			return pGlyph;
+		}
+		m_tStats.glyphMisses++;
+
+		FT_Face face = pFace->face;
+		if (FT_Load_Glyph(face, FT_Get_Char_Index(face, cText), FT_LOAD_RENDER)) {
+			return NULL;
+		}
+
+		FT_Bitmap & bitmap = face->glyph->bitmap;
+		unsigned int uBitmapSize = bitmap.width * bitmap.rows;
+		pGlyph = new GlyphInfo();
+		pGlyph->metrics = face->glyph->metrics;
+		pGlyph->iBitmapWidth = bitmap.width;
+		pGlyph->iBitmapRows = bitmap.rows;
+		pGlyph->pBitmap = NULL;
+		if (uBitmapSize > 0) {
+			pGlyph->pBitmap = new unsigned char[uBitmapSize];
+			for (int i = 0; i < (int)bitmap.rows; ++i) {
+				memcpy(pGlyph->pBitmap + i * bitmap.width,
+						bitmap.buffer + i * bitmap.pitch, bitmap.width);
+			}
+		}
+
+		unsigned int uBytes = sizeof(GlyphInfo) + uBitmapSize;
+		pFace->pGlyphs[(unsigned char)cText] = pGlyph;
+		pFace->uGlyphCount++;
+		pFace->uGlyphBytes += uBytes;
+		m_uGlyphBytes += uBytes;
+		return pGlyph;
+	}
+
+	/**
+	 * keep the cached glyphs under CC_FONT_CACHE_GLYPH_MEMORY by dropping the glyphs
+	 * of the least recently used faces, pCurrentFace last
+	 */
+	void trimGlyphCache(FontFace* pCurrentFace) {
+		while (m_uGlyphBytes > CC_FONT_CACHE_GLYPH_MEMORY) {
+			FontFace* pOldest = NULL;
+			for (size_t i = 0; i < m_vFaces.size(); i++) {
+				FontFace* pFace = m_vFaces[i];
+				if (pFace != pCurrentFace && pFace->uGlyphCount > 0
+						&& (!pOldest || pFace->uLastUsed < pOldest->uLastUsed)) {
+					pOldest = pFace;
+				}
+			}
+			if (!pOldest) {
+				releaseGlyphs(pCurrentFace);
+				break;
+			}
+			releaseGlyphs(pOldest);
+		}
+	}
+
+	void releaseGlyphs(FontFace* pFace) {
+		for (int i = 0; i < 256; i++) {
+			if (pFace->pGlyphs[i]) {
+				CC_SAFE_DELETE_ARRAY(pFace->pGlyphs[i]->pBitmap);
+				CC_SAFE_DELETE(pFace->pGlyphs[i]);
+			}
+		}
+		m_uGlyphBytes -= pFace->uGlyphBytes;
+		pFace->uGlyphCount = 0;
+		pFace->uGlyphBytes = 0;
+	}
+
+	void releaseFontFace(FontFace* pFace) {
+		releaseGlyphs(pFace);
+		FT_Done_Face(pFace->face);
+		delete pFace;
+	}
+
+	void purgeFontCache() {
+		for (size_t i = 0; i < m_vFaces.size(); i++) {
+			releaseFontFace(m_vFaces[i]);
+		}
+		m_vFaces.clear();
+	}
+
+	void getFontCacheStats(ccFontCacheStats* pStats) {
+		*pStats = m_tStats;
+		pStats->faces = (unsigned int)m_vFaces.size();
+		pStats->glyphs = 0;
+		for (size_t i = 0; i < m_vFaces.size(); i++) {
+			pStats->glyphs += m_vFaces[i]->uGlyphCount;
+		}
+		pStats->glyphBytes = m_uGlyphBytes;
+	}
+
+	void buildLine(stringstream& ss, FontFace* pFace, int iCurXCursor, char cLastChar) {
 		TextLine oTempLine;
 		ss << '\0';
 		oTempLine.sLineStr = ss.str();
 		//get last glyph
-		FT_Load_Glyph(face, FT_Get_Char_Index(face, cLastChar),
-				FT_LOAD_DEFAULT);
+		const GlyphInfo* pGlyph = getGlyph(pFace, cLastChar);
 
-        oTempLine.iLineWidth = iCurXCursor - SHIFT6((face->glyph->metrics.horiAdvance + face->glyph->metrics.horiBearingX - face->glyph->metrics.width))/*-iInterval*/;//TODO interval
+		oTempLine.iLineWidth = iCurXCursor;
+		if (pGlyph) {
+			oTempLine.iLineWidth -= SHIFT6((pGlyph->metrics.horiAdvance + pGlyph->metrics.horiBearingX - pGlyph->metrics.width))/*-iInterval*/;//TODO interval
+		}
 		iMaxLineWidth = MAX(iMaxLineWidth, oTempLine.iLineWidth);
 
 		ss.clear();
@@ -68,16 +249,14 @@ public:
 		vLines.push_back(oTempLine);
 	}
 
-	bool divideString(FT_Face face, const char* sText, int iMaxWidth, int iMaxHeight) {
+	bool divideString(FontFace* pFace, const char* sText, int iMaxWidth, int iMaxHeight) {
 		const char* pText = sText;
-		int iError = 0;
-		int iCurXCursor, iCurYCursor;
-		iError = FT_Load_Glyph(face, FT_Get_Char_Index(face, *pText),
-				FT_LOAD_DEFAULT);
-		if (iError) {
+		int iCurXCursor;
+		const GlyphInfo* pGlyph = getGlyph(pFace, *pText);
+		if (!pGlyph) {
 			return false;
 		}
-		iCurXCursor = -SHIFT6(face->glyph->metrics.horiBearingX);
+		iCurXCursor = -SHIFT6(pGlyph->metrics.horiBearingX);
 
 		//init stringstream
 		stringstream ss;
@@ -86,46 +265,39 @@ public:
 
 		while (*pText != '\0') {
 			if (*pText == '\n') {
-				buildLine(ss, face, iCurXCursor, cLastCh);
+				buildLine(ss, pFace, iCurXCursor, cLastCh);
 
 				pText++;
-				iError = FT_Load_Glyph(face, FT_Get_Char_Index(face, *pText),
-						FT_LOAD_DEFAULT);
-				if (iError) {
+				pGlyph = getGlyph(pFace, *pText);
+				if (!pGlyph) {
 					return false;
 				}
-				iCurXCursor = -SHIFT6(face->glyph->metrics.horiBearingX);
+				iCurXCursor = -SHIFT6(pGlyph->metrics.horiBearingX);
 				continue;
 			}
 
-			iError = FT_Load_Glyph(face, FT_Get_Char_Index(face, *pText),
-					FT_LOAD_DEFAULT);
-
-			if (iError) {
+			pGlyph = getGlyph(pFace, *pText);
+			if (!pGlyph) {
 				return false;
-				//break;
 			}
 			//check its width
 			//divide it when exceeding
 			if ((iMaxWidth > 0
-							&& iCurXCursor + SHIFT6(face->glyph->metrics.width)
+							&& iCurXCursor + SHIFT6(pGlyph->metrics.width)
 							> iMaxWidth)) {
-				buildLine(ss, face , iCurXCursor, cLastCh);
+				buildLine(ss, pFace, iCurXCursor, cLastCh);
 
-				iCurXCursor = -SHIFT6(face->glyph->metrics.horiBearingX);
+				iCurXCursor = -SHIFT6(pGlyph->metrics.horiBearingX);
 			}
 
 			cLastCh = *pText;
 			ss << *pText;
-			iCurXCursor += SHIFT6(face->glyph->metrics.horiAdvance) + iInterval;
+			iCurXCursor += SHIFT6(pGlyph->metrics.horiAdvance) + iInterval;
 			pText++;
 
 		}
-		if (iError) {
-			return false;
-		}
 
-		buildLine(ss,face, iCurXCursor, cLastCh);
+		buildLine(ss, pFace, iCurXCursor, cLastCh);
 
 		return true;
 	}
@@ -137,25 +309,24 @@ public:
 	 * while -1 means fail
 	 *
 	 */
-	int computeLineStart(FT_Face face, CCImage::ETextAlign eAlignMask, char cText,
+	int computeLineStart(FontFace* pFace, CCImage::ETextAlign eAlignMask, char cText,
 			int iLineIndex) {
 		int iRet;
-		int iError = FT_Load_Glyph(face, FT_Get_Char_Index(face, cText),
-				FT_LOAD_DEFAULT);
-		if (iError) {
+		const GlyphInfo* pGlyph = getGlyph(pFace, cText);
+		if (!pGlyph) {
 			return -1;
 		}
 
 		if (eAlignMask == CCImage::kAlignCenter) {
 			iRet = (iMaxLineWidth - vLines[iLineIndex].iLineWidth) / 2
-			- SHIFT6(face->glyph->metrics.horiBearingX );
+			- SHIFT6(pGlyph->metrics.horiBearingX );
 
 		} else if (eAlignMask == CCImage::kAlignRight) {
 			iRet = (iMaxLineWidth - vLines[iLineIndex].iLineWidth)
-			- SHIFT6(face->glyph->metrics.horiBearingX );
+			- SHIFT6(pGlyph->metrics.horiBearingX );
 		} else {
 			// left or other situation
-			iRet = -SHIFT6(face->glyph->metrics.horiBearingX );
+			iRet = -SHIFT6(pGlyph->metrics.horiBearingX );
 		}
 		return iRet;
 	}
@@ -180,7 +351,6 @@ public:
 	}
 
 	bool getBitmap(const char *text, int nWidth, int nHeight, CCImage::ETextAlign eAlignMask, const char * pFontName, float fontSize) {
-		FT_Face face;
 		FT_Error iError;
 
 		const char* pText = text;
@@ -195,23 +365,14 @@ public:
 			return false;
 		}
 		do {
-			iError = FT_New_Face( library, pFontName, 0, &face );
-
-			if (iError) {
-				//no valid font found use default
-//				CCLog("no valid font, use default %s\n", pFontName);
-				iError = FT_New_Face( library, "/usr/share/fonts/truetype/freefont/FreeSerif.ttf", 0, &face );
-			}
-			CC_BREAK_IF(iError);
+			FontFace* pFace = getFontFace(pFontName, (unsigned int)fontSize);
+			CC_BREAK_IF(! pFace);
+			FT_Face face = pFace->face;
 
-			//select utf8 charmap
-			iError = FT_Select_Charmap(face,FT_ENCODING_UNICODE);
-			CC_BREAK_IF(iError);
+			// the glyphs returned by getGlyph stay valid until the next trim
+			trimGlyphCache(pFace);
 
-			iError = FT_Set_Pixel_Sizes(face, fontSize,fontSize);
-			CC_BREAK_IF(iError);
-
-			iError = divideString(face, text, nWidth, nHeight)?0:1;
+			iError = divideString(pFace, text, nWidth, nHeight)?0:1;
 
 			//compute the final line width
 			iMaxLineWidth = MAX(iMaxLineWidth, nWidth);
@@ -233,46 +394,36 @@ public:
             for (size_t i = 0; i < vLines.size(); i++) {
 				pText = vLines[i].sLineStr.c_str();
 				//initialize the origin cursor
-				iCurXCursor = computeLineStart(face, eAlignMask, *pText, i);
+				iCurXCursor = computeLineStart(pFace, eAlignMask, *pText, i);
 
 				while (*pText != 0) {
-					int iError = FT_Load_Glyph(face, FT_Get_Char_Index(face, *pText),
-							FT_LOAD_RENDER);
-					if (iError) {
+					const GlyphInfo* pGlyph = getGlyph(pFace, *pText);
+					if (!pGlyph) {
 						break;
 					}
 
-					//  convert glyph to bitmap with 256 gray
-					//  and get the bitmap
-					FT_Bitmap & bitmap = face->glyph->bitmap;
+					//  the cached bitmap with 256 gray
+					const unsigned char* pBitmap = pGlyph->pBitmap;
 
-					for (int i = 0; i < bitmap.rows; ++i) {
-						for (int j = 0; j < bitmap.width; ++j) {
+					for (int i = 0; i < pGlyph->iBitmapRows; ++i) {
+						for (int j = 0; j < pGlyph->iBitmapWidth; ++j) {
 							//  if it has gray>0 we set show it as 1, o otherwise
 							int iY = iCurYCursor + i
-							- (face->glyph->metrics.horiBearingY
+							- (pGlyph->metrics.horiBearingY
 									>> 6);
 							int iX = iCurXCursor
-							+ (face->glyph->metrics.horiBearingX
+							+ (pGlyph->metrics.horiBearingX
 									>> 6) + j;
 
-							if (iY>=iMaxLineHeight) {
-								//exceed the height truncate
+							if (iY>=iMaxLineHeight || iY<0
+									|| iX>=iMaxLineWidth || iX<0) {
+								//exceed the bitmap truncate
 								continue;
 							}
 
-//							m_pData[(iY * iMaxLineWidth + iX) * 4 + 3] =
-//							bitmap.buffer[i * bitmap.width + j] ?
-//							0xff : 0;//alpha
-//							m_pData[(iY * iMaxLineWidth + iX) * 4 + 1] =
-//							bitmap.buffer[i * bitmap.width + j];//R
-//							m_pData[(iY * iMaxLineWidth + iX) * 4 + 2] =
-//							bitmap.buffer[i * bitmap.width + j];//G
-//							m_pData[(iY * iMaxLineWidth + iX) * 4 + 0] =
-//							bitmap.buffer[i * bitmap.width + j];//B
 							int iTemp = 0;
-							unsigned char cTemp = bitmap.buffer[i
-							* bitmap.width + j];
+							unsigned char cTemp = pBitmap[i
+							* pGlyph->iBitmapWidth + j];
 							iTemp |= (cTemp ? 0xff : 0)<<24;
 							iTemp |= cTemp << 16 | cTemp << 8 | cTemp;
 							*(int*) &m_pData[(iY * iMaxLineWidth + iX)
@@ -280,7 +431,7 @@ public:
 						}
 					}
 					//step to next glyph
-					iCurXCursor += (face->glyph->metrics.horiAdvance >> 6)
+					iCurXCursor += (pGlyph->metrics.horiAdvance >> 6)
 					+ iInterval;
 
 					pText++;
@@ -297,10 +448,6 @@ public:
 //				printf("\n");
 //			}
 
-			//  free face
-			FT_Done_Face(face);
-			face = NULL;
-
 			//clear all lines
 			vLines.clear();
 
@@ -321,6 +468,12 @@ public:
 	int iInterval;
 	int iMaxLineWidth;
 	int iMaxLineHeight;
+
+private:
+	vector<FontFace*> m_vFaces;
+	unsigned int m_uUseCounter;
+	unsigned int m_uGlyphBytes;
+	ccFontCacheStats m_tStats;
 };
 
 static BitmapDC& sharedBitmapDC()
@@ -367,4 +520,14 @@ bool CCImage::initWithString(
 	return bRet;
 }
 
+void CCImage::getFontCacheStats(ccFontCacheStats* pStats)
+{
+	sharedBitmapDC().getFontCacheStats(pStats);
+}
+
+void CCImage::purgeFontCache()
+{
+	sharedBitmapDC().purgeFontCache();
+}
+
 NS_CC_END
@@ -0,0 +1,603 @@
+/****************************************************************************
+Copyright (c) 2010-2012 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+/*
+ * OpenGL without a context, linked instead of libGL and GLEW by headless builds.
+ * The OpenGL 1.1 functions are defined here, the later ones are the GLEW function pointers.
+ */
+
+#include "CCGL.h"
+#include "CCNullGL.h"
+
+USING_NS_CC;
+
+static ccNullGLCounters s_counters;
+
+NS_CC_BEGIN
+
+const ccNullGLCounters& ccNullGLGetCounters()
+{
+    return s_counters;
+}
+
+void ccNullGLResetCounters()
+{
+    memset(&s_counters, 0, sizeof(s_counters));
+}
+
+NS_CC_END
+
+// the state that is read back by cocos2d-x
+static GLuint s_uLastName = 0;
+static GLint s_nLastUniformLocation = 0;
+static GLint s_nFramebuffer = 0;
+static GLint s_nRenderbuffer = 0;
+static GLint s_nActiveTexture = GL_TEXTURE0;
+static GLint s_pViewport[4] = { 0, 0, 0, 0 };
+static GLfloat s_pClearColor[4] = { 0, 0, 0, 0 };
+static GLfloat s_fClearDepth = 1;
+static GLint s_nClearStencil = 0;
+
+#define NULL_GL_CALL() (s_counters.calls++)
+
+static void genNames(GLsizei n, GLuint* names)
+{
+    NULL_GL_CALL();
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        names[i] = ++s_uLastName;
+    }
+}
+
+static unsigned int bytesPerPixel(GLenum format, GLenum type)
+{
+    if (type != GL_UNSIGNED_BYTE)
+    {
+        // GL_UNSIGNED_SHORT_5_6_5, GL_UNSIGNED_SHORT_4_4_4_4 and GL_UNSIGNED_SHORT_5_5_5_1
+        return 2;
+    }
+
+    switch (format)
+    {
+    case GL_RGBA:
+        return 4;
+    case GL_RGB:
+        return 3;
+    case GL_LUMINANCE_ALPHA:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+static void uploadTexture(GLsizei width, GLsizei height, GLenum format, GLenum type)
+{
+    NULL_GL_CALL();
+    s_counters.textureUploads++;
+    s_counters.textureUploadBytes += (unsigned long long)width * height * bytesPerPixel(format, type);
+}
+
+//
+// OpenGL 1.1
+//
+extern "C" {
+
+void GLAPIENTRY glBindTexture(GLenum target, GLuint texture)
+{
+    NULL_GL_CALL();
+    s_counters.textureBinds++;
+}
+
+void GLAPIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glClear(GLbitfield mask)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+{
+    NULL_GL_CALL();
+    s_pClearColor[0] = red;
+    s_pClearColor[1] = green;
+    s_pClearColor[2] = blue;
+    s_pClearColor[3] = alpha;
+}
+
+void GLAPIENTRY glClearDepth(GLclampd depth)
+{
+    NULL_GL_CALL();
+    s_fClearDepth = (GLfloat)depth;
+}
+
+void GLAPIENTRY glClearStencil(GLint s)
+{
+    NULL_GL_CALL();
+    s_nClearStencil = s;
+}
+
+void GLAPIENTRY glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glDeleteTextures(GLsizei n, const GLuint *textures)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glDepthFunc(GLenum func)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glDepthMask(GLboolean flag)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glDisable(GLenum cap)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    NULL_GL_CALL();
+    s_counters.drawCalls++;
+    s_counters.vertices += count;
+}
+
+void GLAPIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices)
+{
+    NULL_GL_CALL();
+    s_counters.drawCalls++;
+    s_counters.vertices += count;
+}
+
+void GLAPIENTRY glEnable(GLenum cap)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glFinish(void)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glFlush(void)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glGenTextures(GLsizei n, GLuint *textures)
+{
+    genNames(n, textures);
+}
+
+GLenum GLAPIENTRY glGetError(void)
+{
+    NULL_GL_CALL();
+    return GL_NO_ERROR;
+}
+
+void GLAPIENTRY glGetFloatv(GLenum pname, GLfloat *params)
+{
+    NULL_GL_CALL();
+    switch (pname)
+    {
+    case GL_COLOR_CLEAR_VALUE:
+        memcpy(params, s_pClearColor, sizeof(s_pClearColor));
+        break;
+    case GL_DEPTH_CLEAR_VALUE:
+        *params = s_fClearDepth;
+        break;
+    default:
+        *params = 0;
+        break;
+    }
+}
+
+void GLAPIENTRY glGetIntegerv(GLenum pname, GLint *params)
+{
+    NULL_GL_CALL();
+    switch (pname)
+    {
+    case GL_MAX_TEXTURE_SIZE:
+        *params = 4096;
+        break;
+    case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+        *params = 8;
+        break;
+    case GL_FRAMEBUFFER_BINDING:
+        *params = s_nFramebuffer;
+        break;
+    case GL_RENDERBUFFER_BINDING:
+        *params = s_nRenderbuffer;
+        break;
+    case GL_ACTIVE_TEXTURE:
+        *params = s_nActiveTexture;
+        break;
+    case GL_STENCIL_CLEAR_VALUE:
+        *params = s_nClearStencil;
+        break;
+    case GL_VIEWPORT:
+        memcpy(params, s_pViewport, sizeof(s_pViewport));
+        break;
+    default:
+        *params = 0;
+        break;
+    }
+}
+
+const GLubyte * GLAPIENTRY glGetString(GLenum name)
+{
+    NULL_GL_CALL();
+    switch (name)
+    {
+    case GL_VENDOR:
+        return (const GLubyte *)"cocos2d-x";
+    case GL_RENDERER:
+        return (const GLubyte *)"null";
+    case GL_VERSION:
+        return (const GLubyte *)"2.0";
+    case GL_EXTENSIONS:
+        return (const GLubyte *)"GL_ARB_vertex_buffer_object GL_EXT_framebuffer_object GL_ARB_texture_non_power_of_two";
+    default:
+        return (const GLubyte *)"";
+    }
+}
+
+void GLAPIENTRY glLineWidth(GLfloat width)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glPixelStorei(GLenum pname, GLint param)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid *pixels)
+{
+    NULL_GL_CALL();
+    memset(pixels, 0, (size_t)width * height * bytesPerPixel(format, type));
+}
+
+void GLAPIENTRY glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glStencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glStencilMask(GLuint mask)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels)
+{
+    uploadTexture(width, height, format, type);
+}
+
+void GLAPIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+    NULL_GL_CALL();
+}
+
+void GLAPIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels)
+{
+    uploadTexture(width, height, format, type);
+}
+
+void GLAPIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    NULL_GL_CALL();
+    s_pViewport[0] = x;
+    s_pViewport[1] = y;
+    s_pViewport[2] = width;
+    s_pViewport[3] = height;
+}
+
+} // extern "C"
+
+//
+// OpenGL 1.2 and later, called through the GLEW function pointers
+//
+static void GLAPIENTRY nullActiveTexture(GLenum texture)
+{
+    NULL_GL_CALL();
+    s_nActiveTexture = texture;
+}
+
+static void GLAPIENTRY nullAttachShader(GLuint program, GLuint shader)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullBindAttribLocation(GLuint program, GLuint index, const GLchar* name)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullBindBuffer(GLenum target, GLuint buffer)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    NULL_GL_CALL();
+    s_nFramebuffer = framebuffer;
+}
+
+static void GLAPIENTRY nullBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    NULL_GL_CALL();
+    s_nRenderbuffer = renderbuffer;
+}
+
+static void GLAPIENTRY nullBindVertexArray(GLuint array)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullBufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+    NULL_GL_CALL();
+    s_counters.bufferUploads++;
+    s_counters.bufferUploadBytes += size;
+}
+
+static void GLAPIENTRY nullBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+    NULL_GL_CALL();
+    s_counters.bufferUploads++;
+    s_counters.bufferUploadBytes += size;
+}
+
+static GLenum GLAPIENTRY nullCheckFramebufferStatus(GLenum target)
+{
+    NULL_GL_CALL();
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static void GLAPIENTRY nullCompileShader(GLuint shader)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid *data)
+{
+    NULL_GL_CALL();
+    s_counters.textureUploads++;
+    s_counters.textureUploadBytes += imageSize;
+}
+
+static GLuint GLAPIENTRY nullCreateProgram(void)
+{
+    NULL_GL_CALL();
+    return ++s_uLastName;
+}
+
+static GLuint GLAPIENTRY nullCreateShader(GLenum type)
+{
+    NULL_GL_CALL();
+    return ++s_uLastName;
+}
+
+static void GLAPIENTRY nullDeleteNames(GLsizei n, const GLuint* names)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullDeleteName(GLuint name)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullVertexAttribArray(GLuint index)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullGenNames(GLsizei n, GLuint* names)
+{
+    genNames(n, names);
+}
+
+static void GLAPIENTRY nullGenerateMipmap(GLenum target)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullGetInfoLog(GLuint object, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    NULL_GL_CALL();
+    if (length)
+    {
+        *length = 0;
+    }
+    if (bufSize > 0)
+    {
+        infoLog[0] = '\0';
+    }
+}
+
+static void GLAPIENTRY nullGetObjectiv(GLuint object, GLenum pname, GLint* param)
+{
+    NULL_GL_CALL();
+    // the shaders compile and the programs link, without log
+    *param = (pname == GL_COMPILE_STATUS || pname == GL_LINK_STATUS) ? GL_TRUE : 0;
+}
+
+static GLint GLAPIENTRY nullGetUniformLocation(GLuint program, const GLchar* name)
+{
+    NULL_GL_CALL();
+    // CCGLProgram caches the uniform values by location, so they are all different
+    return ++s_nLastUniformLocation;
+}
+
+static void GLAPIENTRY nullLinkProgram(GLuint program)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullShaderSource(GLuint shader, GLsizei count, const GLchar** strings, const GLint* lengths)
+{
+    NULL_GL_CALL();
+}
+
+static void GLAPIENTRY nullUniform1f(GLint location, GLfloat v0)
+{
+    NULL_GL_CALL();
+    s_counters.uniformUpdates++;
+}
+
+static void GLAPIENTRY nullUniform1i(GLint location, GLint v0)
+{
+    NULL_GL_CALL();
+    s_counters.uniformUpdates++;
+}
+
+static void GLAPIENTRY nullUniform2f(GLint location, GLfloat v0, GLfloat v1)
+{
+    NULL_GL_CALL();
+    s_counters.uniformUpdates++;
+}
+
+static void GLAPIENTRY nullUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+{
+    NULL_GL_CALL();
+    s_counters.uniformUpdates++;
+}
+
+static void GLAPIENTRY nullUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+    NULL_GL_CALL();
+    s_counters.uniformUpdates++;
+}
+
+static void GLAPIENTRY nullUniformfv(GLint location, GLsizei count, const GLfloat* value)
+{
+    NULL_GL_CALL();
+    s_counters.uniformUpdates++;
+}
+
+static void GLAPIENTRY nullUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+    NULL_GL_CALL();
+    s_counters.uniformUpdates++;
+}
+
+static void GLAPIENTRY nullUseProgram(GLuint program)
+{
+    NULL_GL_CALL();
+    s_counters.programChanges++;
+}
+
+static void GLAPIENTRY nullVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer)
+{
+    NULL_GL_CALL();
+}
+
+extern "C" {
+
+PFNGLACTIVETEXTUREPROC __glewActiveTexture = nullActiveTexture;
+PFNGLATTACHSHADERPROC __glewAttachShader = nullAttachShader;
+PFNGLBINDATTRIBLOCATIONPROC __glewBindAttribLocation = nullBindAttribLocation;
+PFNGLBINDBUFFERPROC __glewBindBuffer = nullBindBuffer;
+PFNGLBINDFRAMEBUFFERPROC __glewBindFramebuffer = nullBindFramebuffer;
+PFNGLBINDRENDERBUFFERPROC __glewBindRenderbuffer = nullBindRenderbuffer;
+PFNGLBINDVERTEXARRAYPROC __glewBindVertexArray = nullBindVertexArray;
+PFNGLBUFFERDATAPROC __glewBufferData = nullBufferData;
+PFNGLBUFFERSUBDATAPROC __glewBufferSubData = nullBufferSubData;
+PFNGLCHECKFRAMEBUFFERSTATUSPROC __glewCheckFramebufferStatus = nullCheckFramebufferStatus;
+PFNGLCOMPILESHADERPROC __glewCompileShader = nullCompileShader;
+PFNGLCOMPRESSEDTEXIMAGE2DPROC __glewCompressedTexImage2D = nullCompressedTexImage2D;
+PFNGLCREATEPROGRAMPROC __glewCreateProgram = nullCreateProgram;
+PFNGLCREATESHADERPROC __glewCreateShader = nullCreateShader;
+PFNGLDELETEBUFFERSPROC __glewDeleteBuffers = nullDeleteNames;
+PFNGLDELETEFRAMEBUFFERSPROC __glewDeleteFramebuffers = nullDeleteNames;
+PFNGLDELETEPROGRAMPROC __glewDeleteProgram = nullDeleteName;
+PFNGLDELETERENDERBUFFERSPROC __glewDeleteRenderbuffers = nullDeleteNames;
+PFNGLDELETESHADERPROC __glewDeleteShader = nullDeleteName;
+PFNGLDELETEVERTEXARRAYSPROC __glewDeleteVertexArrays = nullDeleteNames;
+PFNGLDISABLEVERTEXATTRIBARRAYPROC __glewDisableVertexAttribArray = nullVertexAttribArray;
+PFNGLENABLEVERTEXATTRIBARRAYPROC __glewEnableVertexAttribArray = nullVertexAttribArray;
+PFNGLFRAMEBUFFERRENDERBUFFERPROC __glewFramebufferRenderbuffer = nullFramebufferRenderbuffer;
+PFNGLFRAMEBUFFERTEXTURE2DPROC __glewFramebufferTexture2D = nullFramebufferTexture2D;
+PFNGLGENBUFFERSPROC __glewGenBuffers = nullGenNames;
+PFNGLGENFRAMEBUFFERSPROC __glewGenFramebuffers = nullGenNames;
+PFNGLGENRENDERBUFFERSPROC __glewGenRenderbuffers = nullGenNames;
+PFNGLGENVERTEXARRAYSPROC __glewGenVertexArrays = nullGenNames;
+PFNGLGENERATEMIPMAPPROC __glewGenerateMipmap = nullGenerateMipmap;
+PFNGLGETPROGRAMINFOLOGPROC __glewGetProgramInfoLog = nullGetInfoLog;
+PFNGLGETPROGRAMIVPROC __glewGetProgramiv = nullGetObjectiv;
+PFNGLGETSHADERINFOLOGPROC __glewGetShaderInfoLog = nullGetInfoLog;
+PFNGLGETSHADERIVPROC __glewGetShaderiv = nullGetObjectiv;
+PFNGLGETUNIFORMLOCATIONPROC __glewGetUniformLocation = nullGetUniformLocation;
+PFNGLLINKPROGRAMPROC __glewLinkProgram = nullLinkProgram;
+PFNGLRENDERBUFFERSTORAGEPROC __glewRenderbufferStorage = nullRenderbufferStorage;
+PFNGLSHADERSOURCEPROC __glewShaderSource = nullShaderSource;
+PFNGLUNIFORM1FPROC __glewUniform1f = nullUniform1f;
+PFNGLUNIFORM1IPROC __glewUniform1i = nullUniform1i;
+PFNGLUNIFORM2FPROC __glewUniform2f = nullUniform2f;
+PFNGLUNIFORM2FVPROC __glewUniform2fv = nullUniformfv;
+PFNGLUNIFORM3FPROC __glewUniform3f = nullUniform3f;
+PFNGLUNIFORM3FVPROC __glewUniform3fv = nullUniformfv;
+PFNGLUNIFORM4FPROC __glewUniform4f = nullUniform4f;
+PFNGLUNIFORM4FVPROC __glewUniform4fv = nullUniformfv;
+PFNGLUNIFORMMATRIX4FVPROC __glewUniformMatrix4fv = nullUniformMatrix4fv;
+PFNGLUSEPROGRAMPROC __glewUseProgram = nullUseProgram;
+PFNGLVERTEXATTRIBPOINTERPROC __glewVertexAttribPointer = nullVertexAttribPointer;
+
+} // extern "C"
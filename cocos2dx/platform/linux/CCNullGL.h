@@ -0,0 +1,81 @@
+/****************************************************************************
+Copyright (c) 2010-2012 cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CC_NULL_GL_H__
+#define __CC_NULL_GL_H__
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** @brief OpenGL calls made since the last ccNullGLResetCounters().
+
+ In headless builds (CC_HEADLESS=1) the OpenGL functions used by cocos2d-x are implemented
+ by CCNullGL.cpp instead of libGL and GLEW: they don't draw anything, they only keep the
+ state that is read back (bindings, clear values, viewport, object names) and count the calls.
+ @since v2.1
+ */
+typedef struct _ccNullGLCounters
+{
+    //! all the OpenGL calls
+    unsigned int        calls;
+    //! glDrawArrays and glDrawElements calls
+    unsigned int        drawCalls;
+    //! vertices or indices drawn
+    unsigned int        vertices;
+    //! glTexImage2D, glTexSubImage2D and glCompressedTexImage2D calls
+    unsigned int        textureUploads;
+    unsigned long long  textureUploadBytes;
+    //! glBufferData and glBufferSubData calls
+    unsigned int        bufferUploads;
+    unsigned long long  bufferUploadBytes;
+    //! glBindTexture calls
+    unsigned int        textureBinds;
+    //! glUseProgram calls
+    unsigned int        programChanges;
+    //! glUniform* calls
+    unsigned int        uniformUpdates;
+} ccNullGLCounters;
+
+/** returns the counters of the null OpenGL implementation
+ @since v2.1
+ */
+const ccNullGLCounters& CC_DLL ccNullGLGetCounters();
+
+/** sets the counters of the null OpenGL implementation to 0
+ @since v2.1
+ */
+void CC_DLL ccNullGLResetCounters();
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_NULL_GL_H__
@@ -25,6 +25,9 @@ THE SOFTWARE.
 #include "platform.h"
 
 #include "CCStdC.h"
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+#include <time.h>
+#endif
 
 NS_CC_BEGIN
 
@@ -38,6 +41,22 @@ int CCTime::gettimeofdayCocos2d(struct cc_timeval *tp, void *tzp)
     return 0;
 }
 
+int CCTime::getMonotonicTime(struct cc_timeval *tp)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    if (tp)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        tp->tv_sec = ts.tv_sec;
+        tp->tv_usec = ts.tv_nsec / 1000;
+    }
+    return 0;
+#else
+    return gettimeofdayCocos2d(tp, NULL);
+#endif
+}
+
 double CCTime::timersubCocos2d(struct cc_timeval *start, struct cc_timeval *end)
 {
     if (! start || ! end)
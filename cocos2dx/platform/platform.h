@@ -45,6 +45,12 @@ class CC_DLL CCTime
 {
 public:
     static int gettimeofdayCocos2d(struct cc_timeval *tp, void *tzp);
+    /** current time, to measure intervals. On Linux it is read from the monotonic clock, which
+     doesn't jump when the wall clock is set, so it isn't the time of day there.
+     Elsewhere it is the same as gettimeofdayCocos2d.
+     @since v2.1
+     */
+    static int getMonotonicTime(struct cc_timeval *tp);
     static double timersubCocos2d(struct cc_timeval *start, struct cc_timeval *end);
 };
 
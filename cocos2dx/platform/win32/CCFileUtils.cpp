@@ -65,6 +65,7 @@ void CCFileUtils::purgeFileUtils()
     }
     
     CC_SAFE_DELETE(s_pFileUtils);
+    ZipFile::purgeSharedZipFiles();
 }
 
 void CCFileUtils::purgeCachedEntries()
@@ -133,6 +134,17 @@ unsigned char* CCFileUtils::getFileData(const char* pszFileName, const char* psz
     unsigned char* pBuffer = NULL;
     CCAssert(pszFileName != NULL && pSize != NULL && pszMode != NULL, "Invaild parameters.");
     *pSize = 0;
+
+    // look in the archives added with addSearchArchive first
+    if (! m_obSearchArchives.empty())
+    {
+        pBuffer = getFileDataFromSearchArchives(pszFileName, s_pszResourcePath, pSize);
+        if (pBuffer)
+        {
+            return pBuffer;
+        }
+    }
+
     do 
     {
         // read the file from hardware
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 #include "support/data_support/uthash.h"
 #include "cocoa/CCString.h"
+#include "support/CCRenderQueue.h"
 // extern
 #include "kazmath/GL/matrix.h"
 #include "kazmath/kazmath.h"
@@ -205,6 +206,10 @@ bool CCGLProgram::link()
 
 void CCGLProgram::use()
 {
+    // something else is going to be drawn: the batched quads must be drawn before the program,
+    // and the GL state that comes with it, is changed
+    CCRenderQueue::sharedRenderQueue()->flush();
+
     ccGLUseProgram(m_uProgram);
 }
 
@@ -99,7 +99,7 @@ public:
     void addAttribute(const char* attributeName, GLuint index);
     /** links the glProgram */
     bool link();
-    /** it will call glUseProgram() */
+    /** it will call glUseProgram(). The quads batched by the CCRenderQueue are drawn first */
     void use();
 /** It will create 3 uniforms:
     - kCCUniformPMatrix
@@ -44,6 +44,7 @@ THE SOFTWARE.
 #include "cocoa/CCAffineTransform.h"
 #include "support/TransformUtils.h"
 #include "support/CCProfiling.h"
+#include "support/CCRenderQueue.h"
 // external
 #include "kazmath/GL/matrix.h"
 #include <string.h>
@@ -482,61 +483,7 @@ void CCSprite::updateTransform(void)
     // recaculate matrix only if it is dirty
     if( isDirty() ) {
 
-        // If it is not visible, or one of its ancestors is not visible, then do nothing:
-        if( !m_bIsVisible || ( m_pParent && m_pParent != m_pobBatchNode && ((CCSprite*)m_pParent)->m_bShouldBeHidden) )
-        {
-            m_sQuad.br.vertices = m_sQuad.tl.vertices = m_sQuad.tr.vertices = m_sQuad.bl.vertices = vertex3(0,0,0);
-            m_bShouldBeHidden = true;
-        }
-        else 
-        {
-            m_bShouldBeHidden = false;
-
-            if( ! m_pParent || m_pParent == m_pobBatchNode )
-            {
-                m_transformToBatch = nodeToParentTransform();
-            }
-            else 
-            {
-                CCAssert( dynamic_cast<CCSprite*>(m_pParent), "Logic error in CCSprite. Parent must be a CCSprite");
-                m_transformToBatch = CCAffineTransformConcat( nodeToParentTransform() , ((CCSprite*)m_pParent)->m_transformToBatch );
-            }
-
-            //
-            // calculate the Quad based on the Affine Matrix
-            //
-
-            CCSize size = m_obRect.size;
-
-            float x1 = m_obOffsetPosition.x;
-            float y1 = m_obOffsetPosition.y;
-
-            float x2 = x1 + size.width;
-            float y2 = y1 + size.height;
-            float x = m_transformToBatch.tx;
-            float y = m_transformToBatch.ty;
-
-            float cr = m_transformToBatch.a;
-            float sr = m_transformToBatch.b;
-            float cr2 = m_transformToBatch.d;
-            float sr2 = -m_transformToBatch.c;
-            float ax = x1 * cr - y1 * sr2 + x;
-            float ay = x1 * sr + y1 * cr2 + y;
-
-            float bx = x2 * cr - y1 * sr2 + x;
-            float by = x2 * sr + y1 * cr2 + y;
-
-            float cx = x2 * cr - y2 * sr2 + x;
-            float cy = x2 * sr + y2 * cr2 + y;
-
-            float dx = x1 * cr - y2 * sr2 + x;
-            float dy = x1 * sr + y2 * cr2 + y;
-
-            m_sQuad.bl.vertices = vertex3( RENDER_IN_SUBPIXEL(ax), RENDER_IN_SUBPIXEL(ay), m_fVertexZ );
-            m_sQuad.br.vertices = vertex3( RENDER_IN_SUBPIXEL(bx), RENDER_IN_SUBPIXEL(by), m_fVertexZ );
-            m_sQuad.tl.vertices = vertex3( RENDER_IN_SUBPIXEL(dx), RENDER_IN_SUBPIXEL(dy), m_fVertexZ );
-            m_sQuad.tr.vertices = vertex3( RENDER_IN_SUBPIXEL(cx), RENDER_IN_SUBPIXEL(cy), m_fVertexZ );
-        }
+        updateQuadVertices();
 
         m_pobTextureAtlas->updateQuad(&m_sQuad, m_uAtlasIndex);
         m_bRecursiveDirty = false;
@@ -560,6 +507,91 @@ void CCSprite::updateTransform(void)
 #endif // CC_SPRITE_DEBUG_DRAW
 }
 
+void CCSprite::updateTransformInQuads(ccV3F_C4B_T2F_Quad* pQuads, unsigned int* pFirstIndex, unsigned int* pLastIndex)
+{
+    CCAssert(m_pobBatchNode, "updateTransformInQuads is only valid when CCSprite is being rendered using an CCSpriteBatchNode");
+
+    if( isDirty() ) {
+
+        updateQuadVertices();
+
+        pQuads[m_uAtlasIndex] = m_sQuad;
+        *pFirstIndex = MIN(*pFirstIndex, m_uAtlasIndex);
+        *pLastIndex = MAX(*pLastIndex, m_uAtlasIndex);
+        m_bRecursiveDirty = false;
+        setDirty(false);
+    }
+
+    // the children use the transform of their parent, so they are updated after it, by the same thread
+    if( m_bHasChildren ) 
+    {
+        ccArray *arrayData = m_pChildren->data;
+        for (unsigned int i = 0; i < arrayData->num; i++)
+        {
+            ((CCSprite*)arrayData->arr[i])->updateTransformInQuads(pQuads, pFirstIndex, pLastIndex);
+        }
+    }
+}
+
+void CCSprite::updateQuadVertices(void)
+{
+    // If it is not visible, or one of its ancestors is not visible, then do nothing:
+    if( !m_bIsVisible || ( m_pParent && m_pParent != m_pobBatchNode && ((CCSprite*)m_pParent)->m_bShouldBeHidden) )
+    {
+        m_sQuad.br.vertices = m_sQuad.tl.vertices = m_sQuad.tr.vertices = m_sQuad.bl.vertices = vertex3(0,0,0);
+        m_bShouldBeHidden = true;
+    }
+    else 
+    {
+        m_bShouldBeHidden = false;
+
+        if( ! m_pParent || m_pParent == m_pobBatchNode )
+        {
+            m_transformToBatch = nodeToParentTransform();
+        }
+        else 
+        {
+            CCAssert( dynamic_cast<CCSprite*>(m_pParent), "Logic error in CCSprite. Parent must be a CCSprite");
+            m_transformToBatch = CCAffineTransformConcat( nodeToParentTransform() , ((CCSprite*)m_pParent)->m_transformToBatch );
+        }
+
+        //
+        // calculate the Quad based on the Affine Matrix
+        //
+
+        CCSize size = m_obRect.size;
+
+        float x1 = m_obOffsetPosition.x;
+        float y1 = m_obOffsetPosition.y;
+
+        float x2 = x1 + size.width;
+        float y2 = y1 + size.height;
+        float x = m_transformToBatch.tx;
+        float y = m_transformToBatch.ty;
+
+        float cr = m_transformToBatch.a;
+        float sr = m_transformToBatch.b;
+        float cr2 = m_transformToBatch.d;
+        float sr2 = -m_transformToBatch.c;
+        float ax = x1 * cr - y1 * sr2 + x;
+        float ay = x1 * sr + y1 * cr2 + y;
+
+        float bx = x2 * cr - y1 * sr2 + x;
+        float by = x2 * sr + y1 * cr2 + y;
+
+        float cx = x2 * cr - y2 * sr2 + x;
+        float cy = x2 * sr + y2 * cr2 + y;
+
+        float dx = x1 * cr - y2 * sr2 + x;
+        float dy = x1 * sr + y2 * cr2 + y;
+
+        m_sQuad.bl.vertices = vertex3( RENDER_IN_SUBPIXEL(ax), RENDER_IN_SUBPIXEL(ay), m_fVertexZ );
+        m_sQuad.br.vertices = vertex3( RENDER_IN_SUBPIXEL(bx), RENDER_IN_SUBPIXEL(by), m_fVertexZ );
+        m_sQuad.tl.vertices = vertex3( RENDER_IN_SUBPIXEL(dx), RENDER_IN_SUBPIXEL(dy), m_fVertexZ );
+        m_sQuad.tr.vertices = vertex3( RENDER_IN_SUBPIXEL(cx), RENDER_IN_SUBPIXEL(cy), m_fVertexZ );
+    }
+}
+
 // draw
 
 void CCSprite::draw(void)
@@ -568,6 +600,15 @@ void CCSprite::draw(void)
 
     CCAssert(!m_pobBatchNode, "If CCSprite is being rendered by CCSpriteBatchNode, CCSprite#draw SHOULD NOT be called");
 
+#if CC_SPRITE_DEBUG_DRAW == 0
+    // merge this quad with the previous ones if they share the texture, shader and blend function
+    if (CCRenderQueue::sharedRenderQueue()->addQuad(m_sQuad, m_tModelViewTransform, m_pobTexture ? m_pobTexture->getName() : 0, getShaderProgram(), m_sBlendFunc, m_glServerState))
+    {
+        CC_PROFILER_STOP_CATEGORY(kCCProfilerCategorySprite, "CCSprite - draw");
+        return;
+    }
+#endif // CC_SPRITE_DEBUG_DRAW
+
     CC_NODE_DRAW_SETUP();
 
     ccGLBlendFunc( m_sBlendFunc.src, m_sBlendFunc.dst );
@@ -721,24 +762,7 @@ void CCSprite::sortAllChildren()
 {
     if (m_bReorderChildDirty)
     {
-        int i = 0,j = 0,length = m_pChildren->data->num;
-        CCNode** x = (CCNode**)m_pChildren->data->arr;
-        CCNode *tempItem = NULL;
-
-        // insertion sort
-        for(i=1; i<length; i++)
-        {
-            tempItem = x[i];
-            j = i-1;
-
-            //continue moving element downwards while zOrder is smaller or when zOrder is the same but orderOfArrival is smaller
-            while(j>=0 && ( tempItem->getZOrder() < x[j]->getZOrder() || ( tempItem->getZOrder() == x[j]->getZOrder() && tempItem->getOrderOfArrival() < x[j]->getOrderOfArrival() ) ) )
-            {
-                x[j+1] = x[j];
-                j = j-1;
-            }
-            x[j+1] = tempItem;
-        }
+        sortChildrenByZOrder();
 
         if ( m_pobBatchNode)
         {
@@ -300,6 +300,14 @@ public:
     /** updates the quad according the the rotation, position, scale values. */
     virtual void updateTransform(void);
 
+    /** updates the quad like updateTransform(), but writes it at its index in pQuads instead of going
+     through the texture atlas, so sprites of different subtrees can be updated by different threads.
+     The atlas indices that were written are added to [*pFirstIndex, *pLastIndex]. They still have to
+     be marked as dirty in the atlas.
+     @since v2.1
+     */
+    void updateTransformInQuads(ccV3F_C4B_T2F_Quad* pQuads, unsigned int* pFirstIndex, unsigned int* pLastIndex);
+
     /** updates the texture rect of the CCSprite in points. 
     It will call setTextureRect:rotated:untrimmedSize with rotated = NO, and utrimmedSize = rect.size.
     */
@@ -342,6 +350,8 @@ protected:
     virtual void setTextureCoords(CCRect rect);
     virtual void updateBlendFunc(void);
     virtual void setReorderChildDirtyRecursively(void);
+    // computes the vertices of m_sQuad from the transform to the batch node
+    void updateQuadVertices(void);
 
 protected:
     //
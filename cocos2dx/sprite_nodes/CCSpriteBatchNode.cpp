@@ -37,8 +37,11 @@ THE SOFTWARE.
 #include "CCDirector.h"
 #include "support/TransformUtils.h"
 #include "support/CCProfiling.h"
+#include "support/CCCulling.h"
+#include "support/CCJobSystem.h"
 // external
 #include "kazmath/GL/matrix.h"
+#include <typeinfo>
 
 NS_CC_BEGIN
 
@@ -102,6 +105,8 @@ bool CCSpriteBatchNode::initWithTexture(CCTexture2D *tex, unsigned int capacity)
     m_pobDescendants = new CCArray();
     m_pobDescendants->initWithCapacity(capacity);
 
+    m_bParallelUpdateEnabled = false;
+
     setShaderProgram(CCShaderCache::sharedShaderCache()->programForKey(kCCShader_PositionTextureColor));
     return true;
 }
@@ -250,25 +255,7 @@ void CCSpriteBatchNode::sortAllChildren()
 {
     if (m_bReorderChildDirty)
     {
-        int i = 0,j = 0,length = m_pChildren->data->num;
-        CCNode ** x = (CCNode**)m_pChildren->data->arr;
-        CCNode *tempItem = NULL;
-
-        //insertion sort
-        for(i=1; i<length; i++)
-        {
-            tempItem = x[i];
-            j = i-1;
-
-            //continue moving element downwards while zOrder is smaller or when zOrder is the same but orderOfArrival is smaller
-            while(j>=0 && ( tempItem->getZOrder() < x[j]->getZOrder() || ( tempItem->getZOrder() == x[j]->getZOrder() && tempItem->getOrderOfArrival() < x[j]->getOrderOfArrival() ) ) )
-            {
-                x[j+1] = x[j];
-                j--;
-            }
-
-            x[j+1] = tempItem;
-        }
+        sortChildrenByZOrder();
 
         //sorted now check all children
         if (m_pChildren->count() > 0)
@@ -400,15 +387,143 @@ void CCSpriteBatchNode::draw(void)
 
     CC_NODE_DRAW_SETUP();
 
-    arrayMakeObjectsPerformSelector(m_pChildren, updateTransform, CCSprite*);
+    // with CC_SPRITE_DEBUG_DRAW the sprites draw their bounding box from updateTransform(), on this thread
+    if (m_bParallelUpdateEnabled && ! CC_SPRITE_DEBUG_DRAW)
+    {
+        updateTransformsInParallel();
+    }
+    else
+    {
+        arrayMakeObjectsPerformSelector(m_pChildren, updateTransform, CCSprite*);
+    }
 
     ccGLBlendFunc( m_blendFunc.src, m_blendFunc.dst );
 
-    m_pobTextureAtlas->drawQuads();
+    // only draw the quads that intersect the screen
+    CCRect visibleRect;
+    if (CCCulling::isActive() && ! (m_pGrid && m_pGrid->isActive())
+        && CCCulling::getVisibleRect(&m_tModelViewTransform, &visibleRect))
+    {
+        unsigned int uDrawn = m_pobTextureAtlas->drawQuadsInRect(visibleRect);
+        CCCulling::addDrawn(uDrawn);
+        CCCulling::addCulled(m_pobTextureAtlas->getTotalQuads() - uDrawn);
+    }
+    else
+    {
+        m_pobTextureAtlas->drawQuads();
+    }
 
     CC_PROFILER_STOP("CCSpriteBatchNode - draw");
 }
 
+// more jobs than threads, so a thread that finishes early takes another part
+#define kCCSpriteUpdateJobsPerThread 4
+#define kCCSpriteUpdateMaxJobs 64
+
+typedef struct _ccSpriteUpdateJobs
+{
+    CCSprite**          sprites;
+    unsigned int        spriteCount;
+    unsigned int        jobCount;
+    ccV3F_C4B_T2F_Quad* quads;
+    // atlas indices written by each job
+    unsigned int        firstIndex[kCCSpriteUpdateMaxJobs];
+    unsigned int        lastIndex[kCCSpriteUpdateMaxJobs];
+} ccSpriteUpdateJobs;
+
+static void updateSpritesJob(void* pContext, unsigned int uJob)
+{
+    ccSpriteUpdateJobs* pJobs = (ccSpriteUpdateJobs*)pContext;
+    unsigned int uStart = pJobs->spriteCount * uJob / pJobs->jobCount;
+    unsigned int uEnd = pJobs->spriteCount * (uJob + 1) / pJobs->jobCount;
+
+    pJobs->firstIndex[uJob] = UINT_MAX;
+    pJobs->lastIndex[uJob] = 0;
+    for (unsigned int i = uStart; i < uEnd; i++)
+    {
+        pJobs->sprites[i]->updateTransformInQuads(pJobs->quads, &pJobs->firstIndex[uJob], &pJobs->lastIndex[uJob]);
+    }
+}
+
+// the jobs call CCSprite::updateTransformInQuads, which isn't virtual: the subclasses of CCSprite might
+// override updateTransform(), so they are left to the main thread with their ancestors
+static bool isUpdatedByJobs(CCSprite* pSprite)
+{
+    if (typeid(*pSprite) != typeid(CCSprite))
+    {
+        return false;
+    }
+
+    CCArray* pChildren = pSprite->getChildren();
+    if (pChildren)
+    {
+        ccArray *arrayData = pChildren->data;
+        for (unsigned int i = 0; i < arrayData->num; i++)
+        {
+            if (! isUpdatedByJobs((CCSprite*)arrayData->arr[i]))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void CCSpriteBatchNode::updateTransformsInParallel()
+{
+    CC_FRAME_PROFILER_SCOPE("sprite transforms");
+
+    // only the children that are dirty, or whose descendants might be, are given to the jobs
+    m_obUpdatedChildren.clear();
+    ccArray *arrayData = m_pChildren->data;
+    for (unsigned int i = 0; i < arrayData->num; i++)
+    {
+        CCSprite* pChild = (CCSprite*)arrayData->arr[i];
+        if (pChild->isDirty() || pChild->getChildrenCount() > 0)
+        {
+            if (isUpdatedByJobs(pChild))
+            {
+                m_obUpdatedChildren.push_back(pChild);
+            }
+            else
+            {
+                pChild->updateTransform();
+            }
+        }
+    }
+
+    unsigned int uCount = (unsigned int)m_obUpdatedChildren.size();
+    CCJobSystem* pJobSystem = CCJobSystem::sharedJobSystem();
+    unsigned int uJobs = MIN(uCount / CC_SPRITE_BATCH_NODE_SPRITES_PER_JOB, pJobSystem->getThreadCount() * kCCSpriteUpdateJobsPerThread);
+    uJobs = MIN(uJobs, kCCSpriteUpdateMaxJobs);
+
+    if (uJobs < 2 || pJobSystem->getThreadCount() < 2)
+    {
+        for (unsigned int i = 0; i < uCount; i++)
+        {
+            m_obUpdatedChildren[i]->updateTransform();
+        }
+        return;
+    }
+
+    ccSpriteUpdateJobs jobs;
+    jobs.sprites = &m_obUpdatedChildren[0];
+    jobs.spriteCount = uCount;
+    jobs.jobCount = uJobs;
+    // the quads are written in place, and marked as dirty once the jobs are finished
+    jobs.quads = m_pobTextureAtlas->getQuadsAtIndex(0, 0);
+
+    pJobSystem->run(updateSpritesJob, &jobs, uJobs);
+
+    for (unsigned int i = 0; i < uJobs; i++)
+    {
+        if (jobs.firstIndex[i] <= jobs.lastIndex[i])
+        {
+            m_pobTextureAtlas->setDirty(jobs.firstIndex[i], jobs.lastIndex[i] - jobs.firstIndex[i] + 1);
+        }
+    }
+}
+
 void CCSpriteBatchNode::increaseAtlasCapacity(void)
 {
     // if we're going beyond the current TextureAtlas's capacity,
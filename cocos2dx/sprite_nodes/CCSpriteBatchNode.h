@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "textures/CCTextureAtlas.h"
 #include "ccMacros.h"
 #include "cocoa/CCArray.h"
+#include <vector>
 
 NS_CC_BEGIN
 
@@ -81,6 +82,17 @@ public:
 
     inline CCArray* getDescendants(void) { return m_pobDescendants; }
 
+    /** Whether or not the transforms and quads of the children are computed by the threads of CCJobSystem.
+    Each child is updated with its descendants by a single thread, so a sprite is still updated after its parent.
+    Only the children whose subtree is made of plain CCSprite objects are given to the threads, with
+    CCSprite::updateTransformInQuads. The subtrees that contain a subclass of CCSprite, which might override
+    updateTransform(), are updated by the main thread, and so are all the children with CC_SPRITE_DEBUG_DRAW.
+    nodeToParentTransform() and setDirty() of the sprites are then called from other threads. Disabled by default.
+    @since v2.1
+    */
+    inline bool isParallelUpdateEnabled(void) { return m_bParallelUpdateEnabled; }
+    inline void setParallelUpdateEnabled(bool bEnabled) { m_bParallelUpdateEnabled = bEnabled; }
+
     /** creates a CCSpriteBatchNode with a texture2d and capacity of children.
     The capacity will be increased in 33% in runtime if it run out of space.
     @deprecated: This interface will be deprecated sooner or later.
@@ -175,6 +187,7 @@ private:
     void updateAtlasIndex(CCSprite* sprite, int* curIndex);
     void swap(int oldIndex, int newIndex);
     void updateBlendFunc();
+    void updateTransformsInParallel();
 
 protected:
     CCTextureAtlas *m_pobTextureAtlas;
@@ -182,6 +195,10 @@ protected:
 
     // all descendants: chlidren, gran children, etc...
     CCArray* m_pobDescendants;
+
+    bool m_bParallelUpdateEnabled;
+    // children that are updated by the jobs
+    std::vector<CCSprite*> m_obUpdatedChildren;
 };
 
 // end of sprite_nodes group
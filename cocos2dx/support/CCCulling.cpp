@@ -0,0 +1,145 @@
+/****************************************************************************
+Copyright (c) 2012      cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "CCCulling.h"
+#include "ccMacros.h"
+
+NS_CC_BEGIN
+
+// tolerance of the depth comparisons: vertexZ are expected to be much larger than that
+#define kCCCullingEpsilon 0.0001f
+
+bool         CCCulling::s_bActive = false;
+int          CCCulling::s_nSuspended = 0;
+float        CCCulling::s_fMinX = 0;
+float        CCCulling::s_fMinY = 0;
+float        CCCulling::s_fMaxX = 0;
+float        CCCulling::s_fMaxY = 0;
+float        CCCulling::s_fZ = 0;
+unsigned int CCCulling::s_uCulled = 0;
+unsigned int CCCulling::s_uDrawn = 0;
+
+// bounding box of rect transformed by the xy part of the matrix
+static void transformRectBounds(const CCRect& rect, const kmMat4* pTransform, float* pMinX, float* pMinY, float* pMaxX, float* pMaxY)
+{
+    const float* m = pTransform->mat;
+    float x0 = rect.origin.x;
+    float y0 = rect.origin.y;
+    float x1 = x0 + rect.size.width;
+    float y1 = y0 + rect.size.height;
+
+    float ax = m[0] * x0, bx = m[0] * x1;
+    float ay = m[1] * x0, by = m[1] * x1;
+    float cx = m[4] * y0, dx = m[4] * y1;
+    float cy = m[5] * y0, dy = m[5] * y1;
+
+    *pMinX = MIN(ax, bx) + MIN(cx, dx) + m[12];
+    *pMaxX = MAX(ax, bx) + MAX(cx, dx) + m[12];
+    *pMinY = MIN(ay, by) + MIN(cy, dy) + m[13];
+    *pMaxY = MAX(ay, by) + MAX(cy, dy) + m[13];
+}
+
+bool CCCulling::isPlanar(const kmMat4* pTransform)
+{
+    const float* m = pTransform->mat;
+    return m[2] == 0.0f && m[6] == 0.0f
+        && m[3] == 0.0f && m[7] == 0.0f && m[15] == 1.0f
+        && fabsf(m[14] - s_fZ) < kCCCullingEpsilon;
+}
+
+void CCCulling::begin(const CCRect& visibleRect, const kmMat4* pSceneTransform)
+{
+    s_uCulled = 0;
+    s_uDrawn = 0;
+    s_nSuspended = 0;
+
+    s_fZ = pSceneTransform->mat[14];
+    s_bActive = isPlanar(pSceneTransform);
+    if (s_bActive)
+    {
+        transformRectBounds(visibleRect, pSceneTransform, &s_fMinX, &s_fMinY, &s_fMaxX, &s_fMaxY);
+    }
+}
+
+void CCCulling::end()
+{
+    s_bActive = false;
+}
+
+void CCCulling::suspend()
+{
+    s_nSuspended++;
+}
+
+void CCCulling::resume()
+{
+    CCAssert(s_nSuspended > 0, "CCCulling: resume() without suspend()");
+    s_nSuspended--;
+}
+
+bool CCCulling::isRectOutside(const CCRect& rect, const kmMat4* pTransform)
+{
+    if (! isPlanar(pTransform))
+    {
+        return false;
+    }
+
+    float fMinX, fMinY, fMaxX, fMaxY;
+    transformRectBounds(rect, pTransform, &fMinX, &fMinY, &fMaxX, &fMaxY);
+
+    return fMaxX < s_fMinX || fMinX > s_fMaxX || fMaxY < s_fMinY || fMinY > s_fMaxY;
+}
+
+bool CCCulling::getVisibleRect(const kmMat4* pTransform, CCRect* pRect)
+{
+    if (! isPlanar(pTransform))
+    {
+        return false;
+    }
+
+    const float* m = pTransform->mat;
+    float fDet = m[0] * m[5] - m[4] * m[1];
+    if (fDet == 0.0f)
+    {
+        return false;
+    }
+
+    // the inverse of the xy part maps the eye space rect back into the space of the node
+    kmMat4 inverse;
+    kmMat4Identity(&inverse);
+    inverse.mat[0] = m[5] / fDet;
+    inverse.mat[1] = -m[1] / fDet;
+    inverse.mat[4] = -m[4] / fDet;
+    inverse.mat[5] = m[0] / fDet;
+    inverse.mat[12] = -(inverse.mat[0] * m[12] + inverse.mat[4] * m[13]);
+    inverse.mat[13] = -(inverse.mat[1] * m[12] + inverse.mat[5] * m[13]);
+
+    float fMinX, fMinY, fMaxX, fMaxY;
+    transformRectBounds(CCRectMake(s_fMinX, s_fMinY, s_fMaxX - s_fMinX, s_fMaxY - s_fMinY), &inverse, &fMinX, &fMinY, &fMaxX, &fMaxY);
+    *pRect = CCRectMake(fMinX, fMinY, fMaxX - fMinX, fMaxY - fMinY);
+
+    return true;
+}
+
+NS_CC_END
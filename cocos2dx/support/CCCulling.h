@@ -0,0 +1,104 @@
+/****************************************************************************
+Copyright (c) 2012      cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __SUPPORT_CCCULLING_H__
+#define __SUPPORT_CCCULLING_H__
+
+#include "platform/CCPlatformMacros.h"
+#include "cocoa/CCGeometry.h"
+#include "kazmath/mat4.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup global
+ * @{
+ */
+
+/** @brief CCCulling
+ Tests the nodes against the visible rect of the screen while the scene is visited.
+
+ CCDirector calls begin() before visiting the running scene when culling is enabled
+ (see CCDirector::setCullingEnabled). CCNode::visit then skips the draw() of the nodes whose
+ content size, transformed by their cached model-view matrix, doesn't intersect the screen,
+ and CCSpriteBatchNode only draws the quads that intersect it. Children are still visited.
+
+ Only transforms that keep the content in the plane of the scene (translations, rotations
+ around z, scales and skews) are tested: nodes with a vertexZ, a camera or a 3D rotation are
+ always drawn. Nodes without a content size are always drawn too, since draw() isn't bounded by it.
+ Rendering into a CCRenderTexture or a CCGrid suspends the tests.
+ @since v2.1
+ */
+class CC_DLL CCCulling
+{
+public:
+    /** starts testing the nodes against visibleRect, expressed in the coordinates of the scene.
+     pSceneTransform is the model-view matrix the scene is visited with. */
+    static void begin(const CCRect& visibleRect, const kmMat4* pSceneTransform);
+    /** stops testing the nodes */
+    static void end();
+
+    /** disables the tests until the matching resume(). Calls can be nested */
+    static void suspend();
+    static void resume();
+
+    /** whether or not the nodes that are visited are tested */
+    static inline bool isActive() { return s_bActive && s_nSuspended == 0; }
+
+    /** returns true if rect, in the space of pTransform, is outside of the visible rect.
+     Returns false when the transform takes the rect out of the plane of the scene */
+    static bool isRectOutside(const CCRect& rect, const kmMat4* pTransform);
+
+    /** computes the bounding rect of the visible rect in the space of pTransform.
+     Returns false when the transform takes the rect out of the plane of the scene, or can't be inverted */
+    static bool getVisibleRect(const kmMat4* pTransform, CCRect* pRect);
+
+    /** counts nodes (or batched quads) that were skipped / drawn since begin() */
+    static inline void addCulled(unsigned int n) { s_uCulled += n; }
+    static inline void addDrawn(unsigned int n) { s_uDrawn += n; }
+    static inline unsigned int getNumberOfCulled() { return s_uCulled; }
+    static inline unsigned int getNumberOfDrawn() { return s_uDrawn; }
+
+private:
+    static bool isPlanar(const kmMat4* pTransform);
+
+    static bool         s_bActive;
+    static int          s_nSuspended;
+    // visible rect in eye space
+    static float        s_fMinX;
+    static float        s_fMinY;
+    static float        s_fMaxX;
+    static float        s_fMaxY;
+    // depth of the scene in eye space
+    static float        s_fZ;
+    static unsigned int s_uCulled;
+    static unsigned int s_uDrawn;
+};
+
+// end of global group
+/// @}
+
+NS_CC_END
+
+#endif // __SUPPORT_CCCULLING_H__
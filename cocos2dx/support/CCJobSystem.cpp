@@ -0,0 +1,227 @@
+/****************************************************************************
+Copyright (c) 2012      cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "CCJobSystem.h"
+#include "ccMacros.h"
+#include "ccConfig.h"
+#include <errno.h>
+#include <string.h>
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+NS_CC_BEGIN
+
+static CCJobSystem *s_pSharedJobSystem = NULL;
+
+static unsigned int processorCount()
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (unsigned int)info.dwNumberOfProcessors;
+#else
+    long nCount = sysconf(_SC_NPROCESSORS_ONLN);
+    return nCount > 0 ? (unsigned int)nCount : 1;
+#endif
+}
+
+CCJobSystem* CCJobSystem::sharedJobSystem()
+{
+    if (! s_pSharedJobSystem)
+    {
+        s_pSharedJobSystem = new CCJobSystem();
+    }
+    return s_pSharedJobSystem;
+}
+
+void CCJobSystem::purgeSharedJobSystem()
+{
+    CC_SAFE_RELEASE_NULL(s_pSharedJobSystem);
+}
+
+CCJobSystem::CCJobSystem()
+: m_uWorkerThreadCount(CC_JOB_SYSTEM_THREADS)
+, m_pThreads(NULL)
+, m_uStartedThreads(0)
+, m_bQuit(false)
+, m_pFunction(NULL)
+, m_pContext(NULL)
+, m_uJobs(0)
+, m_uNextJob(0)
+, m_uFinishedJobs(0)
+{
+    if (m_uWorkerThreadCount == 0)
+    {
+        m_uWorkerThreadCount = processorCount() - 1;
+    }
+
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_workCondition, NULL);
+    pthread_cond_init(&m_doneCondition, NULL);
+}
+
+CCJobSystem::~CCJobSystem()
+{
+    stopThreads();
+
+    pthread_mutex_destroy(&m_mutex);
+    pthread_cond_destroy(&m_workCondition);
+    pthread_cond_destroy(&m_doneCondition);
+}
+
+void CCJobSystem::setWorkerThreadCount(unsigned int uCount)
+{
+    if (uCount != m_uWorkerThreadCount)
+    {
+        // the threads are started again by the next run()
+        stopThreads();
+        m_uWorkerThreadCount = uCount;
+    }
+}
+
+bool CCJobSystem::startThreads()
+{
+    m_bQuit = false;
+
+    m_pThreads = new pthread_t[m_uWorkerThreadCount];
+    m_uStartedThreads = 0;
+    for (unsigned int i = 0; i < m_uWorkerThreadCount; ++i)
+    {
+        if (pthread_create(&m_pThreads[m_uStartedThreads], NULL, workerThread, this) != 0)
+        {
+            CCLOG("CCJobSystem thread creation error: %s\n", strerror(errno));
+            break;
+        }
+        ++m_uStartedThreads;
+    }
+
+    return m_uStartedThreads > 0;
+}
+
+void CCJobSystem::stopThreads()
+{
+    if (m_pThreads == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    m_bQuit = true;
+    pthread_cond_broadcast(&m_workCondition);
+    pthread_mutex_unlock(&m_mutex);
+
+    for (unsigned int i = 0; i < m_uStartedThreads; ++i)
+    {
+        pthread_join(m_pThreads[i], NULL);
+    }
+    CC_SAFE_DELETE_ARRAY(m_pThreads);
+    m_uStartedThreads = 0;
+}
+
+void CCJobSystem::run(ccJobFunction pFunction, void* pContext, unsigned int uJobs)
+{
+    if (uJobs > 1 && m_uWorkerThreadCount > 0 && m_pThreads == NULL)
+    {
+        startThreads();
+    }
+
+    if (uJobs <= 1 || m_uStartedThreads == 0)
+    {
+        for (unsigned int i = 0; i < uJobs; ++i)
+        {
+            pFunction(pContext, i);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+
+    CCAssert(m_uJobs == 0, "CCJobSystem: run() can't be called by a job");
+    m_pFunction = pFunction;
+    m_pContext = pContext;
+    m_uJobs = uJobs;
+    m_uNextJob = 0;
+    m_uFinishedJobs = 0;
+    pthread_cond_broadcast(&m_workCondition);
+
+    // the calling thread runs jobs too, instead of waiting
+    runJobs();
+
+    while (m_uFinishedJobs < m_uJobs)
+    {
+        pthread_cond_wait(&m_doneCondition, &m_mutex);
+    }
+    m_uJobs = 0;
+    m_uNextJob = 0;
+
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void CCJobSystem::runJobs()
+{
+    while (m_uNextJob < m_uJobs)
+    {
+        unsigned int uJob = m_uNextJob++;
+        ccJobFunction pFunction = m_pFunction;
+        void* pContext = m_pContext;
+
+        pthread_mutex_unlock(&m_mutex);
+        pFunction(pContext, uJob);
+        pthread_mutex_lock(&m_mutex);
+
+        if (++m_uFinishedJobs == m_uJobs)
+        {
+            pthread_cond_signal(&m_doneCondition);
+        }
+    }
+}
+
+void* CCJobSystem::workerThread(void* pData)
+{
+    CCJobSystem* pJobSystem = (CCJobSystem*)pData;
+
+    pthread_mutex_lock(&pJobSystem->m_mutex);
+    while (true)
+    {
+        while (! pJobSystem->m_bQuit && pJobSystem->m_uNextJob >= pJobSystem->m_uJobs)
+        {
+            pthread_cond_wait(&pJobSystem->m_workCondition, &pJobSystem->m_mutex);
+        }
+
+        if (pJobSystem->m_bQuit)
+        {
+            break;
+        }
+
+        pJobSystem->runJobs();
+    }
+    pthread_mutex_unlock(&pJobSystem->m_mutex);
+
+    return NULL;
+}
+
+NS_CC_END
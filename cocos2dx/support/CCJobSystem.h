@@ -0,0 +1,104 @@
+/****************************************************************************
+Copyright (c) 2012      cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __SUPPORT_CCJOBSYSTEM_H__
+#define __SUPPORT_CCJOBSYSTEM_H__
+
+#include "cocoa/CCObject.h"
+#include <pthread.h>
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup global
+ * @{
+ */
+
+/** function run by the jobs: uJob is the index of the job, between 0 and the number of jobs - 1 */
+typedef void (*ccJobFunction)(void* pContext, unsigned int uJob);
+
+/** @brief CCJobSystem
+ Singleton that runs the jobs of a task on a pool of worker threads.
+
+ run() hands out the jobs to the worker threads and to the calling thread, and returns once all of
+ them are finished. The jobs of a task run in any order and at the same time, so they must not
+ write the same data. A job must not call run().
+
+ The worker threads are started by the first run() that has more than one job.
+ @since v2.1
+ */
+class CC_DLL CCJobSystem : public CCObject
+{
+public:
+    CCJobSystem();
+    virtual ~CCJobSystem();
+
+    /** returns the shared instance */
+    static CCJobSystem* sharedJobSystem();
+
+    /** purges the shared instance. The worker threads are stopped */
+    static void purgeSharedJobSystem();
+
+    /** runs pFunction(pContext, i) for i in [0, uJobs) and waits until all the jobs are finished */
+    void run(ccJobFunction pFunction, void* pContext, unsigned int uJobs);
+
+    /** number of threads that run the jobs, including the calling thread */
+    inline unsigned int getThreadCount() { return m_uWorkerThreadCount + 1; }
+
+    /** number of worker threads. Default is CC_JOB_SYSTEM_THREADS */
+    inline unsigned int getWorkerThreadCount() { return m_uWorkerThreadCount; }
+    void setWorkerThreadCount(unsigned int uCount);
+
+private:
+    bool startThreads();
+    void stopThreads();
+    // runs the jobs that are left. Called with the mutex locked, returns with it locked
+    void runJobs();
+    static void* workerThread(void* pData);
+
+private:
+    unsigned int        m_uWorkerThreadCount;
+    pthread_t*          m_pThreads;
+    unsigned int        m_uStartedThreads;
+    pthread_mutex_t     m_mutex;
+    // signaled when jobs are available, or when the threads have to quit
+    pthread_cond_t      m_workCondition;
+    // signaled when the last job is finished
+    pthread_cond_t      m_doneCondition;
+    bool                m_bQuit;
+
+    // current task
+    ccJobFunction       m_pFunction;
+    void*               m_pContext;
+    unsigned int        m_uJobs;
+    unsigned int        m_uNextJob;
+    unsigned int        m_uFinishedJobs;
+};
+
+// end of global group
+/// @}
+
+NS_CC_END
+
+#endif // __SUPPORT_CCJOBSYSTEM_H__
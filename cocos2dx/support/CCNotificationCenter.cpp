@@ -24,23 +24,55 @@ THE SOFTWARE.
 
 #include "CCNotificationCenter.h"
 #include "cocoa/CCArray.h"
+#include "CCDirector.h"
+#include "CCScheduler.h"
+#include "support/data_support/uthash.h"
 #include <string>
 
 using namespace std;
 
 NS_CC_BEGIN;
 
+// The observer of a target for a notification name
+typedef struct _hashObserverEntry
+{
+    CCNotificationObserver  *observer;          // retained
+    CCObject                *target;            // hash key
+    bool                    markedForDeletion;  // removed while the notification was posted, deleted after it
+    UT_hash_handle          hh;
+} tHashObserverEntry;
+
+// The observers of a notification name, in the order they were added
+typedef struct _hashNotificationEntry
+{
+    char                    *name;              // hash key
+    tHashObserverEntry      *observers;
+    int                     postCount;          // the notification is being posted while > 0
+    bool                    hasMarkedObservers;
+    UT_hash_handle          hh;
+} tHashNotificationEntry;
+
 static CCNotificationCenter *s_sharedNotifCenter = NULL;
 
 CCNotificationCenter::CCNotificationCenter()
+: m_pHashForNames(NULL)
+, m_bQueueScheduled(false)
 {
-    m_observers = CCArray::createWithCapacity(3);
-    m_observers->retain();
 }
 
 CCNotificationCenter::~CCNotificationCenter()
 {
-    m_observers->release();
+    tHashNotificationEntry *pEntry, *pTmp;
+    HASH_ITER(hh, m_pHashForNames, pEntry, pTmp)
+    {
+        removeObserversOfEntry(pEntry, false);
+    }
+
+    std::vector<QueuedNotification>::iterator it;
+    for (it = m_queuedNotifications.begin(); it != m_queuedNotifications.end(); ++it)
+    {
+        CC_SAFE_RELEASE(it->second);
+    }
 }
 
 CCNotificationCenter *CCNotificationCenter::sharedNotificationCenter(void)
@@ -54,6 +86,11 @@ CCNotificationCenter *CCNotificationCenter::sharedNotificationCenter(void)
 
 void CCNotificationCenter::purgeNotificationCenter(void)
 {
+    if (s_sharedNotifCenter && s_sharedNotifCenter->m_bQueueScheduled)
+    {
+        CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(CCNotificationCenter::postQueuedNotifications), s_sharedNotifCenter);
+        s_sharedNotifCenter->m_bQueueScheduled = false;
+    }
     CC_SAFE_RELEASE_NULL(s_sharedNotifCenter);
 }
 
@@ -62,17 +99,36 @@ void CCNotificationCenter::purgeNotificationCenter(void)
 //
 bool CCNotificationCenter::observerExisted(CCObject *target,const char *name)
 {
-    CCObject* obj = NULL;
-    CCARRAY_FOREACH(m_observers, obj)
+    tHashNotificationEntry *pEntry = NULL;
+    HASH_FIND_STR(m_pHashForNames, name, pEntry);
+    if (! pEntry)
+        return false;
+
+    tHashObserverEntry *pObserverEntry = NULL;
+    HASH_FIND_PTR(pEntry->observers, &target, pObserverEntry);
+    return pObserverEntry && ! pObserverEntry->markedForDeletion;
+}
+
+void CCNotificationCenter::removeObserversOfEntry(tHashNotificationEntry *pEntry, bool bMarkedOnly)
+{
+    tHashObserverEntry *pObserverEntry, *pTmp;
+    HASH_ITER(hh, pEntry->observers, pObserverEntry, pTmp)
     {
-        CCNotificationObserver* observer = (CCNotificationObserver*) obj;
-        if (!observer)
+        if (bMarkedOnly && ! pObserverEntry->markedForDeletion)
             continue;
-        
-        if (!strcmp(observer->getName(),name) && observer->getTarget() == target)
-            return true;
+
+        HASH_DEL(pEntry->observers, pObserverEntry);
+        pObserverEntry->observer->release();
+        free(pObserverEntry);
+    }
+    pEntry->hasMarkedObservers = false;
+
+    if (! pEntry->observers)
+    {
+        HASH_DEL(m_pHashForNames, pEntry);
+        delete [] pEntry->name;
+        free(pEntry);
     }
-    return false;
 }
 
 //
@@ -83,46 +139,95 @@ void CCNotificationCenter::addObserver(CCObject *target,
                                        const char *name,
                                        CCObject *obj)
 {
-    if (this->observerExisted(target, name))
+    tHashNotificationEntry *pEntry = NULL;
+    HASH_FIND_STR(m_pHashForNames, name, pEntry);
+    if (! pEntry)
+    {
+        pEntry = (tHashNotificationEntry *)calloc(sizeof(*pEntry), 1);
+        pEntry->name = new char[strlen(name) + 1];
+        strcpy(pEntry->name, name);
+        HASH_ADD_KEYPTR(hh, m_pHashForNames, pEntry->name, strlen(pEntry->name), pEntry);
+    }
+
+    tHashObserverEntry *pObserverEntry = NULL;
+    HASH_FIND_PTR(pEntry->observers, &target, pObserverEntry);
+    if (pObserverEntry && ! pObserverEntry->markedForDeletion)
         return;
     
     CCNotificationObserver *observer = new CCNotificationObserver(target, selector, name, obj);
     if (!observer)
         return;
-    
-    observer->autorelease();
-    m_observers->addObject(observer);
+
+    if (pObserverEntry)
+    {
+        // removed while the notification is posted, the old observer may be the one being called
+        pObserverEntry->observer->autorelease();
+        pObserverEntry->observer = observer;
+        pObserverEntry->markedForDeletion = false;
+        return;
+    }
+
+    pObserverEntry = (tHashObserverEntry *)calloc(sizeof(*pObserverEntry), 1);
+    pObserverEntry->target = target;
+    pObserverEntry->observer = observer;
+    HASH_ADD_PTR(pEntry->observers, target, pObserverEntry);
 }
 
 void CCNotificationCenter::removeObserver(CCObject *target,const char *name)
 {
-    CCObject* obj = NULL;
-    CCARRAY_FOREACH(m_observers, obj)
+    tHashNotificationEntry *pEntry = NULL;
+    HASH_FIND_STR(m_pHashForNames, name, pEntry);
+    if (! pEntry)
+        return;
+
+    tHashObserverEntry *pObserverEntry = NULL;
+    HASH_FIND_PTR(pEntry->observers, &target, pObserverEntry);
+    if (! pObserverEntry || pObserverEntry->markedForDeletion)
+        return;
+
+    if (pEntry->postCount > 0)
     {
-        CCNotificationObserver* observer = (CCNotificationObserver*) obj;
-        if (!observer)
-            continue;
-        
-        if (!strcmp(observer->getName(),name) && observer->getTarget() == target)
-        {
-            m_observers->removeObject(observer);
-            return;
-        }
+        // the notification is being posted, don't change the list that is iterated
+        pObserverEntry->markedForDeletion = true;
+        pEntry->hasMarkedObservers = true;
+        return;
+    }
+
+    HASH_DEL(pEntry->observers, pObserverEntry);
+    pObserverEntry->observer->release();
+    free(pObserverEntry);
+
+    if (! pEntry->observers)
+    {
+        HASH_DEL(m_pHashForNames, pEntry);
+        delete [] pEntry->name;
+        free(pEntry);
     }
 }
 
 void CCNotificationCenter::postNotification(const char *name, CCObject *object)
 {
-    CCObject* obj = NULL;
-    CCARRAY_FOREACH(m_observers, obj)
+    tHashNotificationEntry *pEntry = NULL;
+    HASH_FIND_STR(m_pHashForNames, name, pEntry);
+    if (! pEntry)
+        return;
+
+    // the observers added by the selectors are after the last one, and are not called
+    tHashObserverEntry *pLast = (tHashObserverEntry *)ELMT_FROM_HH(pEntry->observers->hh.tbl, pEntry->observers->hh.tbl->tail);
+
+    pEntry->postCount++;
+    for (tHashObserverEntry *pObserverEntry = pEntry->observers; pObserverEntry; pObserverEntry = (tHashObserverEntry *)pObserverEntry->hh.next)
     {
-        CCNotificationObserver* observer = (CCNotificationObserver*) obj;
-        if (!observer)
-            continue;
-        
-        if (!strcmp(name,observer->getName()))
-            observer->performSelector(object);
+        if (! pObserverEntry->markedForDeletion)
+            pObserverEntry->observer->performSelector(object);
+
+        if (pObserverEntry == pLast)
+            break;
     }
+    pEntry->postCount--;
+
+    if (pEntry->postCount == 0 && pEntry->hasMarkedObservers)
+        removeObserversOfEntry(pEntry, true);
 }
 
 void CCNotificationCenter::postNotification(const char *name)
@@ -130,6 +235,48 @@ void CCNotificationCenter::postNotification(const char *name)
     this->postNotification(name,NULL);
 }
 
+void CCNotificationCenter::enqueueNotification(const char *name, CCObject *object)
+{
+    QueuedNotification notification(name, object);
+    if (! m_queuedNotificationSet.insert(notification).second)
+        return;
+
+    CC_SAFE_RETAIN(object);
+    m_queuedNotifications.push_back(notification);
+
+    if (! m_bQueueScheduled)
+    {
+        CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(CCNotificationCenter::postQueuedNotifications), this, 0, false);
+        m_bQueueScheduled = true;
+    }
+}
+
+void CCNotificationCenter::enqueueNotification(const char *name)
+{
+    this->enqueueNotification(name, NULL);
+}
+
+void CCNotificationCenter::postQueuedNotifications(float dt)
+{
+    // the notifications queued by the observers are posted at the next frame
+    std::vector<QueuedNotification> notifications;
+    notifications.swap(m_queuedNotifications);
+    m_queuedNotificationSet.clear();
+
+    std::vector<QueuedNotification>::iterator it;
+    for (it = notifications.begin(); it != notifications.end(); ++it)
+    {
+        postNotification(it->first.c_str(), it->second);
+        CC_SAFE_RELEASE(it->second);
+    }
+
+    if (m_queuedNotifications.empty() && m_bQueueScheduled)
+    {
+        CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(CCNotificationCenter::postQueuedNotifications), this);
+        m_bQueueScheduled = false;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// CCNotificationObserver
@@ -154,7 +301,7 @@ CCNotificationObserver::CCNotificationObserver(CCObject *target,
 CCNotificationObserver::~CCNotificationObserver()
 {
     if (m_name)
-        delete m_name;
+        delete [] m_name;
 }
 
 void CCNotificationObserver::performSelector(CCObject *obj)
@@ -27,9 +27,22 @@ THE SOFTWARE.
 
 #include "cocoa/CCObject.h"
 #include "cocoa/CCArray.h"
+#include <string>
+#include <vector>
+#include <set>
 
 NS_CC_BEGIN;
 
+struct _hashNotificationEntry;
+
+/**
+ * The observers are kept in a hash of the notification names, and in a hash of their targets for each
+ * name: adding, removing and finding the observers of a notification don't depend on the number of
+ * observers of other notifications.
+ *
+ * Observers can be added and removed while a notification is posted. Removed observers are not
+ * called anymore, added observers are called from the next notification on.
+ */
 class CC_DLL CCNotificationCenter : public CCObject
 {
 public:
@@ -48,17 +61,35 @@ public:
     
     void postNotification(const char *name);
     void postNotification(const char *name, CCObject *object);
+
+    /** Posts the notification at the next frame. The notifications with the same name and object
+     queued before it is posted are posted once. The object is retained until then.
+     @since v2.1
+     */
+    void enqueueNotification(const char *name);
+    void enqueueNotification(const char *name, CCObject *object);
+    /** Posts the queued notifications now, in the order they were queued.
+     It is called by the scheduler at the next frame after a notification is queued.
+     @since v2.1
+     */
+    void postQueuedNotifications(float dt = 0);
     
 private:
     //
     // internal functions
     //
     bool observerExisted(CCObject *target,const char *name);
+    void removeObserversOfEntry(struct _hashNotificationEntry *pEntry, bool bMarkedOnly);
     
     //
     // variables
     //
-    CCArray *m_observers;
+    struct _hashNotificationEntry *m_pHashForNames;
+
+    typedef std::pair<std::string, CCObject*> QueuedNotification;
+    std::vector<QueuedNotification> m_queuedNotifications;
+    std::set<QueuedNotification> m_queuedNotificationSet;
+    bool m_bQueueScheduled;
 };
 
 class CC_DLL CCNotificationObserver : public CCObject
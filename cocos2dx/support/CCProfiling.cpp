@@ -23,6 +23,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include "CCProfiling.h"
+#include <stdio.h>
+#include <pthread.h>
+#if defined(_MSC_VER)
+#include <windows.h>
+#endif
 
 using namespace std;
 
@@ -152,6 +157,12 @@ void CCProfilingEndTimingBlock(const char *timerName)
 
     double duration = CCTime::timersubCocos2d((struct cc_timeval *)&timer->m_sStartTime, (struct cc_timeval *)&currentTime);
 
+    if (CCFrameProfiler::isRecording())
+    {
+        long long start = (long long)timer->m_sStartTime.tv_sec * 1000000 + timer->m_sStartTime.tv_usec;
+        CCFrameProfiler::sharedFrameProfiler()->addSpan(timerName, start, start + (long long)(duration * 1000));
+    }
+
     // milliseconds
     timer->m_dAverageTime = (timer->m_dAverageTime + duration) / 2.0f;
     timer->totalTime += duration;
@@ -170,5 +181,249 @@ void CCProfilingResetTimingBlock(const char *timerName)
     timer->reset();
 }
 
+// implementation of CCFrameProfiler
+
+static CCFrameProfiler* s_pSharedFrameProfiler = NULL;
+static pthread_key_t s_threadKey;
+static volatile unsigned int s_uThreads = 0;
+
+bool CCFrameProfiler::s_bRecording = false;
+
+static inline unsigned int atomicIncrement(volatile unsigned int* pValue)
+{
+#if defined(_MSC_VER)
+    return (unsigned int)InterlockedIncrement((volatile LONG*)pValue);
+#else
+    return __sync_add_and_fetch(pValue, 1);
+#endif
+}
+
+static inline void memoryBarrier()
+{
+#if defined(_MSC_VER)
+    MemoryBarrier();
+#else
+    __sync_synchronize();
+#endif
+}
+
+CCFrameProfiler* CCFrameProfiler::sharedFrameProfiler()
+{
+    if (! s_pSharedFrameProfiler)
+    {
+        s_pSharedFrameProfiler = new CCFrameProfiler();
+        pthread_key_create(&s_threadKey, NULL);
+    }
+    return s_pSharedFrameProfiler;
+}
+
+void CCFrameProfiler::purgeSharedFrameProfiler()
+{
+    if (s_pSharedFrameProfiler)
+    {
+        s_pSharedFrameProfiler->stop();
+        CC_SAFE_RELEASE_NULL(s_pSharedFrameProfiler);
+        pthread_key_delete(s_threadKey);
+    }
+}
+
+CCFrameProfiler::CCFrameProfiler()
+: m_pSpans(NULL)
+, m_uNextSpan(0)
+, m_uFrame(0)
+, m_uSlowFrames(0)
+, m_fFrameBudget(1000.0f / 60)
+, m_lFrameStart(0)
+, m_lOrigin(0)
+{
+}
+
+CCFrameProfiler::~CCFrameProfiler()
+{
+    CC_SAFE_FREE(m_pSpans);
+}
+
+void CCFrameProfiler::start()
+{
+    if (! m_pSpans)
+    {
+        m_pSpans = (ccProfilerSpan*)calloc(CC_FRAME_PROFILER_CAPACITY, sizeof(ccProfilerSpan));
+        if (! m_pSpans)
+        {
+            CCLOG("cocos2d: CCFrameProfiler: not enough memory");
+            return;
+        }
+        m_lOrigin = now();
+    }
+    s_bRecording = true;
+}
+
+void CCFrameProfiler::stop()
+{
+    s_bRecording = false;
+    m_lFrameStart = 0;
+}
+
+void CCFrameProfiler::reset()
+{
+    if (m_pSpans)
+    {
+        memset(m_pSpans, 0, CC_FRAME_PROFILER_CAPACITY * sizeof(ccProfilerSpan));
+    }
+    m_uNextSpan = 0;
+    m_uFrame = 0;
+    m_uSlowFrames = 0;
+    m_lFrameStart = 0;
+    m_lOrigin = now();
+}
+
+long long CCFrameProfiler::now()
+{
+    struct cc_timeval tv;
+    CCTime::getMonotonicTime(&tv);
+    return (long long)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+unsigned int CCFrameProfiler::currentThread()
+{
+    // ids are stored + 1, NULL means that the thread has no id yet
+    size_t uThread = (size_t)pthread_getspecific(s_threadKey);
+    if (! uThread)
+    {
+        uThread = atomicIncrement(&s_uThreads);
+        pthread_setspecific(s_threadKey, (void*)uThread);
+    }
+    return (unsigned int)uThread;
+}
+
+void CCFrameProfiler::addSpan(const char* pszName, long long start, long long end)
+{
+    if (! s_bRecording || ! m_pSpans)
+    {
+        return;
+    }
+
+    unsigned int uIndex = atomicIncrement(&m_uNextSpan) - 1;
+    ccProfilerSpan* pSpan = &m_pSpans[uIndex % CC_FRAME_PROFILER_CAPACITY];
+
+    // readers skip the slot until its sequence matches
+    pSpan->sequence = 0;
+    memoryBarrier();
+    pSpan->name = pszName;
+    pSpan->start = start;
+    pSpan->duration = (unsigned int)(end > start ? end - start : 0);
+    pSpan->frame = m_uFrame;
+    pSpan->thread = currentThread();
+    memoryBarrier();
+    pSpan->sequence = uIndex + 1;
+}
+
+void CCFrameProfiler::beginFrame()
+{
+    m_lFrameStart = now();
+}
+
+void CCFrameProfiler::endFrame()
+{
+    // recording may have started in the middle of the frame
+    if (m_lFrameStart)
+    {
+        long long end = now();
+        addSpan("frame", m_lFrameStart, end);
+        if (end - m_lFrameStart > (long long)(m_fFrameBudget * 1000))
+        {
+            m_uSlowFrames++;
+        }
+        m_uFrame++;
+    }
+    m_lFrameStart = 0;
+}
+
+bool CCFrameProfiler::writeChromeTrace(const char* pszPath)
+{
+    FILE* fp = fopen(pszPath, "w");
+    if (! fp)
+    {
+        CCLOG("cocos2d: CCFrameProfiler: can't write %s", pszPath);
+        return false;
+    }
+
+    fprintf(fp, "{\"traceEvents\":[\n");
+
+    unsigned int uEnd = m_uNextSpan;
+    unsigned int uBegin = uEnd > CC_FRAME_PROFILER_CAPACITY ? uEnd - CC_FRAME_PROFILER_CAPACITY : 0;
+    bool bFirst = true;
+    for (unsigned int i = uBegin; m_pSpans && i != uEnd; ++i)
+    {
+        ccProfilerSpan span = m_pSpans[i % CC_FRAME_PROFILER_CAPACITY];
+        // skip the spans that are being written, or were overwritten
+        if (span.sequence != i + 1 || ! span.name)
+        {
+            continue;
+        }
+
+        fprintf(fp, "%s{\"name\":\"", bFirst ? "" : ",\n");
+        for (const char* c = span.name; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                fputc('\\', fp);
+            }
+            fputc(*c, fp);
+        }
+        fprintf(fp, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lld,\"dur\":%u,\"args\":{\"frame\":%u}}",
+                span.thread, span.start - m_lOrigin, span.duration, span.frame);
+        bFirst = false;
+    }
+
+    fprintf(fp, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    bool bRet = ferror(fp) == 0;
+    fclose(fp);
+    return bRet;
+}
+
+unsigned int CCFrameProfiler::getPhaseTimes(ccProfilerPhase* pPhases, unsigned int uMaxPhases)
+{
+    unsigned int uPhases = 0;
+
+    unsigned int uEnd = m_uNextSpan;
+    unsigned int uBegin = uEnd > CC_FRAME_PROFILER_CAPACITY ? uEnd - CC_FRAME_PROFILER_CAPACITY : 0;
+    for (unsigned int i = uBegin; m_pSpans && i != uEnd; ++i)
+    {
+        ccProfilerSpan span = m_pSpans[i % CC_FRAME_PROFILER_CAPACITY];
+        if (span.sequence != i + 1 || ! span.name)
+        {
+            continue;
+        }
+
+        // there are few names, and they are usually the same literals
+        unsigned int uPhase = 0;
+        while (uPhase < uPhases && pPhases[uPhase].name != span.name && strcmp(pPhases[uPhase].name, span.name) != 0)
+        {
+            ++uPhase;
+        }
+
+        if (uPhase == uPhases)
+        {
+            if (uPhases == uMaxPhases)
+            {
+                continue;
+            }
+            pPhases[uPhase].name = span.name;
+            pPhases[uPhase].calls = 0;
+            pPhases[uPhase].total = 0;
+            pPhases[uPhase].longest = 0;
+            ++uPhases;
+        }
+
+        ccProfilerPhase* pPhase = &pPhases[uPhase];
+        pPhase->calls++;
+        pPhase->total += span.duration;
+        pPhase->longest = MAX(pPhase->longest, span.duration);
+    }
+
+    return uPhases;
+}
+
 NS_CC_END
 
@@ -87,6 +87,142 @@ public:
     unsigned int    numberOfCalls;
 };
 
+/** a span recorded by CCFrameProfiler */
+typedef struct _ccProfilerSpan
+{
+    //! name of the span. It must stay valid, usually it is a string literal
+    const char*             name;
+    //! start time in microseconds
+    long long               start;
+    //! duration in microseconds
+    unsigned int            duration;
+    //! frame during which the span was recorded
+    unsigned int            frame;
+    //! recording thread, 1 is the first thread that recorded a span
+    unsigned int            thread;
+    //! index + 1 of the span stored in this slot, 0 while the slot is being written
+    volatile unsigned int   sequence;
+} ccProfilerSpan;
+
+/** the spans of one name, summed by CCFrameProfiler::getPhaseTimes */
+typedef struct _ccProfilerPhase
+{
+    //! name of the spans
+    const char*             name;
+    //! number of spans
+    unsigned int            calls;
+    //! sum of the durations in microseconds
+    long long               total;
+    //! longest span in microseconds
+    unsigned int            longest;
+} ccProfilerPhase;
+
+/** @brief CCFrameProfiler
+ Records the phases of each frame (scheduler, actions, visit, draw, texture uploads,
+ autorelease pool...) as nested spans, and exports them as a Chrome trace event file
+ that can be opened with chrome://tracing.
+
+ Unlike CCProfiler, which only keeps averages, each span is kept, so the frames that
+ go over budget can be found. Spans are stored in a ring buffer of
+ CC_FRAME_PROFILER_CAPACITY spans; when it is full the oldest spans are overwritten.
+ Recording doesn't take locks: a span reserves its slot with an atomic increment,
+ so spans can be recorded from any thread.
+
+ The profiler is compiled in when CC_ENABLE_FRAME_PROFILER is set, and records only
+ between start() and stop(). A span costs a branch when the profiler isn't recording.
+ @since v2.1
+ */
+class CC_DLL CCFrameProfiler : public CCObject
+{
+public:
+    CCFrameProfiler();
+    ~CCFrameProfiler();
+
+    /** returns the shared instance */
+    static CCFrameProfiler* sharedFrameProfiler();
+    /** purges the shared instance */
+    static void purgeSharedFrameProfiler();
+
+    /** starts recording. The ring buffer is allocated by the first call */
+    void start();
+    /** stops recording. The recorded spans are kept */
+    void stop();
+    /** whether or not spans are being recorded */
+    static inline bool isRecording() { return s_bRecording; }
+    /** discards the recorded spans and the frame counters */
+    void reset();
+
+    /** current time in microseconds */
+    static long long now();
+
+    /** records a span. pszName must stay valid, usually it is a string literal */
+    void addSpan(const char* pszName, long long start, long long end);
+
+    /** called by the director at the beginning and at the end of each frame */
+    void beginFrame();
+    void endFrame();
+
+    /** frames that took longer than the budget are counted as slow. Default is 1/60 s */
+    inline void setFrameBudget(float fMilliseconds) { m_fFrameBudget = fMilliseconds; }
+    inline float getFrameBudget() { return m_fFrameBudget; }
+    /** number of frames recorded since the last reset() */
+    inline unsigned int getNumberOfFrames() { return m_uFrame; }
+    /** number of recorded frames that went over budget */
+    inline unsigned int getNumberOfSlowFrames() { return m_uSlowFrames; }
+
+    /** writes the spans that are in the ring buffer as a Chrome trace event JSON file
+     @return false if the file couldn't be written
+     */
+    bool writeChromeTrace(const char* pszPath);
+
+    /** sums the spans that are in the ring buffer by name, in the order the names were first recorded.
+     The "frame" phase gives the number of frames they were recorded in.
+     @return the number of phases written to pPhases, at most uMaxPhases
+     */
+    unsigned int getPhaseTimes(ccProfilerPhase* pPhases, unsigned int uMaxPhases);
+
+private:
+    unsigned int currentThread();
+
+private:
+    static bool             s_bRecording;
+
+    ccProfilerSpan*         m_pSpans;
+    volatile unsigned int   m_uNextSpan;
+    unsigned int            m_uFrame;
+    unsigned int            m_uSlowFrames;
+    float                   m_fFrameBudget;
+    long long               m_lFrameStart;
+    long long               m_lOrigin;
+};
+
+/** records a span from its construction to its destruction. Used by CC_FRAME_PROFILER_SCOPE */
+class CC_DLL CCFrameProfilerScope
+{
+public:
+    inline CCFrameProfilerScope(const char* pszName)
+    : m_pszName(NULL)
+    {
+        if (CCFrameProfiler::isRecording())
+        {
+            m_pszName = pszName;
+            m_lStart = CCFrameProfiler::now();
+        }
+    }
+
+    inline ~CCFrameProfilerScope()
+    {
+        if (m_pszName)
+        {
+            CCFrameProfiler::sharedFrameProfiler()->addSpan(m_pszName, m_lStart, CCFrameProfiler::now());
+        }
+    }
+
+private:
+    const char* m_pszName;
+    long long   m_lStart;
+};
+
 extern void CCProfilingBeginTimingBlock(const char *timerName);
 extern void CCProfilingEndTimingBlock(const char *timerName);
 extern void CCProfilingResetTimingBlock(const char *timerName);
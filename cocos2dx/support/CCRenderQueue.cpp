@@ -0,0 +1,301 @@
+/****************************************************************************
+Copyright (c) 2012      cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "CCRenderQueue.h"
+#include "ccMacros.h"
+#include "CCEventType.h"
+#include "shaders/CCGLProgram.h"
+#include "shaders/CCShaderCache.h"
+#include "support/CCNotificationCenter.h"
+#include "support/CCProfiling.h"
+// externals
+#include "kazmath/GL/matrix.h"
+#include <stdlib.h>
+
+NS_CC_BEGIN
+
+// indices are GLushort, so a single draw can't address more than 65536 vertices
+#define kCCRenderQueueMaxQuads      16384
+#define kCCRenderQueueInitialQuads  64
+
+static CCRenderQueue *s_pSharedRenderQueue = NULL;
+
+CCRenderQueue* CCRenderQueue::sharedRenderQueue()
+{
+    if (! s_pSharedRenderQueue)
+    {
+        s_pSharedRenderQueue = new CCRenderQueue();
+        if (! s_pSharedRenderQueue->init())
+        {
+            CC_SAFE_DELETE(s_pSharedRenderQueue);
+        }
+    }
+    return s_pSharedRenderQueue;
+}
+
+void CCRenderQueue::purgeSharedRenderQueue()
+{
+    CC_SAFE_RELEASE_NULL(s_pSharedRenderQueue);
+}
+
+CCRenderQueue::CCRenderQueue()
+: m_bAutoBatchingEnabled(false)
+, m_bFlushing(false)
+, m_pQuads(NULL)
+, m_pIndices(NULL)
+, m_uTotalQuads(0)
+, m_uCapacity(0)
+, m_bIndicesDirty(false)
+, m_uTexture(0)
+, m_pProgram(NULL)
+, m_pBatchableProgram(NULL)
+, m_eGLServerState(CC_GL_BLEND)
+, m_uBatchedQuads(0)
+, m_uBatchedDraws(0)
+{
+    m_tBlendFunc.src = CC_BLEND_SRC;
+    m_tBlendFunc.dst = CC_BLEND_DST;
+    m_pBuffersVBO[0] = m_pBuffersVBO[1] = 0;
+}
+
+CCRenderQueue::~CCRenderQueue()
+{
+    CCLOGINFO("cocos2d: CCRenderQueue deallocing %p.", this);
+
+    CC_SAFE_FREE(m_pQuads);
+    CC_SAFE_FREE(m_pIndices);
+
+    if (m_pBuffersVBO[0])
+    {
+        glDeleteBuffers(2, m_pBuffersVBO);
+    }
+
+    CCNotificationCenter::sharedNotificationCenter()->removeObserver(this, EVNET_COME_TO_FOREGROUND);
+}
+
+bool CCRenderQueue::init()
+{
+    // the VBOs are lazily created by the first quad, so an unused queue doesn't touch GL
+    CCNotificationCenter::sharedNotificationCenter()->addObserver(this,
+                                                           callfuncO_selector(CCRenderQueue::listenBackToForeground),
+                                                           EVNET_COME_TO_FOREGROUND,
+                                                           NULL);
+    return true;
+}
+
+void CCRenderQueue::setAutoBatchingEnabled(bool bEnabled)
+{
+    if (m_bAutoBatchingEnabled != bEnabled)
+    {
+        flush();
+        m_bAutoBatchingEnabled = bEnabled;
+        m_pBatchableProgram = bEnabled ? CCShaderCache::sharedShaderCache()->programForKey(kCCShader_PositionTextureColor) : NULL;
+    }
+}
+
+void CCRenderQueue::resetStats()
+{
+    m_uBatchedQuads = 0;
+    m_uBatchedDraws = 0;
+}
+
+void CCRenderQueue::listenBackToForeground(CCObject *obj)
+{
+    if (m_pBuffersVBO[0])
+    {
+        m_pBuffersVBO[0] = m_pBuffersVBO[1] = 0;
+        setupVBO();
+    }
+}
+
+void CCRenderQueue::setupIndices(unsigned int uFrom)
+{
+    for (unsigned int i = uFrom; i < m_uCapacity; i++)
+    {
+        m_pIndices[i*6+0] = i*4+0;
+        m_pIndices[i*6+1] = i*4+1;
+        m_pIndices[i*6+2] = i*4+2;
+
+        // inverted index. issue #179
+        m_pIndices[i*6+3] = i*4+3;
+        m_pIndices[i*6+4] = i*4+2;
+        m_pIndices[i*6+5] = i*4+1;
+    }
+}
+
+void CCRenderQueue::setupVBO()
+{
+    glGenBuffers(2, &m_pBuffersVBO[0]);
+    m_bIndicesDirty = true;
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+bool CCRenderQueue::resizeCapacity(unsigned int uNewCapacity)
+{
+    ccV3F_C4B_T2F_Quad* pTmpQuads = (ccV3F_C4B_T2F_Quad*)realloc(m_pQuads, uNewCapacity * sizeof(m_pQuads[0]));
+    if (! pTmpQuads)
+    {
+        return false;
+    }
+    m_pQuads = pTmpQuads;
+
+    GLushort* pTmpIndices = (GLushort*)realloc(m_pIndices, uNewCapacity * 6 * sizeof(m_pIndices[0]));
+    if (! pTmpIndices)
+    {
+        return false;
+    }
+    m_pIndices = pTmpIndices;
+
+    unsigned int uOldCapacity = m_uCapacity;
+    m_uCapacity = uNewCapacity;
+    setupIndices(uOldCapacity);
+
+    if (! m_pBuffersVBO[0])
+    {
+        setupVBO();
+    }
+    m_bIndicesDirty = true;
+
+    return true;
+}
+
+bool CCRenderQueue::addQuad(const ccV3F_C4B_T2F_Quad& quad, const kmMat4& modelView, GLuint texture, CCGLProgram* pProgram, const ccBlendFunc& blendFunc, ccGLServerState glServerState)
+{
+    // other programs might have per node uniforms, that can't be shared by a batch
+    if (! m_bAutoBatchingEnabled || pProgram != m_pBatchableProgram)
+    {
+        return false;
+    }
+
+    if (m_uTotalQuads > 0 &&
+        (m_uTexture != texture || m_pProgram != pProgram ||
+         m_tBlendFunc.src != blendFunc.src || m_tBlendFunc.dst != blendFunc.dst ||
+         m_eGLServerState != glServerState))
+    {
+        flush();
+    }
+
+    if (m_uTotalQuads == m_uCapacity)
+    {
+        if (m_uCapacity == kCCRenderQueueMaxQuads ||
+            ! resizeCapacity(MIN(MAX(m_uCapacity * 2, kCCRenderQueueInitialQuads), kCCRenderQueueMaxQuads)))
+        {
+            flush();
+        }
+
+        if (m_uTotalQuads == m_uCapacity)
+        {
+            // out of memory: let the caller draw the quad by itself
+            return false;
+        }
+    }
+
+    m_uTexture = texture;
+    m_pProgram = pProgram;
+    m_tBlendFunc = blendFunc;
+    m_eGLServerState = glServerState;
+
+    // bake the model-view matrix into the vertices, so the batch can be drawn with an identity model-view
+    const float *m = modelView.mat;
+
+    ccV3F_C4B_T2F_Quad *pQuad = &m_pQuads[m_uTotalQuads++];
+    *pQuad = quad;
+
+    ccV3F_C4B_T2F *pVertex = (ccV3F_C4B_T2F*)pQuad;
+    for (int i = 0; i < 4; i++)
+    {
+        ccVertex3F v = pVertex[i].vertices;
+        pVertex[i].vertices.x = v.x * m[0] + v.y * m[4] + v.z * m[8]  + m[12];
+        pVertex[i].vertices.y = v.x * m[1] + v.y * m[5] + v.z * m[9]  + m[13];
+        pVertex[i].vertices.z = v.x * m[2] + v.y * m[6] + v.z * m[10] + m[14];
+    }
+
+    return true;
+}
+
+void CCRenderQueue::flush()
+{
+    if (m_uTotalQuads == 0 || m_bFlushing)
+    {
+        return;
+    }
+
+    CC_FRAME_PROFILER_SCOPE("render queue");
+
+    // CCGLProgram::use() flushes the queue too
+    m_bFlushing = true;
+
+    ccGLEnable(m_eGLServerState);
+    m_pProgram->use();
+
+    kmGLMatrixMode(KM_GL_MODELVIEW);
+    kmGLPushMatrix();
+    kmGLLoadIdentity();
+    m_pProgram->setUniformForModelViewProjectionMatrix();
+    kmGLPopMatrix();
+
+    ccGLBlendFunc(m_tBlendFunc.src, m_tBlendFunc.dst);
+    ccGLBindTexture2D(m_uTexture);
+
+#define kQuadSize sizeof(m_pQuads[0].bl)
+    glBindBuffer(GL_ARRAY_BUFFER, m_pBuffersVBO[0]);
+    // orphan the previous storage, the driver doesn't need to wait for the last batch to finish
+    glBufferData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0]) * m_uCapacity, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(m_pQuads[0]) * m_uTotalQuads, m_pQuads);
+    CC_INCREMENT_GL_UPLOADED_BYTES(sizeof(m_pQuads[0]) * m_uTotalQuads);
+
+    ccGLEnableVertexAttribs(kCCVertexAttribFlag_PosColorTex);
+
+    // vertices
+    glVertexAttribPointer(kCCVertexAttrib_Position, 3, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(ccV3F_C4B_T2F, vertices));
+
+    // colors
+    glVertexAttribPointer(kCCVertexAttrib_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, kQuadSize, (GLvoid*) offsetof(ccV3F_C4B_T2F, colors));
+
+    // tex coords
+    glVertexAttribPointer(kCCVertexAttrib_TexCoords, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(ccV3F_C4B_T2F, texCoords));
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_pBuffersVBO[1]);
+    if (m_bIndicesDirty)
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(m_pIndices[0]) * m_uCapacity * 6, m_pIndices, GL_STATIC_DRAW);
+        m_bIndicesDirty = false;
+    }
+
+    glDrawElements(GL_TRIANGLES, (GLsizei)m_uTotalQuads*6, GL_UNSIGNED_SHORT, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWS(1);
+    CHECK_GL_ERROR_DEBUG();
+
+    m_uBatchedQuads += m_uTotalQuads;
+    m_uBatchedDraws++;
+    m_uTotalQuads = 0;
+    m_bFlushing = false;
+}
+
+NS_CC_END
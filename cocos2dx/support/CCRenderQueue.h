@@ -0,0 +1,130 @@
+/****************************************************************************
+Copyright (c) 2012      cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __SUPPORT_CCRENDERQUEUE_H__
+#define __SUPPORT_CCRENDERQUEUE_H__
+
+#include "cocoa/CCObject.h"
+#include "ccTypes.h"
+#include "CCGL.h"
+#include "shaders/ccGLStateCache.h"
+#include "kazmath/mat4.h"
+
+NS_CC_BEGIN
+
+class CCGLProgram;
+
+/**
+ * @addtogroup global
+ * @{
+ */
+
+/** @brief CCRenderQueue
+ Singleton that merges consecutive quad draws into a single VBO backed draw call.
+
+ When automatic batching is enabled, CCSprite::draw doesn't issue its own glDrawArrays.
+ Instead the quad is transformed into world space using the node's cached model-view matrix
+ and appended to the queue. Consecutive quads that share the same texture, shader program,
+ blend function and GL server state are drawn with a single glDrawElements.
+
+ Any other draw (anything that calls CCGLProgram::setUniformForModelViewProjectionMatrix)
+ flushes the pending quads first, so the visit order of the scene graph is preserved.
+ Code that changes the GL state without setting up a shader (FBOs, scissor, projection)
+ should call flush() before doing it.
+
+ Automatic batching is disabled by default.
+ @since v2.1
+ */
+class CC_DLL CCRenderQueue : public CCObject
+{
+public:
+    CCRenderQueue();
+    virtual ~CCRenderQueue();
+
+    /** returns the shared instance */
+    static CCRenderQueue* sharedRenderQueue();
+
+    /** purges the shared instance. It releases the retained instance. */
+    static void purgeSharedRenderQueue();
+
+    bool init();
+
+    /** whether or not CCSprite draws are merged by the queue. Default is false */
+    inline bool isAutoBatchingEnabled() { return m_bAutoBatchingEnabled; }
+    void setAutoBatchingEnabled(bool bEnabled);
+
+    /** appends a quad that is expressed in the given model-view space.
+     If the texture, program, blend function or server state differs from the pending ones,
+     the pending quads are drawn first.
+     Only quads that use the kCCShader_PositionTextureColor program are batched.
+     @return false if the quad was not queued and the caller should draw it by itself
+     */
+    bool addQuad(const ccV3F_C4B_T2F_Quad& quad, const kmMat4& modelView, GLuint texture, CCGLProgram* pProgram, const ccBlendFunc& blendFunc, ccGLServerState glServerState);
+
+    /** draws the pending quads, if any */
+    void flush();
+
+    /** number of quads that were drawn through the queue since the last resetStats() */
+    inline unsigned int getNumberOfBatchedQuads() { return m_uBatchedQuads; }
+    /** number of draw calls issued by the queue since the last resetStats() */
+    inline unsigned int getNumberOfBatchedDraws() { return m_uBatchedDraws; }
+    /** resets the quads / draws counters. Called once per frame by CCDirector */
+    void resetStats();
+
+    /** recreates the VBOs. Used when the GL context was lost */
+    void listenBackToForeground(CCObject *obj);
+
+private:
+    void setupIndices(unsigned int uFrom);
+    void setupVBO();
+    bool resizeCapacity(unsigned int uNewCapacity);
+
+private:
+    bool                m_bAutoBatchingEnabled;
+    bool                m_bFlushing;
+
+    ccV3F_C4B_T2F_Quad* m_pQuads;
+    GLushort*           m_pIndices;
+    GLuint              m_pBuffersVBO[2]; //0: vertex  1: indices
+    unsigned int        m_uTotalQuads;
+    unsigned int        m_uCapacity;
+    bool                m_bIndicesDirty;
+
+    // state shared by the pending quads
+    GLuint              m_uTexture;
+    CCGLProgram*        m_pProgram;
+    CCGLProgram*        m_pBatchableProgram;
+    ccBlendFunc         m_tBlendFunc;
+    ccGLServerState     m_eGLServerState;
+
+    unsigned int        m_uBatchedQuads;
+    unsigned int        m_uBatchedDraws;
+};
+
+// end of global group
+/// @}
+
+NS_CC_END
+
+#endif // __SUPPORT_CCRENDERQUEUE_H__
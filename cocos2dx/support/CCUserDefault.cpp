@@ -24,107 +24,352 @@ THE SOFTWARE.
 #include "CCUserDefault.h"
 #include "platform/CCCommon.h"
 #include "platform/CCFileUtils.h"
+#include "cocoa/CCDictionary.h"
+#include "cocoa/CCString.h"
 #include <libxml/parser.h>
 #include <libxml/tree.h>
+#include <pthread.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
 
-// root name of xml
-#define USERDEFAULT_ROOT_NAME    "userDefaultRoot"
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #define XML_FILE_NAME "UserDefault.xml"
 
+#define BINARY_FILE_NAME "UserDefault.bin"
+
+// "CCUD", version, count of values, then for each value:
+// key length, value length, key bytes, value bytes. Integers are 32 bits little endian.
+#define BINARY_FILE_MAGIC "CCUD"
+#define BINARY_FILE_VERSION 1
+#define BINARY_FILE_HEADER_SIZE 12
+
 using namespace std;
 
 NS_CC_BEGIN
 
-static xmlDocPtr g_sharedDoc = NULL;
+// the values, as strings, keyed by their key
+static CCDictionary* s_pValues = NULL;
+// whether a value changed since the last flush
+static bool s_bDirty = false;
 
 /**
- * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * the writer thread saves the values passed by flush()
  */
 
-static xmlNodePtr getXMLNodeForKey(const char* pKey, xmlNodePtr *rootNode)
+static pthread_t        s_writerThread;
+static bool             s_bWriterStarted = false;
+static bool             s_bWriterQuit = false;
+static pthread_mutex_t  s_writerMutex;
+// signaled when values are passed to the writer, or when it has to quit
+static pthread_cond_t   s_writerCond;
+// signaled when the writer has written the values
+static pthread_cond_t   s_writtenCond;
+// serialized values waiting to be written, NULL if there are none
+static string*          s_pPendingData = NULL;
+static bool             s_bWriting = false;
+
+static inline void appendUInt32(string& data, unsigned int uValue)
 {
-    xmlNodePtr curNode = NULL;
+    data += (char)(uValue & 0xff);
+    data += (char)((uValue >> 8) & 0xff);
+    data += (char)((uValue >> 16) & 0xff);
+    data += (char)((uValue >> 24) & 0xff);
+}
 
-    // check the key value
-    if (! pKey)
+static inline unsigned int readUInt32(const unsigned char* pData)
+{
+    return pData[0] | (pData[1] << 8) | (pData[2] << 16) | ((unsigned int)pData[3] << 24);
+}
+
+static void serializeValues(string& data)
+{
+    data.reserve(BINARY_FILE_HEADER_SIZE + s_pValues->count() * 32);
+    data.append(BINARY_FILE_MAGIC, 4);
+    appendUInt32(data, BINARY_FILE_VERSION);
+    appendUInt32(data, s_pValues->count());
+
+    CCDictElement* pElement = NULL;
+    CCDICT_FOREACH(s_pValues, pElement)
     {
-        return NULL;
+        const char* pKey = pElement->getStrKey();
+        const string& value = ((CCString*)pElement->getObject())->m_sString;
+        unsigned int uKeyLength = strlen(pKey);
+
+        appendUInt32(data, uKeyLength);
+        appendUInt32(data, value.size());
+        data.append(pKey, uKeyLength);
+        data.append(value);
+    }
+}
+
+// writes the data in a temporary file, then replaces the file with it,
+// so a crash while writing leaves the previous file intact
+static bool writeFile(const string& path, const string& data)
+{
+    string tmpPath = path + ".tmp";
+    FILE* fp = fopen(tmpPath.c_str(), "wb");
+    if (! fp)
+    {
+        CCLOG("CCUserDefault: can not open %s: %s", tmpPath.c_str(), strerror(errno));
+        return false;
+    }
+
+    bool bRet = (fwrite(data.data(), 1, data.size(), fp) == data.size()) && (fflush(fp) == 0);
+    if (bRet)
+    {
+        // make sure the data is on the disk before the file is replaced
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        _commit(_fileno(fp));
+#else
+        fsync(fileno(fp));
+#endif
+    }
+    fclose(fp);
+
+    if (! bRet)
+    {
+        CCLOG("CCUserDefault: can not write %s", tmpPath.c_str());
+        remove(tmpPath.c_str());
+        return false;
+    }
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    // rename doesn't replace an existing file on win32. If the application is killed
+    // before the rename, the temporary file is loaded instead.
+    remove(path.c_str());
+#endif
+    if (rename(tmpPath.c_str(), path.c_str()) != 0)
+    {
+        CCLOG("CCUserDefault: can not rename %s: %s", tmpPath.c_str(), strerror(errno));
+        return false;
     }
 
-    do 
+    return true;
+}
+
+static void* writeValues(void* data)
+{
+    while (true)
     {
-        // get root node
-        *rootNode = xmlDocGetRootElement(g_sharedDoc);
-        if (NULL == *rootNode)
+        pthread_mutex_lock(&s_writerMutex);
+        while (! s_pPendingData && ! s_bWriterQuit)
+        {
+            pthread_cond_wait(&s_writerCond, &s_writerMutex);
+        }
+
+        // the values passed before quitting are written
+        if (! s_pPendingData)
         {
-            CCLOG("read root node error");
+            pthread_mutex_unlock(&s_writerMutex);
             break;
         }
 
-        // find the node
-        curNode = (*rootNode)->xmlChildrenNode;
-        while (NULL != curNode)
+        string* pData = s_pPendingData;
+        s_pPendingData = NULL;
+        s_bWriting = true;
+        pthread_mutex_unlock(&s_writerMutex);
+
+        writeFile(CCUserDefault::getFilePath(), *pData);
+        delete pData;
+
+        pthread_mutex_lock(&s_writerMutex);
+        s_bWriting = false;
+        pthread_cond_broadcast(&s_writtenCond);
+        pthread_mutex_unlock(&s_writerMutex);
+    }
+
+    return 0;
+}
+
+static bool startWriterThread()
+{
+    pthread_mutex_init(&s_writerMutex, NULL);
+    pthread_cond_init(&s_writerCond, NULL);
+    pthread_cond_init(&s_writtenCond, NULL);
+
+    s_bWriterQuit = false;
+    if (pthread_create(&s_writerThread, NULL, writeValues, NULL) != 0)
+    {
+        CCLOG("CCUserDefault writer thread creation error: %s\n", strerror(errno));
+        pthread_mutex_destroy(&s_writerMutex);
+        pthread_cond_destroy(&s_writerCond);
+        pthread_cond_destroy(&s_writtenCond);
+        return false;
+    }
+
+    s_bWriterStarted = true;
+    return true;
+}
+
+static void stopWriterThread()
+{
+    if (! s_bWriterStarted)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&s_writerMutex);
+    s_bWriterQuit = true;
+    pthread_cond_signal(&s_writerCond);
+    pthread_mutex_unlock(&s_writerMutex);
+
+    pthread_join(s_writerThread, NULL);
+    s_bWriterStarted = false;
+
+    pthread_mutex_destroy(&s_writerMutex);
+    pthread_cond_destroy(&s_writerCond);
+    pthread_cond_destroy(&s_writtenCond);
+}
+
+/**
+ * loading of the files
+ */
+
+static void setValueForKey(const char* pKey, const char* pValue);
+
+static bool loadBinaryFile(const string& path)
+{
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (! fp)
+    {
+        return false;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long nSize = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    unsigned char* pData = NULL;
+    bool bRet = false;
+    do
+    {
+        CC_BREAK_IF(nSize < BINARY_FILE_HEADER_SIZE);
+        pData = new unsigned char[nSize];
+        CC_BREAK_IF(fread(pData, 1, nSize, fp) != (size_t)nSize);
+        CC_BREAK_IF(memcmp(pData, BINARY_FILE_MAGIC, 4) != 0 || readUInt32(pData + 4) != BINARY_FILE_VERSION);
+
+        unsigned int uCount = readUInt32(pData + 8);
+        unsigned long uOffset = BINARY_FILE_HEADER_SIZE;
+        unsigned int i = 0;
+        for (; i < uCount; ++i)
         {
-            if (! xmlStrcmp(curNode->name, BAD_CAST pKey))
+            if (nSize - uOffset < 8)
+            {
+                break;
+            }
+            unsigned long uKeyLength = readUInt32(pData + uOffset);
+            unsigned long uValueLength = readUInt32(pData + uOffset + 4);
+            uOffset += 8;
+            if (nSize - uOffset < uKeyLength || nSize - uOffset - uKeyLength < uValueLength)
             {
                 break;
             }
 
-            curNode = curNode->next;
+            string key((const char*)pData + uOffset, uKeyLength);
+            uOffset += uKeyLength;
+            string value((const char*)pData + uOffset, uValueLength);
+            uOffset += uValueLength;
+
+            setValueForKey(key.c_str(), value.c_str());
         }
+
+        bRet = (i == uCount);
     } while (0);
 
-    return curNode;
+    CC_SAFE_DELETE_ARRAY(pData);
+    fclose(fp);
+
+    if (! bRet)
+    {
+        CCLOG("CCUserDefault: %s is corrupted", path.c_str());
+        s_pValues->removeAllObjects();
+    }
+    return bRet;
 }
 
-static inline const char* getValueForKey(const char* pKey)
+// imports the values of the xml file used by previous versions
+static bool importXMLFile(const string& path)
 {
-    const char* ret = NULL;
-    xmlNodePtr rootNode;
-    xmlNodePtr node = getXMLNodeForKey(pKey, &rootNode);
+    FILE* fp = fopen(path.c_str(), "r");
+    if (! fp)
+    {
+        return false;
+    }
+    fclose(fp);
 
-    // find the node
-    if (node)
+    xmlDocPtr doc = xmlReadFile(path.c_str(), "utf-8", XML_PARSE_RECOVER);
+    if (! doc)
     {
-        ret = (const char*)xmlNodeGetContent(node);
+        CCLOG("CCUserDefault: can not read %s", path.c_str());
+        return false;
     }
 
-    return ret;
+    xmlNodePtr rootNode = xmlDocGetRootElement(doc);
+    if (rootNode)
+    {
+        for (xmlNodePtr curNode = rootNode->xmlChildrenNode; curNode; curNode = curNode->next)
+        {
+            if (curNode->type != XML_ELEMENT_NODE)
+            {
+                continue;
+            }
+
+            xmlChar* pContent = xmlNodeGetContent(curNode);
+            setValueForKey((const char*)curNode->name, pContent ? (const char*)pContent : "");
+            if (pContent)
+            {
+                xmlFree(pContent);
+            }
+        }
+    }
+    xmlFreeDoc(doc);
+
+    return true;
 }
 
-static void setValueForKey(const char* pKey, const char* pValue)
+static inline const char* getValueForKey(const char* pKey)
 {
-    xmlNodePtr rootNode;
-    xmlNodePtr node;
+    // check the key value
+    if (! pKey)
+    {
+        return NULL;
+    }
 
+    CCString* pValue = (CCString*)s_pValues->objectForKey(pKey);
+    return pValue ? pValue->getCString() : NULL;
+}
+
+static void setValueForKey(const char* pKey, const char* pValue)
+{
     // check the params
     if (! pKey || ! pValue)
     {
         return;
     }
 
-    // find the node
-    node = getXMLNodeForKey(pKey, &rootNode);
-
-    // if node exist, change the content
-    if (node)
+    CCString* pString = (CCString*)s_pValues->objectForKey(pKey);
+    if (pString)
     {
-        xmlNodeSetContent(node, BAD_CAST pValue);
+        if (pString->m_sString == pValue)
+        {
+            return;
+        }
+        pString->m_sString = pValue;
     }
     else
     {
-        if (rootNode)
-        {
-            // the node doesn't exist, add a new one
-            // libxml in android donesn't support xmlNewTextChild, so use this approach
-            xmlNodePtr tmpNode = xmlNewNode(NULL, BAD_CAST pKey);
-            xmlNodePtr content = xmlNewText(BAD_CAST pValue);
-            xmlAddChild(rootNode, tmpNode);
-            xmlAddChild(tmpNode, content);
-        }    
+        pString = new CCString(pValue);
+        s_pValues->setObject(pString, pKey);
+        pString->release();
     }
+
+    s_bDirty = true;
 }
 
 /**
@@ -133,6 +378,7 @@ static void setValueForKey(const char* pKey, const char* pValue)
 
 CCUserDefault* CCUserDefault::m_spUserDefault = 0;
 string CCUserDefault::m_sFilePath = string("");
+string CCUserDefault::m_sXMLFilePath = string("");
 bool CCUserDefault::m_sbIsFilePathInitialized = false;
 
 /**
@@ -142,18 +388,31 @@ bool CCUserDefault::m_sbIsFilePathInitialized = false;
 CCUserDefault::~CCUserDefault()
 {
     flush();
-    if (g_sharedDoc)
-    {
-        xmlFreeDoc(g_sharedDoc);
-        g_sharedDoc = NULL;
-    }
+    // the writer thread writes the pending values before quitting
+    stopWriterThread();
 
+    CC_SAFE_RELEASE_NULL(s_pValues);
     m_spUserDefault = NULL;
 }
 
 CCUserDefault::CCUserDefault()
 {
-    g_sharedDoc = xmlReadFile(getXMLFilePath().c_str(), "utf-8", XML_PARSE_RECOVER);
+    s_pValues = new CCDictionary();
+
+    if (loadBinaryFile(m_sFilePath))
+    {
+        s_bDirty = false;
+        return;
+    }
+
+    // the temporary file is complete if the application was killed before replacing the file with it
+    if (! loadBinaryFile(m_sFilePath + ".tmp"))
+    {
+        importXMLFile(m_sXMLFilePath);
+    }
+
+    // the next flush creates the binary file
+    s_bDirty = (s_pValues->count() > 0);
 }
 
 void CCUserDefault::purgeSharedUserDefault()
@@ -170,7 +429,6 @@ bool CCUserDefault::getBoolForKey(const char* pKey, bool defaultValue)
     if (value)
     {
         ret = (! strcmp(value, "true"));
-        xmlFree((void*)value);
     }
 
     return ret;
@@ -184,7 +442,6 @@ int CCUserDefault::getIntegerForKey(const char* pKey, int defaultValue)
     if (value)
     {
         ret = atoi(value);
-        xmlFree((void*)value);
     }
 
     return ret;
@@ -205,7 +462,6 @@ double CCUserDefault::getDoubleForKey(const char* pKey, double defaultValue)
     if (value)
     {
         ret = atof(value);
-        xmlFree((void*)value);
     }
 
     return ret;
@@ -219,7 +475,6 @@ string CCUserDefault::getStringForKey(const char* pKey, const std::string & defa
     if (value)
     {
         ret = string(value);
-        xmlFree((void*)value);
     }
 
     return ret;
@@ -289,14 +544,7 @@ void CCUserDefault::setStringForKey(const char* pKey, const std::string & value)
 
 CCUserDefault* CCUserDefault::sharedUserDefault()
 {
-    initXMLFilePath();
-
-    // only create xml file one time
-    // the file exists after the programe exit
-    if ((! isXMLFileExist()) && (! createXMLFile()))
-    {
-        return NULL;
-    }
+    initFilePaths();
 
     if (! m_spUserDefault)
     {
@@ -306,83 +554,67 @@ CCUserDefault* CCUserDefault::sharedUserDefault()
     return m_spUserDefault;
 }
 
-bool CCUserDefault::isXMLFileExist()
-{
-    FILE *fp = fopen(m_sFilePath.c_str(), "r");
-    bool bRet = false;
-
-    if (fp)
-    {
-        bRet = true;
-        fclose(fp);
-    }
-
-    return bRet;
-}
-
-void CCUserDefault::initXMLFilePath()
+void CCUserDefault::initFilePaths()
 {
     if (! m_sbIsFilePathInitialized)
     {
-        m_sFilePath += CCFileUtils::sharedFileUtils()->getWriteablePath() + XML_FILE_NAME;
+        string writeablePath = CCFileUtils::sharedFileUtils()->getWriteablePath();
+        m_sFilePath = writeablePath + BINARY_FILE_NAME;
+        m_sXMLFilePath = writeablePath + XML_FILE_NAME;
         m_sbIsFilePathInitialized = true;
     }    
 }
 
-// create new xml file
-bool CCUserDefault::createXMLFile()
+const string& CCUserDefault::getXMLFilePath()
 {
-    bool bRet = false;
-    xmlDocPtr doc = NULL;
-
-    do 
-    {
-        // new doc
-        doc = xmlNewDoc(BAD_CAST"1.0");
-        if (doc == NULL)
-        {
-            CCLOG("can not create xml doc");
-            break;
-        }
-
-        // new root node
-        xmlNodePtr rootNode = xmlNewNode(NULL, BAD_CAST USERDEFAULT_ROOT_NAME);
-        if (rootNode == NULL)
-        {
-            CCLOG("can not create root node");
-            break;
-        }
+    return m_sXMLFilePath;
+}
 
-        // set root node
-        xmlDocSetRootElement(doc, rootNode);
+const string& CCUserDefault::getFilePath()
+{
+    return m_sFilePath;
+}
 
-        // save xml file
-        xmlSaveFile(m_sFilePath.c_str(), doc);
+void CCUserDefault::flush()
+{
+    if (! s_bDirty)
+    {
+        return;
+    }
+    s_bDirty = false;
 
-        bRet = true;
-    } while (0);
+    // only the copy of the values is done in this thread
+    string* pData = new string();
+    serializeValues(*pData);
 
-    // if doc is not null, free it
-    if (doc)
+    if (! s_bWriterStarted && ! startWriterThread())
     {
-        xmlFreeDoc(doc);
+        writeFile(m_sFilePath, *pData);
+        delete pData;
+        return;
     }
 
-    return bRet;
+    pthread_mutex_lock(&s_writerMutex);
+    // values that weren't written yet are replaced by the new ones
+    delete s_pPendingData;
+    s_pPendingData = pData;
+    pthread_cond_signal(&s_writerCond);
+    pthread_mutex_unlock(&s_writerMutex);
 }
 
-const string& CCUserDefault::getXMLFilePath()
+void CCUserDefault::waitForFlush()
 {
-    return m_sFilePath;
-}
+    if (! s_bWriterStarted)
+    {
+        return;
+    }
 
-void CCUserDefault::flush()
-{
-    // save to file
-    if (g_sharedDoc)
+    pthread_mutex_lock(&s_writerMutex);
+    while (s_pPendingData || s_bWriting)
     {
-        xmlSaveFile(CCUserDefault::sharedUserDefault()->getXMLFilePath().c_str(), g_sharedDoc);
+        pthread_cond_wait(&s_writtenCond, &s_writerMutex);
     }
+    pthread_mutex_unlock(&s_writerMutex);
 }
 
 NS_CC_END
@@ -41,6 +41,11 @@ NS_CC_BEGIN
  * 
  * It supports the following base types:
  * bool, int, float, double, string
+ *
+ * The values are kept in memory, in a dictionary, and saved in a compact binary file
+ * (UserDefault.bin in the writeable path) by flush(). flush() only copies the values: a background
+ * thread writes them to a temporary file that replaces the previous one, so the file is never left
+ * half written. The first time, the values of the UserDefault.xml of previous versions are imported.
  */
 class CC_DLL CCUserDefault
 {
@@ -98,22 +103,33 @@ public:
     */
     void    setStringForKey(const char* pKey, const std::string & value);
     /**
-     @brief Save content to xml file
+     @brief Save the values to the file, in a background thread. Does nothing if no value changed.
      */
     void    flush();
+    /**
+     @brief Wait until the values passed to flush() are written. Call it when the application
+     may be killed, for example when it enters the background.
+     @since v2.1
+     */
+    void    waitForFlush();
 
     static CCUserDefault* sharedUserDefault();
+    /** Saves the values, waits until they are written and deletes the shared CCUserDefault */
     static void purgeSharedUserDefault();
+    /** path of the xml file used by previous versions, imported when there is no binary file */
     const static std::string& getXMLFilePath();
+    /** path of the binary file
+     @since v2.1
+     */
+    const static std::string& getFilePath();
 
 private:
     CCUserDefault();
-    static bool createXMLFile();
-    static bool isXMLFileExist();
-    static void initXMLFilePath();
+    static void initFilePaths();
     
     static CCUserDefault* m_spUserDefault;
     static std::string m_sFilePath;
+    static std::string m_sXMLFilePath;
     static bool m_sbIsFilePathInitialized;
 };
 
@@ -0,0 +1,266 @@
+/****************************************************************************
+Copyright (c) 2012      cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "ccPixelConversion.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define CC_PIXEL_CONVERSION_SSE2 1
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    #define CC_PIXEL_CONVERSION_NEON 1
+    #include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+// The scalar loops are the reference: the vectorized paths only handle the first
+// length - (length % N) pixels and always fall back to them for the remaining ones.
+
+static inline unsigned short RGBA8888ToRGB565(unsigned int p)
+{
+    return (unsigned short)(
+    (((p >>  0) & 0xFF) >> 3) << 11 |  // R
+    (((p >>  8) & 0xFF) >> 2) << 5  |  // G
+    (((p >> 16) & 0xFF) >> 3) << 0);   // B
+}
+
+static inline unsigned short RGBA8888ToRGBA4444(unsigned int p)
+{
+    return (unsigned short)(
+    (((p >>  0) & 0xFF) >> 4) << 12 |  // R
+    (((p >>  8) & 0xFF) >> 4) <<  8 |  // G
+    (((p >> 16) & 0xFF) >> 4) <<  4 |  // B
+    (((p >> 24) & 0xFF) >> 4) <<  0);  // A
+}
+
+static inline unsigned short RGBA8888ToRGB5A1(unsigned int p)
+{
+    return (unsigned short)(
+    (((p >>  0) & 0xFF) >> 3) << 11 |  // R
+    (((p >>  8) & 0xFF) >> 3) <<  6 |  // G
+    (((p >> 16) & 0xFF) >> 3) <<  1 |  // B
+    (((p >> 24) & 0xFF) >> 7) <<  0);  // A
+}
+
+#if CC_PIXEL_CONVERSION_SSE2
+
+// 8 pixels, 32 bits each, packed into 8 x 16 bits. The values must fit in 16 bits.
+// packs_epi32 saturates signed values, so the low halves are sign extended first.
+static inline __m128i packLow16(__m128i lo, __m128i hi)
+{
+    lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+    hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+    return _mm_packs_epi32(lo, hi);
+}
+
+static inline __m128i sseRGB565(__m128i p)
+{
+    return _mm_or_si128(_mm_or_si128(
+        _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0xF800)),    // R
+        _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07E0))),   // G
+        _mm_and_si128(_mm_srli_epi32(p, 19), _mm_set1_epi32(0x001F)));  // B
+}
+
+static inline __m128i sseRGBA4444(__m128i p)
+{
+    return _mm_or_si128(_mm_or_si128(
+        _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0xF000)),    // R
+        _mm_and_si128(_mm_srli_epi32(p, 4), _mm_set1_epi32(0x0F00))),   // G
+        _mm_or_si128(
+        _mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0x00F0)),   // B
+        _mm_srli_epi32(p, 28)));                                        // A
+}
+
+static inline __m128i sseRGB5A1(__m128i p)
+{
+    return _mm_or_si128(_mm_or_si128(
+        _mm_and_si128(_mm_slli_epi32(p, 8), _mm_set1_epi32(0xF800)),    // R
+        _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x07C0))),   // G
+        _mm_or_si128(
+        _mm_and_si128(_mm_srli_epi32(p, 18), _mm_set1_epi32(0x003E)),   // B
+        _mm_srli_epi32(p, 31)));                                        // A
+}
+
+#define CC_SSE2_CONVERT_TO_16(__function__) \
+    for (; length >= 8; length -= 8, in += 32, out += 8) \
+    { \
+        __m128i lo = __function__(_mm_loadu_si128((const __m128i*)in)); \
+        __m128i hi = __function__(_mm_loadu_si128((const __m128i*)(in + 16))); \
+        _mm_storeu_si128((__m128i*)out, packLow16(lo, hi)); \
+    }
+
+#endif // CC_PIXEL_CONVERSION_SSE2
+
+void ccConvertRGBA8888ToRGB565(const unsigned char* in, unsigned short* out, unsigned int length)
+{
+#if CC_PIXEL_CONVERSION_SSE2
+    CC_SSE2_CONVERT_TO_16(sseRGB565)
+#elif CC_PIXEL_CONVERSION_NEON
+    for (; length >= 16; length -= 16, in += 64, out += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(in);
+        uint8x16x2_t o;
+        // little endian: low byte first
+        o.val[0] = vorrq_u8(vandq_u8(vshlq_n_u8(p.val[1], 3), vdupq_n_u8(0xE0)), vshrq_n_u8(p.val[2], 3));
+        o.val[1] = vorrq_u8(vandq_u8(p.val[0], vdupq_n_u8(0xF8)), vshrq_n_u8(p.val[1], 5));
+        vst2q_u8((uint8_t*)out, o);
+    }
+#endif
+
+    const unsigned int *inPixel32 = (const unsigned int*)in;
+    for (unsigned int i = 0; i < length; ++i)
+    {
+        *out++ = RGBA8888ToRGB565(*inPixel32++);
+    }
+}
+
+void ccConvertRGB888ToRGB565(const unsigned char* in, unsigned short* out, unsigned int length)
+{
+#if CC_PIXEL_CONVERSION_NEON
+    for (; length >= 16; length -= 16, in += 48, out += 16)
+    {
+        uint8x16x3_t p = vld3q_u8(in);
+        uint8x16x2_t o;
+        o.val[0] = vorrq_u8(vandq_u8(vshlq_n_u8(p.val[1], 3), vdupq_n_u8(0xE0)), vshrq_n_u8(p.val[2], 3));
+        o.val[1] = vorrq_u8(vandq_u8(p.val[0], vdupq_n_u8(0xF8)), vshrq_n_u8(p.val[1], 5));
+        vst2q_u8((uint8_t*)out, o);
+    }
+#endif
+
+    // SSE2 can't shuffle bytes, so 24 bit pixels are converted with the scalar loop there
+    for (unsigned int i = 0; i < length; ++i, in += 3)
+    {
+        *out++ = (unsigned short)(
+        ((in[0] & 0xFF) >> 3) << 11 |  // R
+        ((in[1] & 0xFF) >> 2) << 5  |  // G
+        ((in[2] & 0xFF) >> 3) << 0);   // B
+    }
+}
+
+void ccConvertRGBA8888ToRGBA4444(const unsigned char* in, unsigned short* out, unsigned int length)
+{
+#if CC_PIXEL_CONVERSION_SSE2
+    CC_SSE2_CONVERT_TO_16(sseRGBA4444)
+#elif CC_PIXEL_CONVERSION_NEON
+    uint8x16_t mask = vdupq_n_u8(0xF0);
+    for (; length >= 16; length -= 16, in += 64, out += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(in);
+        uint8x16x2_t o;
+        o.val[0] = vorrq_u8(vandq_u8(p.val[2], mask), vshrq_n_u8(p.val[3], 4));   // BA
+        o.val[1] = vorrq_u8(vandq_u8(p.val[0], mask), vshrq_n_u8(p.val[1], 4));   // RG
+        vst2q_u8((uint8_t*)out, o);
+    }
+#endif
+
+    const unsigned int *inPixel32 = (const unsigned int*)in;
+    for (unsigned int i = 0; i < length; ++i)
+    {
+        *out++ = RGBA8888ToRGBA4444(*inPixel32++);
+    }
+}
+
+void ccConvertRGBA8888ToRGB5A1(const unsigned char* in, unsigned short* out, unsigned int length)
+{
+#if CC_PIXEL_CONVERSION_SSE2
+    CC_SSE2_CONVERT_TO_16(sseRGB5A1)
+#elif CC_PIXEL_CONVERSION_NEON
+    for (; length >= 16; length -= 16, in += 64, out += 16)
+    {
+        uint8x16x4_t p = vld4q_u8(in);
+        uint8x16x2_t o;
+        o.val[0] = vorrq_u8(vorrq_u8(vandq_u8(vshlq_n_u8(p.val[1], 3), vdupq_n_u8(0xC0)),
+                                     vandq_u8(vshrq_n_u8(p.val[2], 2), vdupq_n_u8(0x3E))),
+                            vshrq_n_u8(p.val[3], 7));
+        o.val[1] = vorrq_u8(vandq_u8(p.val[0], vdupq_n_u8(0xF8)), vshrq_n_u8(p.val[1], 5));
+        vst2q_u8((uint8_t*)out, o);
+    }
+#endif
+
+    const unsigned int *inPixel32 = (const unsigned int*)in;
+    for (unsigned int i = 0; i < length; ++i)
+    {
+        *out++ = RGBA8888ToRGB5A1(*inPixel32++);
+    }
+}
+
+void ccConvertRGBA8888ToA8(const unsigned char* in, unsigned char* out, unsigned int length)
+{
+#if CC_PIXEL_CONVERSION_SSE2
+    for (; length >= 16; length -= 16, in += 64, out += 16)
+    {
+        __m128i p0 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)in), 24);
+        __m128i p1 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(in + 16)), 24);
+        __m128i p2 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(in + 32)), 24);
+        __m128i p3 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(in + 48)), 24);
+        _mm_storeu_si128((__m128i*)out, _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3)));
+    }
+#elif CC_PIXEL_CONVERSION_NEON
+    for (; length >= 16; length -= 16, in += 64, out += 16)
+    {
+        vst1q_u8(out, vld4q_u8(in).val[3]);
+    }
+#endif
+
+    const unsigned int *inPixel32 = (const unsigned int*)in;
+    for (unsigned int i = 0; i < length; ++i)
+    {
+        *out++ = (*inPixel32++ >> 24) & 0xFF;  // A
+    }
+}
+
+void ccConvertRGBA8888ToRGB888(const unsigned char* in, unsigned char* out, unsigned int length)
+{
+#if CC_PIXEL_CONVERSION_NEON
+    for (; length >= 16; length -= 16, in += 64, out += 48)
+    {
+        uint8x16x4_t p = vld4q_u8(in);
+        uint8x16x3_t o;
+        o.val[0] = p.val[0];
+        o.val[1] = p.val[1];
+        o.val[2] = p.val[2];
+        vst3q_u8(out, o);
+    }
+#endif
+
+    for (unsigned int i = 0; i < length; ++i, in += 4)
+    {
+        *out++ = in[0]; // R
+        *out++ = in[1]; // G
+        *out++ = in[2]; // B
+    }
+}
+
+const char* ccPixelConversionInstructionSet()
+{
+#if CC_PIXEL_CONVERSION_SSE2
+    return "SSE2";
+#elif CC_PIXEL_CONVERSION_NEON
+    return "NEON";
+#else
+    return "C";
+#endif
+}
+
+NS_CC_END
@@ -0,0 +1,62 @@
+/****************************************************************************
+Copyright (c) 2012      cocos2d-x.org
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+#ifndef __SUPPORT_CC_PIXEL_CONVERSION_H__
+#define __SUPPORT_CC_PIXEL_CONVERSION_H__
+
+#include "platform/CCPlatformMacros.h"
+
+/** @file ccPixelConversion.h
+Pixel format conversion routines used by CCTexture2D.
+
+The routines use SSE2 or NEON when the compiler targets them, and plain C otherwise.
+All the implementations return exactly the same pixels.
+Input pixels are in memory order: RGBA8888 is "RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA".
+*/
+
+NS_CC_BEGIN
+
+/** Converts RGBA8888 pixels to "RRRRRGGGGGGBBBBB" */
+void CC_DLL ccConvertRGBA8888ToRGB565(const unsigned char* in, unsigned short* out, unsigned int length);
+
+/** Converts RGB888 pixels to "RRRRRGGGGGGBBBBB" */
+void CC_DLL ccConvertRGB888ToRGB565(const unsigned char* in, unsigned short* out, unsigned int length);
+
+/** Converts RGBA8888 pixels to "RRRRGGGGBBBBAAAA" */
+void CC_DLL ccConvertRGBA8888ToRGBA4444(const unsigned char* in, unsigned short* out, unsigned int length);
+
+/** Converts RGBA8888 pixels to "RRRRRGGGGGBBBBBA" */
+void CC_DLL ccConvertRGBA8888ToRGB5A1(const unsigned char* in, unsigned short* out, unsigned int length);
+
+/** Converts RGBA8888 pixels to "AAAAAAAA" */
+void CC_DLL ccConvertRGBA8888ToA8(const unsigned char* in, unsigned char* out, unsigned int length);
+
+/** Converts RGBA8888 pixels to "RRRRRRRRGGGGGGGGBBBBBBBB" */
+void CC_DLL ccConvertRGBA8888ToRGB888(const unsigned char* in, unsigned char* out, unsigned int length);
+
+/** returns the name of the instruction set used by the conversion routines: "SSE2", "NEON" or "C" */
+CC_DLL const char* ccPixelConversionInstructionSet();
+
+NS_CC_END
+
+#endif // __SUPPORT_CC_PIXEL_CONVERSION_H__
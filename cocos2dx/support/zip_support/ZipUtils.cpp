@@ -24,10 +24,25 @@ THE SOFTWARE.
 #include <zlib.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "ZipUtils.h"
 #include "ccMacros.h"
 #include "platform/CCFileUtils.h"
+#include "support/data_support/uthash.h"
+#include <map>
+#include <vector>
+#include <string>
+#include <pthread.h>
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 NS_CC_BEGIN
 
@@ -280,4 +295,439 @@ int ZipUtils::ccInflateCCZFile(const char *path, unsigned char **out)
      return len;
 }
 
+// ZipFile
+
+#define ZIP_LOCAL_HEADER_SIGNATURE      0x04034b50
+#define ZIP_CENTRAL_HEADER_SIGNATURE    0x02014b50
+#define ZIP_END_OF_DIRECTORY_SIGNATURE  0x06054b50
+#define ZIP_LOCAL_HEADER_SIZE           30
+#define ZIP_CENTRAL_HEADER_SIZE         46
+#define ZIP_END_OF_DIRECTORY_SIZE       22
+
+struct ZipEntry
+{
+    const char      *name;
+    unsigned int    compressedSize;
+    unsigned int    uncompressedSize;
+    unsigned int    localHeaderOffset;
+    unsigned short  compressionMethod;
+    UT_hash_handle  hh;
+};
+
+// zip archives are little endian
+static inline unsigned short zipReadShort(const unsigned char *p)
+{
+    return (unsigned short)(p[0] | (p[1] << 8));
+}
+
+static inline unsigned int zipReadInt(const unsigned char *p)
+{
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+// archives opened by sharedZipFile, by path
+typedef std::map<std::string, ZipFile*> ZipFileMap;
+static ZipFileMap *s_pSharedZipFiles = NULL;
+// archives replaced because they changed on disk, they may still be read
+static std::vector<ZipFile*> *s_pReplacedZipFiles = NULL;
+static pthread_mutex_t s_sharedZipFilesMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// size and modification time of a file
+static bool zipFileStamp(const char *pszPath, unsigned long *pSize, unsigned long long *pModificationTime)
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (! GetFileAttributesExA(pszPath, GetFileExInfoStandard, &data))
+    {
+        return false;
+    }
+    *pSize = data.nFileSizeLow;
+    *pModificationTime = ((unsigned long long)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat st;
+    if (stat(pszPath, &st) != 0)
+    {
+        return false;
+    }
+    *pSize = (unsigned long)st.st_size;
+    *pModificationTime = (unsigned long long)st.st_mtime;
+#endif
+    return true;
+}
+
+ZipFile::ZipFile()
+: m_pMapping(NULL)
+, m_uMappingSize(0)
+, m_pMappingHandle(NULL)
+, m_uModificationTime(0)
+, m_pEntries(NULL)
+, m_pIndex(NULL)
+, m_pNames(NULL)
+, m_uNumberOfEntries(0)
+{
+}
+
+ZipFile::~ZipFile()
+{
+    close();
+}
+
+void ZipFile::close()
+{
+    HASH_CLEAR(hh, m_pIndex);
+    CC_SAFE_DELETE_ARRAY(m_pEntries);
+    CC_SAFE_DELETE_ARRAY(m_pNames);
+    m_uNumberOfEntries = 0;
+
+    if (m_pMapping)
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        UnmapViewOfFile(m_pMapping);
+        CloseHandle((HANDLE)m_pMappingHandle);
+#else
+        munmap((void*)m_pMapping, m_uMappingSize);
+#endif
+        m_pMapping = NULL;
+        m_pMappingHandle = NULL;
+        m_uMappingSize = 0;
+        m_uModificationTime = 0;
+    }
+}
+
+bool ZipFile::isModified(const char *pszZipFilePath)
+{
+    unsigned long uSize = 0;
+    unsigned long long uModificationTime = 0;
+    return ! zipFileStamp(pszZipFilePath, &uSize, &uModificationTime) || uSize != m_uMappingSize || uModificationTime != m_uModificationTime;
+}
+
+bool ZipFile::initWithFile(const char *pszZipFilePath)
+{
+    close();
+
+    if (! pszZipFilePath)
+    {
+        return false;
+    }
+
+    // map the whole archive: entries are read straight from memory, without locking a file position
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    HANDLE hFile = CreateFileA(pszZipFilePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    DWORD uSize = GetFileSize(hFile, NULL);
+    HANDLE hMapping = (uSize != INVALID_FILE_SIZE && uSize > 0) ? CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    CloseHandle(hFile);
+    if (hMapping == NULL)
+    {
+        return false;
+    }
+    m_pMapping = (const unsigned char*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (m_pMapping == NULL)
+    {
+        CloseHandle(hMapping);
+        return false;
+    }
+    m_pMappingHandle = hMapping;
+    m_uMappingSize = uSize;
+    unsigned long uStampSize = 0;
+    zipFileStamp(pszZipFilePath, &uStampSize, &m_uModificationTime);
+#else
+    int fd = open(pszZipFilePath, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat st;
+    void *pMapping = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        pMapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (pMapping == MAP_FAILED)
+    {
+        return false;
+    }
+    m_pMapping = (const unsigned char*)pMapping;
+    m_uMappingSize = st.st_size;
+    m_uModificationTime = (unsigned long long)st.st_mtime;
+#endif
+
+    // the end of central directory record is at the end of the file, followed by a comment of up to 64k
+    const unsigned char *pEnd = NULL;
+    if (m_uMappingSize >= ZIP_END_OF_DIRECTORY_SIZE)
+    {
+        unsigned long uMinimum = m_uMappingSize > 0xffff + ZIP_END_OF_DIRECTORY_SIZE ? m_uMappingSize - 0xffff - ZIP_END_OF_DIRECTORY_SIZE : 0;
+        for (unsigned long i = m_uMappingSize - ZIP_END_OF_DIRECTORY_SIZE + 1; i-- > uMinimum; )
+        {
+            if (zipReadInt(m_pMapping + i) == ZIP_END_OF_DIRECTORY_SIGNATURE)
+            {
+                pEnd = m_pMapping + i;
+                break;
+            }
+        }
+    }
+
+    do
+    {
+        CC_BREAK_IF(! pEnd);
+
+        unsigned int uCount = zipReadShort(pEnd + 10);
+        unsigned int uDirectorySize = zipReadInt(pEnd + 12);
+        unsigned int uDirectoryOffset = zipReadInt(pEnd + 16);
+        CC_BREAK_IF(uDirectoryOffset > m_uMappingSize || uDirectorySize > m_uMappingSize - uDirectoryOffset);
+
+        // first pass: validate the directory and measure the names
+        const unsigned char *p = m_pMapping + uDirectoryOffset;
+        const unsigned char *pDirectoryEnd = p + uDirectorySize;
+        unsigned int uNamesSize = 0;
+        unsigned int i = 0;
+        for (; i < uCount; i++)
+        {
+            if (p + ZIP_CENTRAL_HEADER_SIZE > pDirectoryEnd || zipReadInt(p) != ZIP_CENTRAL_HEADER_SIGNATURE)
+            {
+                break;
+            }
+            unsigned int uRecordSize = ZIP_CENTRAL_HEADER_SIZE + zipReadShort(p + 28) + zipReadShort(p + 30) + zipReadShort(p + 32);
+            if (p + uRecordSize > pDirectoryEnd)
+            {
+                break;
+            }
+            uNamesSize += zipReadShort(p + 28) + 1;
+            p += uRecordSize;
+        }
+        CC_BREAK_IF(i != uCount);
+
+        // second pass: fill the entries and the index
+        m_pEntries = new ZipEntry[uCount ? uCount : 1];
+        m_pNames = new char[uNamesSize + 1];
+        char *pName = m_pNames;
+        p = m_pMapping + uDirectoryOffset;
+        for (i = 0; i < uCount; i++)
+        {
+            unsigned short uFlags = zipReadShort(p + 8);
+            unsigned short uMethod = zipReadShort(p + 10);
+            unsigned int uCompressedSize = zipReadInt(p + 20);
+            unsigned int uUncompressedSize = zipReadInt(p + 24);
+            unsigned short uNameLength = zipReadShort(p + 28);
+
+            memcpy(pName, p + ZIP_CENTRAL_HEADER_SIZE, uNameLength);
+            pName[uNameLength] = 0;
+
+            // encrypted entries can't be read. Stored entries are returned or copied with their
+            // uncompressed size, that is only checked against the mapping as the compressed size
+            if (! (uFlags & 1) && (uMethod != 0 || uCompressedSize == uUncompressedSize))
+            {
+                ZipEntry *pEntry = m_pEntries + m_uNumberOfEntries;
+                pEntry->name = pName;
+                pEntry->compressionMethod = uMethod;
+                pEntry->compressedSize = uCompressedSize;
+                pEntry->uncompressedSize = uUncompressedSize;
+                pEntry->localHeaderOffset = zipReadInt(p + 42);
+
+                ZipEntry *pExisting = NULL;
+                HASH_FIND(hh, m_pIndex, pName, uNameLength, pExisting);
+                if (! pExisting)
+                {
+                    HASH_ADD_KEYPTR(hh, m_pIndex, pName, uNameLength, pEntry);
+                    m_uNumberOfEntries++;
+                }
+            }
+
+            pName += uNameLength + 1;
+            p += ZIP_CENTRAL_HEADER_SIZE + uNameLength + zipReadShort(p + 30) + zipReadShort(p + 32);
+        }
+
+        return true;
+    } while (0);
+
+    CCLOG("cocos2d: ZipFile: %s is not a valid zip archive", pszZipFilePath);
+    close();
+    return false;
+}
+
+ZipFile* ZipFile::sharedZipFile(const char *pszZipFilePath)
+{
+    if (! pszZipFilePath || ! pszZipFilePath[0])
+    {
+        return NULL;
+    }
+
+    ZipFile *pZipFile = NULL;
+    pthread_mutex_lock(&s_sharedZipFilesMutex);
+
+    if (! s_pSharedZipFiles)
+    {
+        s_pSharedZipFiles = new ZipFileMap();
+    }
+
+    ZipFileMap::iterator it = s_pSharedZipFiles->find(pszZipFilePath);
+    if (it != s_pSharedZipFiles->end() && it->second->isModified(pszZipFilePath))
+    {
+        // rewritten or truncated, e.g. by an update: the mapping doesn't match the file anymore
+        if (! s_pReplacedZipFiles)
+        {
+            s_pReplacedZipFiles = new std::vector<ZipFile*>();
+        }
+        s_pReplacedZipFiles->push_back(it->second);
+        s_pSharedZipFiles->erase(it);
+        it = s_pSharedZipFiles->end();
+    }
+
+    if (it != s_pSharedZipFiles->end())
+    {
+        pZipFile = it->second;
+    }
+    else
+    {
+        pZipFile = new ZipFile();
+        if (pZipFile->initWithFile(pszZipFilePath))
+        {
+            (*s_pSharedZipFiles)[pszZipFilePath] = pZipFile;
+        }
+        else
+        {
+            CC_SAFE_DELETE(pZipFile);
+        }
+    }
+
+    pthread_mutex_unlock(&s_sharedZipFilesMutex);
+    return pZipFile;
+}
+
+void ZipFile::purgeSharedZipFiles()
+{
+    pthread_mutex_lock(&s_sharedZipFilesMutex);
+    if (s_pSharedZipFiles)
+    {
+        for (ZipFileMap::iterator it = s_pSharedZipFiles->begin(); it != s_pSharedZipFiles->end(); ++it)
+        {
+            delete it->second;
+        }
+        CC_SAFE_DELETE(s_pSharedZipFiles);
+    }
+    if (s_pReplacedZipFiles)
+    {
+        for (std::vector<ZipFile*>::iterator it = s_pReplacedZipFiles->begin(); it != s_pReplacedZipFiles->end(); ++it)
+        {
+            delete *it;
+        }
+        CC_SAFE_DELETE(s_pReplacedZipFiles);
+    }
+    pthread_mutex_unlock(&s_sharedZipFilesMutex);
+}
+
+ZipEntry* ZipFile::findEntry(const char *pszFileName)
+{
+    ZipEntry *pEntry = NULL;
+    if (pszFileName && m_pIndex)
+    {
+        HASH_FIND(hh, m_pIndex, pszFileName, strlen(pszFileName), pEntry);
+    }
+    return pEntry;
+}
+
+const unsigned char* ZipFile::entryData(ZipEntry *pEntry)
+{
+    // the local header has its own, possibly different, extra field
+    unsigned long uOffset = pEntry->localHeaderOffset;
+    if (uOffset + ZIP_LOCAL_HEADER_SIZE > m_uMappingSize || zipReadInt(m_pMapping + uOffset) != ZIP_LOCAL_HEADER_SIGNATURE)
+    {
+        return NULL;
+    }
+
+    uOffset += ZIP_LOCAL_HEADER_SIZE + zipReadShort(m_pMapping + uOffset + 26) + zipReadShort(m_pMapping + uOffset + 28);
+    if (uOffset > m_uMappingSize || pEntry->compressedSize > m_uMappingSize - uOffset)
+    {
+        return NULL;
+    }
+    return m_pMapping + uOffset;
+}
+
+bool ZipFile::fileExists(const char *pszFileName)
+{
+    return findEntry(pszFileName) != NULL;
+}
+
+const unsigned char* ZipFile::getMappedFileData(const char *pszFileName, unsigned long *pSize)
+{
+    ZipEntry *pEntry = findEntry(pszFileName);
+    const unsigned char *pData = NULL;
+    if (pEntry && pEntry->compressionMethod == 0)
+    {
+        pData = entryData(pEntry);
+    }
+
+    if (pSize)
+    {
+        *pSize = pData ? pEntry->uncompressedSize : 0;
+    }
+    return pData;
+}
+
+unsigned char* ZipFile::getFileData(const char *pszFileName, unsigned long *pSize)
+{
+    unsigned char *pBuffer = NULL;
+    if (pSize)
+    {
+        *pSize = 0;
+    }
+
+    do
+    {
+        ZipEntry *pEntry = findEntry(pszFileName);
+        CC_BREAK_IF(! pEntry);
+
+        const unsigned char *pData = entryData(pEntry);
+        CC_BREAK_IF(! pData);
+
+        if (pEntry->compressionMethod == 0)
+        {
+            pBuffer = new unsigned char[pEntry->uncompressedSize];
+            memcpy(pBuffer, pData, pEntry->uncompressedSize);
+        }
+        else if (pEntry->compressionMethod == Z_DEFLATED)
+        {
+            pBuffer = new unsigned char[pEntry->uncompressedSize];
+
+            z_stream d_stream;
+            memset(&d_stream, 0, sizeof(d_stream));
+            d_stream.next_in = (Bytef*)pData;
+            d_stream.avail_in = pEntry->compressedSize;
+            d_stream.next_out = pBuffer;
+            d_stream.avail_out = pEntry->uncompressedSize;
+
+            // raw deflate data, without zlib header
+            int err = inflateInit2(&d_stream, -MAX_WBITS);
+            if (err == Z_OK)
+            {
+                err = inflate(&d_stream, Z_FINISH);
+                inflateEnd(&d_stream);
+            }
+
+            if (err != Z_STREAM_END || d_stream.total_out != pEntry->uncompressedSize)
+            {
+                CCLOG("cocos2d: ZipFile: failed to inflate %s", pszFileName);
+                CC_SAFE_DELETE_ARRAY(pBuffer);
+                break;
+            }
+        }
+        else
+        {
+            CCLOG("cocos2d: ZipFile: unsupported compression method %d for %s", pEntry->compressionMethod, pszFileName);
+            break;
+        }
+
+        if (pSize)
+        {
+            *pSize = pEntry->uncompressedSize;
+        }
+    } while (0);
+
+    return pBuffer;
+}
+
 NS_CC_END
@@ -24,6 +24,8 @@ THE SOFTWARE.
 #ifndef __SUPPORT_ZIPUTILS_H__
 #define __SUPPORT_ZIPUTILS_H__
 
+#include "CCPlatformMacros.h"
+
 namespace cocos2d
 {
     /* XXX: pragma pack ??? */
@@ -91,6 +93,75 @@ namespace cocos2d
             unsigned int outLenghtHint);
     };
 
+    struct ZipEntry;
+
+    /** @brief A zip archive that stays open.
+    * The archive is mapped in memory and its central directory is read once, into a hash table,
+    * so looking up a file doesn't scan the directory like unzLocateFile does.
+    * Reads don't modify the archive, so several threads can read entries at the same time.
+    * Only stored and deflated entries are supported. Zip64 and encrypted archives are not, and neither are
+    * stored entries whose compressed and uncompressed sizes differ.
+    * @since v2.1
+    */
+    class CC_DLL ZipFile
+    {
+    public:
+        ZipFile();
+        ~ZipFile();
+
+        /** maps the archive and indexes its entries.
+        * @returns false if the file can't be mapped or isn't a zip archive
+        */
+        bool initWithFile(const char *pszZipFilePath);
+
+        /** whether or not the archive has an entry with the given name */
+        bool fileExists(const char *pszFileName);
+
+        /** returns the uncompressed data of an entry, or NULL if it isn't in the archive.
+        * The data is expected to be freed by the caller with delete[].
+        */
+        unsigned char* getFileData(const char *pszFileName, unsigned long *pSize);
+
+        /** returns a pointer to the data of a stored (not compressed) entry, without copying it.
+        * Returns NULL if the entry isn't in the archive or is compressed.
+        * The data must not be freed, and it is valid while the ZipFile exists.
+        */
+        const unsigned char* getMappedFileData(const char *pszFileName, unsigned long *pSize);
+
+        /** number of entries in the archive */
+        unsigned int getNumberOfEntries() { return m_uNumberOfEntries; }
+
+        /** returns the archive at the given path, opening it the first time it is requested.
+        * The archives stay open until purgeSharedZipFiles is called. Can be called from any thread.
+        * An archive whose size or modification time changed, e.g. rewritten by an update, is opened
+        * again. The previous ZipFile, and the data it mapped, stays valid until purgeSharedZipFiles.
+        * @returns NULL if the archive can't be opened
+        */
+        static ZipFile* sharedZipFile(const char *pszZipFilePath);
+
+        /** closes the archives opened by sharedZipFile, including the ones replaced because they changed.
+        * Their data must not be in use, and no other thread may be reading them.
+        */
+        static void purgeSharedZipFiles();
+
+    private:
+        void close();
+        bool isModified(const char *pszZipFilePath);
+        ZipEntry* findEntry(const char *pszFileName);
+        const unsigned char* entryData(ZipEntry *pEntry);
+
+        const unsigned char *m_pMapping;
+        unsigned long        m_uMappingSize;
+        void                *m_pMappingHandle;
+        // modification time of the file when it was mapped
+        unsigned long long   m_uModificationTime;
+
+        ZipEntry            *m_pEntries;
+        ZipEntry            *m_pIndex;
+        char                *m_pNames;
+        unsigned int         m_uNumberOfEntries;
+    };
+
 } // end of namespace cocos2d
 #endif // __PLATFORM_WOPHONE_ZIPUTILS_H__
 
@@ -38,6 +38,8 @@ THE SOFTWARE.
 #include "platform/CCImage.h"
 #include "CCGL.h"
 #include "support/ccUtils.h"
+#include "support/ccPixelConversion.h"
+#include "support/CCProfiling.h"
 #include "platform/CCPlatformMacros.h"
 #include "textures/CCTexturePVR.h"
 #include "CCDirector.h"
@@ -61,14 +63,15 @@ static CCTexture2DPixelFormat g_defaultAlphaPixelFormat = kCCTexture2DPixelForma
 static bool PVRHaveAlphaPremultiplied_ = false;
 
 CCTexture2D::CCTexture2D()
-: m_uPixelsWide(0)
+: m_bPVRHaveAlphaPremultiplied(true)
+, m_uPixelsWide(0)
 , m_uPixelsHigh(0)
 , m_uName(0)
 , m_fMaxS(0.0)
 , m_fMaxT(0.0)
 , m_bHasPremultipliedAlpha(false)
 , m_bHasMipmaps(false)
-, m_bPVRHaveAlphaPremultiplied(true)
+, m_uLastUsedFrame(0)
 , m_pShaderProgram(NULL)
 {
 }
@@ -174,6 +177,8 @@ bool CCTexture2D::hasPremultipliedAlpha()
 
 bool CCTexture2D::initWithData(const void *data, CCTexture2DPixelFormat pixelFormat, unsigned int pixelsWide, unsigned int pixelsHigh, const CCSize& contentSize)
 {
+    CC_FRAME_PROFILER_SCOPE("texture upload");
+
     // XXX: 32 bits or POT textures uses UNPACK of 4 (is this correct ??? )
     if( pixelFormat == kCCTexture2DPixelFormat_RGBA8888 || ( ccNextPOT(pixelsWide)==pixelsWide && ccNextPOT(pixelsHigh)==pixelsHigh) )
     {
@@ -240,6 +245,52 @@ bool CCTexture2D::initWithData(const void *data, CCTexture2DPixelFormat pixelFor
     return true;
 }
 
+bool CCTexture2D::updateWithData(const void *data, unsigned int offsetX, unsigned int offsetY, unsigned int width, unsigned int height)
+{
+    CCAssert(offsetX + width <= m_uPixelsWide && offsetY + height <= m_uPixelsHigh, "CCTexture2D: region out of the texture");
+    CC_FRAME_PROFILER_SCOPE("texture upload");
+
+    GLenum format, type;
+    switch(m_ePixelFormat)
+    {
+    case kCCTexture2DPixelFormat_RGBA8888:
+        format = GL_RGBA; type = GL_UNSIGNED_BYTE;
+        break;
+    case kCCTexture2DPixelFormat_RGB888:
+        format = GL_RGB; type = GL_UNSIGNED_BYTE;
+        break;
+    case kCCTexture2DPixelFormat_RGBA4444:
+        format = GL_RGBA; type = GL_UNSIGNED_SHORT_4_4_4_4;
+        break;
+    case kCCTexture2DPixelFormat_RGB5A1:
+        format = GL_RGBA; type = GL_UNSIGNED_SHORT_5_5_5_1;
+        break;
+    case kCCTexture2DPixelFormat_RGB565:
+        format = GL_RGB; type = GL_UNSIGNED_SHORT_5_6_5;
+        break;
+    case kCCTexture2DPixelFormat_AI88:
+        format = GL_LUMINANCE_ALPHA; type = GL_UNSIGNED_BYTE;
+        break;
+    case kCCTexture2DPixelFormat_A8:
+        format = GL_ALPHA; type = GL_UNSIGNED_BYTE;
+        break;
+    case kCCTexture2DPixelFormat_I8:
+        format = GL_LUMINANCE; type = GL_UNSIGNED_BYTE;
+        break;
+    default:
+        CCAssert(0, "CCTexture2D: the pixel format of compressed textures can't be updated");
+        return false;
+    }
+
+    // the rows of the region are tightly packed
+    glPixelStorei(GL_UNPACK_ALIGNMENT, m_ePixelFormat == kCCTexture2DPixelFormat_RGBA8888 ? 4 : 1);
+
+    ccGLBindTexture2D(m_uName);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, (GLint)offsetX, (GLint)offsetY, (GLsizei)width, (GLsizei)height, format, type, data);
+
+    return true;
+}
+
 
 const char* CCTexture2D::description(void)
 {
@@ -277,9 +328,6 @@ bool CCTexture2D::initWithImage(CCImage *uiImage)
 bool CCTexture2D::initPremultipliedATextureWithImage(CCImage *image, unsigned int width, unsigned int height)
 {
     unsigned char*            tempData = image->getData();
-    unsigned int*             inPixel32 = NULL;
-    unsigned char*            inPixel8 = NULL;
-    unsigned short*           outPixel16 = NULL;
     bool                      hasAlpha = image->hasAlpha();
     CCSize                    imageSize = CCSizeMake((float)(image->getWidth()), (float)(image->getHeight()));
     CCTexture2DPixelFormat    pixelFormat;
@@ -308,98 +356,42 @@ bool CCTexture2D::initPremultipliedATextureWithImage(CCImage *image, unsigned in
     
     if (pixelFormat == kCCTexture2DPixelFormat_RGB565)
     {
+        tempData = new unsigned char[width * height * 2];
         if (hasAlpha)
         {
             // Convert "RRRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA" to "RRRRRGGGGGGBBBBB"
-            
-            tempData = new unsigned char[width * height * 2];
-            outPixel16 = (unsigned short*)tempData;
-            inPixel32 = (unsigned int*)image->getData();
-            
-            for(unsigned int i = 0; i < length; ++i, ++inPixel32)
-            {
-                *outPixel16++ = 
-                ((((*inPixel32 >>  0) & 0xFF) >> 3) << 11) |  // R
-                ((((*inPixel32 >>  8) & 0xFF) >> 2) << 5)  |  // G
-                ((((*inPixel32 >> 16) & 0xFF) >> 3) << 0);    // B
-            }
+            ccConvertRGBA8888ToRGB565(image->getData(), (unsigned short*)tempData, length);
         }
         else 
         {
             // Convert "RRRRRRRRRGGGGGGGGBBBBBBBB" to "RRRRRGGGGGGBBBBB"
-            
-            tempData = new unsigned char[width * height * 2];
-            outPixel16 = (unsigned short*)tempData;
-            inPixel8 = (unsigned char*)image->getData();
-            
-            for(unsigned int i = 0; i < length; ++i)
-            {
-                *outPixel16++ = 
-                (((*inPixel8++ & 0xFF) >> 3) << 11) |  // R
-                (((*inPixel8++ & 0xFF) >> 2) << 5)  |  // G
-                (((*inPixel8++ & 0xFF) >> 3) << 0);    // B
-            }
+            ccConvertRGB888ToRGB565(image->getData(), (unsigned short*)tempData, length);
         }    
     }
     else if (pixelFormat == kCCTexture2DPixelFormat_RGBA4444)
     {
         // Convert "RRRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA" to "RRRRGGGGBBBBAAAA"
-        
-        inPixel32 = (unsigned int*)image->getData();  
         tempData = new unsigned char[width * height * 2];
-        outPixel16 = (unsigned short*)tempData;
-        
-        for(unsigned int i = 0; i < length; ++i, ++inPixel32)
-        {
-            *outPixel16++ = 
-            ((((*inPixel32 >> 0) & 0xFF) >> 4) << 12) | // R
-            ((((*inPixel32 >> 8) & 0xFF) >> 4) <<  8) | // G
-            ((((*inPixel32 >> 16) & 0xFF) >> 4) << 4) | // B
-            ((((*inPixel32 >> 24) & 0xFF) >> 4) << 0);  // A
-        }
+        ccConvertRGBA8888ToRGBA4444(image->getData(), (unsigned short*)tempData, length);
     }
     else if (pixelFormat == kCCTexture2DPixelFormat_RGB5A1)
     {
         // Convert "RRRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA" to "RRRRRGGGGGBBBBBA"
-        inPixel32 = (unsigned int*)image->getData();   
         tempData = new unsigned char[width * height * 2];
-        outPixel16 = (unsigned short*)tempData;
-        
-        for(unsigned int i = 0; i < length; ++i, ++inPixel32)
-        {
-            *outPixel16++ = 
-            ((((*inPixel32 >> 0) & 0xFF) >> 3) << 11) | // R
-            ((((*inPixel32 >> 8) & 0xFF) >> 3) <<  6) | // G
-            ((((*inPixel32 >> 16) & 0xFF) >> 3) << 1) | // B
-            ((((*inPixel32 >> 24) & 0xFF) >> 7) << 0);  // A
-        }
+        ccConvertRGBA8888ToRGB5A1(image->getData(), (unsigned short*)tempData, length);
     }
     else if (pixelFormat == kCCTexture2DPixelFormat_A8)
     {
         // Convert "RRRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA" to "AAAAAAAA"
-        inPixel32 = (unsigned int*)image->getData();
         tempData = new unsigned char[width * height];
-        unsigned char *outPixel8 = tempData;
-        
-        for(unsigned int i = 0; i < length; ++i, ++inPixel32)
-        {
-            *outPixel8++ = (*inPixel32 >> 24) & 0xFF;  // A
-        }
+        ccConvertRGBA8888ToA8(image->getData(), tempData, length);
     }
     
     if (hasAlpha && pixelFormat == kCCTexture2DPixelFormat_RGB888)
     {
         // Convert "RRRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA" to "RRRRRRRRGGGGGGGGBBBBBBBB"
-        inPixel32 = (unsigned int*)image->getData();
         tempData = new unsigned char[width * height * 3];
-        unsigned char *outPixel8 = tempData;
-        
-        for(unsigned int i = 0; i < length; ++i, ++inPixel32)
-        {
-            *outPixel8++ = (*inPixel32 >> 0) & 0xFF; // R
-            *outPixel8++ = (*inPixel32 >> 8) & 0xFF; // G
-            *outPixel8++ = (*inPixel32 >> 16) & 0xFF; // B
-        }
+        ccConvertRGBA8888ToRGB888(image->getData(), tempData, length);
     }
     
     initWithData(tempData, pixelFormat, width, height, imageSize);
@@ -778,5 +770,16 @@ unsigned int CCTexture2D::bitsPerPixelForFormat()
 	return this->bitsPerPixelForFormat(m_ePixelFormat);
 }
 
+unsigned int CCTexture2D::getMemorySize()
+{
+    unsigned int uBytes = m_uPixelsWide * m_uPixelsHigh * bitsPerPixelForFormat() / 8;
+    if (m_bHasMipmaps)
+    {
+        // the mipmap chain adds 1/4 + 1/16 + ... of the base level
+        uBytes += uBytes / 3;
+    }
+    return uBytes;
+}
+
 
 NS_CC_END
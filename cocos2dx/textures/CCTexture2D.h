@@ -117,6 +117,12 @@ public:
     /** Intializes with a texture2d with data */
     bool initWithData(const void* data, CCTexture2DPixelFormat pixelFormat, unsigned int pixelsWide, unsigned int pixelsHigh, const CCSize& contentSize);
 
+    /** Replaces a region of the texture with data of the pixel format the texture was created with.
+     The region is given in pixels, from the top-left corner of the texture.
+     @since v2.1
+     */
+    bool updateWithData(const void* data, unsigned int offsetX, unsigned int offsetY, unsigned int width, unsigned int height);
+
     /**
     Drawing extensions to make it easy to draw basic quads using a CCTexture2D object.
     These functions require GL_TEXTURE_2D and both GL_VERTEX_ARRAY and GL_TEXTURE_COORD_ARRAY client states to be enabled.
@@ -241,6 +247,12 @@ public:
     
     bool hasPremultipliedAlpha();
     bool hasMipmaps();
+
+    /** returns the size, in bytes, of the texture in video memory.
+     It is computed from the pixel format, plus a third for the mipmaps.
+     @since v2.1
+     */
+    unsigned int getMemorySize();
 private:
     bool initPremultipliedATextureWithImage(CCImage * image, unsigned int pixelsWide, unsigned int pixelsHigh);
     
@@ -269,6 +281,11 @@ private:
 
     bool m_bHasMipmaps;
 
+    /** last frame (CCDirector::getTotalFrames) in which the texture was used. Maintained by CCTextureCache
+     @since v2.1
+     */
+    CC_SYNTHESIZE(unsigned int, m_uLastUsedFrame, LastUsedFrame)
+
     /** shader program used by drawAtPoint and drawInRect */
     CC_PROPERTY(CCGLProgram*, m_pShaderProgram, ShaderProgram);
 };
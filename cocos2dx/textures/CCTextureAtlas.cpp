@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "shaders/CCGLProgram.h"
 #include "shaders/ccGLStateCache.h"
 #include "support/CCNotificationCenter.h"
+#include "support/CCProfiling.h"
 #include "CCEventType.h"
 // support
 #include "CCTexture2D.h"
@@ -45,7 +46,9 @@ NS_CC_BEGIN
 
 CCTextureAtlas::CCTextureAtlas()
     :m_pIndices(NULL)
-    ,m_bDirty(false)
+    ,m_pCulledIndices(NULL)
+    ,m_uCulledIndicesVBO(0)
+    ,m_uDirtyRanges(0)
     ,m_pTexture(NULL)
     ,m_pQuads(NULL)
 {}
@@ -56,8 +59,13 @@ CCTextureAtlas::~CCTextureAtlas()
 
     CC_SAFE_FREE(m_pQuads);
     CC_SAFE_FREE(m_pIndices);
+    CC_SAFE_FREE(m_pCulledIndices);
 
     glDeleteBuffers(2, m_pBuffersVBO);
+    if (m_uCulledIndicesVBO)
+    {
+        glDeleteBuffers(1, &m_uCulledIndicesVBO);
+    }
 
 #if CC_TEXTURE_ATLAS_USE_VAO
     glDeleteVertexArrays(1, &m_uVAOname);
@@ -92,10 +100,18 @@ void CCTextureAtlas::setTexture(CCTexture2D * var)
 ccV3F_C4B_T2F_Quad* CCTextureAtlas::getQuads()
 {
     //if someone accesses the quads directly, presume that changes will be made
-    m_bDirty = true;
+    setDirty(0, m_uCapacity);
     return m_pQuads;
 }
 
+ccV3F_C4B_T2F_Quad* CCTextureAtlas::getQuadsAtIndex(unsigned int index, unsigned int amount)
+{
+    CCAssert(index + amount <= m_uCapacity, "getQuadsAtIndex: Invalid index + amount");
+
+    setDirty(index, amount);
+    return m_pQuads + index;
+}
+
 void CCTextureAtlas::setQuads(ccV3F_C4B_T2F_Quad *var)
 {
     m_pQuads = var;
@@ -199,7 +215,8 @@ bool CCTextureAtlas::initWithTexture(CCTexture2D *texture, unsigned int capacity
     setupVBO();
 #endif
 
-    m_bDirty = true;
+    // the VBO was created with the quads
+    m_uDirtyRanges = 0;
 
     return true;
 }
@@ -211,9 +228,11 @@ void CCTextureAtlas::listenBackToForeground(CCObject *obj)
 #else    
     setupVBO();
 #endif
+    // the buffer was lost with the context
+    m_uCulledIndicesVBO = 0;
     
-    // set m_bDirty to true to force it rebinding buffer
-    m_bDirty = true;
+    // upload all the quads again
+    setDirty(0, m_uCapacity);
 }
 
 const char* CCTextureAtlas::description()
@@ -318,7 +337,7 @@ void CCTextureAtlas::updateQuad(ccV3F_C4B_T2F_Quad *quad, unsigned int index)
     m_pQuads[index] = *quad;    
 
 
-    m_bDirty = true;
+    setDirty(index, 1);
 
 }
 
@@ -342,7 +361,7 @@ void CCTextureAtlas::insertQuad(ccV3F_C4B_T2F_Quad *quad, unsigned int index)
     m_pQuads[index] = *quad;
 
 
-    m_bDirty = true;
+    setDirty(index, m_uTotalQuads - index);
 
 }
 
@@ -374,7 +393,7 @@ void CCTextureAtlas::insertQuads(ccV3F_C4B_T2F_Quad* quads, unsigned int index,
         j++;
     }
 
-    m_bDirty = true;
+    setDirty(max - amount, m_uTotalQuads - (max - amount));
 }
 
 void CCTextureAtlas::insertQuadFromIndex(unsigned int oldIndex, unsigned int newIndex)
@@ -403,7 +422,7 @@ void CCTextureAtlas::insertQuadFromIndex(unsigned int oldIndex, unsigned int new
     m_pQuads[newIndex] = quadsBackup;
 
 
-    m_bDirty = true;
+    setDirty(MIN(oldIndex, newIndex), howMany + 1);
 
 }
 
@@ -424,7 +443,7 @@ void CCTextureAtlas::removeQuadAtIndex(unsigned int index)
     m_uTotalQuads--;
 
 
-    m_bDirty = true;
+    setDirty(index, m_uTotalQuads - index);
 
 }
 
@@ -441,7 +460,7 @@ void CCTextureAtlas::removeQuadsAtIndex(unsigned int index, unsigned int amount)
         memmove( &m_pQuads[index], &m_pQuads[index+amount], sizeof(m_pQuads[0]) * remaining );
     }
 
-    m_bDirty = true;
+    setDirty(index, remaining);
 }
 
 void CCTextureAtlas::removeAllQuads()
@@ -514,11 +533,15 @@ bool CCTextureAtlas::resizeCapacity(unsigned int newCapacity)
     m_pQuads = tmpQuads;
     m_pIndices = tmpIndices;
 
+    // reallocated by the next drawQuadsInRect()
+    CC_SAFE_FREE(m_pCulledIndices);
+
 
     setupIndices();
     mapBuffers();
 
-    m_bDirty = true;
+    // mapBuffers() uploaded all the quads
+    m_uDirtyRanges = 0;
 
     return true;
 }
@@ -556,7 +579,7 @@ void CCTextureAtlas::moveQuadsFromIndex(unsigned int oldIndex, unsigned int amou
 
     free(tempQuads);
 
-    m_bDirty = true;
+    setDirty(MIN(oldIndex, newIndex), MAX(oldIndex, newIndex) - MIN(oldIndex, newIndex) + amount);
 }
 
 void CCTextureAtlas::moveQuadsFromIndex(unsigned int index, unsigned int newIndex)
@@ -564,6 +587,8 @@ void CCTextureAtlas::moveQuadsFromIndex(unsigned int index, unsigned int newInde
     CCAssert(newIndex + (m_uTotalQuads - index) <= m_uCapacity, "moveQuadsFromIndex move is out of bounds");
 
     memmove(m_pQuads + newIndex,m_pQuads + index, (m_uTotalQuads - index) * sizeof(m_pQuads[0]));
+
+    setDirty(newIndex, m_uTotalQuads - index);
 }
 
 void CCTextureAtlas::fillWithEmptyQuadsFromIndex(unsigned int index, unsigned int amount)
@@ -576,6 +601,132 @@ void CCTextureAtlas::fillWithEmptyQuadsFromIndex(unsigned int index, unsigned in
     {
         m_pQuads[i] = quad;
     }
+
+    setDirty(index, amount);
+}
+
+// TextureAtlas - Dirty ranges
+
+void CCTextureAtlas::setDirty(unsigned int index, unsigned int amount)
+{
+    if (index < m_uCapacity)
+    {
+        addDirtyRange(index, index + MIN(amount, m_uCapacity - index));
+    }
+}
+
+void CCTextureAtlas::addDirtyRange(unsigned int start, unsigned int end)
+{
+    end = MIN(end, m_uCapacity);
+    if (start >= end)
+    {
+        return;
+    }
+
+    // first range that overlaps or touches [start, end), or that is after it
+    unsigned int first = 0;
+    while (first < m_uDirtyRanges && m_pDirtyEnd[first] < start)
+    {
+        first++;
+    }
+
+    unsigned int last = first;
+    while (last < m_uDirtyRanges && m_pDirtyStart[last] <= end)
+    {
+        start = MIN(start, m_pDirtyStart[last]);
+        end = MAX(end, m_pDirtyEnd[last]);
+        last++;
+    }
+
+    if (last > first)
+    {
+        // the ranges [first, last) are replaced by the merged one
+        m_pDirtyStart[first] = start;
+        m_pDirtyEnd[first] = end;
+        unsigned int remaining = m_uDirtyRanges - last;
+        memmove(&m_pDirtyStart[first+1], &m_pDirtyStart[last], remaining * sizeof(m_pDirtyStart[0]));
+        memmove(&m_pDirtyEnd[first+1], &m_pDirtyEnd[last], remaining * sizeof(m_pDirtyEnd[0]));
+        m_uDirtyRanges -= last - first - 1;
+        return;
+    }
+
+    // insert a new range
+    unsigned int remaining = m_uDirtyRanges - first;
+    memmove(&m_pDirtyStart[first+1], &m_pDirtyStart[first], remaining * sizeof(m_pDirtyStart[0]));
+    memmove(&m_pDirtyEnd[first+1], &m_pDirtyEnd[first], remaining * sizeof(m_pDirtyEnd[0]));
+    m_pDirtyStart[first] = start;
+    m_pDirtyEnd[first] = end;
+    m_uDirtyRanges++;
+
+    if (m_uDirtyRanges > CC_TEXTURE_ATLAS_DIRTY_RANGES)
+    {
+        // too many ranges: merge the two closest ones
+        unsigned int closest = 0;
+        for (unsigned int i = 1; i + 1 < m_uDirtyRanges; i++)
+        {
+            if (m_pDirtyStart[i+1] - m_pDirtyEnd[i] < m_pDirtyStart[closest+1] - m_pDirtyEnd[closest])
+            {
+                closest = i;
+            }
+        }
+
+        m_pDirtyEnd[closest] = m_pDirtyEnd[closest+1];
+        remaining = m_uDirtyRanges - (closest + 2);
+        memmove(&m_pDirtyStart[closest+1], &m_pDirtyStart[closest+2], remaining * sizeof(m_pDirtyStart[0]));
+        memmove(&m_pDirtyEnd[closest+1], &m_pDirtyEnd[closest+2], remaining * sizeof(m_pDirtyEnd[0]));
+        m_uDirtyRanges--;
+    }
+}
+
+// uploads the dirty quads below limit to the bound GL_ARRAY_BUFFER. The quads above it aren't drawn, they stay dirty
+void CCTextureAtlas::uploadDirtyQuads(unsigned int limit)
+{
+    CC_FRAME_PROFILER_SCOPE("vertex upload");
+
+    limit = MIN(limit, m_uCapacity);
+
+    unsigned int dirtyQuads = 0;
+    for (unsigned int i = 0; i < m_uDirtyRanges && m_pDirtyStart[i] < limit; i++)
+    {
+        dirtyQuads += MIN(m_pDirtyEnd[i], limit) - m_pDirtyStart[i];
+    }
+
+    if (dirtyQuads == 0)
+    {
+        return;
+    }
+
+    if (dirtyQuads * 2 > limit)
+    {
+        // most of the quads changed: orphan the buffer, so the driver doesn't wait for the GPU to release the previous storage
+        glBufferData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0]) * m_uCapacity, NULL, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(m_pQuads[0]) * limit, m_pQuads);
+        CC_INCREMENT_GL_UPLOADED_BYTES(sizeof(m_pQuads[0]) * limit);
+
+        // the new storage is undefined above limit
+        m_uDirtyRanges = 0;
+        addDirtyRange(limit, m_uCapacity);
+        return;
+    }
+
+    unsigned int i = 0;
+    for (; i < m_uDirtyRanges && m_pDirtyStart[i] < limit; i++)
+    {
+        unsigned int start = m_pDirtyStart[i];
+        unsigned int amount = MIN(m_pDirtyEnd[i], limit) - start;
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0]) * start, sizeof(m_pQuads[0]) * amount, &m_pQuads[start]);
+        CC_INCREMENT_GL_UPLOADED_BYTES(sizeof(m_pQuads[0]) * amount);
+    }
+
+    // keep the parts that are above limit
+    if (i > 0 && m_pDirtyEnd[i-1] > limit)
+    {
+        i--;
+        m_pDirtyStart[i] = limit;
+    }
+    m_uDirtyRanges -= i;
+    memmove(&m_pDirtyStart[0], &m_pDirtyStart[i], m_uDirtyRanges * sizeof(m_pDirtyStart[0]));
+    memmove(&m_pDirtyEnd[0], &m_pDirtyEnd[i], m_uDirtyRanges * sizeof(m_pDirtyEnd[0]));
 }
 
 // TextureAtlas - Drawing
@@ -596,6 +747,71 @@ void CCTextureAtlas::drawNumberOfQuads(unsigned int n, unsigned int start)
     {
         return;
     }
+
+    drawElements(m_pBuffersVBO[1], NULL, n*6, start*6, MAX(m_uTotalQuads, start + n));
+}
+
+unsigned int CCTextureAtlas::drawQuadsInRect(const CCRect& rect)
+{
+    if (0 == m_uTotalQuads)
+    {
+        return 0;
+    }
+
+    if (m_pCulledIndices == NULL)
+    {
+        m_pCulledIndices = (GLushort *)malloc( m_uCapacity * 6 * sizeof(m_pIndices[0]) );
+        if (m_pCulledIndices == NULL)
+        {
+            drawQuads();
+            return m_uTotalQuads;
+        }
+    }
+
+    float minX = rect.getMinX();
+    float maxX = rect.getMaxX();
+    float minY = rect.getMinY();
+    float maxY = rect.getMaxY();
+
+    // copy the indices of the visible quads, so they are drawn with a single call
+    unsigned int visible = 0;
+    for (unsigned int i = 0; i < m_uTotalQuads; i++)
+    {
+        const ccV3F_C4B_T2F_Quad& quad = m_pQuads[i];
+        if (MAX(MAX(quad.bl.vertices.x, quad.br.vertices.x), MAX(quad.tl.vertices.x, quad.tr.vertices.x)) < minX
+            || MIN(MIN(quad.bl.vertices.x, quad.br.vertices.x), MIN(quad.tl.vertices.x, quad.tr.vertices.x)) > maxX
+            || MAX(MAX(quad.bl.vertices.y, quad.br.vertices.y), MAX(quad.tl.vertices.y, quad.tr.vertices.y)) < minY
+            || MIN(MIN(quad.bl.vertices.y, quad.br.vertices.y), MIN(quad.tl.vertices.y, quad.tr.vertices.y)) > maxY)
+        {
+            continue;
+        }
+
+        memcpy(&m_pCulledIndices[visible*6], &m_pIndices[i*6], 6 * sizeof(m_pIndices[0]));
+        visible++;
+    }
+
+    if (visible == m_uTotalQuads)
+    {
+        // the static indices buffer can be used
+        drawQuads();
+        return visible;
+    }
+
+    if (visible > 0)
+    {
+        if (m_uCulledIndicesVBO == 0)
+        {
+            glGenBuffers(1, &m_uCulledIndicesVBO);
+        }
+        drawElements(m_uCulledIndicesVBO, m_pCulledIndices, visible*6, 0, m_uTotalQuads);
+    }
+
+    return visible;
+}
+
+// draws count indices of indicesVBO from first. pUploadIndices, if not NULL, are uploaded to indicesVBO before
+void CCTextureAtlas::drawElements(GLuint indicesVBO, const GLushort* pUploadIndices, unsigned int count, unsigned int first, unsigned int uploadLimit)
+{
     ccGLBindTexture2D(m_pTexture->getName());
 
 #if CC_TEXTURE_ATLAS_USE_VAO
@@ -605,29 +821,44 @@ void CCTextureAtlas::drawNumberOfQuads(unsigned int n, unsigned int start)
     //
 
     // XXX: update is done in draw... perhaps it should be done in a timer
-    if (m_bDirty) 
+    if (m_uDirtyRanges)
     {
         glBindBuffer(GL_ARRAY_BUFFER, m_pBuffersVBO[0]);
-        glBufferSubData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0])*start, sizeof(m_pQuads[0]) * n , &m_pQuads[start] );
+        uploadDirtyQuads(uploadLimit);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-        m_bDirty = false;
     }
 
     glBindVertexArray(m_uVAOname);
 
 #if CC_REBIND_INDICES_BUFFER
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_pBuffersVBO[1]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesVBO);
+#else
+    if (indicesVBO != m_pBuffersVBO[1])
+    {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesVBO);
+    }
 #endif
 
+    if (pUploadIndices)
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(pUploadIndices[0]) * count, pUploadIndices, GL_STREAM_DRAW);
+        CC_INCREMENT_GL_UPLOADED_BYTES(sizeof(pUploadIndices[0]) * count);
+    }
+
 #if CC_TEXTURE_ATLAS_USE_TRIANGLE_STRIP
-    glDrawElements(GL_TRIANGLE_STRIP, (GLsizei) n*6, GL_UNSIGNED_SHORT, (GLvoid*) (start*6*sizeof(m_pIndices[0])) );
+    glDrawElements(GL_TRIANGLE_STRIP, (GLsizei) count, GL_UNSIGNED_SHORT, (GLvoid*) (first*sizeof(m_pIndices[0])) );
 #else
-    glDrawElements(GL_TRIANGLES, (GLsizei) n*6, GL_UNSIGNED_SHORT, (GLvoid*) (start*6*sizeof(m_pIndices[0])) );
+    glDrawElements(GL_TRIANGLES, (GLsizei) count, GL_UNSIGNED_SHORT, (GLvoid*) (first*sizeof(m_pIndices[0])) );
 #endif // CC_TEXTURE_ATLAS_USE_TRIANGLE_STRIP
 
 #if CC_REBIND_INDICES_BUFFER
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+#else
+    // the indices buffer is part of the state of the VAO
+    if (indicesVBO != m_pBuffersVBO[1])
+    {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_pBuffersVBO[1]);
+    }
 #endif
 
     glBindVertexArray(0);
@@ -642,10 +873,9 @@ void CCTextureAtlas::drawNumberOfQuads(unsigned int n, unsigned int start)
     glBindBuffer(GL_ARRAY_BUFFER, m_pBuffersVBO[0]);
 
     // XXX: update is done in draw... perhaps it should be done in a timer
-    if (m_bDirty) 
+    if (m_uDirtyRanges)
     {
-        glBufferSubData(GL_ARRAY_BUFFER, sizeof(m_pQuads[0])*start, sizeof(m_pQuads[0]) * n , &m_pQuads[start] );
-        m_bDirty = false;
+        uploadDirtyQuads(uploadLimit);
     }
 
     ccGLEnableVertexAttribs(kCCVertexAttribFlag_PosColorTex);
@@ -659,12 +889,18 @@ void CCTextureAtlas::drawNumberOfQuads(unsigned int n, unsigned int start)
     // tex coords
     glVertexAttribPointer(kCCVertexAttrib_TexCoords, 2, GL_FLOAT, GL_FALSE, kQuadSize, (GLvoid*) offsetof(ccV3F_C4B_T2F, texCoords));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_pBuffersVBO[1]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesVBO);
+
+    if (pUploadIndices)
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(pUploadIndices[0]) * count, pUploadIndices, GL_STREAM_DRAW);
+        CC_INCREMENT_GL_UPLOADED_BYTES(sizeof(pUploadIndices[0]) * count);
+    }
 
 #if CC_TEXTURE_ATLAS_USE_TRIANGLE_STRIP
-    glDrawElements(GL_TRIANGLE_STRIP, (GLsizei)n*6, GL_UNSIGNED_SHORT, (GLvoid*) (start*6*sizeof(m_pIndices[0])));
+    glDrawElements(GL_TRIANGLE_STRIP, (GLsizei) count, GL_UNSIGNED_SHORT, (GLvoid*) (first*sizeof(m_pIndices[0])));
 #else
-    glDrawElements(GL_TRIANGLES, (GLsizei)n*6, GL_UNSIGNED_SHORT, (GLvoid*) (start*6*sizeof(m_pIndices[0])));
+    glDrawElements(GL_TRIANGLES, (GLsizei) count, GL_UNSIGNED_SHORT, (GLvoid*) (first*sizeof(m_pIndices[0])));
 #endif // CC_TEXTURE_ATLAS_USE_TRIANGLE_STRIP
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -61,7 +61,15 @@ protected:
     GLuint              m_uVAOname;
 #endif
     GLuint              m_pBuffersVBO[2]; //0: vertex  1: indices
-    bool                m_bDirty; //indicates whether or not the array buffer of the VBO needs to be updated
+    // indices of the quads drawn by drawQuadsInRect(). Allocated on first use
+    GLushort*           m_pCulledIndices;
+    GLuint              m_uCulledIndicesVBO;
+
+    // ranges [start, end) of quads that must be uploaded to the VBO. Sorted and disjoint.
+    // the extra slot is used while a range is inserted
+    unsigned int        m_pDirtyStart[CC_TEXTURE_ATLAS_DIRTY_RANGES + 1];
+    unsigned int        m_pDirtyEnd[CC_TEXTURE_ATLAS_DIRTY_RANGES + 1];
+    unsigned int        m_uDirtyRanges;
 
 
     /** quantity of quads that are going to be drawn */
@@ -120,6 +128,17 @@ public:
     */
     bool initWithTexture(CCTexture2D *texture, unsigned int capacity);
 
+    /** returns the quads in [index, index + amount) for modification.
+    Unlike getQuads(), only those quads are uploaded to the VBO by the next draw.
+    @since v2.1
+    */
+    ccV3F_C4B_T2F_Quad* getQuadsAtIndex(unsigned int index, unsigned int amount);
+
+    /** marks the quads in [index, index + amount) as modified. They are uploaded by the next draw
+    @since v2.1
+    */
+    void setDirty(unsigned int index, unsigned int amount);
+
     /** updates a Quad (texture, vertex and color) at a certain index
     * index must be between 0 and the atlas capacity - 1
     @since v0.8
@@ -212,12 +231,21 @@ public:
     /** draws all the Atlas's Quads
     */
     void drawQuads();
+
+    /** draws the quads whose vertices' bounding box intersects rect, in the order of the atlas.
+    Returns the number of quads that were drawn
+    @since v2.1
+    */
+    unsigned int drawQuadsInRect(const CCRect& rect);
     /** listen the event that coming to foreground on Android
      */
     void listenBackToForeground(CCObject *obj);
 private:
     void setupIndices();
     void mapBuffers();
+    void addDirtyRange(unsigned int start, unsigned int end);
+    void uploadDirtyQuads(unsigned int limit);
+    void drawElements(GLuint indicesVBO, const GLushort* pUploadIndices, unsigned int count, unsigned int first, unsigned int uploadLimit);
 #if CC_TEXTURE_ATLAS_USE_VAO
     void setupVBOandVAO();
 #else
@@ -33,16 +33,19 @@ THE SOFTWARE.
 #include "platform/CCThread.h"
 #include "platform/CCImage.h"
 #include "support/ccUtils.h"
+#include "support/CCProfiling.h"
 #include "CCScheduler.h"
 #include "cocoa/CCString.h"
 #include <errno.h>
 #include <stack>
 #include <string>
 #include <cctype>
+#include <string.h>
 #include <queue>
 #include <list>
 #include <pthread.h>
-#include <semaphore.h>
+#include <vector>
+#include <algorithm>
 
 using namespace std;
 
@@ -58,37 +61,39 @@ typedef struct _AsyncStruct
 typedef struct _ImageInfo
 {
     AsyncStruct *asyncStruct;
-    CCImage        *image;
+    CCImage        *image;        // NULL if the image couldn't be loaded
     CCImage::EImageFormat imageType;
 } ImageInfo;
 
-static pthread_t s_loadingThread;
+static pthread_t*   s_pLoadingThreads = NULL;
+static unsigned int s_uLoadingThreadCount = CC_TEXTURE_CACHE_ASYNC_THREADS;
+static unsigned int s_uStartedLoadingThreads = 0;
+static float        s_fAsyncUploadTimeBudget = CC_TEXTURE_CACHE_ASYNC_UPLOAD_BUDGET;
 
 static pthread_mutex_t      s_asyncStructQueueMutex;
+// signaled when an async struct is queued, or when the loading threads have to quit
+static pthread_cond_t       s_asyncStructQueueCond;
 static pthread_mutex_t      s_ImageInfoMutex;
 
-static sem_t* s_pSem = NULL;
 static unsigned long s_nAsyncRefCount = 0;
 
-#if CC_TARGET_PLATFORM == CC_PLATFORM_IOS
-    #define CC_ASYNC_TEXTURE_CACHE_USE_NAMED_SEMAPHORE 1
-#else
-    #define CC_ASYNC_TEXTURE_CACHE_USE_NAMED_SEMAPHORE 0
-#endif
-    
-
-#if CC_ASYNC_TEXTURE_CACHE_USE_NAMED_SEMAPHORE
-    #define CC_ASYNC_TEXTURE_CACHE_SEMAPHORE "ccAsync"
-#else
-    static sem_t s_sem;
-#endif
-
-
 static bool need_quit = false;
 
 static std::queue<AsyncStruct*>* s_pAsyncStructQueue = NULL;
 static std::queue<ImageInfo*>*   s_pImageQueue = NULL;
 
+// remembers that the texture was used in this frame
+static inline void markTextureUsed(CCTexture2D* pTexture)
+{
+    pTexture->setLastUsedFrame(CCDirector::sharedDirector()->getTotalFrames());
+}
+
+// least recently used textures first
+static bool lessRecentlyUsed(CCDictElement* pA, CCDictElement* pB)
+{
+    return ((CCTexture2D*)pA->getObject())->getLastUsedFrame() < ((CCTexture2D*)pB->getObject())->getLastUsedFrame();
+}
+
 static CCImage::EImageFormat computeImageFormatType(string& filename)
 {
     CCImage::EImageFormat ret = CCImage::kFmtUnKnown;
@@ -120,53 +125,45 @@ static void* loadImage(void* data)
     while (true)
     {
         // wait for rendering thread to ask for loading if s_pAsyncStructQueue is empty
-        int semWaitRet = sem_wait(s_pSem);
-        if( semWaitRet < 0 )
+        pthread_mutex_lock(&s_asyncStructQueueMutex);
+        while (s_pAsyncStructQueue->empty() && ! need_quit)
         {
-            CCLOG( "CCTextureCache async thread semaphore error: %s\n", strerror( errno ) );
-            break;
+            pthread_cond_wait(&s_asyncStructQueueCond, &s_asyncStructQueueMutex);
         }
 
-        std::queue<AsyncStruct*> *pQueue = s_pAsyncStructQueue;
-
-        pthread_mutex_lock(&s_asyncStructQueueMutex);// get async struct from queue
-        if (pQueue->empty())
+        if (need_quit)
         {
             pthread_mutex_unlock(&s_asyncStructQueueMutex);
-            if (need_quit)
-                break;
-            else
-                continue;
+            break;
         }
-        else
-        {
-            pAsyncStruct = pQueue->front();
-            pQueue->pop();
-            pthread_mutex_unlock(&s_asyncStructQueueMutex);
-        }        
+
+        // get async struct from queue
+        pAsyncStruct = s_pAsyncStructQueue->front();
+        s_pAsyncStructQueue->pop();
+        pthread_mutex_unlock(&s_asyncStructQueueMutex);
 
         const char *filename = pAsyncStruct->filename.c_str();
 
         // compute image type
         CCImage::EImageFormat imageType = computeImageFormatType(pAsyncStruct->filename);
+        
+        // generate image
+        CCImage *pImage = NULL;
         if (imageType == CCImage::kFmtUnKnown)
         {
             CCLOG("unsupportted format %s",filename);
-            delete pAsyncStruct;
-            
-            continue;
         }
-        
-        // generate image            
-        CCImage *pImage = new CCImage();
-        if (! pImage->initWithImageFileThreadSafe(filename, imageType))
+        else
         {
-            delete pImage;
-            CCLOG("can not load %s", filename);
-            continue;
+            pImage = new CCImage();
+            if (! pImage->initWithImageFileThreadSafe(filename, imageType))
+            {
+                CC_SAFE_DELETE(pImage);
+                CCLOG("can not load %s", filename);
+            }
         }
 
-        // generate image info
+        // generate image info. Failed images are queued too, so the target is released in the main thread
         ImageInfo *pImageInfo = new ImageInfo();
         pImageInfo->asyncStruct = pAsyncStruct;
         pImageInfo->image = pImage;
@@ -178,22 +175,91 @@ static void* loadImage(void* data)
         pthread_mutex_unlock(&s_ImageInfoMutex);    
     }
     
-    if( s_pSem != NULL )
-    {
-    #if CC_ASYNC_TEXTURE_CACHE_USE_NAMED_SEMAPHORE
-        sem_unlink(CC_ASYNC_TEXTURE_CACHE_SEMAPHORE);
-        sem_close(s_pSem);
-    #else
-        sem_destroy(s_pSem);
-    #endif
-        s_pSem = NULL;
-        delete s_pAsyncStructQueue;
-        delete s_pImageQueue;
-    }
-    
     return 0;
 }
 
+static void releaseAsyncStruct(AsyncStruct *pAsyncStruct)
+{
+    if (pAsyncStruct->target)
+    {
+        pAsyncStruct->target->release();
+    }
+    delete pAsyncStruct;
+}
+
+static bool startLoadingThreads()
+{
+    s_pAsyncStructQueue = new queue<AsyncStruct*>();
+    s_pImageQueue = new queue<ImageInfo*>();
+
+    pthread_mutex_init(&s_asyncStructQueueMutex, NULL);
+    pthread_cond_init(&s_asyncStructQueueCond, NULL);
+    pthread_mutex_init(&s_ImageInfoMutex, NULL);
+
+    need_quit = false;
+
+    s_pLoadingThreads = new pthread_t[s_uLoadingThreadCount];
+    s_uStartedLoadingThreads = 0;
+    for (unsigned int i = 0; i < s_uLoadingThreadCount; ++i)
+    {
+        if (pthread_create(&s_pLoadingThreads[s_uStartedLoadingThreads], NULL, loadImage, NULL) != 0)
+        {
+            CCLOG("CCTextureCache async thread creation error: %s\n", strerror(errno));
+            break;
+        }
+        ++s_uStartedLoadingThreads;
+    }
+
+    return s_uStartedLoadingThreads > 0;
+}
+
+static void stopLoadingThreads()
+{
+    if (s_pLoadingThreads == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&s_asyncStructQueueMutex);
+    need_quit = true;
+    pthread_cond_broadcast(&s_asyncStructQueueCond);
+    pthread_mutex_unlock(&s_asyncStructQueueMutex);
+
+    // a thread finishes decoding its current image before quitting
+    for (unsigned int i = 0; i < s_uStartedLoadingThreads; ++i)
+    {
+        pthread_join(s_pLoadingThreads[i], NULL);
+    }
+    CC_SAFE_DELETE_ARRAY(s_pLoadingThreads);
+    s_uStartedLoadingThreads = 0;
+
+    // discard the requests that weren't delivered
+    while (! s_pAsyncStructQueue->empty())
+    {
+        releaseAsyncStruct(s_pAsyncStructQueue->front());
+        s_pAsyncStructQueue->pop();
+    }
+
+    while (! s_pImageQueue->empty())
+    {
+        ImageInfo *pImageInfo = s_pImageQueue->front();
+        s_pImageQueue->pop();
+
+        CC_SAFE_RELEASE(pImageInfo->image);
+        releaseAsyncStruct(pImageInfo->asyncStruct);
+        delete pImageInfo;
+    }
+
+    CC_SAFE_DELETE(s_pAsyncStructQueue);
+    CC_SAFE_DELETE(s_pImageQueue);
+
+    pthread_mutex_destroy(&s_asyncStructQueueMutex);
+    pthread_cond_destroy(&s_asyncStructQueueCond);
+    pthread_mutex_destroy(&s_ImageInfoMutex);
+
+    s_nAsyncRefCount = 0;
+}
+
 // implementation CCTextureCache
 
 // TextureCache - Alloc, Init & Dealloc
@@ -209,6 +275,9 @@ CCTextureCache * CCTextureCache::sharedTextureCache()
 }
 
 CCTextureCache::CCTextureCache()
+: m_uMemoryBudget(CC_TEXTURE_CACHE_MEMORY_BUDGET)
+, m_uEvictedTextures(0)
+, m_uEvictedBytes(0)
 {
     CCAssert(g_sharedTextureCache == NULL, "Attempted to allocate a second instance of a singleton.");
     
@@ -218,11 +287,7 @@ CCTextureCache::CCTextureCache()
 CCTextureCache::~CCTextureCache()
 {
     CCLOGINFO("cocos2d: deallocing CCTextureCache.");
-    need_quit = true;
-    if (s_pSem != NULL)
-    {
-        sem_post(s_pSem);
-    }
+    stopLoadingThreads();
     
     CC_SAFE_RELEASE(m_pTextures);
 }
@@ -264,6 +329,7 @@ void CCTextureCache::addImageAsync(const char *path, CCObject *target, SEL_CallF
     std::string fullpath = pathKey;
     if (texture != NULL)
     {
+        markTextureUsed(texture);
         if (target && selector)
         {
             (target->*selector)(texture);
@@ -273,33 +339,10 @@ void CCTextureCache::addImageAsync(const char *path, CCObject *target, SEL_CallF
     }
 
     // lazy init
-    if (s_pSem == NULL)
-    {             
-#if CC_ASYNC_TEXTURE_CACHE_USE_NAMED_SEMAPHORE
-        s_pSem = sem_open(CC_ASYNC_TEXTURE_CACHE_SEMAPHORE, O_CREAT, 0644, 0);
-        if( s_pSem == SEM_FAILED )
-        {
-            CCLOG( "CCTextureCache async thread semaphore init error: %s\n", strerror( errno ) );
-            s_pSem = NULL;
-            return;
-        }
-#else
-        int semInitRet = sem_init(&s_sem, 0, 0);
-        if( semInitRet < 0 )
-        {
-            CCLOG( "CCTextureCache async thread semaphore init error: %s\n", strerror( errno ) );
-            return;
-        }
-        s_pSem = &s_sem;
-#endif
-        s_pAsyncStructQueue = new queue<AsyncStruct*>();
-        s_pImageQueue = new queue<ImageInfo*>();        
-        
-        pthread_mutex_init(&s_asyncStructQueueMutex, NULL);
-        pthread_mutex_init(&s_ImageInfoMutex, NULL);
-        pthread_create(&s_loadingThread, NULL, loadImage, NULL);
-
-        need_quit = false;
+    if (s_pLoadingThreads == NULL && ! startLoadingThreads())
+    {
+        stopLoadingThreads();
+        return;
     }
 
     if (0 == s_nAsyncRefCount)
@@ -320,28 +363,54 @@ void CCTextureCache::addImageAsync(const char *path, CCObject *target, SEL_CallF
     data->target = target;
     data->selector = selector;
 
-    // add async struct into queue
+    // add async struct into queue, and wake up one of the loading threads
     pthread_mutex_lock(&s_asyncStructQueueMutex);
     s_pAsyncStructQueue->push(data);
+    pthread_cond_signal(&s_asyncStructQueueCond);
     pthread_mutex_unlock(&s_asyncStructQueueMutex);
+}
 
-    sem_post(s_pSem);
+void CCTextureCache::setAsyncLoadingThreadCount(unsigned int uCount)
+{
+    CCAssert(uCount > 0, "At least one loading thread is needed");
+    s_uLoadingThreadCount = MAX(uCount, 1);
+}
+
+unsigned int CCTextureCache::getAsyncLoadingThreadCount()
+{
+    return s_uLoadingThreadCount;
+}
+
+void CCTextureCache::setAsyncUploadTimeBudget(float fMilliseconds)
+{
+    s_fAsyncUploadTimeBudget = fMilliseconds;
+}
+
+float CCTextureCache::getAsyncUploadTimeBudget()
+{
+    return s_fAsyncUploadTimeBudget;
 }
 
 void CCTextureCache::addImageAsyncCallBack(float dt)
 {
-    // the image is generated in loading thread
-    std::queue<ImageInfo*> *imagesQueue = s_pImageQueue;
+    CC_FRAME_PROFILER_SCOPE("async textures");
 
-    pthread_mutex_lock(&s_ImageInfoMutex);
-    if (imagesQueue->empty())
-    {
-        pthread_mutex_unlock(&s_ImageInfoMutex);
-    }
-    else
+    struct cc_timeval start, now;
+    CCTime::getMonotonicTime(&start);
+
+    // the images are generated in the loading threads.
+    // Create as many textures as fit in the time budget, and at least one
+    while (s_nAsyncRefCount > 0)
     {
-        ImageInfo *pImageInfo = imagesQueue->front();
-        imagesQueue->pop();
+        pthread_mutex_lock(&s_ImageInfoMutex);
+        if (s_pImageQueue->empty())
+        {
+            pthread_mutex_unlock(&s_ImageInfoMutex);
+            break;
+        }
+
+        ImageInfo *pImageInfo = s_pImageQueue->front();
+        s_pImageQueue->pop();
         pthread_mutex_unlock(&s_ImageInfoMutex);
 
         AsyncStruct *pAsyncStruct = pImageInfo->asyncStruct;
@@ -351,37 +420,48 @@ void CCTextureCache::addImageAsyncCallBack(float dt)
         SEL_CallFuncO selector = pAsyncStruct->selector;
         const char* filename = pAsyncStruct->filename.c_str();
 
-        // generate texture in render thread
-        CCTexture2D *texture = new CCTexture2D();
+        if (pImage)
+        {
+            // generate texture in render thread
+            CCTexture2D *texture = new CCTexture2D();
 #if 0 //TODO: (CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
-        texture->initWithImage(pImage, kCCResolutioniPhone);
+            texture->initWithImage(pImage, kCCResolutioniPhone);
 #else
-        texture->initWithImage(pImage);
+            texture->initWithImage(pImage);
 #endif
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
-       // cache the texture file name
-       VolatileTexture::addImageTexture(texture, filename, pImageInfo->imageType);
+            // cache the texture file name
+            VolatileTexture::addImageTexture(texture, filename, pImageInfo->imageType);
 #endif
 
-        // cache the texture
-        m_pTextures->setObject(texture, filename);
-        texture->autorelease();
+            // cache the texture
+            m_pTextures->setObject(texture, filename);
+            markTextureUsed(texture);
+            texture->autorelease();
 
-        if (target && selector)
-        {
-            (target->*selector)(texture);
-            target->release();
-        }        
+            if (target && selector)
+            {
+                (target->*selector)(texture);
+            }
 
-        pImage->release();
-        delete pAsyncStruct;
+            pImage->release();
+        }
+
+        releaseAsyncStruct(pAsyncStruct);
         delete pImageInfo;
 
         --s_nAsyncRefCount;
         if (0 == s_nAsyncRefCount)
         {
             CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(CCTextureCache::addImageAsyncCallBack), this);
+            break;
+        }
+
+        CCTime::getMonotonicTime(&now);
+        if (CCTime::timersubCocos2d(&start, &now) >= s_fAsyncUploadTimeBudget)
+        {
+            break;
         }
     }
 }
@@ -404,7 +484,11 @@ CCTexture2D * CCTextureCache::addImage(const char * path)
     texture = (CCTexture2D*)m_pTextures->objectForKey(pathKey.c_str());
 
     std::string fullpath = pathKey; // (CCFileUtils::sharedFileUtils()->fullPathFromRelativePath(path));
-    if( ! texture ) 
+    if (texture)
+    {
+        markTextureUsed(texture);
+    }
+    else
     {
         std::string lowerCase(path);
         for (unsigned int i = 0; i < lowerCase.length(); ++i)
@@ -451,6 +535,7 @@ CCTexture2D * CCTextureCache::addImage(const char * path)
 #endif
 
                     m_pTextures->setObject(texture, pathKey.c_str());
+                    markTextureUsed(texture);
                     texture->release();
                 }
                 else
@@ -477,6 +562,7 @@ CCTexture2D* CCTextureCache::addPVRTCImage(const char* path, int bpp, bool hasAl
     
     if ( (texture = (CCTexture2D*)m_pTextures->objectForKey(temp.c_str())) )
     {
+        markTextureUsed(texture);
         return texture;
     }
     
@@ -492,6 +578,7 @@ CCTexture2D* CCTextureCache::addPVRTCImage(const char* path, int bpp, bool hasAl
                                    (bpp==2 ? kCCTexture2DPixelFormat_PVRTC2 : kCCTexture2DPixelFormat_PVRTC4)))
     {
         m_pTextures->setObject(texture, temp.c_str());
+        markTextureUsed(texture);
         texture->autorelease();
     }
     else
@@ -513,6 +600,7 @@ CCTexture2D * CCTextureCache::addPVRImage(const char* path)
     
     if( (texture = (CCTexture2D*)m_pTextures->objectForKey(key.c_str())) ) 
     {
+        markTextureUsed(texture);
         return texture;
     }
 
@@ -526,6 +614,7 @@ CCTexture2D * CCTextureCache::addPVRImage(const char* path)
         VolatileTexture::addImageTexture(texture, fullpath.c_str(), CCImage::kFmtRawData);
 #endif
         m_pTextures->setObject(texture, key.c_str());
+        markTextureUsed(texture);
         texture->autorelease();
     }
     else
@@ -557,6 +646,7 @@ CCTexture2D* CCTextureCache::addUIImage(CCImage *image, const char *key)
         // If key is nil, then create a new texture each time
         if(key && (texture = (CCTexture2D *)m_pTextures->objectForKey(forKey.c_str())))
         {
+            markTextureUsed(texture);
             break;
         }
 
@@ -567,6 +657,7 @@ CCTexture2D* CCTextureCache::addUIImage(CCImage *image, const char *key)
         if(key && texture)
         {
             m_pTextures->setObject(texture, forKey.c_str());
+            markTextureUsed(texture);
             texture->autorelease();
         }
         else
@@ -656,7 +747,12 @@ void CCTextureCache::removeTextureForKey(const char *textureKeyName)
 
 CCTexture2D* CCTextureCache::textureForKey(const char* key)
 {
-    return (CCTexture2D*)m_pTextures->objectForKey(CCFileUtils::sharedFileUtils()->fullPathFromRelativePath(key));
+    CCTexture2D* texture = (CCTexture2D*)m_pTextures->objectForKey(CCFileUtils::sharedFileUtils()->fullPathFromRelativePath(key));
+    if (texture)
+    {
+        markTextureUsed(texture);
+    }
+    return texture;
 }
 
 void CCTextureCache::reloadAllTextures()
@@ -675,22 +771,118 @@ void CCTextureCache::dumpCachedTextureInfo()
     CCDICT_FOREACH(m_pTextures, pElement)
     {
         CCTexture2D* tex = (CCTexture2D*)pElement->getObject();
-        unsigned int bpp = tex->bitsPerPixelForFormat();
-        // Each texture takes up width * height * bytesPerPixel bytes.
-        unsigned int bytes = tex->getPixelsWide() * tex->getPixelsHigh() * bpp / 8;
+        // Each texture takes up width * height * bytesPerPixel bytes, plus the mipmaps.
+        unsigned int bytes = tex->getMemorySize();
         totalBytes += bytes;
         count++;
-        CCLOG("cocos2d: \"%s\" rc=%lu id=%lu %lu x %lu @ %ld bpp => %lu KB",
+        CCLOG("cocos2d: \"%s\" rc=%lu id=%lu %lu x %lu @ %ld bpp => %lu KB, last used in frame %lu",
                pElement->getStrKey(),
                (long)tex->retainCount(),
                (long)tex->getName(),
                (long)tex->getPixelsWide(),
                (long)tex->getPixelsHigh(),
-               (long)bpp,
-               (long)bytes / 1024);
+               (long)tex->bitsPerPixelForFormat(),
+               (long)bytes / 1024,
+               (long)tex->getLastUsedFrame());
     }
 
     CCLOG("cocos2d: CCTextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
+
+    ccTextureCacheStats stats;
+    getStats(&stats);
+    CCLOG("cocos2d: CCTextureCache residency: %u KB only retained by the cache in %u textures, budget %u KB, %u textures evicted for %lu KB",
+           stats.unusedBytes / 1024,
+           stats.unusedTextures,
+           stats.memoryBudget / 1024,
+           stats.evictedTextures,
+           (unsigned long)(stats.evictedBytes / 1024));
+}
+
+void CCTextureCache::setMemoryBudget(unsigned int uBytes)
+{
+    m_uMemoryBudget = uBytes;
+}
+
+unsigned int CCTextureCache::getMemoryBudget()
+{
+    return m_uMemoryBudget;
+}
+
+void CCTextureCache::getStats(ccTextureCacheStats* pStats)
+{
+    CCAssert(pStats != NULL, "pStats should not be null");
+    memset(pStats, 0, sizeof(*pStats));
+
+    CCDictElement* pElement = NULL;
+    CCDICT_FOREACH(m_pTextures, pElement)
+    {
+        CCTexture2D* pTexture = (CCTexture2D*)pElement->getObject();
+        unsigned int uBytes = pTexture->getMemorySize();
+        pStats->textures++;
+        pStats->residentBytes += uBytes;
+        if (pTexture->retainCount() == 1)
+        {
+            pStats->unusedTextures++;
+            pStats->unusedBytes += uBytes;
+        }
+    }
+
+    pStats->memoryBudget = m_uMemoryBudget;
+    pStats->evictedTextures = m_uEvictedTextures;
+    pStats->evictedBytes = m_uEvictedBytes;
+}
+
+void CCTextureCache::updateResidency()
+{
+    unsigned int uFrame = CCDirector::sharedDirector()->getTotalFrames();
+    unsigned int uResidentBytes = 0;
+    unsigned int uEvictableBytes = 0;
+
+    CCDictElement* pElement = NULL;
+    CCDICT_FOREACH(m_pTextures, pElement)
+    {
+        CCTexture2D* pTexture = (CCTexture2D*)pElement->getObject();
+        unsigned int uBytes = pTexture->getMemorySize();
+        uResidentBytes += uBytes;
+
+        if (pTexture->retainCount() > 1)
+        {
+            pTexture->setLastUsedFrame(uFrame);
+        }
+        else if (pTexture->getLastUsedFrame() != uFrame)
+        {
+            uEvictableBytes += uBytes;
+        }
+    }
+
+    if (m_uMemoryBudget == 0 || uResidentBytes <= m_uMemoryBudget || uEvictableBytes == 0)
+    {
+        return;
+    }
+
+    // only the cache retains these textures: release the least recently used ones first
+    std::vector<CCDictElement*> candidates;
+    CCDictElement* pCandidate = NULL;
+    CCDICT_FOREACH(m_pTextures, pCandidate)
+    {
+        CCTexture2D* pTexture = (CCTexture2D*)pCandidate->getObject();
+        if (pTexture->retainCount() == 1 && pTexture->getLastUsedFrame() != uFrame)
+        {
+            candidates.push_back(pCandidate);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), lessRecentlyUsed);
+
+    for (std::vector<CCDictElement*>::iterator iter = candidates.begin(); iter != candidates.end() && uResidentBytes > m_uMemoryBudget; ++iter)
+    {
+        unsigned int uBytes = ((CCTexture2D*)(*iter)->getObject())->getMemorySize();
+        CCLOGINFO("cocos2d: CCTextureCache: evicting texture: %s", (*iter)->getStrKey());
+
+        uResidentBytes -= uBytes;
+        m_uEvictedTextures++;
+        m_uEvictedBytes += uBytes;
+        m_pTextures->removeObjectForElememt(*iter);
+    }
 }
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -48,6 +48,27 @@ class CCImage;
  * @{
  */
 
+/** @brief Residency statistics of CCTextureCache
+ @since v2.1
+ */
+typedef struct _ccTextureCacheStats
+{
+    //! number of cached textures
+    unsigned int textures;
+    //! video memory used by the cached textures, in bytes
+    unsigned int residentBytes;
+    //! number of cached textures that are only retained by the cache
+    unsigned int unusedTextures;
+    //! video memory used by the textures that are only retained by the cache, in bytes
+    unsigned int unusedBytes;
+    //! memory budget, in bytes. 0 if there is no budget
+    unsigned int memoryBudget;
+    //! number of textures evicted because of the budget, since the cache was created
+    unsigned int evictedTextures;
+    //! video memory released by the evictions, in bytes
+    unsigned long long evictedBytes;
+} ccTextureCacheStats;
+
 /** @brief Singleton that handles the loading of textures
 * Once the texture is loaded, the next time it will return
 * a reference of the previously loaded texture reducing GPU & CPU memory
@@ -58,6 +79,10 @@ protected:
     CCDictionary* m_pTextures;
     //pthread_mutex_t                *m_pDictLock;
 
+    unsigned int m_uMemoryBudget;
+    unsigned int m_uEvictedTextures;
+    unsigned long long m_uEvictedBytes;
+
 
 private:
     /// todo: void addImageWithAsyncObject(CCAsyncObject* async);
@@ -92,12 +117,29 @@ public:
     * If the file image was not previously loaded, it will create a new CCTexture2D object and it will return it.
     * Otherwise it will load a texture in a new thread, and when the image is loaded, the callback will be called with the Texture2D as a parameter.
     * The callback will be called from the main thread, so it is safe to create any cocos2d object from the callback.
+    * The images are decoded by a pool of threads, so the callbacks may not be called in the order the images were requested.
     * Supported image extensions: .png, .jpg
     * @since v0.8
     */
     
     void addImageAsync(const char *path, CCObject *target, SEL_CallFuncO selector);
 
+    /** Sets the number of threads that decode the images requested with addImageAsync.
+    * It is used the next time the threads are started: call it before the first addImageAsync.
+    * Default is CC_TEXTURE_CACHE_ASYNC_THREADS.
+    * @since v2.1
+    */
+    static void setAsyncLoadingThreadCount(unsigned int uCount);
+    static unsigned int getAsyncLoadingThreadCount();
+
+    /** Sets the time, in milliseconds, that can be spent per frame creating the textures of the decoded images.
+    * At least one texture is created per frame. 0 creates just one texture per frame.
+    * Default is CC_TEXTURE_CACHE_ASYNC_UPLOAD_BUDGET.
+    * @since v2.1
+    */
+    static void setAsyncUploadTimeBudget(float fMilliseconds);
+    static float getAsyncUploadTimeBudget();
+
     /* Returns a Texture2D object given an CGImageRef image
     * If the image was not previously loaded, it will create a new CCTexture2D object and it will return it.
     * Otherwise it will return a reference of a previously loaded image
@@ -149,6 +191,27 @@ public:
     */
     void dumpCachedTextureInfo();
 
+    /** Sets the video memory budget of the cache, in bytes.
+    * When the cached textures use more memory than that, the least recently used textures that are
+    * only retained by the cache are removed at the end of the frame, until the cache fits in the budget.
+    * Textures that were used or added during the frame are never evicted.
+    * 0 disables the eviction. Default is CC_TEXTURE_CACHE_MEMORY_BUDGET.
+    * @since v2.1
+    */
+    void setMemoryBudget(unsigned int uBytes);
+    unsigned int getMemoryBudget();
+
+    /** Fills pStats with the current residency statistics of the cache
+    * @since v2.1
+    */
+    void getStats(ccTextureCacheStats* pStats);
+
+    /** Updates the last used frame of the textures that are retained by somebody else than the cache,
+    * and evicts textures if the cache is over budget. Called by CCDirector at the end of each frame.
+    * @since v2.1
+    */
+    void updateResidency();
+
 #ifdef CC_SUPPORT_PVRTC
     /** Returns a Texture2D object given an PVRTC RAW filename
     * If the file image was not previously loaded, it will create a new CCTexture2D
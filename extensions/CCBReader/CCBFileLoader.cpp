@@ -4,10 +4,10 @@ USING_NS_CC;
 
 NS_CC_EXT_BEGIN
 
-#define PROPERTY_CCBFILE "ccbFile"
+static const int PROPERTY_CCBFILE = CCBReader::getPropertyIDForName("ccbFile");
 
 void CCBFileLoader::onHandlePropTypeCCBFile(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCNode * pCCBFileNode, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_CCBFILE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_CCBFILE) {
         pNode->addChild(pCCBFileNode);
     } else {
         CCNodeLoader::onHandlePropTypeCCBFile(pNode, pParent, pPropertyName, pCCBFileNode, pCCBReader);
@@ -17,9 +17,39 @@
 USING_NS_CC;
 NS_CC_EXT_BEGIN;
 
+static CCDictionary * sCCBTemplateCache = NULL;
+
+CCBTemplate::CCBTemplate(unsigned char * pBytes) {
+    this->mBytes = pBytes;
+    this->mNodeGraphByte = 0;
+    this->mRecording = false;
+    this->mCompiled = false;
+}
+
+CCBTemplate::~CCBTemplate() {
+    CC_SAFE_DELETE_ARRAY(this->mBytes);
+
+    /* Clear string cache. */
+    std::vector<CCString *>::iterator stringCacheIterator;
+    for (stringCacheIterator = this->mStringCache.begin(); stringCacheIterator != this->mStringCache.end(); stringCacheIterator++) {
+        (*stringCacheIterator)->release();
+    }
+    this->mStringCache.clear();
+}
+
+bool CCBTemplate::isCompiled() {
+    return this->mCompiled;
+}
+
 CCBReader::CCBReader(CCNodeLoaderLibrary * pCCNodeLoaderLibrary, CCBMemberVariableAssigner * pCCBMemberVariableAssigner, CCBSelectorResolver * pCCBSelectorResolver, CCNodeLoaderListener * pCCNodeLoaderListener) {
     this->mRootNode = NULL;
     this->mRootCCBReader = true;
+    this->mTemplate = NULL;
+    this->mBytes = NULL;
+    this->mReplaying = false;
+    this->mRecording = false;
+    this->mCurrentPropertyName = NULL;
+    this->mCurrentPropertyID = -1;
 
     this->mCCNodeLoaderLibrary = pCCNodeLoaderLibrary;
     this->mCCNodeLoaderLibrary->retain();
@@ -40,6 +70,12 @@ CCBReader::CCBReader(CCNodeLoaderLibrary * pCCNodeLoaderLibrary, CCBMemberVariab
 CCBReader::CCBReader(CCBReader * pCCBReader) {
     this->mRootNode = NULL;
     this->mRootCCBReader = false;
+    this->mTemplate = NULL;
+    this->mBytes = NULL;
+    this->mReplaying = false;
+    this->mRecording = false;
+    this->mCurrentPropertyName = NULL;
+    this->mCurrentPropertyID = -1;
 
     /* Borrow data from the 'parent' CCBReader. */
     this->mResolutionScale = pCCBReader->mResolutionScale;
@@ -53,17 +89,10 @@ CCBReader::CCBReader(CCBReader * pCCBReader) {
 }
 
 CCBReader::~CCBReader() {
-    CC_SAFE_DELETE_ARRAY(this->mBytes);
+    CC_SAFE_RELEASE(this->mTemplate);
 
     this->mCCNodeLoaderLibrary->release();
 
-    /* Clear string cache. */
-    std::vector<CCString *>::iterator stringCacheIterator;
-    for (stringCacheIterator = this->mStringCache.begin(); stringCacheIterator != this->mStringCache.end(); stringCacheIterator++) {
-        (*stringCacheIterator)->release();
-    }
-    this->mStringCache.clear();
-    
     if(this->mRootCCBReader) {
         /* Clear loaded spritesheets. */
         this->mLoadedSpriteSheets.clear();
@@ -106,19 +135,46 @@ CCNode * CCBReader::readNodeGraphFromFile(CCString * pCCBRootPath, CCString * pC
 
     const char * path = CCFileUtils::sharedFileUtils()->fullPathFromRelativePath(ccbFullFilePath->getCString());
 
-    unsigned long size = 0;
-    this->mBytes = CCFileUtils::sharedFileUtils()->getFileData(path, "rb", &size);
-
-    this->mCurrentByte = 0;
-    this->mCurrentBit = 0;
+    CC_SAFE_RELEASE_NULL(this->mTemplate);
+    this->mTemplate = this->templateForFile(path);
+    CC_SAFE_RETAIN(this->mTemplate);
 
     this->mOwner = pOwner;
     CC_SAFE_RETAIN(this->mOwner);
     this->mRootContainerSize = pRootContainerSize;
 
     CCNode * node = NULL;
-    if(this->readHeader() && this->readStringCache()) {
+    if(this->mTemplate != NULL) {
+        if(this->mTemplate->mCompiled) {
+            this->mReplaying = true;
+            this->mCurrentValue = 0;
+        } else {
+            /* Record the values decoded by this reader and the loaders, the next readers replay them.
+             * A file loaded again while it is being recorded is only decoded. */
+            this->mRecording = !this->mTemplate->mRecording;
+            if(this->mRecording) {
+                this->mTemplate->mRecording = true;
+                this->mTemplate->mValues.clear();
+            }
+            this->mBytes = this->mTemplate->mBytes;
+            this->mCurrentByte = this->mTemplate->mNodeGraphByte;
+            this->mCurrentBit = 0;
+        }
+
         node = this->readNodeGraph();
+
+        if(this->mRecording) {
+            this->mTemplate->mRecording = false;
+            if(node != NULL) {
+                this->mTemplate->mCompiled = true;
+                std::vector<int>(this->mTemplate->mValues).swap(this->mTemplate->mValues);
+                CC_SAFE_DELETE_ARRAY(this->mTemplate->mBytes);
+            }
+        }
+        this->mReplaying = false;
+        this->mRecording = false;
+        this->mBytes = NULL;
+        this->mCurrentPropertyName = NULL;
     }
 
     CC_SAFE_RELEASE(this->mOwner);
@@ -128,6 +184,43 @@ CCNode * CCBReader::readNodeGraphFromFile(CCString * pCCBRootPath, CCString * pC
     return node;
 }
 
+CCBTemplate * CCBReader::templateForFile(const char * pPath) {
+    if(sCCBTemplateCache == NULL) {
+        sCCBTemplateCache = new CCDictionary();
+    }
+
+    CCBTemplate * ccbTemplate = (CCBTemplate *)sCCBTemplateCache->objectForKey(pPath);
+    if(ccbTemplate != NULL) {
+        return ccbTemplate;
+    }
+
+    unsigned long size = 0;
+    unsigned char * bytes = CCFileUtils::sharedFileUtils()->getFileData(pPath, "rb", &size);
+
+    ccbTemplate = new CCBTemplate(bytes);
+    this->mTemplate = ccbTemplate;
+    this->mBytes = bytes;
+    this->mCurrentByte = 0;
+    this->mCurrentBit = 0;
+
+    if(this->readHeader() && this->readStringCache()) {
+        ccbTemplate->mNodeGraphByte = this->mCurrentByte;
+        ccbTemplate->mPropertyIDs.resize(ccbTemplate->mStringCache.size(), -1);
+        sCCBTemplateCache->setObject(ccbTemplate, pPath);
+    } else {
+        ccbTemplate = NULL;
+    }
+    this->mTemplate->release();
+    this->mTemplate = NULL;
+    this->mBytes = NULL;
+
+    return ccbTemplate;
+}
+
+void CCBReader::purgeTemplateCache() {
+    CC_SAFE_RELEASE_NULL(sCCBTemplateCache);
+}
+
 bool CCBReader::readHeader() {
 	/* If no bytes loaded, don't crash about it. */
 	if(this->mBytes == NULL) {
@@ -174,12 +267,25 @@ void CCBReader::readStringCacheEntry() {
 
     this->mCurrentByte += numBytes;
 
-    this->mStringCache.push_back(string);
+    this->mTemplate->mStringCache.push_back(string);
+}
+
+int CCBReader::readValue() {
+    CCAssert(this->mCurrentValue < (int)this->mTemplate->mValues.size(), "The node graph read more values than it recorded.");
+    return this->mTemplate->mValues[this->mCurrentValue++];
 }
 
 unsigned char CCBReader::readByte() {
+    if(this->mReplaying) {
+        return (unsigned char)this->readValue();
+    }
+
     unsigned char byte = this->mBytes[this->mCurrentByte];
     this->mCurrentByte++;
+
+    if(this->mRecording) {
+        this->mTemplate->mValues.push_back(byte);
+    }
     return byte;
 }
 
@@ -188,6 +294,10 @@ bool CCBReader::readBool() {
 }
 
 int CCBReader::readInt(bool pSigned) {
+    if(this->mReplaying) {
+        return this->readValue();
+    }
+
     int numBits = 0;
     while(!this->getBit()) {
         numBits++;
@@ -214,35 +324,62 @@ int CCBReader::readInt(bool pSigned) {
     }
     
     this->alignBits();
-    
+
+    if(this->mRecording) {
+        this->mTemplate->mValues.push_back(num);
+    }
     return num;
 }
 
 
 float CCBReader::readFloat() {
+    float f = 0;
+    int value;
+
+    if(this->mReplaying) {
+        value = this->readValue();
+        memcpy(&f, &value, sizeof(float));
+        return f;
+    }
+
+    /* The value is recorded as a whole, not the byte and int it is made of. */
+    bool recording = this->mRecording;
+    this->mRecording = false;
+
     unsigned char type = this->readByte();
     
     switch (type) {
         case kCCBFloat0:
-            return 0;    
+            f = 0;
+            break;
         case kCCBFloat1:
-            return 1;
+            f = 1;
+            break;
         case kCCBFloatMinus1:
-            return -1;
+            f = -1;
+            break;
         case kCCBFloat05:
-            return 0.5f;
+            f = 0.5f;
+            break;
         case kCCBFloatInteger:
-            return (float)this->readInt(true);
+            f = (float)this->readInt(true);
+            break;
         default:
             /* using a memcpy since the compiler isn't
              * doing the float ptr math correctly on device.
              * TODO still applies in C++ ? */
             float * pF = (float*)(this->mBytes + this->mCurrentByte);
-            float f = 0;
             memcpy(&f, pF, sizeof(float));
             this->mCurrentByte += 4;
-            return f;
+            break;
+    }
+
+    this->mRecording = recording;
+    if(this->mRecording) {
+        memcpy(&value, &f, sizeof(float));
+        this->mTemplate->mValues.push_back(value);
     }
+    return f;
 }
 
 
@@ -274,7 +411,42 @@ void CCBReader::alignBits() {
 
 CCString * CCBReader::readCachedString() {
     int i = this->readInt(false);
-    return this->mStringCache[i];
+    return this->mTemplate->mStringCache[i];
+}
+
+CCString * CCBReader::readPropertyName() {
+    int i = this->readInt(false);
+    CCString * propertyName = this->mTemplate->mStringCache[i];
+
+    int & propertyID = this->mTemplate->mPropertyIDs[i];
+    if(propertyID < 0) {
+        propertyID = CCBReader::getPropertyIDForName(propertyName->getCString());
+    }
+
+    this->mCurrentPropertyName = propertyName;
+    this->mCurrentPropertyID = propertyID;
+    return propertyName;
+}
+
+int CCBReader::getPropertyID(CCString * pPropertyName) {
+    /* The loaders are passed the name that was just read. */
+    if(pPropertyName == this->mCurrentPropertyName) {
+        return this->mCurrentPropertyID;
+    }
+    return CCBReader::getPropertyIDForName(pPropertyName->getCString());
+}
+
+int CCBReader::getPropertyIDForName(const char * pPropertyName) {
+    static std::map<std::string, int> propertyIDs;
+
+    std::map<std::string, int>::iterator it = propertyIDs.find(pPropertyName);
+    if(it != propertyIDs.end()) {
+        return it->second;
+    }
+
+    int propertyID = (int)propertyIDs.size();
+    propertyIDs.insert(std::make_pair(std::string(pPropertyName), propertyID));
+    return propertyID;
 }
 
 CCNode * CCBReader::readNodeGraph(CCNode * pParent) {
@@ -100,17 +100,61 @@ class CCNodeLoaderListener;
 class CCBMemberVariableAssigner;
 class CCBSelectorResolver;
 
+/**
+ * @brief A parsed CCBI file, shared by all the CCBReaders that read the file.
+ *
+ * It keeps the string cache of the file. The first CCBReader that reads the node graph records
+ * the values it decodes, the next ones replay them instead of decoding the file again.
+ * @since v2.1
+ */
+class CCBTemplate : public CCObject {
+    friend class CCBReader;
+
+    private:
+        unsigned char * mBytes;
+        int mNodeGraphByte;
+
+        std::vector<CCString *> mStringCache;
+        /* Property id of each string of the cache, -1 until the string is read as a property name. */
+        std::vector<int> mPropertyIDs;
+
+        /* Values decoded from the node graph, in the order they were read. */
+        std::vector<int> mValues;
+        bool mRecording;
+        bool mCompiled;
+
+    public:
+        CCBTemplate(unsigned char * pBytes);
+        virtual ~CCBTemplate();
+
+        /** Whether the node graph was recorded, so that reading it does not decode the file anymore. */
+        bool isCompiled();
+};
+
 /**
  * @brief Parse CCBI file which is generated by CocosBuilder
+ *
+ * The parsed files are cached as CCBTemplates, see purgeTemplateCache().
+ * Property names are resolved to ids once per file: loaders compare ids, returned by
+ * getPropertyID(), with the ids of the names they handle, returned by getPropertyIDForName().
  */
 class CCBReader : public CCObject {
     private:
         CCString * mCCBRootPath;
         bool mRootCCBReader;
 
+        CCBTemplate * mTemplate;
         unsigned char * mBytes;
         int mCurrentByte;
         int mCurrentBit;
+        /* Replaying the values recorded in mTemplate, or recording them. */
+        bool mReplaying;
+        bool mRecording;
+        int mCurrentValue;
+
+        CCString * mCurrentPropertyName;
+        int mCurrentPropertyID;
+
         CCObject * mOwner;
         CCNode * mRootNode;
         CCSize mRootContainerSize;
@@ -121,7 +165,6 @@ class CCBReader : public CCObject {
         CCBMemberVariableAssigner * mCCBMemberVariableAssigner;
         CCBSelectorResolver * mCCBSelectorResolver;
 
-        std::vector<CCString *> mStringCache;
         std::set<std::string> mLoadedSpriteSheets;
 
     public:
@@ -159,8 +202,29 @@ class CCBReader : public CCObject {
         bool readBool();
         float readFloat();
         CCString * readCachedString();
+        /** Reads a cached string used as a property name, and resolves its id.
+         @since v2.1
+         */
+        CCString * readPropertyName();
+
+        /** Id of a property name passed to the CCNodeLoader::onHandlePropType* methods.
+         @since v2.1
+         */
+        int getPropertyID(CCString * pPropertyName);
+        /** Id of a property name. The same name always has the same id.
+         @since v2.1
+         */
+        static int getPropertyIDForName(const char * pPropertyName);
+
+        /** Releases the cached CCBTemplates. Call it to free memory, or after a CCBI file changed.
+         @since v2.1
+         */
+        static void purgeTemplateCache();
 
     private:
+        CCBTemplate * templateForFile(const char * pPath);
+        int readValue();
+
         bool readHeader();
         bool readStringCache();
         void readStringCacheEntry();
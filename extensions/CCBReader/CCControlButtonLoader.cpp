@@ -3,27 +3,27 @@
 USING_NS_CC;
 NS_CC_EXT_BEGIN;
 
-#define PROPERTY_ZOOMONTOUCHDOWN "zoomOnTouchDown"
-#define PROPERTY_TITLE_NORMAL "title|1"
-#define PROPERTY_TITLE_HIGHLIGHTED "title|2"
-#define PROPERTY_TITLE_DISABLED "title|4"
-#define PROPERTY_TITLECOLOR_NORMAL "titleColor|1"
-#define PROPERTY_TITLECOLOR_HIGHLIGHTED "titleColor|2"
-#define PROPERTY_TITLECOLOR_DISABLED "titleColor|4"
-#define PROPERTY_TITLETTF_NORMAL "titleTTF|1"
-#define PROPERTY_TITLETTF_HIGHLIGHTED "titleTTF|2"
-#define PROPERTY_TITLETTF_DISABLED "titleTTF|4"
-#define PROPERTY_TITLETTFSIZE_NORMAL "titleTTFSize|1"
-#define PROPERTY_TITLETTFSIZE_HIGHLIGHTED "titleTTFSize|2"
-#define PROPERTY_TITLETTFSIZE_DISABLED "titleTTFSize|4"
-#define PROPERTY_LABELANCHORPOINT "labelAnchorPoint"
-#define PROPERTY_PREFEREDSIZE "preferedSize" // TODO Should be "preferredSize". This is a typo in cocos2d-iphone, cocos2d-x and CocosBuilder!
-#define PROPERTY_BACKGROUNDSPRITEFRAME_NORMAL "backgroundSpriteFrame|1"
-#define PROPERTY_BACKGROUNDSPRITEFRAME_HIGHLIGHTED "backgroundSpriteFrame|2"
-#define PROPERTY_BACKGROUNDSPRITEFRAME_DISABLED "backgroundSpriteFrame|4"
+static const int PROPERTY_ZOOMONTOUCHDOWN = CCBReader::getPropertyIDForName("zoomOnTouchDown");
+static const int PROPERTY_TITLE_NORMAL = CCBReader::getPropertyIDForName("title|1");
+static const int PROPERTY_TITLE_HIGHLIGHTED = CCBReader::getPropertyIDForName("title|2");
+static const int PROPERTY_TITLE_DISABLED = CCBReader::getPropertyIDForName("title|4");
+static const int PROPERTY_TITLECOLOR_NORMAL = CCBReader::getPropertyIDForName("titleColor|1");
+static const int PROPERTY_TITLECOLOR_HIGHLIGHTED = CCBReader::getPropertyIDForName("titleColor|2");
+static const int PROPERTY_TITLECOLOR_DISABLED = CCBReader::getPropertyIDForName("titleColor|4");
+static const int PROPERTY_TITLETTF_NORMAL = CCBReader::getPropertyIDForName("titleTTF|1");
+static const int PROPERTY_TITLETTF_HIGHLIGHTED = CCBReader::getPropertyIDForName("titleTTF|2");
+static const int PROPERTY_TITLETTF_DISABLED = CCBReader::getPropertyIDForName("titleTTF|4");
+static const int PROPERTY_TITLETTFSIZE_NORMAL = CCBReader::getPropertyIDForName("titleTTFSize|1");
+static const int PROPERTY_TITLETTFSIZE_HIGHLIGHTED = CCBReader::getPropertyIDForName("titleTTFSize|2");
+static const int PROPERTY_TITLETTFSIZE_DISABLED = CCBReader::getPropertyIDForName("titleTTFSize|4");
+static const int PROPERTY_LABELANCHORPOINT = CCBReader::getPropertyIDForName("labelAnchorPoint");
+static const int PROPERTY_PREFEREDSIZE = CCBReader::getPropertyIDForName("preferedSize"); // TODO Should be "preferredSize". This is a typo in cocos2d-iphone, cocos2d-x and CocosBuilder!
+static const int PROPERTY_BACKGROUNDSPRITEFRAME_NORMAL = CCBReader::getPropertyIDForName("backgroundSpriteFrame|1");
+static const int PROPERTY_BACKGROUNDSPRITEFRAME_HIGHLIGHTED = CCBReader::getPropertyIDForName("backgroundSpriteFrame|2");
+static const int PROPERTY_BACKGROUNDSPRITEFRAME_DISABLED = CCBReader::getPropertyIDForName("backgroundSpriteFrame|4");
 
 void CCControlButtonLoader::onHandlePropTypeCheck(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, bool pCheck, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_ZOOMONTOUCHDOWN) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ZOOMONTOUCHDOWN) {
         ((CCControlButton *)pNode)->setZoomOnTouchDown(pCheck);
     } else {
         CCControlLoader::onHandlePropTypeCheck(pNode, pParent, pPropertyName, pCheck, pCCBReader);
@@ -31,11 +31,11 @@ void CCControlButtonLoader::onHandlePropTypeCheck(CCNode * pNode, CCNode * pPare
 }
 
 void CCControlButtonLoader::onHandlePropTypeString(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCString * pString, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_TITLE_NORMAL) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TITLE_NORMAL) {
         ((CCControlButton *)pNode)->setTitleForState(pString, CCControlStateNormal);
-    } else if(pPropertyName->compare(PROPERTY_TITLE_HIGHLIGHTED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TITLE_HIGHLIGHTED) {
         ((CCControlButton *)pNode)->setTitleForState(pString, CCControlStateHighlighted);
-    } else if(pPropertyName->compare(PROPERTY_TITLE_DISABLED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TITLE_DISABLED) {
         ((CCControlButton *)pNode)->setTitleForState(pString, CCControlStateDisabled);
     } else {
         CCControlLoader::onHandlePropTypeString(pNode, pParent, pPropertyName, pString, pCCBReader);
@@ -43,11 +43,11 @@ void CCControlButtonLoader::onHandlePropTypeString(CCNode * pNode, CCNode * pPar
 }
 
 void CCControlButtonLoader::onHandlePropTypeFontTTF(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCString * pFontTTF, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_TITLETTF_NORMAL) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TITLETTF_NORMAL) {
         ((CCControlButton *)pNode)->setTitleTTFForState(pFontTTF->getCString(), CCControlStateNormal);
-    } else if(pPropertyName->compare(PROPERTY_TITLETTF_HIGHLIGHTED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TITLETTF_HIGHLIGHTED) {
         ((CCControlButton *)pNode)->setTitleTTFForState(pFontTTF->getCString(), CCControlStateHighlighted);
-    } else if(pPropertyName->compare(PROPERTY_TITLETTF_DISABLED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TITLETTF_DISABLED) {
         ((CCControlButton *)pNode)->setTitleTTFForState(pFontTTF->getCString(), CCControlStateDisabled);
     } else {
         CCControlLoader::onHandlePropTypeFontTTF(pNode, pParent, pPropertyName, pFontTTF, pCCBReader);
@@ -55,11 +55,11 @@ void CCControlButtonLoader::onHandlePropTypeFontTTF(CCNode * pNode, CCNode * pPa
 }
 
 void CCControlButtonLoader::onHandlePropTypeFloatScale(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, float pFloatScale, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_TITLETTFSIZE_NORMAL) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TITLETTFSIZE_NORMAL) {
         ((CCControlButton *)pNode)->setTitleTTFSizeForState(pFloatScale, CCControlStateNormal);
-    } else if(pPropertyName->compare(PROPERTY_TITLETTFSIZE_HIGHLIGHTED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TITLETTFSIZE_HIGHLIGHTED) {
         ((CCControlButton *)pNode)->setTitleTTFSizeForState(pFloatScale, CCControlStateHighlighted);
-    } else if(pPropertyName->compare(PROPERTY_TITLETTFSIZE_DISABLED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TITLETTFSIZE_DISABLED) {
         ((CCControlButton *)pNode)->setTitleTTFSizeForState(pFloatScale, CCControlStateDisabled);
     } else {
         CCControlLoader::onHandlePropTypeFloatScale(pNode, pParent, pPropertyName, pFloatScale, pCCBReader);
@@ -67,7 +67,7 @@ void CCControlButtonLoader::onHandlePropTypeFloatScale(CCNode * pNode, CCNode *
 }
 
 void CCControlButtonLoader::onHandlePropTypePoint(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCPoint pPoint, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_LABELANCHORPOINT) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_LABELANCHORPOINT) {
         ((CCControlButton *)pNode)->setLabelAnchorPoint(pPoint);
     } else {
         CCControlLoader::onHandlePropTypePoint(pNode, pParent, pPropertyName, pPoint, pCCBReader);
@@ -75,7 +75,7 @@ void CCControlButtonLoader::onHandlePropTypePoint(CCNode * pNode, CCNode * pPare
 }
 
 void CCControlButtonLoader::onHandlePropTypeSize(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCSize pSize, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_PREFEREDSIZE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_PREFEREDSIZE) {
         ((CCControlButton *)pNode)->setPreferredSize(pSize);
     } else {
         CCControlLoader::onHandlePropTypeSize(pNode, pParent, pPropertyName, pSize, pCCBReader);
@@ -83,15 +83,15 @@ void CCControlButtonLoader::onHandlePropTypeSize(CCNode * pNode, CCNode * pParen
 }
 
 void CCControlButtonLoader::onHandlePropTypeSpriteFrame(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCSpriteFrame * pCCSpriteFrame, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_BACKGROUNDSPRITEFRAME_NORMAL) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_BACKGROUNDSPRITEFRAME_NORMAL) {
         if(pCCSpriteFrame != NULL) {
             ((CCControlButton *)pNode)->setBackgroundSpriteFrameForState(pCCSpriteFrame, CCControlStateNormal);
         }
-    } else if(pPropertyName->compare(PROPERTY_BACKGROUNDSPRITEFRAME_HIGHLIGHTED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_BACKGROUNDSPRITEFRAME_HIGHLIGHTED) {
         if(pCCSpriteFrame != NULL) {
             ((CCControlButton *)pNode)->setBackgroundSpriteFrameForState(pCCSpriteFrame, CCControlStateHighlighted);
         }
-    } else if(pPropertyName->compare(PROPERTY_BACKGROUNDSPRITEFRAME_DISABLED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_BACKGROUNDSPRITEFRAME_DISABLED) {
         if(pCCSpriteFrame != NULL) {
             ((CCControlButton *)pNode)->setBackgroundSpriteFrameForState(pCCSpriteFrame, CCControlStateDisabled);
         }
@@ -101,11 +101,11 @@ void CCControlButtonLoader::onHandlePropTypeSpriteFrame(CCNode * pNode, CCNode *
 }
 
 void CCControlButtonLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccColor3B pCCColor3B, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_TITLECOLOR_NORMAL) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TITLECOLOR_NORMAL) {
         ((CCControlButton *)pNode)->setTitleColorForState(pCCColor3B, CCControlStateNormal);
-    } else if(pPropertyName->compare(PROPERTY_TITLECOLOR_HIGHLIGHTED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TITLECOLOR_HIGHLIGHTED) {
         ((CCControlButton *)pNode)->setTitleColorForState(pCCColor3B, CCControlStateHighlighted);
-    } else if(pPropertyName->compare(PROPERTY_TITLECOLOR_DISABLED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TITLECOLOR_DISABLED) {
         ((CCControlButton *)pNode)->setTitleColorForState(pCCColor3B, CCControlStateDisabled);
     } else {
         CCControlLoader::onHandlePropTypeColor3(pNode, pParent, pPropertyName, pCCColor3B, pCCBReader);
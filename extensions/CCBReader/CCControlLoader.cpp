@@ -3,14 +3,14 @@
 USING_NS_CC;
 NS_CC_EXT_BEGIN
 
-#define PROPERTY_ENABLED "enabled"
-#define PROPERTY_SELECTED "selected"
-#define PROPERTY_CCCONTROL "ccControl"
+static const int PROPERTY_ENABLED = CCBReader::getPropertyIDForName("enabled");
+static const int PROPERTY_SELECTED = CCBReader::getPropertyIDForName("selected");
+static const int PROPERTY_CCCONTROL = CCBReader::getPropertyIDForName("ccControl");
 
 void CCControlLoader::onHandlePropTypeCheck(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, bool pCheck, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_ENABLED) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ENABLED) {
         ((CCControl *)pNode)->setEnabled(pCheck);
-    } else if(pPropertyName->compare(PROPERTY_SELECTED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_SELECTED) {
         ((CCControl *)pNode)->setSelected(pCheck);
     } else {
         CCNodeLoader::onHandlePropTypeCheck(pNode, pParent, pPropertyName, pCheck, pCCBReader);
@@ -18,7 +18,7 @@ void CCControlLoader::onHandlePropTypeCheck(CCNode * pNode, CCNode * pParent, CC
 }
 
 void CCControlLoader::onHandlePropTypeBlockCCControl(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, BlockCCControlData * pBlockCCControlData, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_CCCONTROL) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_CCCONTROL) {
         ((CCControl *)pNode)->addTargetWithActionForControlEvents(pBlockCCControlData->mTarget, pBlockCCControlData->mSELCCControlHandler, pBlockCCControlData->mControlEvents);
     } else {
         CCNodeLoader::onHandlePropTypeBlockCCControl(pNode, pParent, pPropertyName, pBlockCCControlData, pCCBReader);
@@ -4,14 +4,14 @@ USING_NS_CC;
 
 NS_CC_EXT_BEGIN
 
-#define PROPERTY_COLOR "color"
-#define PROPERTY_OPACITY "opacity"
-#define PROPERTY_BLENDFUNC "blendFunc"
-#define PROPERTY_FNTFILE "fntFile"
-#define PROPERTY_STRING "string"
+static const int PROPERTY_COLOR = CCBReader::getPropertyIDForName("color");
+static const int PROPERTY_OPACITY = CCBReader::getPropertyIDForName("opacity");
+static const int PROPERTY_BLENDFUNC = CCBReader::getPropertyIDForName("blendFunc");
+static const int PROPERTY_FNTFILE = CCBReader::getPropertyIDForName("fntFile");
+static const int PROPERTY_STRING = CCBReader::getPropertyIDForName("string");
 
 void CCLabelBMFontLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccColor3B pCCColor3B, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_COLOR) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_COLOR) {
         ((CCLabelBMFont *)pNode)->setColor(pCCColor3B);
     } else {
         CCNodeLoader::onHandlePropTypeColor3(pNode, pParent, pPropertyName, pCCColor3B, pCCBReader);
@@ -19,7 +19,7 @@ void CCLabelBMFontLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pParen
 }
 
 void CCLabelBMFontLoader::onHandlePropTypeByte(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, unsigned char pByte, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_OPACITY) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_OPACITY) {
         ((CCLabelBMFont *)pNode)->setOpacity(pByte);
     } else {
         CCNodeLoader::onHandlePropTypeByte(pNode, pParent, pPropertyName, pByte, pCCBReader);
@@ -27,7 +27,7 @@ void CCLabelBMFontLoader::onHandlePropTypeByte(CCNode * pNode, CCNode * pParent,
 }
 
 void CCLabelBMFontLoader::onHandlePropTypeBlendFunc(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccBlendFunc pCCBlendFunc, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_BLENDFUNC) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_BLENDFUNC) {
         ((CCLabelBMFont *)pNode)->setBlendFunc(pCCBlendFunc);
     } else {
         CCNodeLoader::onHandlePropTypeBlendFunc(pNode, pParent, pPropertyName, pCCBlendFunc, pCCBReader);
@@ -35,7 +35,7 @@ void CCLabelBMFontLoader::onHandlePropTypeBlendFunc(CCNode * pNode, CCNode * pPa
 }
 
 void CCLabelBMFontLoader::onHandlePropTypeFntFile(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCString * pFntFile, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_FNTFILE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_FNTFILE) {
         ((CCLabelBMFont *)pNode)->setFntFile(pFntFile->getCString());
     } else {
         CCNodeLoader::onHandlePropTypeFntFile(pNode, pParent, pPropertyName, pFntFile, pCCBReader);
@@ -43,7 +43,7 @@ void CCLabelBMFontLoader::onHandlePropTypeFntFile(CCNode * pNode, CCNode * pPare
 }
 
 void CCLabelBMFontLoader::onHandlePropTypeText(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCString * pText, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_STRING) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_STRING) {
         ((CCLabelBMFont *)pNode)->setString(pText->getCString());
     } else {
         CCNodeLoader::onHandlePropTypeText(pNode, pParent, pPropertyName, pText, pCCBReader);
@@ -2,20 +2,20 @@
 
 USING_NS_CC;
 
-#define PROPERTY_COLOR "color"
-#define PROPERTY_OPACITY "opacity"
-#define PROPERTY_BLENDFUNC "blendFunc"
-#define PROPERTY_FONTNAME "fontName"
-#define PROPERTY_FONTSIZE "fontSize"
-#define PROPERTY_HORIZONTALALIGNMENT "horizontalAlignment"
-#define PROPERTY_VERTICALALIGNMENT "verticalAlignment"
-#define PROPERTY_STRING "string"
-#define PROPERTY_DIMENSIONS "dimensions"
-
 NS_CC_EXT_BEGIN
 
+static const int PROPERTY_COLOR = CCBReader::getPropertyIDForName("color");
+static const int PROPERTY_OPACITY = CCBReader::getPropertyIDForName("opacity");
+static const int PROPERTY_BLENDFUNC = CCBReader::getPropertyIDForName("blendFunc");
+static const int PROPERTY_FONTNAME = CCBReader::getPropertyIDForName("fontName");
+static const int PROPERTY_FONTSIZE = CCBReader::getPropertyIDForName("fontSize");
+static const int PROPERTY_HORIZONTALALIGNMENT = CCBReader::getPropertyIDForName("horizontalAlignment");
+static const int PROPERTY_VERTICALALIGNMENT = CCBReader::getPropertyIDForName("verticalAlignment");
+static const int PROPERTY_STRING = CCBReader::getPropertyIDForName("string");
+static const int PROPERTY_DIMENSIONS = CCBReader::getPropertyIDForName("dimensions");
+
 void CCLabelTTFLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccColor3B pCCColor3B, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_COLOR) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_COLOR) {
         ((CCLabelTTF *)pNode)->setColor(pCCColor3B);
     } else {
         CCNodeLoader::onHandlePropTypeColor3(pNode, pParent, pPropertyName, pCCColor3B, pCCBReader);
@@ -23,7 +23,7 @@ void CCLabelTTFLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pParent,
 }
 
 void CCLabelTTFLoader::onHandlePropTypeByte(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, unsigned char pByte, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_OPACITY) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_OPACITY) {
         ((CCLabelTTF *)pNode)->setOpacity(pByte);
     } else {
         CCNodeLoader::onHandlePropTypeByte(pNode, pParent, pPropertyName, pByte, pCCBReader);
@@ -31,7 +31,7 @@ void CCLabelTTFLoader::onHandlePropTypeByte(CCNode * pNode, CCNode * pParent, CC
 }
 
 void CCLabelTTFLoader::onHandlePropTypeBlendFunc(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccBlendFunc pCCBlendFunc, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_BLENDFUNC) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_BLENDFUNC) {
         ((CCLabelTTF *)pNode)->setBlendFunc(pCCBlendFunc);
     } else {
         CCNodeLoader::onHandlePropTypeBlendFunc(pNode, pParent, pPropertyName, pCCBlendFunc, pCCBReader);
@@ -39,7 +39,7 @@ void CCLabelTTFLoader::onHandlePropTypeBlendFunc(CCNode * pNode, CCNode * pParen
 }
 
 void CCLabelTTFLoader::onHandlePropTypeFontTTF(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCString * pFontTTF, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_FONTNAME) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_FONTNAME) {
         ((CCLabelTTF *)pNode)->setFontName(pFontTTF->getCString());
     } else {
         CCNodeLoader::onHandlePropTypeFontTTF(pNode, pParent, pPropertyName, pFontTTF, pCCBReader);
@@ -47,7 +47,7 @@ void CCLabelTTFLoader::onHandlePropTypeFontTTF(CCNode * pNode, CCNode * pParent,
 }
 
 void CCLabelTTFLoader::onHandlePropTypeText(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCString * pText, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_STRING) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_STRING) {
         ((CCLabelTTF *)pNode)->setString(pText->getCString());
     } else {
         CCNodeLoader::onHandlePropTypeText(pNode, pParent, pPropertyName, pText, pCCBReader);
@@ -55,7 +55,7 @@ void CCLabelTTFLoader::onHandlePropTypeText(CCNode * pNode, CCNode * pParent, CC
 }
 
 void CCLabelTTFLoader::onHandlePropTypeFloatScale(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, float pFloatScale, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_FONTSIZE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_FONTSIZE) {
         ((CCLabelTTF *)pNode)->setFontSize(pFloatScale);
     } else {
         CCNodeLoader::onHandlePropTypeFloatScale(pNode, pParent, pPropertyName, pFloatScale, pCCBReader);
@@ -63,9 +63,9 @@ void CCLabelTTFLoader::onHandlePropTypeFloatScale(CCNode * pNode, CCNode * pPare
 }
 
 void CCLabelTTFLoader::onHandlePropTypeIntegerLabeled(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, int pIntegerLabeled, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_HORIZONTALALIGNMENT) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_HORIZONTALALIGNMENT) {
         ((CCLabelTTF *)pNode)->setHorizontalAlignment(CCTextAlignment(pIntegerLabeled));
-    } else if(pPropertyName->compare(PROPERTY_VERTICALALIGNMENT) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_VERTICALALIGNMENT) {
         ((CCLabelTTF *)pNode)->setVerticalAlignment(CCVerticalTextAlignment(pIntegerLabeled));
     } else {
         CCNodeLoader::onHandlePropTypeFloatScale(pNode, pParent, pPropertyName, pIntegerLabeled, pCCBReader);
@@ -73,7 +73,7 @@ void CCLabelTTFLoader::onHandlePropTypeIntegerLabeled(CCNode * pNode, CCNode * p
 }
 
 void CCLabelTTFLoader::onHandlePropTypeSize(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCSize pSize, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_DIMENSIONS) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_DIMENSIONS) {
         ((CCLabelTTF *)pNode)->setDimensions(pSize);
     } else {
         CCNodeLoader::onHandlePropTypeSize(pNode, pParent, pPropertyName, pSize, pCCBReader);
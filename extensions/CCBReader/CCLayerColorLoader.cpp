@@ -4,12 +4,12 @@ USING_NS_CC;
 
 NS_CC_EXT_BEGIN
 
-#define PROPERTY_COLOR "color"
-#define PROPERTY_OPACITY "opacity"
-#define PROPERTY_BLENDFUNC "blendFunc"
+static const int PROPERTY_COLOR = CCBReader::getPropertyIDForName("color");
+static const int PROPERTY_OPACITY = CCBReader::getPropertyIDForName("opacity");
+static const int PROPERTY_BLENDFUNC = CCBReader::getPropertyIDForName("blendFunc");
 
 void CCLayerColorLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccColor3B pCCColor3B, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_COLOR) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_COLOR) {
         ((CCLayerColor *)pNode)->setColor(pCCColor3B);
     } else {
         CCLayerLoader::onHandlePropTypeColor3(pNode, pParent, pPropertyName, pCCColor3B, pCCBReader);
@@ -17,7 +17,7 @@ void CCLayerColorLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pParent
 }
 
 void CCLayerColorLoader::onHandlePropTypeByte(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, unsigned char pByte, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_OPACITY) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_OPACITY) {
         ((CCLayerColor *)pNode)->setOpacity(pByte);
     } else {
         CCLayerLoader::onHandlePropTypeByte(pNode, pParent, pPropertyName, pByte, pCCBReader);
@@ -25,7 +25,7 @@ void CCLayerColorLoader::onHandlePropTypeByte(CCNode * pNode, CCNode * pParent,
 }
 
 void CCLayerColorLoader::onHandlePropTypeBlendFunc(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccBlendFunc pCCBlendFunc, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_BLENDFUNC) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_BLENDFUNC) {
         ((CCLayerColor *)pNode)->setBlendFunc(pCCBlendFunc);
     } else {
         CCLayerLoader::onHandlePropTypeBlendFunc(pNode, pParent, pPropertyName, pCCBlendFunc, pCCBReader);
@@ -2,19 +2,19 @@
 
 USING_NS_CC;
 
-#define PROPERTY_STARTCOLOR "startColor"
-#define PROPERTY_ENDCOLOR "endColor"
-#define PROPERTY_STARTOPACITY "startOpacity"
-#define PROPERTY_ENDOPACITY "endOpacity"
-#define PROPERTY_VECTOR "vector"
-#define PROPERTY_BLENDFUNC "blendFunc"
-
 NS_CC_EXT_BEGIN
 
+static const int PROPERTY_STARTCOLOR = CCBReader::getPropertyIDForName("startColor");
+static const int PROPERTY_ENDCOLOR = CCBReader::getPropertyIDForName("endColor");
+static const int PROPERTY_STARTOPACITY = CCBReader::getPropertyIDForName("startOpacity");
+static const int PROPERTY_ENDOPACITY = CCBReader::getPropertyIDForName("endOpacity");
+static const int PROPERTY_VECTOR = CCBReader::getPropertyIDForName("vector");
+static const int PROPERTY_BLENDFUNC = CCBReader::getPropertyIDForName("blendFunc");
+
 void CCLayerGradientLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccColor3B pCCColor3B, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_STARTCOLOR) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_STARTCOLOR) {
         ((CCLayerGradient *)pNode)->setStartColor(pCCColor3B);
-    } else if(pPropertyName->compare(PROPERTY_ENDCOLOR) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ENDCOLOR) {
         ((CCLayerGradient *)pNode)->setEndColor(pCCColor3B);
     } else {
         CCLayerLoader::onHandlePropTypeColor3(pNode, pParent, pPropertyName, pCCColor3B, pCCBReader);
@@ -22,9 +22,9 @@ void CCLayerGradientLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pPar
 }
 
 void CCLayerGradientLoader::onHandlePropTypeByte(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, unsigned char pByte, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_STARTOPACITY) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_STARTOPACITY) {
         ((CCLayerGradient *)pNode)->setStartOpacity(pByte);
-    } else if(pPropertyName->compare(PROPERTY_ENDOPACITY) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ENDOPACITY) {
         ((CCLayerGradient *)pNode)->setEndOpacity(pByte);
     } else {
         CCLayerLoader::onHandlePropTypeByte(pNode, pParent, pPropertyName, pByte, pCCBReader);
@@ -32,7 +32,7 @@ void CCLayerGradientLoader::onHandlePropTypeByte(CCNode * pNode, CCNode * pParen
 }
 
 void CCLayerGradientLoader::onHandlePropTypeBlendFunc(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccBlendFunc pCCBlendFunc, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_BLENDFUNC) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_BLENDFUNC) {
         ((CCLayerGradient *)pNode)->setBlendFunc(pCCBlendFunc);
     } else {
         CCLayerLoader::onHandlePropTypeBlendFunc(pNode, pParent, pPropertyName, pCCBlendFunc, pCCBReader);
@@ -41,7 +41,7 @@ void CCLayerGradientLoader::onHandlePropTypeBlendFunc(CCNode * pNode, CCNode * p
 
 
 void CCLayerGradientLoader::onHandlePropTypePoint(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCPoint pPoint, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_VECTOR) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_VECTOR) {
         ((CCLayerGradient *)pNode)->setVector(pPoint);
 
         // TODO Not passed along the ccbi file.
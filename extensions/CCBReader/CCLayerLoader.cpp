@@ -2,25 +2,24 @@
 
 USING_NS_CC;
 
-
-#define PROPERTY_TOUCH_ENABLED "isTouchEnabled"
-#define PROPERTY_ACCELEROMETER_ENABLED "isAccelerometerEnabled"
-#define PROPERTY_MOUSE_ENABLED "isMouseEnabled"
-#define PROPERTY_KEYBOARD_ENABLED "isKeyboardEnabled"
-
 NS_CC_EXT_BEGIN
 
+static const int PROPERTY_TOUCH_ENABLED = CCBReader::getPropertyIDForName("isTouchEnabled");
+static const int PROPERTY_ACCELEROMETER_ENABLED = CCBReader::getPropertyIDForName("isAccelerometerEnabled");
+static const int PROPERTY_MOUSE_ENABLED = CCBReader::getPropertyIDForName("isMouseEnabled");
+static const int PROPERTY_KEYBOARD_ENABLED = CCBReader::getPropertyIDForName("isKeyboardEnabled");
+
 void CCLayerLoader::onHandlePropTypeCheck(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, bool pCheck, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_TOUCH_ENABLED) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TOUCH_ENABLED) {
         ((CCLayer *)pNode)->setTouchEnabled(pCheck);
-    } else if(pPropertyName->compare(PROPERTY_ACCELEROMETER_ENABLED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ACCELEROMETER_ENABLED) {
         ((CCLayer *)pNode)->setAccelerometerEnabled(pCheck);
-    } else if(pPropertyName->compare(PROPERTY_MOUSE_ENABLED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_MOUSE_ENABLED) {
         // TODO XXX
-        CCLOG("The property '%s' is not supported!", PROPERTY_MOUSE_ENABLED);
-    } else if(pPropertyName->compare(PROPERTY_KEYBOARD_ENABLED) == 0) {
+        CCLOG("The property '%s' is not supported!", pPropertyName->getCString());
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_KEYBOARD_ENABLED) {
         // TODO XXX
-        CCLOG("The property '%s' is not supported!", PROPERTY_KEYBOARD_ENABLED);
+        CCLOG("The property '%s' is not supported!", pPropertyName->getCString());
         // This comes closest: ((CCLayer *)pNode)->setKeypadEnabled(pCheck);
     } else {
         CCNodeLoader::onHandlePropTypeCheck(pNode, pParent, pPropertyName, pCheck, pCCBReader);
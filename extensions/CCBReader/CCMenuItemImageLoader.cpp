@@ -2,22 +2,22 @@
 
 USING_NS_CC;
 
-#define PROPERTY_NORMALDISPLAYFRAME "normalSpriteFrame"
-#define PROPERTY_SELECTEDDISPLAYFRAME "selectedSpriteFrame"
-#define PROPERTY_DISABLEDDISPLAYFRAME "disabledSpriteFrame"
-
 NS_CC_EXT_BEGIN
 
+static const int PROPERTY_NORMALDISPLAYFRAME = CCBReader::getPropertyIDForName("normalSpriteFrame");
+static const int PROPERTY_SELECTEDDISPLAYFRAME = CCBReader::getPropertyIDForName("selectedSpriteFrame");
+static const int PROPERTY_DISABLEDDISPLAYFRAME = CCBReader::getPropertyIDForName("disabledSpriteFrame");
+
 void CCMenuItemImageLoader::onHandlePropTypeSpriteFrame(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCSpriteFrame * pCCSpriteFrame, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_NORMALDISPLAYFRAME) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_NORMALDISPLAYFRAME) {
         if(pCCSpriteFrame != NULL) {
             ((CCMenuItemImage *)pNode)->setNormalSpriteFrame(pCCSpriteFrame);
         }
-    } else if(pPropertyName->compare(PROPERTY_SELECTEDDISPLAYFRAME) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_SELECTEDDISPLAYFRAME) {
         if(pCCSpriteFrame != NULL) {
             ((CCMenuItemImage *)pNode)->setSelectedSpriteFrame(pCCSpriteFrame);
         }
-    } else if(pPropertyName->compare(PROPERTY_DISABLEDDISPLAYFRAME) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_DISABLEDDISPLAYFRAME) {
         if(pCCSpriteFrame != NULL) {
             ((CCMenuItemImage *)pNode)->setDisabledSpriteFrame(pCCSpriteFrame);
         }
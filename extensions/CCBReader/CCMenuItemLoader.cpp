@@ -2,13 +2,13 @@
 
 USING_NS_CC;
 
-#define PROPERTY_BLOCK "block"
-#define PROPERTY_ISENABLED "isEnabled"
-
 NS_CC_EXT_BEGIN
 
+static const int PROPERTY_BLOCK = CCBReader::getPropertyIDForName("block");
+static const int PROPERTY_ISENABLED = CCBReader::getPropertyIDForName("isEnabled");
+
 void CCMenuItemLoader::onHandlePropTypeBlock(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, BlockData * pBlockData, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_BLOCK) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_BLOCK) {
         if (NULL != pBlockData) // Add this condition to allow CCMenuItemImage without target/selector predefined 
         {
             ((CCMenuItem *)pNode)->setTarget(pBlockData->mTarget, pBlockData->mSELMenuHandler);
@@ -19,7 +19,7 @@ void CCMenuItemLoader::onHandlePropTypeBlock(CCNode * pNode, CCNode * pParent, C
 }
 
 void CCMenuItemLoader::onHandlePropTypeCheck(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, bool pCheck, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_ISENABLED) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ISENABLED) {
         ((CCMenuItem *)pNode)->setEnabled(pCheck);
     } else {
         CCNodeLoader::onHandlePropTypeCheck(pNode, pParent, pPropertyName, pCheck, pCCBReader);
@@ -2,15 +2,6 @@
 #include "CCBSelectorResolver.h"
 #include "CCBMemberVariableAssigner.h"
 
-#define PROPERTY_POSITION "position"
-#define PROPERTY_CONTENTSIZE "contentSize"
-#define PROPERTY_ANCHORPOINT "anchorPoint"
-#define PROPERTY_SCALE "scale"
-#define PROPERTY_ROTATION "rotation"
-#define PROPERTY_TAG "tag"
-#define PROPERTY_IGNOREANCHORPOINTFORPOSITION "ignoreAnchorPointForPosition"
-#define PROPERTY_VISIBLE "visible"
-
 #define ASSERT_FAIL_UNEXPECTED_PROPERTY(PROPERTY) CCLog("Unexpected property: '%s'!\n", PROPERTY->getCString()); assert(false)
 #define ASSERT_FAIL_UNEXPECTED_PROPERTYTYPE(PROPERTYTYPE) CCLog("Unexpected property type: '%d'!\n", PROPERTYTYPE); assert(false)
 
@@ -18,6 +9,15 @@ USING_NS_CC;
 
 NS_CC_EXT_BEGIN
 
+static const int PROPERTY_POSITION = CCBReader::getPropertyIDForName("position");
+static const int PROPERTY_CONTENTSIZE = CCBReader::getPropertyIDForName("contentSize");
+static const int PROPERTY_ANCHORPOINT = CCBReader::getPropertyIDForName("anchorPoint");
+static const int PROPERTY_SCALE = CCBReader::getPropertyIDForName("scale");
+static const int PROPERTY_ROTATION = CCBReader::getPropertyIDForName("rotation");
+static const int PROPERTY_TAG = CCBReader::getPropertyIDForName("tag");
+static const int PROPERTY_IGNOREANCHORPOINTFORPOSITION = CCBReader::getPropertyIDForName("ignoreAnchorPointForPosition");
+static const int PROPERTY_VISIBLE = CCBReader::getPropertyIDForName("visible");
+
 CCNode * CCNodeLoader::loadCCNode(CCNode * pParent, CCBReader * pCCBReader) {
     CCNode * ccNode = this->createCCNode(pParent, pCCBReader);
 
@@ -30,7 +30,7 @@ void CCNodeLoader::parseProperties(CCNode * pNode, CCNode * pParent, CCBReader *
     int propertyCount = pCCBReader->readInt(false);
     for(int i = 0; i < propertyCount; i++) {
         int type = pCCBReader->readInt(false);
-        CCString * propertyName = pCCBReader->readCachedString();
+        CCString * propertyName = pCCBReader->readPropertyName();
 
         // Check if the property can be set for this platform
         bool setProp = false;
@@ -667,7 +667,7 @@ CCNode * CCNodeLoader::parsePropTypeCCBFile(CCNode * pNode, CCNode * pParent, CC
 
 
 void CCNodeLoader::onHandlePropTypePosition(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCPoint pPosition, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_POSITION) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_POSITION) {
         pNode->setPosition(pPosition);
     } else {
         ASSERT_FAIL_UNEXPECTED_PROPERTY(pPropertyName);
@@ -675,7 +675,7 @@ void CCNodeLoader::onHandlePropTypePosition(CCNode * pNode, CCNode * pParent, CC
 }
 
 void CCNodeLoader::onHandlePropTypePoint(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCPoint pPoint, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_ANCHORPOINT) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ANCHORPOINT) {
         pNode->setAnchorPoint(pPoint);
     } else {
         ASSERT_FAIL_UNEXPECTED_PROPERTY(pPropertyName);
@@ -687,7 +687,7 @@ void CCNodeLoader::onHandlePropTypePointLock(CCNode * pNode, CCNode * pParent, C
 }
 
 void CCNodeLoader::onHandlePropTypeSize(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCSize pSize, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_CONTENTSIZE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_CONTENTSIZE) {
         pNode->setContentSize(pSize);
     } else {
         ASSERT_FAIL_UNEXPECTED_PROPERTY(pPropertyName);
@@ -695,7 +695,7 @@ void CCNodeLoader::onHandlePropTypeSize(CCNode * pNode, CCNode * pParent, CCStri
 }
 
 void CCNodeLoader::onHandlePropTypeScaleLock(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, float * pScaleLock, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_SCALE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_SCALE) {
         pNode->setScaleX(pScaleLock[0]);
         pNode->setScaleY(pScaleLock[1]);
     } else {
@@ -708,7 +708,7 @@ void CCNodeLoader::onHandlePropTypeFloat(CCNode * pNode, CCNode * pParent, CCStr
 }
 
 void CCNodeLoader::onHandlePropTypeDegrees(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, float pDegrees, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_ROTATION) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ROTATION) {
         pNode->setRotation(pDegrees);
     } else {
         ASSERT_FAIL_UNEXPECTED_PROPERTY(pPropertyName);
@@ -720,7 +720,7 @@ void CCNodeLoader::onHandlePropTypeFloatScale(CCNode * pNode, CCNode * pParent,
 }
 
 void CCNodeLoader::onHandlePropTypeInteger(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, int pInteger, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_TAG) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TAG) {
         pNode->setTag(pInteger);
     } else {
         ASSERT_FAIL_UNEXPECTED_PROPERTY(pPropertyName);
@@ -736,9 +736,9 @@ void CCNodeLoader::onHandlePropTypeFloatVar(CCNode * pNode, CCNode * pParent, CC
 }
 
 void CCNodeLoader::onHandlePropTypeCheck(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, bool pCheck, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_VISIBLE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_VISIBLE) {
         pNode->setVisible(pCheck);
-    } else if(pPropertyName->compare(PROPERTY_IGNOREANCHORPOINTFORPOSITION) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_IGNOREANCHORPOINTFORPOSITION) {
         pNode->ignoreAnchorPointForPosition(pCheck);
     } else {
         ASSERT_FAIL_UNEXPECTED_PROPERTY(pPropertyName);
@@ -2,33 +2,33 @@
 
 USING_NS_CC;
 
-#define PROPERTY_EMITERMODE "emitterMode"
-#define PROPERTY_POSVAR "posVar"
-#define PROPERTY_EMISSIONRATE "emissionRate"
-#define PROPERTY_DURATION "duration"
-#define PROPERTY_TOTALPARTICLES "totalParticles"
-#define PROPERTY_LIFE "life"
-#define PROPERTY_STARTSIZE "startSize"
-#define PROPERTY_ENDSIZE "endSize"
-#define PROPERTY_STARTSPIN "startSpin"
-#define PROPERTY_ENDSPIN "endSpin"
-#define PROPERTY_ANGLE "angle"
-#define PROPERTY_STARTCOLOR "startColor"
-#define PROPERTY_ENDCOLOR "endColor"
-#define PROPERTY_BLENDFUNC "blendFunc"
-#define PROPERTY_GRAVITY "gravity"
-#define PROPERTY_SPEED "speed"
-#define PROPERTY_TANGENTIALACCEL "tangentialAccel"
-#define PROPERTY_RADIALACCEL "radialAccel"
-#define PROPERTY_TEXTURE "texture"
-#define PROPERTY_STARTRADIUS "startRadius"
-#define PROPERTY_ENDRADIUS "endRadius"
-#define PROPERTY_ROTATEPERSECOND "rotatePerSecond"
-
 NS_CC_EXT_BEGIN
 
+static const int PROPERTY_EMITERMODE = CCBReader::getPropertyIDForName("emitterMode");
+static const int PROPERTY_POSVAR = CCBReader::getPropertyIDForName("posVar");
+static const int PROPERTY_EMISSIONRATE = CCBReader::getPropertyIDForName("emissionRate");
+static const int PROPERTY_DURATION = CCBReader::getPropertyIDForName("duration");
+static const int PROPERTY_TOTALPARTICLES = CCBReader::getPropertyIDForName("totalParticles");
+static const int PROPERTY_LIFE = CCBReader::getPropertyIDForName("life");
+static const int PROPERTY_STARTSIZE = CCBReader::getPropertyIDForName("startSize");
+static const int PROPERTY_ENDSIZE = CCBReader::getPropertyIDForName("endSize");
+static const int PROPERTY_STARTSPIN = CCBReader::getPropertyIDForName("startSpin");
+static const int PROPERTY_ENDSPIN = CCBReader::getPropertyIDForName("endSpin");
+static const int PROPERTY_ANGLE = CCBReader::getPropertyIDForName("angle");
+static const int PROPERTY_STARTCOLOR = CCBReader::getPropertyIDForName("startColor");
+static const int PROPERTY_ENDCOLOR = CCBReader::getPropertyIDForName("endColor");
+static const int PROPERTY_BLENDFUNC = CCBReader::getPropertyIDForName("blendFunc");
+static const int PROPERTY_GRAVITY = CCBReader::getPropertyIDForName("gravity");
+static const int PROPERTY_SPEED = CCBReader::getPropertyIDForName("speed");
+static const int PROPERTY_TANGENTIALACCEL = CCBReader::getPropertyIDForName("tangentialAccel");
+static const int PROPERTY_RADIALACCEL = CCBReader::getPropertyIDForName("radialAccel");
+static const int PROPERTY_TEXTURE = CCBReader::getPropertyIDForName("texture");
+static const int PROPERTY_STARTRADIUS = CCBReader::getPropertyIDForName("startRadius");
+static const int PROPERTY_ENDRADIUS = CCBReader::getPropertyIDForName("endRadius");
+static const int PROPERTY_ROTATEPERSECOND = CCBReader::getPropertyIDForName("rotatePerSecond");
+
 void CCParticleSystemQuadLoader::onHandlePropTypeIntegerLabeled(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, int pIntegerLabeled, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_EMITERMODE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_EMITERMODE) {
         ((CCParticleSystemQuad *)pNode)->setEmitterMode(pIntegerLabeled);
     } else {
         CCNodeLoader::onHandlePropTypeIntegerLabeled(pNode, pParent, pPropertyName, pIntegerLabeled, pCCBReader);
@@ -36,9 +36,9 @@ void CCParticleSystemQuadLoader::onHandlePropTypeIntegerLabeled(CCNode * pNode,
 }
 
 void CCParticleSystemQuadLoader::onHandlePropTypePoint(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCPoint pPoint, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_POSVAR) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_POSVAR) {
         ((CCParticleSystemQuad *)pNode)->setPosVar(pPoint);
-    } else if(pPropertyName->compare(PROPERTY_GRAVITY) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_GRAVITY) {
         ((CCParticleSystemQuad *)pNode)->setGravity(pPoint);
     } else {
         CCNodeLoader::onHandlePropTypePoint(pNode, pParent, pPropertyName, pPoint, pCCBReader);
@@ -46,9 +46,9 @@ void CCParticleSystemQuadLoader::onHandlePropTypePoint(CCNode * pNode, CCNode *
 }
 
 void CCParticleSystemQuadLoader::onHandlePropTypeFloat(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, float pFloat, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_EMISSIONRATE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_EMISSIONRATE) {
         ((CCParticleSystemQuad *)pNode)->setEmissionRate(pFloat);
-    } else if(pPropertyName->compare(PROPERTY_DURATION) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_DURATION) {
         ((CCParticleSystemQuad *)pNode)->setDuration(pFloat);
     } else {
         CCNodeLoader::onHandlePropTypeFloat(pNode, pParent, pPropertyName, pFloat, pCCBReader);
@@ -56,7 +56,7 @@ void CCParticleSystemQuadLoader::onHandlePropTypeFloat(CCNode * pNode, CCNode *
 }
 
 void CCParticleSystemQuadLoader::onHandlePropTypeInteger(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, int pInteger, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_TOTALPARTICLES) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TOTALPARTICLES) {
         ((CCParticleSystemQuad *)pNode)->setTotalParticles(pInteger);
     } else {
         CCNodeLoader::onHandlePropTypeInteger(pNode, pParent, pPropertyName, pInteger, pCCBReader);
@@ -64,40 +64,40 @@ void CCParticleSystemQuadLoader::onHandlePropTypeInteger(CCNode * pNode, CCNode
 }
 
 void CCParticleSystemQuadLoader::onHandlePropTypeFloatVar(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, float * pFloatVar, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_LIFE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_LIFE) {
         ((CCParticleSystemQuad *)pNode)->setLife(pFloatVar[0]);
         ((CCParticleSystemQuad *)pNode)->setLifeVar(pFloatVar[1]);
-    } else if(pPropertyName->compare(PROPERTY_STARTSIZE) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_STARTSIZE) {
         ((CCParticleSystemQuad *)pNode)->setStartSize(pFloatVar[0]);
         ((CCParticleSystemQuad *)pNode)->setStartSizeVar(pFloatVar[1]);
-    } else if(pPropertyName->compare(PROPERTY_ENDSIZE) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ENDSIZE) {
         ((CCParticleSystemQuad *)pNode)->setEndSize(pFloatVar[0]);
         ((CCParticleSystemQuad *)pNode)->setEndSizeVar(pFloatVar[1]);
-    } else if(pPropertyName->compare(PROPERTY_STARTSPIN) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_STARTSPIN) {
         ((CCParticleSystemQuad *)pNode)->setStartSpin(pFloatVar[0]);
         ((CCParticleSystemQuad *)pNode)->setStartSpinVar(pFloatVar[1]);
-    } else if(pPropertyName->compare(PROPERTY_ENDSPIN) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ENDSPIN) {
         ((CCParticleSystemQuad *)pNode)->setEndSpin(pFloatVar[0]);
         ((CCParticleSystemQuad *)pNode)->setEndSpinVar(pFloatVar[1]);
-    } else if(pPropertyName->compare(PROPERTY_ANGLE) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ANGLE) {
         ((CCParticleSystemQuad *)pNode)->setAngle(pFloatVar[0]);
         ((CCParticleSystemQuad *)pNode)->setAngleVar(pFloatVar[1]);
-    } else if(pPropertyName->compare(PROPERTY_SPEED) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_SPEED) {
         ((CCParticleSystemQuad *)pNode)->setSpeed(pFloatVar[0]);
         ((CCParticleSystemQuad *)pNode)->setSpeedVar(pFloatVar[1]);
-    } else if(pPropertyName->compare(PROPERTY_TANGENTIALACCEL) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TANGENTIALACCEL) {
         ((CCParticleSystemQuad *)pNode)->setTangentialAccel(pFloatVar[0]);
         ((CCParticleSystemQuad *)pNode)->setTangentialAccelVar(pFloatVar[1]);
-    } else if(pPropertyName->compare(PROPERTY_RADIALACCEL) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_RADIALACCEL) {
         ((CCParticleSystemQuad *)pNode)->setRadialAccel(pFloatVar[0]);
         ((CCParticleSystemQuad *)pNode)->setRadialAccelVar(pFloatVar[1]);
-    } else if(pPropertyName->compare(PROPERTY_STARTRADIUS) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_STARTRADIUS) {
         ((CCParticleSystemQuad *)pNode)->setStartRadius(pFloatVar[0]);
         ((CCParticleSystemQuad *)pNode)->setStartRadiusVar(pFloatVar[1]);
-    } else if(pPropertyName->compare(PROPERTY_ENDRADIUS) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ENDRADIUS) {
         ((CCParticleSystemQuad *)pNode)->setEndRadius(pFloatVar[0]);
         ((CCParticleSystemQuad *)pNode)->setEndRadiusVar(pFloatVar[1]);
-    } else if(pPropertyName->compare(PROPERTY_ROTATEPERSECOND) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ROTATEPERSECOND) {
         ((CCParticleSystemQuad *)pNode)->setRotatePerSecond(pFloatVar[0]);
         ((CCParticleSystemQuad *)pNode)->setRotatePerSecondVar(pFloatVar[1]);
     } else {
@@ -106,10 +106,10 @@ void CCParticleSystemQuadLoader::onHandlePropTypeFloatVar(CCNode * pNode, CCNode
 }
 
 void CCParticleSystemQuadLoader::onHandlePropTypeColor4FVar(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccColor4F * pCCColor4FVar, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_STARTCOLOR) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_STARTCOLOR) {
         ((CCParticleSystemQuad *)pNode)->setStartColor(pCCColor4FVar[0]);
         ((CCParticleSystemQuad *)pNode)->setStartColorVar(pCCColor4FVar[1]);
-    } else if(pPropertyName->compare(PROPERTY_ENDCOLOR) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_ENDCOLOR) {
         ((CCParticleSystemQuad *)pNode)->setEndColor(pCCColor4FVar[0]);
         ((CCParticleSystemQuad *)pNode)->setEndColorVar(pCCColor4FVar[1]);
     } else {
@@ -118,7 +118,7 @@ void CCParticleSystemQuadLoader::onHandlePropTypeColor4FVar(CCNode * pNode, CCNo
 }
 
 void CCParticleSystemQuadLoader::onHandlePropTypeBlendFunc(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccBlendFunc pCCBlendFunc, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_BLENDFUNC) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_BLENDFUNC) {
         ((CCParticleSystemQuad *)pNode)->setBlendFunc(pCCBlendFunc);
     } else {
         CCNodeLoader::onHandlePropTypeBlendFunc(pNode, pParent, pPropertyName, pCCBlendFunc, pCCBReader);
@@ -126,7 +126,7 @@ void CCParticleSystemQuadLoader::onHandlePropTypeBlendFunc(CCNode * pNode, CCNod
 }
 
 void CCParticleSystemQuadLoader::onHandlePropTypeTexture(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCTexture2D * pCCTexture2D, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_TEXTURE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_TEXTURE) {
         ((CCParticleSystemQuad *)pNode)->setTexture(pCCTexture2D);
     } else {
         CCNodeLoader::onHandlePropTypeTexture(pNode, pParent, pPropertyName, pCCTexture2D, pCCBReader);
@@ -2,21 +2,21 @@
 
 USING_NS_CC;
 
-#define PROPERTY_CONTENTSIZE "contentSize"
-#define PROPERTY_SPRITEFRAME "spriteFrame"
-#define PROPERTY_COLOR "color"
-#define PROPERTY_OPACITY "opacity"
-#define PROPERTY_BLENDFUNC "blendFunc"
-#define PROPERTY_PREFEREDSIZE "preferedSize" // TODO Should be "preferredSize". This is a typo in cocos2d-iphone, cocos2d-x and CocosBuilder!
-#define PROPERTY_INSETLEFT "insetLeft"
-#define PROPERTY_INSETTOP "insetTop"
-#define PROPERTY_INSETRIGHT "insetRight"
-#define PROPERTY_INSETBOTTOM "insetBottom"
-
 NS_CC_EXT_BEGIN
 
+static const int PROPERTY_CONTENTSIZE = CCBReader::getPropertyIDForName("contentSize");
+static const int PROPERTY_SPRITEFRAME = CCBReader::getPropertyIDForName("spriteFrame");
+static const int PROPERTY_COLOR = CCBReader::getPropertyIDForName("color");
+static const int PROPERTY_OPACITY = CCBReader::getPropertyIDForName("opacity");
+static const int PROPERTY_BLENDFUNC = CCBReader::getPropertyIDForName("blendFunc");
+static const int PROPERTY_PREFEREDSIZE = CCBReader::getPropertyIDForName("preferedSize"); // TODO Should be "preferredSize". This is a typo in cocos2d-iphone, cocos2d-x and CocosBuilder!
+static const int PROPERTY_INSETLEFT = CCBReader::getPropertyIDForName("insetLeft");
+static const int PROPERTY_INSETTOP = CCBReader::getPropertyIDForName("insetTop");
+static const int PROPERTY_INSETRIGHT = CCBReader::getPropertyIDForName("insetRight");
+static const int PROPERTY_INSETBOTTOM = CCBReader::getPropertyIDForName("insetBottom");
+
 void CCScale9SpriteLoader::onHandlePropTypeSpriteFrame(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCSpriteFrame * pCCSpriteFrame, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_SPRITEFRAME) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_SPRITEFRAME) {
         ((CCScale9Sprite *)pNode)->initWithSpriteFrame(pCCSpriteFrame);
     } else {
         CCNodeLoader::onHandlePropTypeSpriteFrame(pNode, pParent, pPropertyName, pCCSpriteFrame, pCCBReader);
@@ -24,7 +24,7 @@ void CCScale9SpriteLoader::onHandlePropTypeSpriteFrame(CCNode * pNode, CCNode *
 }
 
 void CCScale9SpriteLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccColor3B pCCColor3B, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_COLOR) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_COLOR) {
         ((CCScale9Sprite *)pNode)->setColor(pCCColor3B);
     } else {
         CCNodeLoader::onHandlePropTypeColor3(pNode, pParent, pPropertyName, pCCColor3B, pCCBReader);
@@ -32,7 +32,7 @@ void CCScale9SpriteLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pPare
 }
 
 void CCScale9SpriteLoader::onHandlePropTypeByte(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, unsigned char pByte, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_OPACITY) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_OPACITY) {
         ((CCScale9Sprite *)pNode)->setOpacity(pByte);
     } else {
         CCNodeLoader::onHandlePropTypeByte(pNode, pParent, pPropertyName, pByte, pCCBReader);
@@ -40,7 +40,7 @@ void CCScale9SpriteLoader::onHandlePropTypeByte(CCNode * pNode, CCNode * pParent
 }
 
 void CCScale9SpriteLoader::onHandlePropTypeBlendFunc(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccBlendFunc pCCBlendFunc, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_BLENDFUNC) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_BLENDFUNC) {
         // TODO Not exported by CocosBuilder yet!
         // ((CCScale9Sprite *)pNode)->setBlendFunc(pCCBlendFunc);
     } else {
@@ -49,9 +49,9 @@ void CCScale9SpriteLoader::onHandlePropTypeBlendFunc(CCNode * pNode, CCNode * pP
 }
 
 void CCScale9SpriteLoader::onHandlePropTypeSize(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCSize pSize, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_CONTENTSIZE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_CONTENTSIZE) {
         //((CCScale9Sprite *)pNode)->setContentSize(pSize);
-    } else if(pPropertyName->compare(PROPERTY_PREFEREDSIZE) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_PREFEREDSIZE) {
         ((CCScale9Sprite *)pNode)->setPreferredSize(pSize);
     } else {
         CCNodeLoader::onHandlePropTypeSize(pNode, pParent, pPropertyName, pSize, pCCBReader);
@@ -59,13 +59,13 @@ void CCScale9SpriteLoader::onHandlePropTypeSize(CCNode * pNode, CCNode * pParent
 }
 
 void CCScale9SpriteLoader::onHandlePropTypeFloat(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, float pFloat, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_INSETLEFT) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_INSETLEFT) {
         ((CCScale9Sprite *)pNode)->setInsetLeft(pFloat);
-    } else if(pPropertyName->compare(PROPERTY_INSETTOP) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_INSETTOP) {
         ((CCScale9Sprite *)pNode)->setInsetTop(pFloat);
-    } else if(pPropertyName->compare(PROPERTY_INSETRIGHT) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_INSETRIGHT) {
         ((CCScale9Sprite *)pNode)->setInsetRight(pFloat);
-    } else if(pPropertyName->compare(PROPERTY_INSETBOTTOM) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_INSETBOTTOM) {
         ((CCScale9Sprite *)pNode)->setInsetBottom(pFloat);
     } else {
         CCNodeLoader::onHandlePropTypeFloat(pNode, pParent, pPropertyName, pFloat, pCCBReader);
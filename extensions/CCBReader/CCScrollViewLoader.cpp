@@ -2,18 +2,18 @@
 
 USING_NS_CC;
 
-#define PROPERTY_CONTAINER "container"
-#define PROPERTY_DIRECTION "direction"
-#define PROPERTY_CLIPSTOBOUNDS "clipsToBounds"
-#define PROPERTY_BOUNCES "bounces"
-#define PROPERTY_SCALE "scale"
-
 NS_CC_EXT_BEGIN
 
+static const int PROPERTY_CONTAINER = CCBReader::getPropertyIDForName("container");
+static const int PROPERTY_DIRECTION = CCBReader::getPropertyIDForName("direction");
+static const int PROPERTY_CLIPSTOBOUNDS = CCBReader::getPropertyIDForName("clipsToBounds");
+static const int PROPERTY_BOUNCES = CCBReader::getPropertyIDForName("bounces");
+static const int PROPERTY_SCALE = CCBReader::getPropertyIDForName("scale");
+
 void CCScrollViewLoader::onHandlePropTypeCheck(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, bool pCheck, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_CLIPSTOBOUNDS) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_CLIPSTOBOUNDS) {
         ((CCScrollView *)pNode)->setClippingToBounds(pCheck);
-    } else if(pPropertyName->compare(PROPERTY_BOUNCES) == 0) {
+    } else if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_BOUNCES) {
         ((CCScrollView *)pNode)->setBounceable(pCheck);
     } else {
         CCNodeLoader::onHandlePropTypeCheck(pNode, pParent, pPropertyName, pCheck, pCCBReader);
@@ -21,7 +21,7 @@ void CCScrollViewLoader::onHandlePropTypeCheck(CCNode * pNode, CCNode * pParent,
 }
 
 void CCScrollViewLoader::onHandlePropTypeCCBFile(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCNode * pCCBFileNode, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_CONTAINER) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_CONTAINER) {
         ((CCScrollView *)pNode)->setContainer(pCCBFileNode);
     } else {
         CCNodeLoader::onHandlePropTypeCCBFile(pNode, pParent, pPropertyName, pCCBFileNode, pCCBReader);
@@ -29,7 +29,7 @@ void CCScrollViewLoader::onHandlePropTypeCCBFile(CCNode * pNode, CCNode * pParen
 }
 
 void CCScrollViewLoader::onHandlePropTypeFloat(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, float pFloat, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_SCALE) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_SCALE) {
         ((CCScrollView *)pNode)->setScale(pFloat);
     } else {
         CCNodeLoader::onHandlePropTypeFloat(pNode, pParent, pPropertyName, pFloat, pCCBReader);
@@ -37,7 +37,7 @@ void CCScrollViewLoader::onHandlePropTypeFloat(CCNode * pNode, CCNode * pParent,
 }
 
 void CCScrollViewLoader::onHandlePropTypeIntegerLabeled(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, int pIntegerLabeled, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_DIRECTION) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_DIRECTION) {
         ((CCScrollView *)pNode)->setDirection(CCScrollViewDirection(pIntegerLabeled));
     } else {
         CCNodeLoader::onHandlePropTypeFloatScale(pNode, pParent, pPropertyName, pIntegerLabeled, pCCBReader);
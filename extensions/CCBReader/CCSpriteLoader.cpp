@@ -2,16 +2,16 @@
 
 USING_NS_CC;
 
-#define PROPERTY_FLIP "flip"
-#define PROPERTY_DISPLAYFRAME "displayFrame"
-#define PROPERTY_COLOR "color"
-#define PROPERTY_OPACITY "opacity"
-#define PROPERTY_BLENDFUNC "blendFunc"
-
 NS_CC_EXT_BEGIN
 
+static const int PROPERTY_FLIP = CCBReader::getPropertyIDForName("flip");
+static const int PROPERTY_DISPLAYFRAME = CCBReader::getPropertyIDForName("displayFrame");
+static const int PROPERTY_COLOR = CCBReader::getPropertyIDForName("color");
+static const int PROPERTY_OPACITY = CCBReader::getPropertyIDForName("opacity");
+static const int PROPERTY_BLENDFUNC = CCBReader::getPropertyIDForName("blendFunc");
+
 void CCSpriteLoader::onHandlePropTypeSpriteFrame(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, CCSpriteFrame * pCCSpriteFrame, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_DISPLAYFRAME) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_DISPLAYFRAME) {
         ((CCSprite *)pNode)->setDisplayFrame(pCCSpriteFrame);
     } else {
         CCNodeLoader::onHandlePropTypeSpriteFrame(pNode, pParent, pPropertyName, pCCSpriteFrame, pCCBReader);
@@ -19,7 +19,7 @@ void CCSpriteLoader::onHandlePropTypeSpriteFrame(CCNode * pNode, CCNode * pParen
 }
 
 void CCSpriteLoader::onHandlePropTypeFlip(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, bool * pFlip, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_FLIP) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_FLIP) {
         ((CCSprite *)pNode)->setFlipX(pFlip[0]);
         ((CCSprite *)pNode)->setFlipX(pFlip[1]);
     } else {
@@ -28,7 +28,7 @@ void CCSpriteLoader::onHandlePropTypeFlip(CCNode * pNode, CCNode * pParent, CCSt
 }
 
 void CCSpriteLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccColor3B pCCColor3B, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_COLOR) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_COLOR) {
         ((CCSprite *)pNode)->setColor(pCCColor3B);
     } else {
         CCNodeLoader::onHandlePropTypeColor3(pNode, pParent, pPropertyName, pCCColor3B, pCCBReader);
@@ -36,7 +36,7 @@ void CCSpriteLoader::onHandlePropTypeColor3(CCNode * pNode, CCNode * pParent, CC
 }
 
 void CCSpriteLoader::onHandlePropTypeByte(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, unsigned char pByte, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_OPACITY) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_OPACITY) {
         ((CCSprite *)pNode)->setOpacity(pByte);
     } else {
         CCNodeLoader::onHandlePropTypeByte(pNode, pParent, pPropertyName, pByte, pCCBReader);
@@ -44,7 +44,7 @@ void CCSpriteLoader::onHandlePropTypeByte(CCNode * pNode, CCNode * pParent, CCSt
 }
 
 void CCSpriteLoader::onHandlePropTypeBlendFunc(CCNode * pNode, CCNode * pParent, CCString * pPropertyName, ccBlendFunc pCCBlendFunc, CCBReader * pCCBReader) {
-    if(pPropertyName->compare(PROPERTY_BLENDFUNC) == 0) {
+    if(pCCBReader->getPropertyID(pPropertyName) == PROPERTY_BLENDFUNC) {
         ((CCSprite *)pNode)->setBlendFunc(pCCBlendFunc);
     } else {
         CCNodeLoader::onHandlePropTypeBlendFunc(pNode, pParent, pPropertyName, pCCBlendFunc, pCCBReader);
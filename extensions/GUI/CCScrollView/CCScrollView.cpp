@@ -37,6 +37,7 @@
 #include "CCDirector.h"
 #include "kazmath/GL/matrix.h"
 #include "touch_dispatcher/CCTouch.h"
+#include "support/CCRenderQueue.h"
 
 NS_CC_EXT_BEGIN
 
@@ -492,6 +493,8 @@ void CCScrollView::beforeDraw()
 		// TODO: This scrollview should respect parents' positions
 		CCPoint screenPos = this->convertToWorldSpace(this->getParent()->getPosition());
 
+        // the batched quads must not be clipped
+        CCRenderQueue::sharedRenderQueue()->flush();
         glEnable(GL_SCISSOR_TEST);
         float s = this->getScale();
 
@@ -511,6 +514,7 @@ void CCScrollView::afterDraw()
 {
     if (m_bClippingToBounds)
     {
+        CCRenderQueue::sharedRenderQueue()->flush();
         glDisable(GL_SCISSOR_TEST);
     }
 }
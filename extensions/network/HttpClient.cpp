@@ -26,65 +26,145 @@
 #include "HttpClient.h"
 // #include "platform/CCThread.h"
 
-#include <queue>
+#include <list>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
 #include <pthread.h>
-#include <semaphore.h>
 #include <errno.h>
 
 #include "curl/curl.h"
 
 NS_CC_EXT_BEGIN
 
-static pthread_t        s_networkThread;
+static pthread_t*       s_pNetworkThreads = NULL;
+static unsigned int     s_uThreadCount = CC_HTTP_CLIENT_THREADS;
+static unsigned int     s_uStartedThreads = 0;
+
 static pthread_mutex_t  s_requestQueueMutex;
+// signaled when a request is queued, or when the network threads have to quit
+static pthread_cond_t   s_requestQueueCond;
 static pthread_mutex_t  s_responseQueueMutex;
-static sem_t *          s_pSem = NULL;
 static unsigned long    s_asyncRequestCount = 0;
 
-#if CC_TARGET_PLATFORM == CC_PLATFORM_IOS
-#define CC_ASYNC_HTTPREQUEST_USE_NAMED_SEMAPHORE 1
-#else
-#define CC_ASYNC_HTTPREQUEST_USE_NAMED_SEMAPHORE 0
-#endif
-
-#if CC_ASYNC_HTTPREQUEST_USE_NAMED_SEMAPHORE
-#define CC_ASYNC_HTTPREQUEST_SEMAPHORE "ccHttpAsync"
-#else
-static sem_t s_sem;
-#endif
-
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
 typedef int int32_t;
 #endif
 
 static bool need_quit = false;
 
-static CCArray* s_requestQueue = NULL;
-static CCArray* s_responseQueue = NULL;
+// sorted by priority, highest first
+static std::list<CCHttpRequest*>*   s_pRequestQueue = NULL;
+static std::vector<CCHttpResponse*>* s_pResponseQueue = NULL;
+// responses being received that have a stream or a progress callback, protected by s_responseQueueMutex
+static std::vector<CCHttpResponse*>* s_pActiveResponses = NULL;
 
 static CCHttpClient *s_pHttpClient = NULL; // pointer to singleton
 
-static char s_errorBuffer[CURL_ERROR_SIZE];
-
 typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *stream);
 
+// state of the transfer of a response, shared by the callbacks of libcurl
+typedef struct _TransferContext
+{
+    CCHttpResponse  *response;
+    CURL            *curl;
+    std::string     downloadPath;       // path + ".download" for the downloads, empty otherwise
+    FILE            *file;              // the download file, NULL if the body is kept in memory
+    long            resumeOffset;       // size of the download file when the transfer started
+    long            receivedBytes;      // bytes of the body received by this transfer
+    bool            streaming;          // the body is passed to the stream callback
+    bool            checkedResponseCode;
+    bool            discardBody;        // error pages aren't written in the download file
+} TransferContext;
+
+// the downloads are resumed when the server answers 206 Partial Content
+static inline bool isSuccessCode(int responseCode, TransferContext *context)
+{
+    return responseCode == 200 || (responseCode == 206 && context->resumeOffset > 0);
+}
 
 // Callback function used by libcurl for collect response data
 size_t writeData(void *ptr, size_t size, size_t nmemb, void *stream)
 {
-    std::vector<char> *recvBuffer = (std::vector<char>*)stream;
+    TransferContext *context = (TransferContext*)stream;
+    CCHttpResponse *response = context->response;
     size_t sizes = size * nmemb;
 
-    recvBuffer->clear();
-    recvBuffer->assign((char*)ptr, (char*)ptr + sizes);
+    if (context->file)
+    {
+        if (! context->checkedResponseCode)
+        {
+            context->checkedResponseCode = true;
+            long responseCode = 0;
+            curl_easy_getinfo(context->curl, CURLINFO_RESPONSE_CODE, &responseCode);
+            if (responseCode == 200 && context->resumeOffset > 0)
+            {
+                // the server ignored the range, it sends the whole file again
+                fclose(context->file);
+                context->file = fopen(context->downloadPath.c_str(), "wb");
+                context->resumeOffset = 0;
+                if (! context->file)
+                {
+                    return 0;
+                }
+            }
+            else if (! isSuccessCode(responseCode, context))
+            {
+                context->discardBody = true;
+            }
+        }
+
+        if (context->discardBody)
+        {
+            return sizes;
+        }
+
+        // returning less than sizes aborts the transfer
+        if (fwrite(ptr, 1, sizes, context->file) != sizes)
+        {
+            return 0;
+        }
+    }
+    else if (! context->streaming)
+    {
+        // the body comes in several chunks
+        std::vector<char> *recvBuffer = response->getResponseData();
+        recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr + sizes);
+    }
+
+    context->receivedBytes += sizes;
+
+    pthread_mutex_lock(&s_responseQueueMutex);
+    if (context->streaming && ! context->file)
+    {
+        std::vector<char> *receivedData = response->getReceivedData();
+        receivedData->insert(receivedData->end(), (char*)ptr, (char*)ptr + sizes);
+    }
+    response->setReceivedBytes(context->resumeOffset + context->receivedBytes);
+    pthread_mutex_unlock(&s_responseQueueMutex);
     
     return sizes;
 }
 
+// Callback function used by libcurl to report the size of the body,
+// and to abort the transfers when the client is destroyed
+static int updateProgress(void *clientp, double dltotal, double dlnow, double ultotal, double ulnow)
+{
+    TransferContext *context = (TransferContext*)clientp;
+    if (dltotal > 0)
+    {
+        pthread_mutex_lock(&s_responseQueueMutex);
+        context->response->setReceivedTotalBytes(context->resumeOffset + (long)dltotal);
+        pthread_mutex_unlock(&s_responseQueueMutex);
+    }
+
+    return need_quit ? 1 : 0;
+}
+
 // Prototypes
-bool configureCURL(CURL *handle);
-int processGetTask(CCHttpRequest *request, write_callback callback, void *stream, int32_t *errorCode);
-int processPostTask(CCHttpRequest *request, write_callback callback, void *stream, int32_t *errorCode);
+bool configureCURL(CURL *handle, char *errorBuffer, TransferContext *context);
+int processGetTask(CURL *curl, CCHttpRequest *request, write_callback callback, TransferContext *context, int32_t *errorCode, char *errorBuffer);
+int processPostTask(CURL *curl, CCHttpRequest *request, write_callback callback, TransferContext *context, int32_t *errorCode, char *errorBuffer);
 // int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
 
 
@@ -92,38 +172,31 @@ int processPostTask(CCHttpRequest *request, write_callback callback, void *strea
 static void* networkThread(void *data)
 {    
     CCHttpRequest *request = NULL;
+
+    // the handle is reused by all the requests of this thread, so it keeps the connections alive
+    CURL *curl = curl_easy_init();
+    char errorBuffer[CURL_ERROR_SIZE];
     
     while (true) 
     {
-        // Wait for http request tasks from main thread
-        int semWaitRet = sem_wait(s_pSem);
-        if (semWaitRet < 0) {
-            CCLog("HttpRequest async thread semaphore error: %s\n", strerror(errno));
-            break;
+        // step 1: wait for http request tasks from main thread
+        pthread_mutex_lock(&s_requestQueueMutex);
+        while (s_pRequestQueue->empty() && ! need_quit)
+        {
+            pthread_cond_wait(&s_requestQueueCond, &s_requestQueueMutex);
         }
         
         if (need_quit)
         {
+            pthread_mutex_unlock(&s_requestQueueMutex);
             break;
         }
         
-        // step 1: send http request if the requestQueue isn't empty
-        request = NULL;
-        
-        pthread_mutex_lock(&s_requestQueueMutex); //Get request task from queue
-        if (0 != s_requestQueue->count())
-        {
-            request = dynamic_cast<CCHttpRequest*>(s_requestQueue->objectAtIndex(0));
-            s_requestQueue->removeObjectAtIndex(0);  
-            // request's refcount = 1 here
-        }
+        request = s_pRequestQueue->front();
+        s_pRequestQueue->pop_front();
+        // request's refcount = 1 here
         pthread_mutex_unlock(&s_requestQueueMutex);
         
-        if (NULL == request)
-        {
-            continue;
-        }
-        
         // step 2: libcurl sync access
         
         // Create a HttpResponse object, the default setting is http access failed
@@ -134,28 +207,100 @@ static void* networkThread(void *data)
         // ok, refcount = 1 now, only HttpResponse hold it.
         
         int responseCode = -1;
-        int retValue = 0;
+        int retValue = 1;
+        errorBuffer[0] = '\0';
+        
+        TransferContext context;
+        context.response = response;
+        context.curl = curl;
+        context.file = NULL;
+        context.resumeOffset = 0;
+        context.receivedBytes = 0;
+        context.streaming = (request->getStreamTarget() && request->getStreamSelector());
+        context.checkedResponseCode = false;
+        context.discardBody = false;
+        
+        bool bDownload = (request->getDownloadPath()[0] != '\0');
+        if (bDownload)
+        {
+            // a partial file is left by a failed download, resume it
+            context.downloadPath = std::string(request->getDownloadPath()) + ".download";
+            context.file = fopen(context.downloadPath.c_str(), "ab");
+            if (context.file)
+            {
+                fseek(context.file, 0, SEEK_END);
+                context.resumeOffset = ftell(context.file);
+            }
+        }
+        
+        // the stream and progress callbacks are called by the main thread while the response is received
+        bool bActive = context.streaming || request->getProgressTarget();
+        if (bActive)
+        {
+            // the reference of this thread moves to the response queue when the response is complete.
+            // Only the main thread changes the reference count of the responses it can see
+            pthread_mutex_lock(&s_responseQueueMutex);
+            s_pActiveResponses->push_back(response);
+            pthread_mutex_unlock(&s_responseQueueMutex);
+        }
 
-        // Process the request -> get response packet
-        switch (request->getRequestType())
+        if (bDownload && ! context.file)
         {
-            case CCHttpRequest::kHttpGet: // HTTP GET
-                retValue = processGetTask(request, 
-                                          writeData, 
-                                          response->getResponseData(), 
-                                          &responseCode);
-                break;
-            
-            case CCHttpRequest::kHttpPost: // HTTP POST
-                retValue = processPostTask(request, 
-                                           writeData, 
-                                           response->getResponseData(), 
-                                           &responseCode);
-                break;
+            sprintf(errorBuffer, "can not open %s", context.downloadPath.c_str());
+        }
+        else if (curl)
+        {
+            // Process the request -> get response packet
+            switch (request->getRequestType())
+            {
+                case CCHttpRequest::kHttpGet: // HTTP GET
+                    retValue = processGetTask(curl,
+                                              request, 
+                                              writeData, 
+                                              &context, 
+                                              &responseCode,
+                                              errorBuffer);
+                    break;
+                
+                case CCHttpRequest::kHttpPost: // HTTP POST
+                    retValue = processPostTask(curl,
+                                               request, 
+                                               writeData, 
+                                               &context, 
+                                               &responseCode,
+                                               errorBuffer);
+                    break;
+                
+                default:
+                    CCAssert(true, "CCHttpClient: unkown request type, only GET and POSt are supported");
+                    break;
+            }
+        }
+        else
+        {
+            strcpy(errorBuffer, "curl_easy_init failed");
+        }
+        
+        if (context.file)
+        {
+            fclose(context.file);
             
-            default:
-                CCAssert(true, "CCHttpClient: unkown request type, only GET and POSt are supported");
-                break;
+            if (retValue == 0)
+            {
+                // the file is only replaced once it is complete
+                remove(request->getDownloadPath());
+                if (rename(context.downloadPath.c_str(), request->getDownloadPath()) != 0)
+                {
+                    sprintf(errorBuffer, "can not rename %s", context.downloadPath.c_str());
+                    retValue = 1;
+                }
+            }
+            else if (responseCode == 416 || context.resumeOffset + context.receivedBytes == 0)
+            {
+                // the range of the partial file isn't valid anymore, or nothing was downloaded:
+                // the next download starts again
+                remove(context.downloadPath.c_str());
+            }
         }
                 
         // write data to HttpResponse
@@ -164,7 +309,7 @@ static void* networkThread(void *data)
         if (retValue != 0) 
         {
             response->setSucceed(false);
-            response->setErrorBuffer(s_errorBuffer);
+            response->setErrorBuffer(errorBuffer);
         }
         else
         {
@@ -172,75 +317,157 @@ static void* networkThread(void *data)
         }
 
         
-        // add response packet into queue
+        // add response packet into queue, it's dispatched in the main thread
         pthread_mutex_lock(&s_responseQueueMutex);
-        s_responseQueue->addObject(response);
+        if (bActive)
+        {
+            s_pActiveResponses->erase(std::find(s_pActiveResponses->begin(), s_pActiveResponses->end(), response));
+        }
+        s_pResponseQueue->push_back(response);
         pthread_mutex_unlock(&s_responseQueueMutex);
-        
-        // resume dispatcher selector
-        CCDirector::sharedDirector()->getScheduler()->resumeTarget(CCHttpClient::getInstance());
     }
     
-    // cleanup: if worker thread received quit signal, clean up un-completed request queue
+    if (curl)
+    {
+        curl_easy_cleanup(curl);
+    }
+    
+    return 0;
+}
+
+static bool startNetworkThreads()
+{
+    static bool s_bCurlInitialized = false;
+    if (! s_bCurlInitialized)
+    {
+        // curl_easy_init isn't thread safe when it has to initialize curl itself
+        curl_global_init(CURL_GLOBAL_ALL);
+        s_bCurlInitialized = true;
+    }
+
+    s_pRequestQueue = new std::list<CCHttpRequest*>();
+    s_pResponseQueue = new std::vector<CCHttpResponse*>();
+    s_pActiveResponses = new std::vector<CCHttpResponse*>();
+    
+    pthread_mutex_init(&s_requestQueueMutex, NULL);
+    pthread_cond_init(&s_requestQueueCond, NULL);
+    pthread_mutex_init(&s_responseQueueMutex, NULL);
+    
+    need_quit = false;
+    
+    s_pNetworkThreads = new pthread_t[s_uThreadCount];
+    s_uStartedThreads = 0;
+    for (unsigned int i = 0; i < s_uThreadCount; ++i)
+    {
+        if (pthread_create(&s_pNetworkThreads[s_uStartedThreads], NULL, networkThread, NULL) != 0)
+        {
+            CCLog("HttpRequest async thread creation error: %s\n", strerror(errno));
+            break;
+        }
+        ++s_uStartedThreads;
+    }
+    
+    return s_uStartedThreads > 0;
+}
+
+static void stopNetworkThreads()
+{
+    if (s_pNetworkThreads == NULL)
+    {
+        return;
+    }
+    
     pthread_mutex_lock(&s_requestQueueMutex);
-    s_requestQueue->removeAllObjects();
+    need_quit = true;
+    pthread_cond_broadcast(&s_requestQueueCond);
     pthread_mutex_unlock(&s_requestQueueMutex);
-    s_asyncRequestCount -= s_requestQueue->count();
-    
-    if (s_pSem != NULL) {
-#if CC_ASYNC_HTTPREQUEST_USE_NAMED_SEMAPHORE
-        sem_unlink(CC_ASYNC_HTTPREQUEST_SEMAPHORE);
-        sem_close(s_pSem);
-#else
-        sem_destroy(s_pSem);
-#endif
-        
-        s_pSem = NULL;
-        
-        pthread_mutex_destroy(&s_requestQueueMutex);
-        pthread_mutex_destroy(&s_responseQueueMutex);
-        
-        s_requestQueue->release();
-        s_responseQueue->release();
+    
+    // the requests being sent are aborted by updateProgress
+    for (unsigned int i = 0; i < s_uStartedThreads; ++i)
+    {
+        pthread_join(s_pNetworkThreads[i], NULL);
     }
-
-    pthread_exit(NULL);
+    CC_SAFE_DELETE_ARRAY(s_pNetworkThreads);
+    s_uStartedThreads = 0;
     
-    return 0;
+    // cleanup: release the requests that weren't sent and the responses that weren't dispatched
+    for (std::list<CCHttpRequest*>::iterator it = s_pRequestQueue->begin(); it != s_pRequestQueue->end(); ++it)
+    {
+        (*it)->release();
+    }
+    for (std::vector<CCHttpResponse*>::iterator it = s_pResponseQueue->begin(); it != s_pResponseQueue->end(); ++it)
+    {
+        (*it)->release();
+    }
+    CC_SAFE_DELETE(s_pRequestQueue);
+    CC_SAFE_DELETE(s_pResponseQueue);
+    CC_SAFE_DELETE(s_pActiveResponses);
+    
+    pthread_mutex_destroy(&s_requestQueueMutex);
+    pthread_cond_destroy(&s_requestQueueCond);
+    pthread_mutex_destroy(&s_responseQueueMutex);
+    
+    s_asyncRequestCount = 0;
 }
 
-//Configure curl's timeout property
-bool configureCURL(CURL *handle)
+//Configure curl's timeout property, and the callbacks of the transfer
+bool configureCURL(CURL *handle, char *errorBuffer, TransferContext *context)
 {
     if (!handle) {
         return false;
     }
     
+    // forget the options of the previous request, but not its connection
+    curl_easy_reset(handle);
+    
     int32_t code;
-    code = curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, s_errorBuffer);
+    code = curl_easy_setopt(handle, CURLOPT_ERRORBUFFER, errorBuffer);
+    if (code != CURLE_OK) {
+        return false;
+    }
+    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT, s_pHttpClient->getTimeoutForRead());
     if (code != CURLE_OK) {
         return false;
     }
-    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT, CCHttpClient::getInstance()->getTimeoutForRead());
+    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, s_pHttpClient->getTimeoutForConnect());
     if (code != CURLE_OK) {
         return false;
     }
-    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, CCHttpClient::getInstance()->getTimeoutForConnect());
+    // signals can't be used to time out in several threads
+    code = curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
     if (code != CURLE_OK) {
         return false;
     }
+    code = curl_easy_setopt(handle, CURLOPT_NOPROGRESS, 0L);
+    if (code != CURLE_OK) {
+        return false;
+    }
+    code = curl_easy_setopt(handle, CURLOPT_PROGRESSFUNCTION, updateProgress);
+    if (code != CURLE_OK) {
+        return false;
+    }
+    code = curl_easy_setopt(handle, CURLOPT_PROGRESSDATA, context);
+    if (code != CURLE_OK) {
+        return false;
+    }
+    if (context->resumeOffset > 0) {
+        // asks for the rest of the file with a Range header
+        code = curl_easy_setopt(handle, CURLOPT_RESUME_FROM, context->resumeOffset);
+        if (code != CURLE_OK) {
+            return false;
+        }
+    }
     
     return true;
 }
 
 //Process Get Request
-int processGetTask(CCHttpRequest *request, write_callback callback, void *stream, int *responseCode)
+int processGetTask(CURL *curl, CCHttpRequest *request, write_callback callback, TransferContext *context, int *responseCode, char *errorBuffer)
 {
     CURLcode code = CURL_LAST;
-    CURL *curl = curl_easy_init();
     
     do {
-        if (!configureCURL(curl)) 
+        if (!configureCURL(curl, errorBuffer, context)) 
         {
             break;
         }
@@ -257,7 +484,7 @@ int processGetTask(CCHttpRequest *request, write_callback callback, void *stream
             break;
         }
         
-        code = curl_easy_setopt(curl, CURLOPT_WRITEDATA, stream);
+        code = curl_easy_setopt(curl, CURLOPT_WRITEDATA, context);
         if (code != CURLE_OK) 
         {
             break;
@@ -270,27 +497,22 @@ int processGetTask(CCHttpRequest *request, write_callback callback, void *stream
         }
         
         code = curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, responseCode); 
-        if (code != CURLE_OK || *responseCode != 200) 
+        if (code != CURLE_OK || ! isSuccessCode(*responseCode, context)) 
         {
             code = CURLE_HTTP_RETURNED_ERROR;
         }
     } while (0);
     
-    if (curl) {
-        curl_easy_cleanup(curl);
-    }
-    
     return (code == CURLE_OK ? 0 : 1);
 }
 
 //Process POST Request
-int processPostTask(CCHttpRequest *request, write_callback callback, void *stream, int32_t *responseCode)
+int processPostTask(CURL *curl, CCHttpRequest *request, write_callback callback, TransferContext *context, int32_t *responseCode, char *errorBuffer)
 {
     CURLcode code = CURL_LAST;
-    CURL *curl = curl_easy_init();
     
     do {
-        if (!configureCURL(curl)) {
+        if (!configureCURL(curl, errorBuffer, context)) {
             break;
         }
         
@@ -302,7 +524,7 @@ int processPostTask(CCHttpRequest *request, write_callback callback, void *strea
         if (code != CURLE_OK) {
             break;
         }
-        code = curl_easy_setopt(curl, CURLOPT_WRITEDATA, stream);
+        code = curl_easy_setopt(curl, CURLOPT_WRITEDATA, context);
         if (code != CURLE_OK) {
             break;
         }
@@ -324,13 +546,10 @@ int processPostTask(CCHttpRequest *request, write_callback callback, void *strea
         }
         
         code = curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, responseCode); 
-        if (code != CURLE_OK || *responseCode != 200) {
+        if (code != CURLE_OK || ! isSuccessCode(*responseCode, context)) {
             code = CURLE_HTTP_RETURNED_ERROR;
         }
     } while (0);
-    if (curl) {
-        curl_easy_cleanup(curl);
-    }
     
     return (code == CURLE_OK ? 0 : 1);    
 }
@@ -363,51 +582,33 @@ CCHttpClient::CCHttpClient()
 
 CCHttpClient::~CCHttpClient()
 {
-    need_quit = true;
-    
-    if (s_pSem != NULL) {
-        sem_post(s_pSem);
-    }
+    stopNetworkThreads();
     
     CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(CCHttpClient::dispatchResponseCallbacks), this);
 }
 
-//Lazy create semaphore & mutex & thread
-bool CCHttpClient::lazyInitThreadSemphore()
+void CCHttpClient::setThreadCount(unsigned int count)
 {
-    if (s_pSem != NULL) {
+    CCAssert(count > 0, "At least one network thread is needed");
+    s_uThreadCount = MAX(count, 1);
+}
+
+unsigned int CCHttpClient::getThreadCount()
+{
+    return s_uThreadCount;
+}
+
+//Lazy create mutex, condition & threads
+bool CCHttpClient::lazyInitThreads()
+{
+    if (s_pNetworkThreads != NULL) {
         return true;
-    } else {
-#if CC_ASYNC_HTTPREQUEST_USE_NAMED_SEMAPHORE
-        s_pSem = sem_open(CC_ASYNC_HTTPREQUEST_SEMAPHORE, O_CREAT, 0644, 0);
-        if (s_pSem == SEM_FAILED) {
-            CCLog("Open HttpRequest Semaphore failed");
-            s_pSem = NULL;
-            return false;
-        }
-#else
-        int semRet = sem_init(&s_sem, 0, 0);
-        if (semRet < 0) {
-            CCLog("Init HttpRequest Semaphore failed");
-            return false;
-        }
-        
-        s_pSem = &s_sem;
-#endif
-        
-        s_requestQueue = new CCArray();
-        s_requestQueue->init();
-        
-        s_responseQueue = new CCArray();
-        s_responseQueue->init();
-        
-        pthread_mutex_init(&s_requestQueueMutex, NULL);
-        pthread_mutex_init(&s_responseQueueMutex, NULL);
-        
-        pthread_create(&s_networkThread, NULL, networkThread, NULL);
-        pthread_detach(s_networkThread);
-        
-        need_quit = false;
+    }
+    
+    if (! startNetworkThreads()) {
+        CCLog("Init HttpRequest threads failed");
+        stopNetworkThreads();
+        return false;
     }
     
     return true;
@@ -416,7 +617,7 @@ bool CCHttpClient::lazyInitThreadSemphore()
 //Add a get task to queue
 void CCHttpClient::send(CCHttpRequest* request)
 {    
-    if (false == lazyInitThreadSemphore()) 
+    if (false == lazyInitThreads()) 
     {
         return;
     }
@@ -431,11 +632,68 @@ void CCHttpClient::send(CCHttpRequest* request)
     request->retain();
         
     pthread_mutex_lock(&s_requestQueueMutex);
-    s_requestQueue->addObject(request);
+    // after the requests of the same priority, so they are sent in order
+    std::list<CCHttpRequest*>::iterator it = s_pRequestQueue->end();
+    while (it != s_pRequestQueue->begin())
+    {
+        std::list<CCHttpRequest*>::iterator prev = it;
+        --prev;
+        if ((*prev)->getPriority() >= request->getPriority())
+        {
+            break;
+        }
+        it = prev;
+    }
+    s_pRequestQueue->insert(it, request);
+    
+    // Notify a thread to start working
+    pthread_cond_signal(&s_requestQueueCond);
     pthread_mutex_unlock(&s_requestQueueMutex);
     
-    // Notify thread start to work
-    sem_post(s_pSem);
+    // resume dispatcher selector until all the responses are dispatched
+    CCDirector::sharedDirector()->getScheduler()->resumeTarget(this);
+}
+
+// Passes the data and the progress received by the network thread to the stream and progress callbacks
+static void dispatchReceivedData(CCHttpClient *client, CCHttpResponse *response)
+{
+    std::vector<char> receivedData;
+    
+    pthread_mutex_lock(&s_responseQueueMutex);
+    receivedData.swap(*response->getReceivedData());
+    long receivedBytes = response->getReceivedBytes();
+    long totalBytes = response->getReceivedTotalBytes();
+    pthread_mutex_unlock(&s_responseQueueMutex);
+    
+    CCHttpRequest *request = response->getHttpRequest();
+    CCObject *pTarget = request->getStreamTarget();
+    SEL_CallFuncND pSelector = request->getStreamSelector();
+    
+    if (! receivedData.empty() && pTarget && pSelector)
+    {
+        response->getResponseData()->swap(receivedData);
+        (pTarget->*pSelector)((CCNode *)client, response);
+        response->getResponseData()->clear();
+    }
+    
+    if (receivedBytes == response->getDownloadedBytes() && totalBytes == response->getTotalBytes())
+    {
+        return;
+    }
+    response->setDownloadedBytes(receivedBytes);
+    response->setTotalBytes(totalBytes);
+    
+    pTarget = request->getProgressTarget();
+    pSelector = request->getProgressSelector();
+    if (pTarget && pSelector)
+    {
+        // only the byte counts, the body of the response is still written by the network thread
+        CCHttpProgress progress;
+        progress.request = request;
+        progress.downloadedBytes = receivedBytes;
+        progress.totalBytes = totalBytes;
+        (pTarget->*pSelector)((CCNode *)client, &progress);
+    }
 }
 
 // Poll and notify main thread if responses exists in queue
@@ -443,20 +701,50 @@ void CCHttpClient::dispatchResponseCallbacks(float delta)
 {
     // CCLog("CCHttpClient::dispatchResponseCallbacks is running");
     
-    CCHttpResponse* response = NULL;
+    std::vector<CCHttpResponse*> responses;
+    std::vector<CCHttpResponse*> activeResponses;
     
-    pthread_mutex_lock(&s_responseQueueMutex);
-    if (s_responseQueue->count())
+    if (s_pResponseQueue)
     {
-        response = dynamic_cast<CCHttpResponse*>(s_responseQueue->objectAtIndex(0));
-        s_responseQueue->removeObjectAtIndex(0);
+        pthread_mutex_lock(&s_responseQueueMutex);
+        responses.swap(*s_pResponseQueue);
+        activeResponses = *s_pActiveResponses;
+        pthread_mutex_unlock(&s_responseQueueMutex);
+        
+        // kept alive if a callback destroys the client, which releases the queued responses.
+        // The network threads never change the reference count of a response once it is shared
+        for (unsigned int i = 0; i < activeResponses.size(); ++i)
+        {
+            activeResponses[i]->retain();
+        }
+    }
+    
+    // the responses being received, at most once per frame
+    for (unsigned int i = 0; i < activeResponses.size(); ++i)
+    {
+        if (s_pHttpClient == this)
+        {
+            dispatchReceivedData(this, activeResponses[i]);
+        }
+        activeResponses[i]->release();
     }
-    pthread_mutex_unlock(&s_responseQueueMutex);
     
-    if (response)
+    for (unsigned int i = 0; i < responses.size(); ++i)
     {
+        CCHttpResponse *response = responses[i];
+        
+        // a callback destroyed the client
+        if (s_pHttpClient != this)
+        {
+            response->release();
+            continue;
+        }
+        
         --s_asyncRequestCount;
         
+        // the end of the body and the final progress
+        dispatchReceivedData(this, response);
+        
         CCHttpRequest *request = response->getHttpRequest();
         CCObject *pTarget = request->getTarget();
         SEL_CallFuncND pSelector = request->getSelector();
@@ -469,7 +757,7 @@ void CCHttpClient::dispatchResponseCallbacks(float delta)
         response->release();
     }
     
-    if (0 == s_asyncRequestCount) 
+    if (s_pHttpClient == this && 0 == s_asyncRequestCount) 
     {
         CCDirector::sharedDirector()->getScheduler()->pauseTarget(this);
     }
@@ -477,5 +765,3 @@ void CCHttpClient::dispatchResponseCallbacks(float delta)
 }
 
 NS_CC_EXT_END
-
-
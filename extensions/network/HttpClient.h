@@ -39,9 +39,20 @@ NS_CC_EXT_BEGIN
  * @{
  */
 
+/** @def CC_HTTP_CLIENT_THREADS
+ Number of threads that send the requests of CCHttpClient in parallel.
+ It can be changed at runtime with CCHttpClient::setThreadCount.
+ */
+#ifndef CC_HTTP_CLIENT_THREADS
+#define CC_HTTP_CLIENT_THREADS 4
+#endif
 
 /** @brief Singleton that handles asynchrounous http requests
  * Once the request completed, a callback will issued in main thread when it provided during make request
+ *
+ * The requests are sent by a pool of threads, the ones with the highest priority first. Each thread
+ * keeps its curl handle, so the connections to a server are kept alive between requests.
+ * All the responses received since the previous frame are dispatched at once.
  */
 class CCHttpClient : public cocos2d::CCObject
 {
@@ -88,6 +99,20 @@ public:
      * @return int
      */
     inline int getTimeoutForRead() {return _timeoutForRead;};
+
+    /**
+     * Change the number of threads that send the requests.
+     * It is used the next time the threads are started: call it before the first send.
+     * Default is CC_HTTP_CLIENT_THREADS.
+     * @since v2.1
+     */
+    void setThreadCount(unsigned int count);
+
+    /**
+     * Get the number of threads that send the requests
+     * @since v2.1
+     */
+    unsigned int getThreadCount();
         
 private:
     CCHttpClient();
@@ -95,10 +120,10 @@ private:
     bool init(void);
     
     /**
-     * Init pthread mutex, semaphore, and create new thread for http requests
+     * Init pthread mutex, condition, and create the threads for http requests
      * @return bool
      */
-    bool lazyInitThreadSemphore();
+    bool lazyInitThreads();
     /** Poll function called from main thread to dispatch callbacks when http requests finished **/
     void dispatchResponseCallbacks(float delta);
     
@@ -61,6 +61,12 @@ public:
         _pTarget = NULL;
         _pSelector = NULL;
         _pUserData = NULL;
+        _priority = 0;
+        _downloadPath.clear();
+        _pStreamTarget = NULL;
+        _pStreamSelector = NULL;
+        _pProgressTarget = NULL;
+        _pProgressSelector = NULL;
     };
     
     /** Destructor */
@@ -70,6 +76,14 @@ public:
         {
             _pTarget->release();
         }
+        if (_pStreamTarget)
+        {
+            _pStreamTarget->release();
+        }
+        if (_pProgressTarget)
+        {
+            _pProgressTarget->release();
+        }
     };
     
     /** Override autorelease method to avoid developers to call it */
@@ -138,6 +152,19 @@ public:
         return _tag.c_str();
     };
     
+    /** Option field. The requests with a higher priority are sent first. Default is 0.
+     @since v2.1
+     */
+    inline void setPriority(int priority)
+    {
+        _priority = priority;
+    };
+    /** Get the priority of the request */
+    inline int getPriority()
+    {
+        return _priority;
+    };
+    
     /** Option field. You can attach a customed data in each request, and get it back in response callback.
         But you need to new/delete the data pointer manully
      */
@@ -175,6 +202,63 @@ public:
     {
         return _pSelector;
     }
+    
+    /** Option field. The body of the response is written in this file instead of the response data.
+        It is first written in path + ".download", which is renamed to path once the download succeeded.
+        If a previous download of the same file failed, it is resumed with a Range request.
+     @since v2.1
+     */
+    inline void setDownloadPath(const char* path)
+    {
+        _downloadPath = path;
+    };
+    /** Get the path of the downloaded file, empty if the body is kept in the response data */
+    inline const char* getDownloadPath()
+    {
+        return _downloadPath.c_str();
+    };
+    
+    /** Option field. The selector is called in the main thread, at most once per frame, with the
+        data received since the previous call in CCHttpResponse::getResponseData(). The body isn't
+        kept, so the response data is empty in the response callback.
+        It isn't called for the requests that have a download path.
+     @since v2.1
+     */
+    inline void setStreamCallback(cocos2d::CCObject* pTarget, cocos2d::SEL_CallFuncND pSelector)
+    {
+        CC_SAFE_RETAIN(pTarget);
+        CC_SAFE_RELEASE(_pStreamTarget);
+        _pStreamTarget = pTarget;
+        _pStreamSelector = pSelector;
+    }
+    inline CCObject* getStreamTarget()
+    {
+        return _pStreamTarget;
+    }
+    inline cocos2d::SEL_CallFuncND getStreamSelector()
+    {
+        return _pStreamSelector;
+    }
+    
+    /** Option field. The selector is called in the main thread, at most once per frame, while the
+        response is received, with a CCHttpProgress* as data, e.g. MyLayer::onHttpProgress(CCNode *sender, void *data).
+     @since v2.1
+     */
+    inline void setProgressCallback(cocos2d::CCObject* pTarget, cocos2d::SEL_CallFuncND pSelector)
+    {
+        CC_SAFE_RETAIN(pTarget);
+        CC_SAFE_RELEASE(_pProgressTarget);
+        _pProgressTarget = pTarget;
+        _pProgressSelector = pSelector;
+    }
+    inline CCObject* getProgressTarget()
+    {
+        return _pProgressTarget;
+    }
+    inline cocos2d::SEL_CallFuncND getProgressSelector()
+    {
+        return _pProgressSelector;
+    }
         
 protected:
     // properties
@@ -185,8 +269,26 @@ protected:
     cocos2d::CCObject*          _pTarget;        /// callback target of pSelector function
     cocos2d::SEL_CallFuncND     _pSelector;      /// callback function, e.g. MyLayer::onHttpResponse(CCObject *sender, void *data)
     void*                       _pUserData;      /// You can add your customed data here 
+    int                         _priority;       /// requests with a higher priority are sent first
+    std::string                 _downloadPath;   /// file the body is written in, empty to keep it in memory
+    cocos2d::CCObject*          _pStreamTarget;  /// target of _pStreamSelector
+    cocos2d::SEL_CallFuncND     _pStreamSelector; /// receives the body chunk by chunk
+    cocos2d::CCObject*          _pProgressTarget; /// target of _pProgressSelector
+    cocos2d::SEL_CallFuncND     _pProgressSelector; /// called when more of the response is received
 };
 
+/**
+ @brief the data passed to the progress callback of a CCHttpRequest. The response isn't passed,
+ as the network thread is still writing it.
+ @since v2.1
+ */
+typedef struct _HttpProgress
+{
+    CCHttpRequest*  request;            /// the request whose response is being received
+    long            downloadedBytes;    /// bytes of the body received so far, including the ones of a resumed download
+    long            totalBytes;         /// size of the body, -1 while it is unknown
+} CCHttpProgress;
+
 NS_CC_EXT_END
 
 #endif //__HTTP_REQUEST_H__
\ No newline at end of file
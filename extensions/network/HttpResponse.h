@@ -53,6 +53,11 @@ public:
         _succeed = false;
         _responseData.clear();
         _errorBuffer.clear();
+        _downloadedBytes = 0;
+        _totalBytes = -1;
+        _receivedBytes = 0;
+        _receivedTotalBytes = -1;
+        _receivedData.clear();
     }
     
     /** Destructor, it will be called in CCHttpClient internal,
@@ -114,6 +119,22 @@ public:
         return _errorBuffer.c_str();
     }
     
+    /** Get the number of bytes of the body received so far, including the ones of a resumed download
+     @since v2.1
+     */
+    inline long getDownloadedBytes()
+    {
+        return _downloadedBytes;
+    }
+    
+    /** Get the size of the body, -1 while it is unknown
+     @since v2.1
+     */
+    inline long getTotalBytes()
+    {
+        return _totalBytes;
+    }
+    
     // setters, will be called by CCHttpClient
     // users should avoid invoking these methods
     
@@ -152,6 +173,43 @@ public:
         _errorBuffer.assign(value);
     };
     
+    /** Set the progress of the transfer seen by the main thread, is used by CCHttpClient
+     */
+    inline void setDownloadedBytes(long value)
+    {
+        _downloadedBytes = value;
+    }
+    inline void setTotalBytes(long value)
+    {
+        _totalBytes = value;
+    }
+    
+    /** Progress of the transfer in the network thread, is used by CCHttpClient
+     */
+    inline long getReceivedBytes()
+    {
+        return _receivedBytes;
+    }
+    inline void setReceivedBytes(long value)
+    {
+        _receivedBytes = value;
+    }
+    inline long getReceivedTotalBytes()
+    {
+        return _receivedTotalBytes;
+    }
+    inline void setReceivedTotalBytes(long value)
+    {
+        _receivedTotalBytes = value;
+    }
+    
+    /** Data received by the network thread and not yet streamed, is used by CCHttpClient
+     */
+    inline std::vector<char>* getReceivedData()
+    {
+        return &_receivedData;
+    }
+    
 protected:
     bool initWithRequest(CCHttpRequest* request);
     
@@ -161,6 +219,11 @@ protected:
     std::vector<char>   _responseData;  /// the returned raw data. You can also dump it as a string
     int                 _responseCode;    /// the status code returned from libcurl, e.g. 200, 404
     std::string         _errorBuffer;   /// if _responseCode != 200, please read _errorBuffer to find the reason 
+    long                _downloadedBytes; /// bytes of the body received so far
+    long                _totalBytes;    /// size of the body, -1 if unknown
+    long                _receivedBytes; /// _downloadedBytes, as written by the network thread
+    long                _receivedTotalBytes; /// _totalBytes, as written by the network thread
+    std::vector<char>   _receivedData;  /// chunks waiting to be streamed to the main thread
     
 };
 
@@ -69,6 +69,10 @@ Classes/PerformanceTest/PerformanceSpriteTest.cpp \
 Classes/PerformanceTest/PerformanceTest.cpp \
 Classes/PerformanceTest/PerformanceTextureTest.cpp \
 Classes/PerformanceTest/PerformanceTouchesTest.cpp \
+Classes/PerformanceTest/PerformanceSchedulerTest.cpp \
+Classes/PerformanceTest/PerformanceLabelTest.cpp \
+Classes/PerformanceTest/PerformanceCCBReaderTest.cpp \
+Classes/PerformanceTest/PerformanceNotificationCenterTest.cpp \
 Classes/RenderTextureTest/RenderTextureTest.cpp \
 Classes/RotateWorldTest/RotateWorldTest.cpp \
 Classes/SceneTest/SceneTest.cpp \
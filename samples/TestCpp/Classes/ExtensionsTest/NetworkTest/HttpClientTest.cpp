@@ -5,8 +5,15 @@
 USING_NS_CC;
 USING_NS_CC_EXT;
 
+// run tools/http_test_server/http_test_server.py for the tests of the local server
+#define HTTP_TEST_SERVER "http://localhost:8080"
+
+#define CONCURRENT_REQUESTS 32
+
 HttpClientTest::HttpClientTest() 
 : m_labelStatusCode(NULL)
+, m_nPendingRequests(0)
+, m_nFailedRequests(0)
 {
     CCSize winSize = CCDirector::sharedDirector()->getWinSize();
     
@@ -36,9 +43,21 @@ HttpClientTest::HttpClientTest()
     itemPostBinary->setPosition(ccp(winSize.width / 2, winSize.height - 200));
     menuRequest->addChild(itemPostBinary);
     
+    // Concurrent requests to the local server
+    CCLabelTTF *labelConcurrent = CCLabelTTF::create("Test Concurrent Get (local server)", "Arial", 22);
+    CCMenuItemLabel *itemConcurrent = CCMenuItemLabel::create(labelConcurrent, this, menu_selector(HttpClientTest::onMenuConcurrentTestClicked));
+    itemConcurrent->setPosition(ccp(winSize.width / 2, winSize.height - 250));
+    menuRequest->addChild(itemConcurrent);
+    
+    // Download to a file from the local server
+    CCLabelTTF *labelDownload = CCLabelTTF::create("Test Download (local server)", "Arial", 22);
+    CCMenuItemLabel *itemDownload = CCMenuItemLabel::create(labelDownload, this, menu_selector(HttpClientTest::onMenuDownloadTestClicked));
+    itemDownload->setPosition(ccp(winSize.width / 2, winSize.height - 300));
+    menuRequest->addChild(itemDownload);
+    
     // Response Code Label
     m_labelStatusCode = CCLabelTTF::create("HTTP Status Code", "Marker Felt", 20);
-    m_labelStatusCode->setPosition(ccp(winSize.width / 2,  winSize.height - 250));
+    m_labelStatusCode->setPosition(ccp(winSize.width / 2,  winSize.height - 350));
     addChild(m_labelStatusCode);
     
     // Back Menu
@@ -137,6 +156,96 @@ void HttpClientTest::onMenuPostBinaryTestClicked(cocos2d::CCObject *sender)
     m_labelStatusCode->setString("waiting...");
 }
 
+void HttpClientTest::onMenuConcurrentTestClicked(cocos2d::CCObject *sender)
+{
+    if (m_nPendingRequests > 0)
+    {
+        return;
+    }
+    
+    m_nPendingRequests = CONCURRENT_REQUESTS;
+    m_nFailedRequests = 0;
+    CCTime::gettimeofdayCocos2d(&m_tStartTime, NULL);
+    
+    // each request takes 50ms in the server: they take CONCURRENT_REQUESTS * 50ms when they are sent one by one
+    for (int i = 0; i < CONCURRENT_REQUESTS; i++)
+    {
+        CCHttpRequest* request = new CCHttpRequest();
+        request->setUrl(HTTP_TEST_SERVER "/delay/50");
+        request->setRequestType(CCHttpRequest::kHttpGet);
+        request->setResponseCallback(this, callfuncND_selector(HttpClientTest::onConcurrentRequestCompleted));
+        // the last requests are sent first
+        request->setPriority(i);
+        CCHttpClient::getInstance()->send(request);
+        request->release();
+    }
+    
+    // waiting
+    m_labelStatusCode->setString("waiting...");
+}
+
+void HttpClientTest::onConcurrentRequestCompleted(cocos2d::CCNode *sender, void *data)
+{
+    CCHttpResponse *response = (CCHttpResponse*)data;
+    
+    if (!response->isSucceed())
+    {
+        CCLog("error buffer: %s", response->getErrorBuffer());
+        m_nFailedRequests++;
+    }
+    
+    if (--m_nPendingRequests > 0)
+    {
+        return;
+    }
+    
+    struct cc_timeval now;
+    CCTime::gettimeofdayCocos2d(&now, NULL);
+    
+    char statusString[128] = {};
+    sprintf(statusString, "%d requests in %.0f ms, %d failed, %u threads", CONCURRENT_REQUESTS,
+            CCTime::timersubCocos2d(&m_tStartTime, &now), m_nFailedRequests, CCHttpClient::getInstance()->getThreadCount());
+    m_labelStatusCode->setString(statusString);
+    CCLog("%s", statusString);
+    
+    // the server counts the connections: they are kept alive between the requests
+    CCHttpRequest* request = new CCHttpRequest();
+    request->setUrl(HTTP_TEST_SERVER "/stats");
+    request->setRequestType(CCHttpRequest::kHttpGet);
+    request->setResponseCallback(this, callfuncND_selector(HttpClientTest::onHttpRequestCompleted));
+    request->setTag("server stats");
+    CCHttpClient::getInstance()->send(request);
+    request->release();
+}
+
+void HttpClientTest::onMenuDownloadTestClicked(cocos2d::CCObject *sender)
+{
+    // 20MB, written directly in the file. Leave the test during the download: it is resumed the next time.
+    std::string path = CCFileUtils::sharedFileUtils()->getWriteablePath() + "HttpClientTest.bin";
+    
+    CCHttpRequest* request = new CCHttpRequest();
+    request->setUrl(HTTP_TEST_SERVER "/slow/20000000");
+    request->setRequestType(CCHttpRequest::kHttpGet);
+    request->setDownloadPath(path.c_str());
+    request->setResponseCallback(this, callfuncND_selector(HttpClientTest::onHttpRequestCompleted));
+    request->setProgressCallback(this, callfuncND_selector(HttpClientTest::onDownloadProgress));
+    request->setTag("download test");
+    CCHttpClient::getInstance()->send(request);
+    request->release();
+    
+    // waiting
+    m_labelStatusCode->setString("waiting...");
+}
+
+void HttpClientTest::onDownloadProgress(cocos2d::CCNode *sender, void *data)
+{
+    CCHttpProgress *progress = (CCHttpProgress*)data;
+    
+    char statusString[64] = {};
+    sprintf(statusString, "downloaded %ld / %ld bytes", progress->downloadedBytes, progress->totalBytes);
+    m_labelStatusCode->setString(statusString);
+}
+
 void HttpClientTest::onHttpRequestCompleted(cocos2d::CCNode *sender, void *data)
 {
     CCHttpResponse *response = (CCHttpResponse*)data;
@@ -15,12 +15,19 @@ public:
     void onMenuGetTestClicked(cocos2d::CCObject *sender);
     void onMenuPostTestClicked(cocos2d::CCObject *sender);
     void onMenuPostBinaryTestClicked(cocos2d::CCObject *sender);
+    void onMenuConcurrentTestClicked(cocos2d::CCObject *sender);
+    void onMenuDownloadTestClicked(cocos2d::CCObject *sender);
     
     //Http Response Callback
     void onHttpRequestCompleted(cocos2d::CCNode *sender, void *data);
+    void onConcurrentRequestCompleted(cocos2d::CCNode *sender, void *data);
+    void onDownloadProgress(cocos2d::CCNode *sender, void *data);
 
 private:
     cocos2d::CCLabelTTF* m_labelStatusCode;
+    int m_nPendingRequests;
+    int m_nFailedRequests;
+    struct cocos2d::cc_timeval m_tStartTime;
 };
 
 void runHttpClientTest();
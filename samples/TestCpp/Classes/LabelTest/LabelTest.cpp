@@ -40,7 +40,7 @@ CCLayer* restartAtlasAction();
 
 static int sceneIdx = -1; 
 
-#define MAX_LAYER    26
+#define MAX_LAYER    27
 
 CCLayer* createAtlasLayer(int nIndex)
 {
@@ -74,6 +74,7 @@ CCLayer* createAtlasLayer(int nIndex)
         case 23: return new TTFFontInit();
         case 24: return new Issue1343();
         case 25: return new LabelTTFAlignment();
+        case 26: return new BMFontBinary();
     }
 
     return NULL;
@@ -1505,3 +1506,33 @@ std::string Issue1343::subtitle()
     return "You should see: ABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890abcdefghijklmnopqrstuvwxyz.,'";
 }
 
+//------------------------------------------------------------------
+//
+// BMFontBinary
+//
+//------------------------------------------------------------------
+BMFontBinary::BMFontBinary()
+{
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    // bitmapFontTest2.fntb was converted from bitmapFontTest2.fnt with tools/bmfont_binary/fnt2bin.py
+    CCLabelBMFont* text = CCLabelBMFont::create("AVAST Wally", "fonts/bitmapFontTest2.fnt");
+    text->setScale(0.7f);
+    text->setPosition(ccp(s.width/2, s.height/3*2));
+    addChild(text);
+
+    CCLabelBMFont* binary = CCLabelBMFont::create("AVAST Wally", "fonts/bitmapFontTest2.fntb");
+    binary->setScale(0.7f);
+    binary->setPosition(ccp(s.width/2, s.height/3));
+    addChild(binary);
+}
+
+std::string BMFontBinary::title()
+{
+    return "CCLabelBMFont binary font";
+}
+
+std::string BMFontBinary::subtitle()
+{
+    return "Top: .fnt, bottom: .fntb. Both labels should look the same";
+}
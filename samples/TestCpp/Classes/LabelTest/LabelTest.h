@@ -179,17 +179,17 @@ public:
     virtual std::string title();
     virtual std::string subtitle();
 private:
-    void  setAlignmentLeft(CCObject* pSender);
-    void  setAlignmentCenter(CCObject* pSender);
-    void  setAlignmentRight(CCObject* pSender);
-    void  setAlignmentTop(CCObject* pSender);
-    void  setAlignmentMiddle(CCObject* pSender);
+    void  setAlignmentLeft(CCObject* pSender);
+    void  setAlignmentCenter(CCObject* pSender);
+    void  setAlignmentRight(CCObject* pSender);
+    void  setAlignmentTop(CCObject* pSender);
+    void  setAlignmentMiddle(CCObject* pSender);
     void  setAlignmentBottom(CCObject* pSender);
-    void  updateAlignment();
+    void  updateAlignment();
     const char* getCurrentAlignment();
 private:
-    CCLabelTTF* m_plabel;
-    CCTextAlignment m_eHorizAlign;
+    CCLabelTTF* m_plabel;
+    CCTextAlignment m_eHorizAlign;
     CCVerticalTextAlignment m_eVertAlign;
 };
 
@@ -291,6 +291,15 @@ public:
     virtual std::string subtitle();
 };
 
+class BMFontBinary : public AtlasDemo
+{
+public:
+    BMFontBinary();
+
+    virtual std::string title();
+    virtual std::string subtitle();
+};
+
 // we don't support linebreak mode
 
 #endif
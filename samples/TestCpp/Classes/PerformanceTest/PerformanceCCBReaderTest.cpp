@@ -0,0 +1,135 @@
+#include "PerformanceCCBReaderTest.h"
+#include "cocos-ext.h"
+
+USING_NS_CC_EXT;
+
+enum
+{
+    // a CCLayer with 7 CCLayerColors of 6 CCSprites, written by tools/ccb_benchmark/make_nodes_ccbi.py
+    kNodesInFile = 50,
+    kInstantiations = 1000,
+};
+
+static const char s_pCCBRootPath[] = "ccb/official/pub/";
+static const char s_pCCBFileName[] = "ccb/PerformanceNodes.ccbi";
+
+static CCNode* readNodes(CCNodeLoaderLibrary* pLibrary)
+{
+    CCBReader* pReader = new CCBReader(pLibrary);
+    CCNode* pNode = pReader->readNodeGraphFromFile(s_pCCBRootPath, s_pCCBFileName);
+    pReader->release();
+    return pNode;
+}
+
+static double instantiate(CCNodeLoaderLibrary* pLibrary, bool bPurgeTemplates)
+{
+    struct cc_timeval start, end;
+    double elapsed = 0;
+
+    for (int i = 0; i < kInstantiations; i++)
+    {
+        if (bPurgeTemplates)
+        {
+            CCBReader::purgeTemplateCache();
+        }
+
+        // release the nodes of each instantiation, and only time the reading
+        CCPoolManager::sharedPoolManager()->push();
+        CCTime::gettimeofdayCocos2d(&start, NULL);
+        readNodes(pLibrary);
+        CCTime::gettimeofdayCocos2d(&end, NULL);
+        CCPoolManager::sharedPoolManager()->pop();
+
+        elapsed += CCTime::timersubCocos2d(&start, &end);
+    }
+    return elapsed;
+}
+
+////////////////////////////////////////////////////////
+//
+// CCBReaderTest
+//
+////////////////////////////////////////////////////////
+void CCBReaderTest::showCurrentTest()
+{
+    CCDirector::sharedDirector()->replaceScene(CCBReaderTest::scene());
+}
+
+void CCBReaderTest::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    CCLabelTTF *label = CCLabelTTF::create(title().c_str(), "Arial", 40);
+    addChild(label, 1);
+    label->setPosition(ccp(s.width/2, s.height-32));
+    label->setColor(ccc3(255,255,40));
+
+    CCLabelTTF *l = CCLabelTTF::create(subtitle().c_str(), "Thonburi", 16);
+    addChild(l, 1);
+    l->setPosition(ccp(s.width/2, s.height-80));
+
+    performTests();
+}
+
+void CCBReaderTest::performTests()
+{
+    CCNodeLoaderLibrary* pLibrary = CCNodeLoaderLibrary::newDefaultCCNodeLoaderLibrary();
+    struct cc_timeval start, end;
+
+    // the first instantiation reads the file and records it
+    CCBReader::purgeTemplateCache();
+    CCTime::gettimeofdayCocos2d(&start, NULL);
+    CCNode* pNodes = readNodes(pLibrary);
+    CCTime::gettimeofdayCocos2d(&end, NULL);
+    double first = CCTime::timersubCocos2d(&start, &end);
+
+    double purged = instantiate(pLibrary, true);
+    double cached = instantiate(pLibrary, false);
+
+    char str[256] = {0};
+    sprintf(str, "first instantiation: %.3f ms\n"
+        "template purged every time: %.3f ms per instantiation\n"
+        "cached template: %.3f ms per instantiation",
+        first, purged / kInstantiations, cached / kInstantiations);
+    CCLog("\n\n--- CCBReader, %d instantiations of %d nodes ---\n%s", kInstantiations, kNodesInFile, str);
+
+    if (pNodes)
+    {
+        addChild(pNodes);
+    }
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+    CCLabelTTF *label = CCLabelTTF::create(str, "Arial", 16);
+    label->setPosition(ccp(s.width/2, s.height/2));
+    addChild(label, 1);
+}
+
+std::string CCBReaderTest::title()
+{
+    return "CCBReader";
+}
+
+std::string CCBReaderTest::subtitle()
+{
+    char str[64] = {0};
+    sprintf(str, "%d instantiations of a %d node ccbi file", kInstantiations, kNodesInFile);
+    return str;
+}
+
+CCScene* CCBReaderTest::scene()
+{
+    CCScene *pScene = CCScene::create();
+    CCBReaderTest *layer = new CCBReaderTest(false);
+    pScene->addChild(layer);
+    layer->release();
+
+    return pScene;
+}
+
+void runCCBReaderTest()
+{
+    CCScene* pScene = CCBReaderTest::scene();
+    CCDirector::sharedDirector()->replaceScene(pScene);
+}
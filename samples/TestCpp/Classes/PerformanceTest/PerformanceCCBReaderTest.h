@@ -0,0 +1,25 @@
+#ifndef __PERFORMANCE_CCBREADER_TEST_H__
+#define __PERFORMANCE_CCBREADER_TEST_H__
+
+#include "PerformanceTest.h"
+
+class CCBReaderTest : public PerformBasicLayer
+{
+public:
+    CCBReaderTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void showCurrentTest();
+    virtual void onEnter();
+    virtual std::string title();
+    virtual std::string subtitle();
+    void performTests();
+
+    static CCScene* scene();
+};
+
+void runCCBReaderTest();
+
+#endif // __PERFORMANCE_CCBREADER_TEST_H__
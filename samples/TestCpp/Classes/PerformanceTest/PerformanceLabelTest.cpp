@@ -0,0 +1,320 @@
+#include "PerformanceLabelTest.h"
+
+enum {
+    kTagInfoLayer = 1,
+    kTagTimeLayer = 2,
+
+    TEST_COUNT = 4,
+};
+
+enum {
+    kMaxLabels = 500,
+    kLabelsIncrease = 10,
+};
+
+static int s_nLabelCurCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// LabelMenuLayer
+//
+////////////////////////////////////////////////////////
+LabelMenuLayer::LabelMenuLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+
+}
+
+void LabelMenuLayer::showCurrentTest()
+{
+    int nLabels = ((LabelMainScene*)getParent())->getQuantityOfLabels();
+    LabelMainScene* pScene = NULL;
+
+    switch (m_nCurCase)
+    {
+    case 0:
+        pScene = new PerfLabelTTFTest();
+        break;
+    case 1:
+        pScene = new LabelGlyphAtlasTest();
+        break;
+    case 2:
+        pScene = new LabelBMFontTest();
+        break;
+    case 3:
+        pScene = new LabelBMFontSpritesTest();
+        break;
+    }
+    s_nLabelCurCase = m_nCurCase;
+
+    if (pScene)
+    {
+        pScene->initWithQuantityOfLabels(nLabels);
+
+        CCDirector::sharedDirector()->replaceScene(pScene);
+        pScene->release();
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// LabelMainScene
+//
+////////////////////////////////////////////////////////
+LabelMainScene::LabelMainScene()
+: quantityOfLabels(0)
+, labels(NULL)
+, labelsLayer(NULL)
+, frameNumber(0)
+, elapsedTime(0)
+, benchmarkTime(0)
+, numberOfRuns(0)
+{
+
+}
+
+LabelMainScene::~LabelMainScene()
+{
+    CC_SAFE_RELEASE(labels);
+}
+
+void LabelMainScene::initWithQuantityOfLabels(unsigned int nLabels)
+{
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    // Title
+    CCLabelTTF *label = CCLabelTTF::create(title().c_str(), "Arial", 40);
+    addChild(label, 1);
+    label->setPosition(ccp(s.width/2, s.height-32));
+    label->setColor(ccc3(255,255,40));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        CCLabelTTF *l = CCLabelTTF::create(strSubTitle.c_str(), "Thonburi", 16);
+        addChild(l, 1);
+        l->setPosition(ccp(s.width/2, s.height-80));
+    }
+
+    quantityOfLabels = nLabels;
+    labels = CCArray::createWithCapacity(kMaxLabels);
+    labels->retain();
+
+    labelsLayer = CCNode::create();
+    addChild(labelsLayer, 0);
+
+    CCMenuItemFont::setFontSize(65);
+    CCMenuItemFont *decrease = CCMenuItemFont::create(" - ", this, menu_selector(LabelMainScene::onDecrease));
+    decrease->setColor(ccc3(0,200,20));
+    CCMenuItemFont *increase = CCMenuItemFont::create(" + ", this, menu_selector(LabelMainScene::onIncrease));
+    increase->setColor(ccc3(0,200,20));
+
+    CCMenu *menu = CCMenu::create(decrease, increase, NULL);
+    menu->alignItemsHorizontally();
+    menu->setPosition(ccp(s.width/2, s.height/2+15));
+    addChild(menu, 1);
+
+    CCLabelTTF *infoLabel = CCLabelTTF::create("0 labels", "Marker Felt", 30);
+    infoLabel->setColor(ccc3(0,200,20));
+    infoLabel->setPosition(ccp(s.width/2, s.height/2-15));
+    addChild(infoLabel, 1, kTagInfoLayer);
+
+    CCLabelTTF *timeLabel = CCLabelTTF::create("0.000 ms", "Marker Felt", 30);
+    timeLabel->setColor(ccc3(255,255,40));
+    timeLabel->setPosition(ccp(s.width/2, s.height/2-55));
+    addChild(timeLabel, 1, kTagTimeLayer);
+
+    LabelMenuLayer* pMenu = new LabelMenuLayer(true, TEST_COUNT, s_nLabelCurCase);
+    addChild(pMenu);
+    pMenu->release();
+
+    updateQuantityLabel();
+    updateQuantityOfLabels();
+
+    scheduleUpdate();
+}
+
+void LabelMainScene::onDecrease(CCObject* pSender)
+{
+    quantityOfLabels -= kLabelsIncrease;
+    if( quantityOfLabels < 0 )
+        quantityOfLabels = 0;
+
+    updateQuantityLabel();
+    updateQuantityOfLabels();
+}
+
+void LabelMainScene::onIncrease(CCObject* pSender)
+{
+    quantityOfLabels += kLabelsIncrease;
+    if( quantityOfLabels > kMaxLabels )
+        quantityOfLabels = kMaxLabels;
+
+    updateQuantityLabel();
+    updateQuantityOfLabels();
+}
+
+std::string LabelMainScene::title()
+{
+    return "No title";
+}
+
+std::string LabelMainScene::subtitle()
+{
+    return "";
+}
+
+void LabelMainScene::updateQuantityLabel()
+{
+    CCLabelTTF *infoLabel = (CCLabelTTF *) getChildByTag(kTagInfoLayer);
+    char str[20] = {0};
+    sprintf(str, "%u labels", quantityOfLabels);
+    infoLabel->setString(str);
+}
+
+void LabelMainScene::updateQuantityOfLabels()
+{
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    while ((int)labels->count() < quantityOfLabels)
+    {
+        CCNode *pLabel = createLabel("0");
+        pLabel->setPosition(ccp(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        labelsLayer->addChild(pLabel);
+        labels->addObject(pLabel);
+    }
+
+    while ((int)labels->count() > quantityOfLabels)
+    {
+        labelsLayer->removeChild((CCNode*)labels->lastObject(), true);
+        labels->removeLastObject();
+    }
+
+    benchmarkTime = 0;
+    numberOfRuns = 0;
+}
+
+void LabelMainScene::update(float dt)
+{
+    struct cc_timeval start, end;
+    char str[32] = {0};
+
+    frameNumber++;
+
+    CCTime::gettimeofdayCocos2d(&start, NULL);
+    unsigned int nCount = labels->count();
+    for (unsigned int i = 0; i < nCount; i++)
+    {
+        sprintf(str, "Score: %u", frameNumber * 7 + i);
+        dynamic_cast<CCLabelProtocol*>(labels->objectAtIndex(i))->setString(str);
+    }
+    CCTime::gettimeofdayCocos2d(&end, NULL);
+
+    benchmarkTime += CCTime::timersubCocos2d(&start, &end);
+    numberOfRuns++;
+
+    elapsedTime += dt;
+    if (elapsedTime > 1.0f)
+    {
+        CCLabelTTF *timeLabel = (CCLabelTTF *) getChildByTag(kTagTimeLayer);
+        sprintf(str, "%.3f ms", numberOfRuns ? benchmarkTime / numberOfRuns : 0.0);
+        timeLabel->setString(str);
+
+        elapsedTime = 0;
+        benchmarkTime = 0;
+        numberOfRuns = 0;
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// PerfLabelTTFTest
+//
+////////////////////////////////////////////////////////
+CCNode* PerfLabelTTFTest::createLabel(const char *pszString)
+{
+    return CCLabelTTF::create(pszString, "Marker Felt", 24);
+}
+
+std::string PerfLabelTTFTest::title()
+{
+    return "A - CCLabelTTF";
+}
+
+std::string PerfLabelTTFTest::subtitle()
+{
+    return "setString on every label, every frame. See the time per frame";
+}
+
+////////////////////////////////////////////////////////
+//
+// LabelGlyphAtlasTest
+//
+////////////////////////////////////////////////////////
+CCNode* LabelGlyphAtlasTest::createLabel(const char *pszString)
+{
+    return CCLabelGlyphAtlas::create(pszString, "Marker Felt", 24);
+}
+
+std::string LabelGlyphAtlasTest::title()
+{
+    return "B - CCLabelGlyphAtlas";
+}
+
+std::string LabelGlyphAtlasTest::subtitle()
+{
+    return "setString on every label, every frame. See the time per frame";
+}
+
+////////////////////////////////////////////////////////
+//
+// LabelBMFontTest
+//
+////////////////////////////////////////////////////////
+CCNode* LabelBMFontTest::createLabel(const char *pszString)
+{
+    return CCLabelBMFont::create(pszString, "fonts/bitmapFontTest3.fnt");
+}
+
+std::string LabelBMFontTest::title()
+{
+    return "C - CCLabelBMFont";
+}
+
+std::string LabelBMFontTest::subtitle()
+{
+    return "Only the quads of the changed characters are updated";
+}
+
+////////////////////////////////////////////////////////
+//
+// LabelBMFontSpritesTest
+//
+////////////////////////////////////////////////////////
+CCNode* LabelBMFontSpritesTest::createLabel(const char *pszString)
+{
+    CCLabelBMFont *pLabel = CCLabelBMFont::create(pszString, "fonts/bitmapFontTest3.fnt");
+    // asking for a character turns the label into one sprite per character
+    pLabel->getChildByTag(0);
+    return pLabel;
+}
+
+std::string LabelBMFontSpritesTest::title()
+{
+    return "D - CCLabelBMFont with sprites";
+}
+
+std::string LabelBMFontSpritesTest::subtitle()
+{
+    return "Every character is a CCSprite, as when they are animated";
+}
+
+void runLabelTest()
+{
+    LabelMainScene* pScene = new PerfLabelTTFTest();
+    pScene->initWithQuantityOfLabels(kLabelsIncrease * 10);
+
+    CCDirector::sharedDirector()->replaceScene(pScene);
+    pScene->release();
+}
@@ -0,0 +1,83 @@
+#ifndef __PERFORMANCE_LABEL_TEST_H__
+#define __PERFORMANCE_LABEL_TEST_H__
+
+#include "PerformanceTest.h"
+
+class LabelMenuLayer : public PerformBasicLayer
+{
+public:
+    LabelMenuLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+    virtual void showCurrentTest();
+};
+
+class LabelMainScene : public CCScene
+{
+public:
+    LabelMainScene();
+    ~LabelMainScene();
+
+    virtual void initWithQuantityOfLabels(unsigned int nLabels);
+    virtual std::string title();
+    virtual std::string subtitle();
+    virtual void update(float dt);
+
+    // creates one of the labels whose string changes every frame
+    virtual CCNode* createLabel(const char *pszString) = 0;
+    void updateQuantityOfLabels();
+
+    void onDecrease(CCObject* pSender);
+    void onIncrease(CCObject* pSender);
+    void updateQuantityLabel();
+
+    int getQuantityOfLabels() { return quantityOfLabels; }
+
+protected:
+    int             quantityOfLabels;
+    CCArray         *labels;
+    CCNode          *labelsLayer;
+    unsigned int    frameNumber;
+
+    float           elapsedTime;
+    double          benchmarkTime;
+    int             numberOfRuns;
+};
+
+class PerfLabelTTFTest : public LabelMainScene
+{
+public:
+    virtual CCNode* createLabel(const char *pszString);
+
+    virtual std::string title();
+    virtual std::string subtitle();
+};
+
+class LabelGlyphAtlasTest : public LabelMainScene
+{
+public:
+    virtual CCNode* createLabel(const char *pszString);
+
+    virtual std::string title();
+    virtual std::string subtitle();
+};
+
+class LabelBMFontTest : public LabelMainScene
+{
+public:
+    virtual CCNode* createLabel(const char *pszString);
+
+    virtual std::string title();
+    virtual std::string subtitle();
+};
+
+class LabelBMFontSpritesTest : public LabelMainScene
+{
+public:
+    virtual CCNode* createLabel(const char *pszString);
+
+    virtual std::string title();
+    virtual std::string subtitle();
+};
+
+void runLabelTest();
+
+#endif // __PERFORMANCE_LABEL_TEST_H__
@@ -4,15 +4,17 @@ enum {
     kTagInfoLayer = 1,
     kTagMainLayer = 2,
     kTagLabelAtlas = 3,
+    kTagSortTimeLabel = 4,
 
     kTagBase = 20000,
 
-    TEST_COUNT = 4,
+    TEST_COUNT = 7,
 };
 
 enum {
     kMaxNodes = 15000,
     kNodesIncrease = 500,
+    kSortedNodes = 10000,
 };
 
 static int s_nCurCase = 0;
@@ -50,6 +52,15 @@ void NodeChildrenMenuLayer::showCurrentTest()
     case 3:
         pScene = new ReorderSpriteSheet();
         break;
+    case 4:
+        pScene = new SortChildren1();
+        break;
+    case 5:
+        pScene = new SortChildren10();
+        break;
+    case 6:
+        pScene = new SortChildren100();
+        break;
     }
     s_nCurCase = m_nCurCase;
 
@@ -555,6 +566,121 @@ std::string ReorderSpriteSheet::profilerName()
     return "reorder sprites";
 }
 
+////////////////////////////////////////////////////////
+//
+// SortChildren
+//
+////////////////////////////////////////////////////////
+void SortChildren::initWithQuantityOfNodes(unsigned int nNodes)
+{
+    container = CCNode::create();
+    addChild(container);
+
+    totalSortTime = 0;
+    totalSorts = 0;
+
+    // the sort is measured with at least 10000 children
+    NodeChildrenMainScene::initWithQuantityOfNodes(MAX(nNodes, kSortedNodes));
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+    CCLabelTTF *sortLabel = CCLabelTTF::create("0 ms", "Marker Felt", 30);
+    sortLabel->setColor(ccc3(0,200,20));
+    sortLabel->setPosition(ccp(s.width/2, s.height/2-50));
+    addChild(sortLabel, 1, kTagSortTimeLabel);
+
+    scheduleUpdate();
+}
+
+void SortChildren::updateQuantityOfNodes()
+{
+    // increase nodes
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = 0; i < (quantityOfNodes-currentQuantityOfNodes); i++)
+        {
+            container->addChild(CCNode::create(), (int)(CCRANDOM_0_1() * quantityOfNodes));
+        }
+    }
+    // decrease nodes
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = 0; i < (currentQuantityOfNodes-quantityOfNodes); i++)
+        {
+            container->removeChild((CCNode*)container->getChildren()->lastObject(), true);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+    totalSortTime = 0;
+    totalSorts = 0;
+}
+
+void SortChildren::update(float dt)
+{
+    CCArray* pChildren = container->getChildren();
+    if (pChildren == NULL || pChildren->count() == 0)
+    {
+        return;
+    }
+
+    // like an isometric map sorting by y: move some children to a new zOrder
+    unsigned int count = pChildren->count();
+    int totalToChange = count * percentOfChanges() / 100;
+    for (int i = 0; i < totalToChange; i++)
+    {
+        unsigned int index = percentOfChanges() == 100 ? i : (unsigned int)(CCRANDOM_0_1() * (count-1));
+        CCNode* pNode = (CCNode*)pChildren->objectAtIndex(index);
+        container->reorderChild(pNode, (int)(CCRANDOM_0_1() * count));
+    }
+
+    struct cc_timeval start, end;
+    CCTime::gettimeofdayCocos2d(&start, NULL);
+    container->sortAllChildren();
+    CCTime::gettimeofdayCocos2d(&end, NULL);
+
+    totalSortTime += (float)CCTime::timersubCocos2d(&start, &end);
+    totalSorts++;
+
+    char str[40] = {0};
+    sprintf(str, "%.3f ms / sort", totalSortTime / totalSorts);
+    ((CCLabelTTF*)getChildByTag(kTagSortTimeLabel))->setString(str);
+}
+
+std::string SortChildren::subtitle()
+{
+    return "Average time of sortAllChildren after reorderChild";
+}
+
+std::string SortChildren1::title()
+{
+    return "F - Sort, 1% changed";
+}
+
+int SortChildren1::percentOfChanges()
+{
+    return 1;
+}
+
+std::string SortChildren10::title()
+{
+    return "G - Sort, 10% changed";
+}
+
+int SortChildren10::percentOfChanges()
+{
+    return 10;
+}
+
+std::string SortChildren100::title()
+{
+    return "H - Sort, 100% changed";
+}
+
+int SortChildren100::percentOfChanges()
+{
+    return 100;
+}
+
 void runNodeChildrenTest()
 {
     IterateSpriteSheet* pScene = new IterateSpriteSheetCArray();
@@ -115,6 +115,43 @@ public:
     virtual std::string profilerName();
 };
 
+class SortChildren : public NodeChildrenMainScene
+{
+public:
+    virtual void initWithQuantityOfNodes(unsigned int nNodes);
+    virtual void updateQuantityOfNodes();
+    virtual void update(float dt);
+    virtual std::string subtitle();
+    // percentage of the children whose zOrder changes every frame
+    virtual int percentOfChanges() = 0;
+
+protected:
+    CCNode    *container;
+    float     totalSortTime;
+    int       totalSorts;
+};
+
+class SortChildren1 : public SortChildren
+{
+public:
+    virtual std::string title();
+    virtual int percentOfChanges();
+};
+
+class SortChildren10 : public SortChildren
+{
+public:
+    virtual std::string title();
+    virtual int percentOfChanges();
+};
+
+class SortChildren100 : public SortChildren
+{
+public:
+    virtual std::string title();
+    virtual int percentOfChanges();
+};
+
 void runNodeChildrenTest();
 
 #endif // __PERFORMANCE_NODE_CHILDREN_TEST_H__
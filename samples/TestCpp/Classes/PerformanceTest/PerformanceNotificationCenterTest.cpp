@@ -0,0 +1,177 @@
+#include "PerformanceNotificationCenterTest.h"
+
+enum
+{
+    kNames = 300,
+    kObserversPerName = 10,
+    kPostsPerName = 100,
+    kQueuedPosts = 1000,
+};
+
+// a target of kObserversPerName notifications, which counts them
+class NotificationCounter : public CCObject
+{
+public:
+    NotificationCounter(int* pReceived, int nName)
+    : m_pReceived(pReceived)
+    , m_nName(nName)
+    {
+    }
+
+    void onNotification(CCObject* pObject)
+    {
+        (*m_pReceived)++;
+    }
+
+    // removes itself while the notification is posted, and observes it again
+    void onNotificationReAdd(CCObject* pObject)
+    {
+        (*m_pReceived)++;
+        CCNotificationCenter::sharedNotificationCenter()->removeObserver(this, name(m_nName));
+        CCNotificationCenter::sharedNotificationCenter()->addObserver(this, callfuncO_selector(NotificationCounter::onNotificationReAdd), name(m_nName), NULL);
+    }
+
+    static const char* name(int nName)
+    {
+        static char str[32];
+        sprintf(str, "PerformanceNotification%d", nName);
+        return str;
+    }
+
+private:
+    int* m_pReceived;
+    int m_nName;
+};
+
+////////////////////////////////////////////////////////
+//
+// NotificationCenterPerformanceTest
+//
+////////////////////////////////////////////////////////
+void NotificationCenterPerformanceTest::showCurrentTest()
+{
+    CCDirector::sharedDirector()->replaceScene(NotificationCenterPerformanceTest::scene());
+}
+
+void NotificationCenterPerformanceTest::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    CCLabelTTF *label = CCLabelTTF::create(title().c_str(), "Arial", 40);
+    addChild(label, 1);
+    label->setPosition(ccp(s.width/2, s.height-32));
+    label->setColor(ccc3(255,255,40));
+
+    CCLabelTTF *l = CCLabelTTF::create(subtitle().c_str(), "Thonburi", 16);
+    addChild(l, 1);
+    l->setPosition(ccp(s.width/2, s.height-80));
+
+    m_pObservers = CCArray::createWithCapacity(kNames * kObserversPerName);
+    m_pObservers->retain();
+
+    performTests();
+}
+
+void NotificationCenterPerformanceTest::onExit()
+{
+    CCNotificationCenter* pCenter = CCNotificationCenter::sharedNotificationCenter();
+    CCObject* pObj = NULL;
+    int i = 0;
+    CCARRAY_FOREACH(m_pObservers, pObj)
+    {
+        pCenter->removeObserver(pObj, NotificationCounter::name(i++ / kObserversPerName));
+    }
+    CC_SAFE_RELEASE_NULL(m_pObservers);
+
+    PerformBasicLayer::onExit();
+}
+
+void NotificationCenterPerformanceTest::performTests()
+{
+    CCNotificationCenter* pCenter = CCNotificationCenter::sharedNotificationCenter();
+    struct cc_timeval start, end;
+
+    CCTime::gettimeofdayCocos2d(&start, NULL);
+    for (int i = 0; i < kNames * kObserversPerName; i++)
+    {
+        int nName = i / kObserversPerName;
+        NotificationCounter* pCounter = new NotificationCounter(&m_nReceived, nName);
+        m_pObservers->addObject(pCounter);
+        pCounter->release();
+        // the first observer of each name removes and adds itself while it is called
+        SEL_CallFuncO selector = (i % kObserversPerName) ? callfuncO_selector(NotificationCounter::onNotification) : callfuncO_selector(NotificationCounter::onNotificationReAdd);
+        pCenter->addObserver(pCounter, selector, NotificationCounter::name(nName), NULL);
+    }
+    CCTime::gettimeofdayCocos2d(&end, NULL);
+    double add = CCTime::timersubCocos2d(&start, &end);
+
+    CCTime::gettimeofdayCocos2d(&start, NULL);
+    for (int i = 0; i < kNames * kPostsPerName; i++)
+    {
+        pCenter->postNotification(NotificationCounter::name(i % kNames));
+    }
+    CCTime::gettimeofdayCocos2d(&end, NULL);
+    double post = CCTime::timersubCocos2d(&start, &end);
+
+    // all of them are posted at the next frame, once
+    m_nReceived = 0;
+    for (int i = 0; i < kQueuedPosts; i++)
+    {
+        pCenter->enqueueNotification(NotificationCounter::name(0));
+    }
+
+    char str[256] = {0};
+    sprintf(str, "add %d observers: %.3f ms\n"
+        "post: %.4f ms per notification of %d observers",
+        kNames * kObserversPerName, add, post / (kNames * kPostsPerName), kObserversPerName);
+    CCLog("\n\n--- CCNotificationCenter, %d names ---\n%s", kNames, str);
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+    CCLabelTTF *label = CCLabelTTF::create(str, "Arial", 16);
+    label->setPosition(ccp(s.width/2, s.height/2));
+    addChild(label, 1);
+
+    scheduleOnce(schedule_selector(NotificationCenterPerformanceTest::showQueuedResult), 0);
+}
+
+void NotificationCenterPerformanceTest::showQueuedResult(float dt)
+{
+    char str[128] = {0};
+    sprintf(str, "%d queued posts delivered to %d observers", kQueuedPosts, m_nReceived);
+    CCLog("%s", str);
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+    CCLabelTTF *label = CCLabelTTF::create(str, "Arial", 16);
+    label->setPosition(ccp(s.width/2, s.height/2 - 40));
+    addChild(label, 1);
+}
+
+std::string NotificationCenterPerformanceTest::title()
+{
+    return "CCNotificationCenter";
+}
+
+std::string NotificationCenterPerformanceTest::subtitle()
+{
+    char str[64] = {0};
+    sprintf(str, "%d observers of %d notifications", kNames * kObserversPerName, kNames);
+    return str;
+}
+
+CCScene* NotificationCenterPerformanceTest::scene()
+{
+    CCScene *pScene = CCScene::create();
+    NotificationCenterPerformanceTest *layer = new NotificationCenterPerformanceTest(false);
+    pScene->addChild(layer);
+    layer->release();
+
+    return pScene;
+}
+
+void runNotificationCenterPerformanceTest()
+{
+    CCScene* pScene = NotificationCenterPerformanceTest::scene();
+    CCDirector::sharedDirector()->replaceScene(pScene);
+}
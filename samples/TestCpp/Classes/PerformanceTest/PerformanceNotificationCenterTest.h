@@ -0,0 +1,32 @@
+#ifndef __PERFORMANCE_NOTIFICATION_CENTER_TEST_H__
+#define __PERFORMANCE_NOTIFICATION_CENTER_TEST_H__
+
+#include "PerformanceTest.h"
+
+class NotificationCenterPerformanceTest : public PerformBasicLayer
+{
+public:
+    NotificationCenterPerformanceTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+        ,m_nReceived(0)
+    {
+    }
+
+    virtual void showCurrentTest();
+    virtual void onEnter();
+    virtual void onExit();
+    virtual std::string title();
+    virtual std::string subtitle();
+    void performTests();
+    void showQueuedResult(float dt);
+
+    static CCScene* scene();
+
+private:
+    CCArray* m_pObservers;
+    int m_nReceived;
+};
+
+void runNotificationCenterPerformanceTest();
+
+#endif // __PERFORMANCE_NOTIFICATION_CENTER_TEST_H__
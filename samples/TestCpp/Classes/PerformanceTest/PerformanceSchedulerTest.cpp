@@ -0,0 +1,402 @@
+#include "PerformanceSchedulerTest.h"
+#include "support/data_support/uthash.h"
+#include "support/data_support/utlist.h"
+
+enum {
+    kTagInfoLayer = 1,
+    kTagTimeLayer = 2,
+
+    TEST_COUNT = 3,
+};
+
+enum {
+    kMaxTargets = 20000,
+    kTargetsIncrease = 1000,
+
+    // priorities are picked in [-kPriorityRange, kPriorityRange]
+    kPriorityRange = 50,
+};
+
+static int s_nSchedulerCurCase = 0;
+
+////////////////////////////////////////////////////////
+//
+// LegacyUpdateList
+//
+// The 'update' list used by CCScheduler before the priority buckets:
+// a single list sorted by priority, where each new target walks the list
+// to find its place. Kept here to compare both implementations.
+//
+////////////////////////////////////////////////////////
+typedef struct _legacyListEntry
+{
+    struct _legacyListEntry *prev, *next;
+    CCObject        *target;    // hash key (retained)
+    int             priority;
+    UT_hash_handle  hh;
+} tLegacyListEntry;
+
+class LegacyUpdateList
+{
+public:
+    LegacyUpdateList() : m_pList(NULL), m_pHash(NULL) {}
+
+    void scheduleUpdateForTarget(CCObject *pTarget, int nPriority)
+    {
+        tLegacyListEntry *pListElement = (tLegacyListEntry *)calloc(sizeof(*pListElement), 1);
+        pListElement->target = pTarget;
+        pListElement->priority = nPriority;
+
+        bool bAdded = false;
+        for (tLegacyListEntry *pElement = m_pList; pElement; pElement = pElement->next)
+        {
+            if (nPriority < pElement->priority)
+            {
+                if (pElement == m_pList)
+                {
+                    DL_PREPEND(m_pList, pListElement);
+                }
+                else
+                {
+                    pListElement->next = pElement;
+                    pListElement->prev = pElement->prev;
+
+                    pElement->prev->next = pListElement;
+                    pElement->prev = pListElement;
+                }
+
+                bAdded = true;
+                break;
+            }
+        }
+
+        if (! bAdded)
+        {
+            DL_APPEND(m_pList, pListElement);
+        }
+
+        pTarget->retain();
+        HASH_ADD_PTR(m_pHash, target, pListElement);
+    }
+
+    void unscheduleUpdateForTarget(CCObject *pTarget)
+    {
+        tLegacyListEntry *pElement = NULL;
+        HASH_FIND_PTR(m_pHash, &pTarget, pElement);
+        if (pElement)
+        {
+            DL_DELETE(m_pList, pElement);
+            HASH_DEL(m_pHash, pElement);
+            free(pElement);
+            pTarget->release();
+        }
+    }
+
+private:
+    tLegacyListEntry    *m_pList;
+    tLegacyListEntry    *m_pHash;
+};
+
+////////////////////////////////////////////////////////
+//
+// SchedulerMenuLayer
+//
+////////////////////////////////////////////////////////
+SchedulerMenuLayer::SchedulerMenuLayer(bool bControlMenuVisible, int nMaxCases, int nCurCase)
+: PerformBasicLayer(bControlMenuVisible, nMaxCases, nCurCase)
+{
+
+}
+
+void SchedulerMenuLayer::showCurrentTest()
+{
+    int nTargets = ((SchedulerMainScene*)getParent())->getQuantityOfTargets();
+    SchedulerMainScene* pScene = NULL;
+
+    switch (m_nCurCase)
+    {
+    case 0:
+        pScene = new ScheduleUpdateTest();
+        break;
+    case 1:
+        pScene = new ScheduleUpdateLegacyTest();
+        break;
+    case 2:
+        pScene = new TickUpdateTest();
+        break;
+    }
+    s_nSchedulerCurCase = m_nCurCase;
+
+    if (pScene)
+    {
+        pScene->initWithQuantityOfTargets(nTargets);
+
+        CCDirector::sharedDirector()->replaceScene(pScene);
+        pScene->release();
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// SchedulerMainScene
+//
+////////////////////////////////////////////////////////
+SchedulerMainScene::SchedulerMainScene()
+: quantityOfTargets(0)
+, targets(NULL)
+, priorities(NULL)
+, scheduler(NULL)
+, elapsedTime(0)
+, benchmarkTime(0)
+, numberOfRuns(0)
+{
+
+}
+
+SchedulerMainScene::~SchedulerMainScene()
+{
+    CC_SAFE_RELEASE(scheduler);
+    CC_SAFE_RELEASE(targets);
+    CC_SAFE_FREE(priorities);
+}
+
+void SchedulerMainScene::initWithQuantityOfTargets(unsigned int nTargets)
+{
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    // Title
+    CCLabelTTF *label = CCLabelTTF::create(title().c_str(), "Arial", 40);
+    addChild(label, 1);
+    label->setPosition(ccp(s.width/2, s.height-32));
+    label->setColor(ccc3(255,255,40));
+
+    // Subtitle
+    std::string strSubTitle = subtitle();
+    if(strSubTitle.length())
+    {
+        CCLabelTTF *l = CCLabelTTF::create(strSubTitle.c_str(), "Thonburi", 16);
+        addChild(l, 1);
+        l->setPosition(ccp(s.width/2, s.height-80));
+    }
+
+    quantityOfTargets = nTargets;
+    targets = CCArray::createWithCapacity(kMaxTargets);
+    targets->retain();
+    priorities = (int*)malloc(kMaxTargets * sizeof(int));
+    scheduler = new CCScheduler();
+
+    CCMenuItemFont::setFontSize(65);
+    CCMenuItemFont *decrease = CCMenuItemFont::create(" - ", this, menu_selector(SchedulerMainScene::onDecrease));
+    decrease->setColor(ccc3(0,200,20));
+    CCMenuItemFont *increase = CCMenuItemFont::create(" + ", this, menu_selector(SchedulerMainScene::onIncrease));
+    increase->setColor(ccc3(0,200,20));
+
+    CCMenu *menu = CCMenu::create(decrease, increase, NULL);
+    menu->alignItemsHorizontally();
+    menu->setPosition(ccp(s.width/2, s.height/2+15));
+    addChild(menu, 1);
+
+    CCLabelTTF *infoLabel = CCLabelTTF::create("0 targets", "Marker Felt", 30);
+    infoLabel->setColor(ccc3(0,200,20));
+    infoLabel->setPosition(ccp(s.width/2, s.height/2-15));
+    addChild(infoLabel, 1, kTagInfoLayer);
+
+    CCLabelTTF *timeLabel = CCLabelTTF::create("0.000 ms", "Marker Felt", 30);
+    timeLabel->setColor(ccc3(255,255,40));
+    timeLabel->setPosition(ccp(s.width/2, s.height/2-55));
+    addChild(timeLabel, 1, kTagTimeLayer);
+
+    SchedulerMenuLayer* pMenu = new SchedulerMenuLayer(true, TEST_COUNT, s_nSchedulerCurCase);
+    addChild(pMenu);
+    pMenu->release();
+
+    updateQuantityLabel();
+    updateQuantityOfTargets();
+
+    scheduleUpdate();
+}
+
+void SchedulerMainScene::onDecrease(CCObject* pSender)
+{
+    quantityOfTargets -= kTargetsIncrease;
+    if( quantityOfTargets < 0 )
+        quantityOfTargets = 0;
+
+    updateQuantityLabel();
+    updateQuantityOfTargets();
+}
+
+void SchedulerMainScene::onIncrease(CCObject* pSender)
+{
+    quantityOfTargets += kTargetsIncrease;
+    if( quantityOfTargets > kMaxTargets )
+        quantityOfTargets = kMaxTargets;
+
+    updateQuantityLabel();
+    updateQuantityOfTargets();
+}
+
+std::string SchedulerMainScene::title()
+{
+    return "No title";
+}
+
+std::string SchedulerMainScene::subtitle()
+{
+    return "";
+}
+
+void SchedulerMainScene::updateQuantityLabel()
+{
+    CCLabelTTF *infoLabel = (CCLabelTTF *) getChildByTag(kTagInfoLayer);
+    char str[20] = {0};
+    sprintf(str, "%u targets", quantityOfTargets);
+    infoLabel->setString(str);
+}
+
+void SchedulerMainScene::updateQuantityOfTargets()
+{
+    scheduler->unscheduleAllSelectors();
+
+    while ((int)targets->count() < quantityOfTargets)
+    {
+        CCObject *pTarget = new CCObject();
+        targets->addObject(pTarget);
+        pTarget->release();
+
+        priorities[targets->count() - 1] = (int)(CCRANDOM_MINUS1_1() * kPriorityRange);
+    }
+
+    while ((int)targets->count() > quantityOfTargets)
+    {
+        targets->removeLastObject();
+    }
+
+    benchmarkTime = 0;
+    numberOfRuns = 0;
+}
+
+void SchedulerMainScene::update(float dt)
+{
+    struct cc_timeval start, end;
+
+    CCTime::gettimeofdayCocos2d(&start, NULL);
+    runBenchmark();
+    CCTime::gettimeofdayCocos2d(&end, NULL);
+
+    benchmarkTime += CCTime::timersubCocos2d(&start, &end);
+    numberOfRuns++;
+
+    elapsedTime += dt;
+    if (elapsedTime > 1.0f)
+    {
+        CCLabelTTF *timeLabel = (CCLabelTTF *) getChildByTag(kTagTimeLayer);
+        char str[32] = {0};
+        sprintf(str, "%.3f ms", numberOfRuns ? benchmarkTime / numberOfRuns : 0.0);
+        timeLabel->setString(str);
+
+        elapsedTime = 0;
+        benchmarkTime = 0;
+        numberOfRuns = 0;
+    }
+}
+
+////////////////////////////////////////////////////////
+//
+// ScheduleUpdateTest
+//
+////////////////////////////////////////////////////////
+void ScheduleUpdateTest::runBenchmark()
+{
+    unsigned int nCount = targets->count();
+    for (unsigned int i = 0; i < nCount; i++)
+    {
+        scheduler->scheduleUpdateForTarget(targets->objectAtIndex(i), priorities[i], false);
+    }
+
+    for (unsigned int i = 0; i < nCount; i++)
+    {
+        scheduler->unscheduleUpdateForTarget(targets->objectAtIndex(i));
+    }
+}
+
+std::string ScheduleUpdateTest::title()
+{
+    return "A - schedule / unschedule";
+}
+
+std::string ScheduleUpdateTest::subtitle()
+{
+    return "CCScheduler, random priorities. See the time per frame";
+}
+
+////////////////////////////////////////////////////////
+//
+// ScheduleUpdateLegacyTest
+//
+////////////////////////////////////////////////////////
+void ScheduleUpdateLegacyTest::runBenchmark()
+{
+    LegacyUpdateList list;
+
+    unsigned int nCount = targets->count();
+    for (unsigned int i = 0; i < nCount; i++)
+    {
+        list.scheduleUpdateForTarget(targets->objectAtIndex(i), priorities[i]);
+    }
+
+    for (unsigned int i = 0; i < nCount; i++)
+    {
+        list.unscheduleUpdateForTarget(targets->objectAtIndex(i));
+    }
+}
+
+std::string ScheduleUpdateLegacyTest::title()
+{
+    return "B - schedule / unschedule";
+}
+
+std::string ScheduleUpdateLegacyTest::subtitle()
+{
+    return "Sorted list (previous scheduler), random priorities";
+}
+
+////////////////////////////////////////////////////////
+//
+// TickUpdateTest
+//
+////////////////////////////////////////////////////////
+void TickUpdateTest::updateQuantityOfTargets()
+{
+    SchedulerMainScene::updateQuantityOfTargets();
+
+    unsigned int nCount = targets->count();
+    for (unsigned int i = 0; i < nCount; i++)
+    {
+        scheduler->scheduleUpdateForTarget(targets->objectAtIndex(i), priorities[i], false);
+    }
+}
+
+void TickUpdateTest::runBenchmark()
+{
+    scheduler->update(1.0f / 60);
+}
+
+std::string TickUpdateTest::title()
+{
+    return "C - tick";
+}
+
+std::string TickUpdateTest::subtitle()
+{
+    return "CCScheduler::update, random priorities";
+}
+
+void runSchedulerTest()
+{
+    SchedulerMainScene* pScene = new ScheduleUpdateTest();
+    pScene->initWithQuantityOfTargets(kTargetsIncrease * 5);
+
+    CCDirector::sharedDirector()->replaceScene(pScene);
+    pScene->release();
+}
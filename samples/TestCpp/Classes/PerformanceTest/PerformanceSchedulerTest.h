@@ -0,0 +1,76 @@
+#ifndef __PERFORMANCE_SCHEDULER_TEST_H__
+#define __PERFORMANCE_SCHEDULER_TEST_H__
+
+#include "PerformanceTest.h"
+
+class SchedulerMenuLayer : public PerformBasicLayer
+{
+public:
+    SchedulerMenuLayer(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0);
+    virtual void showCurrentTest();
+};
+
+class SchedulerMainScene : public CCScene
+{
+public:
+    SchedulerMainScene();
+    ~SchedulerMainScene();
+
+    virtual void initWithQuantityOfTargets(unsigned int nTargets);
+    virtual std::string title();
+    virtual std::string subtitle();
+    virtual void update(float dt);
+
+    // runs the measured operation once, over all the targets
+    virtual void runBenchmark() = 0;
+    virtual void updateQuantityOfTargets();
+
+    void onDecrease(CCObject* pSender);
+    void onIncrease(CCObject* pSender);
+    void updateQuantityLabel();
+
+    int getQuantityOfTargets() { return quantityOfTargets; }
+
+protected:
+    int             quantityOfTargets;
+    CCArray         *targets;
+    int             *priorities;
+    // the targets aren't scheduled in the director's scheduler
+    CCScheduler     *scheduler;
+
+    float           elapsedTime;
+    double          benchmarkTime;
+    int             numberOfRuns;
+};
+
+class ScheduleUpdateTest : public SchedulerMainScene
+{
+public:
+    virtual void runBenchmark();
+
+    virtual std::string title();
+    virtual std::string subtitle();
+};
+
+class ScheduleUpdateLegacyTest : public SchedulerMainScene
+{
+public:
+    virtual void runBenchmark();
+
+    virtual std::string title();
+    virtual std::string subtitle();
+};
+
+class TickUpdateTest : public SchedulerMainScene
+{
+public:
+    virtual void updateQuantityOfTargets();
+    virtual void runBenchmark();
+
+    virtual std::string title();
+    virtual std::string subtitle();
+};
+
+void runSchedulerTest();
+
+#endif // __PERFORMANCE_SCHEDULER_TEST_H__
@@ -4,13 +4,15 @@ enum {
     kMaxNodes = 50000,
     kNodesIncrease = 250,
 
-    TEST_COUNT = 7,
+    TEST_COUNT = 9,
 };
 
 enum {
     kTagInfoLayer = 1,
     kTagMainLayer = 2,
     kTagMenuLayer = (kMaxNodes + 1000),
+    kTagUploadLabel = (kMaxNodes + 1001),
+    kTagCullingLabel = (kMaxNodes + 1002),
 };
 
 static int s_nSpriteCurCase = 0;
@@ -27,6 +29,11 @@ SubTest::~SubTest()
         batchNode->release();
         batchNode = NULL;
     }
+
+    if (subtestNumber == 10)
+    {
+        CCRenderQueue::sharedRenderQueue()->setAutoBatchingEnabled(false);
+    }
 }
 
 void SubTest::initWithSubTest(int nSubTest, CCNode* p)
@@ -50,6 +57,8 @@ void SubTest::initWithSubTest(int nSubTest, CCNode* p)
     *10: 64 (32-bit) PNG Batch Node of 32 x 32 each
     *11: 64 (16-bit) PNG Batch Node of 32 x 32 each
     *12: 64 (4-bit) PVRTC Batch Node of 32 x 32 each
+
+    *10: 14 (32-bit) PNG sprites of 85 x 121 each, sharing one texture and merged by CCRenderQueue
     */
 
     // purge textures
@@ -101,6 +110,11 @@ void SubTest::initWithSubTest(int nSubTest, CCNode* p)
             p->addChild(batchNode, 0);
             break;
 
+            ///
+        case 10:
+            CCRenderQueue::sharedRenderQueue()->setAutoBatchingEnabled(true);
+            break;
+
         default:
             break;
     }
@@ -190,6 +204,22 @@ CCSprite* SubTest::createSpriteWithTag(int tag)
                 break;
             }
 
+        case 10:
+            {
+                int y,x;
+                int r = (CCRANDOM_0_1() * 1400 / 100);
+
+                y = r / 5;
+                x = r % 5;
+
+                x *= 85;
+                y *= 121;
+                CCTexture2D *texture = CCTextureCache::sharedTextureCache()->addImage("Images/grossini_dance_atlas.png");
+                sprite = CCSprite::createWithTexture(texture, CCRectMake(x,y,85,121));
+                parent->addChild(sprite, 0, tag+100);
+                break;
+            }
+
         default:
             break;
     }
@@ -206,6 +236,7 @@ void SubTest::removeByTag(int tag)
         case 1:
         case 4:
         case 7:
+        case 10:
             parent->removeChildByTag(tag+100, true);
             break;
         case 2:
@@ -257,6 +288,12 @@ void SpriteMenuLayer::showCurrentTest()
     case 6:
         pScene = new SpritePerformTest7;
         break;
+    case 7:
+        pScene = new SpritePerformTest8;
+        break;
+    case 8:
+        pScene = new SpritePerformTest9;
+        break;
     }
     s_nSpriteCurCase = m_nCurCase;
 
@@ -302,6 +339,13 @@ void SpriteMainScene::initWithSubTest(int asubtest, int nNodes)
     infoLabel->setPosition(ccp(s.width/2, s.height-90));
     addChild(infoLabel, 1, kTagInfoLayer);
 
+    // bytes uploaded to the vertex buffers by the previous frame
+    CCLabelTTF *uploadLabel = CCLabelTTF::create("0 KB uploaded", "Marker Felt", 24);
+    uploadLabel->setColor(ccc3(0,200,20));
+    uploadLabel->setPosition(ccp(s.width/2, s.height-120));
+    addChild(uploadLabel, 1, kTagUploadLabel);
+    scheduleUpdate();
+
     // add menu
     SpriteMenuLayer* pMenu = new SpriteMenuLayer(true, TEST_COUNT, s_nSpriteCurCase);
     addChild(pMenu, 1, kTagMenuLayer);
@@ -310,7 +354,7 @@ void SpriteMainScene::initWithSubTest(int asubtest, int nNodes)
     // Sub Tests
     CCMenuItemFont::setFontSize(32);
     CCMenu* pSubMenu = CCMenu::create();
-    for (int i = 1; i <= 9; ++i)
+    for (int i = 1; i <= 10; ++i)
     {
         char str[10] = {0};
         sprintf(str, "%d ", i);
@@ -374,6 +418,14 @@ void SpriteMainScene::updateNodes()
     }
 }
 
+void SpriteMainScene::update(float dt)
+{
+    CCLabelTTF *uploadLabel = (CCLabelTTF *) getChildByTag(kTagUploadLabel);
+    char str[32] = {0};
+    sprintf(str, "%u KB uploaded", CCDirector::sharedDirector()->getNumberOfUploadedBytes() / 1024);
+    uploadLabel->setString(str);
+}
+
 void SpriteMainScene::onIncrease(CCObject* pSender)
 {
     if( quantityNodes >= kMaxNodes)
@@ -607,6 +659,102 @@ void SpritePerformTest7::doTest(CCSprite* sprite)
     performanceActions20(sprite);
 }
 
+////////////////////////////////////////////////////////
+//
+// SpritePerformTest8
+//
+////////////////////////////////////////////////////////
+std::string SpritePerformTest8::title()
+{
+    char str[32] = {0};
+    sprintf(str, "H (%d) culling", subtestNumber);
+    std::string strRet = str;
+    return strRet;
+}
+
+void SpritePerformTest8::onEnter()
+{
+    SpriteMainScene::onEnter();
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+    CCLabelTTF *cullingLabel = CCLabelTTF::create("0 drawn, 0 culled", "Marker Felt", 24);
+    cullingLabel->setColor(ccc3(0,200,20));
+    cullingLabel->setPosition(ccp(s.width/2, s.height-150));
+    addChild(cullingLabel, 1, kTagCullingLabel);
+
+    CCDirector::sharedDirector()->setCullingEnabled(true);
+}
+
+void SpritePerformTest8::onExit()
+{
+    CCDirector::sharedDirector()->setCullingEnabled(false);
+
+    SpriteMainScene::onExit();
+}
+
+void SpritePerformTest8::update(float dt)
+{
+    SpriteMainScene::update(dt);
+
+    CCLabelTTF *cullingLabel = (CCLabelTTF *) getChildByTag(kTagCullingLabel);
+    if (cullingLabel)
+    {
+        char str[48] = {0};
+        sprintf(str, "%u drawn, %u culled", CCDirector::sharedDirector()->getNumberOfDrawnNodes(), CCDirector::sharedDirector()->getNumberOfCulledNodes());
+        cullingLabel->setString(str);
+    }
+}
+
+void SpritePerformTest8::doTest(CCSprite* sprite)
+{
+    // sprites spread over 4 screens that move in and out of the visible one
+    CCSize size = CCDirector::sharedDirector()->getWinSize();
+    sprite->setPosition(ccp((rand() % (int)(size.width * 2)) - size.width / 2, (rand() % (int)(size.height * 2)) - size.height / 2));
+
+    float period = 1.0f + (rand() % 1000) / 500.0f;
+    CCActionInterval* move = CCMoveBy::create(period, ccp((CCRANDOM_0_1() - 0.5f) * size.width, (CCRANDOM_0_1() - 0.5f) * size.height));
+    sprite->runAction(CCRepeatForever::create(CCSequence::createWithTwoActions(move, move->reverse())));
+}
+
+////////////////////////////////////////////////////////
+//
+// SpritePerformTest9
+//
+////////////////////////////////////////////////////////
+std::string SpritePerformTest9::title()
+{
+    char str[32] = {0};
+    sprintf(str, "I (%d) parallel update", subtestNumber);
+    std::string strRet = str;
+    return strRet;
+}
+
+void SpritePerformTest9::onEnter()
+{
+    SpriteMainScene::onEnter();
+
+    // only the sub tests that use a batch node are updated in parallel
+    CCSpriteBatchNode* pBatchNode = m_pSubTest->getBatchNode();
+    if (pBatchNode)
+    {
+        pBatchNode->setParallelUpdateEnabled(true);
+    }
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+    char str[32] = {0};
+    sprintf(str, pBatchNode ? "%u threads" : "no batch node", CCJobSystem::sharedJobSystem()->getThreadCount());
+    CCLabelTTF *threadsLabel = CCLabelTTF::create(str, "Marker Felt", 24);
+    threadsLabel->setColor(ccc3(0,200,20));
+    threadsLabel->setPosition(ccp(s.width/2, s.height-150));
+    addChild(threadsLabel, 1);
+}
+
+void SpritePerformTest9::doTest(CCSprite* sprite)
+{
+    // every sprite moves at every frame
+    performanceActions(sprite);
+}
+
 void runSpriteTest()
 {
     SpriteMainScene* pScene = new SpritePerformTest1;
@@ -10,6 +10,7 @@ public:
     void removeByTag(int tag);
     CCSprite* createSpriteWithTag(int tag);
     void initWithSubTest(int nSubTest, CCNode* parent);
+    CCSpriteBatchNode* getBatchNode() { return batchNode; }
 
 protected:
     int                    subtestNumber;
@@ -36,6 +37,7 @@ public:
 
     void initWithSubTest(int nSubTest, int nNodes);
     void updateNodes();
+    virtual void update(float dt);
 
     void testNCallback(CCObject* pSender);
     void onIncrease(CCObject* pSender);
@@ -102,6 +104,24 @@ public:
     virtual std::string title();
 };
 
+class SpritePerformTest8 : public SpriteMainScene
+{
+public:
+    virtual void onEnter();
+    virtual void onExit();
+    virtual void update(float dt);
+    virtual void doTest(CCSprite* sprite);
+    virtual std::string title();
+};
+
+class SpritePerformTest9 : public SpriteMainScene
+{
+public:
+    virtual void onEnter();
+    virtual void doTest(CCSprite* sprite);
+    virtual std::string title();
+};
+
 void runSpriteTest();
 
 #endif
@@ -5,11 +5,15 @@
 #include "PerformanceSpriteTest.h"
 #include "PerformanceTextureTest.h"
 #include "PerformanceTouchesTest.h"
+#include "PerformanceSchedulerTest.h"
+#include "PerformanceLabelTest.h"
+#include "PerformanceCCBReaderTest.h"
+#include "PerformanceNotificationCenterTest.h"
 
 enum
 {
-    MAX_COUNT = 5,
-    LINE_SPACE = 40,
+    MAX_COUNT = 9,
+    LINE_SPACE = 32,
     kItemTagBasic = 1000,
 };
 
@@ -19,7 +23,11 @@ const std::string testsName[MAX_COUNT] =
     "PerformanceParticleTest",
     "PerformanceSpriteTest",
     "PerformanceTextureTest",
-    "PerformanceTouchesTest"
+    "PerformanceTouchesTest",
+    "PerformanceSchedulerTest",
+    "PerformanceLabelTest",
+    "PerformanceCCBReaderTest",
+    "PerformanceNotificationCenterTest"
 };
 
 ////////////////////////////////////////////////////////
@@ -70,6 +78,18 @@ void PerformanceMainLayer::menuCallback(CCObject* pSender)
     case 4:
         runTouchesTest();
         break;
+    case 5:
+        runSchedulerTest();
+        break;
+    case 6:
+        runLabelTest();
+        break;
+    case 7:
+        runCCBReaderTest();
+        break;
+    case 8:
+        runNotificationCenterPerformanceTest();
+        break;
     default:
         break;
     }
@@ -1,8 +1,12 @@
 #include "PerformanceTextureTest.h"
+#include "../testResource.h"
+#include "support/ccPixelConversion.h"
+#include "support/zip_support/ZipUtils.h"
+#include "support/zip_support/unzip.h"
 
 enum
 {
-    TEST_COUNT = 1,
+    TEST_COUNT = 4,
 };
 
 static int s_nTexCurCase = 0;
@@ -32,6 +36,15 @@ void TextureMenuLayer::showCurrentTest()
     case 0:
         pScene = TextureTest::scene();
         break;
+    case 1:
+        pScene = TextureAsyncLoadTest::scene();
+        break;
+    case 2:
+        pScene = TexturePixelConversionTest::scene();
+        break;
+    case 3:
+        pScene = ZipArchiveLoadTest::scene();
+        break;
     }
     s_nTexCurCase = m_nCurCase;
 
@@ -345,7 +358,567 @@ std::string TextureTest::subtitle()
 CCScene* TextureTest::scene()
 {
     CCScene *pScene = CCScene::create();
-    TextureTest *layer = new TextureTest(false, TEST_COUNT, s_nTexCurCase);
+    TextureTest *layer = new TextureTest(true, TEST_COUNT, s_nTexCurCase);
+    pScene->addChild(layer);
+    layer->release();
+
+    return pScene;
+}
+
+////////////////////////////////////////////////////////
+//
+// TextureAsyncLoadTest
+//
+////////////////////////////////////////////////////////
+static const char* s_pAsyncLoadImages[] =
+{
+    "Images/background1.jpg",
+    "Images/background2.jpg",
+    "Images/background.png",
+    "Images/atlastest.png",
+    "Images/grossini_dance_atlas.png",
+    "Images/texture512x512.png",
+    "Images/texture1024x1024.png",
+    "Images/PlanetCute-1024x1024.png",
+    "Images/landscape-1024x1024.png",
+};
+
+void TextureAsyncLoadTest::performTests()
+{
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    m_pResultLabel = CCLabelTTF::create("Loading...", "Marker Felt", 24);
+    m_pResultLabel->setPosition(ccp(s.width/2, s.height/2));
+    addChild(m_pResultLabel, 1);
+
+    CCTextureCache *cache = CCTextureCache::sharedTextureCache();
+    CCTexture2D::setDefaultAlphaPixelFormat(kCCTexture2DPixelFormat_Default);
+
+    std::vector<std::string> files;
+    for (int i = 0; i < 8; i++)
+    {
+        for (int j = 0; j < 8; j++)
+        {
+            char szSpriteName[100] = {0};
+            sprintf(szSpriteName, "Images/sprites_test/sprite-%d-%d.png", i, j);
+            files.push_back(szSpriteName);
+        }
+    }
+    for (unsigned int i = 0; i < sizeof(s_pAsyncLoadImages) / sizeof(s_pAsyncLoadImages[0]); i++)
+    {
+        files.push_back(s_pAsyncLoadImages[i]);
+    }
+
+    // make sure every image is decoded again
+    for (unsigned int i = 0; i < files.size(); i++)
+    {
+        cache->removeTextureForKey(CCFileUtils::sharedFileUtils()->fullPathFromRelativePath(files[i].c_str()));
+    }
+
+    m_nImagesToLoad = (int)files.size();
+    m_nImagesLoaded = 0;
+    m_dWorstFrame = 0;
+
+    CCTime::gettimeofdayCocos2d(&m_tStart, NULL);
+    m_tLastFrame = m_tStart;
+    scheduleUpdate();
+
+    for (unsigned int i = 0; i < files.size(); i++)
+    {
+        cache->addImageAsync(files[i].c_str(), this, callfuncO_selector(TextureAsyncLoadTest::imageLoaded));
+    }
+}
+
+void TextureAsyncLoadTest::update(float dt)
+{
+    struct cc_timeval now;
+    CCTime::gettimeofdayCocos2d(&now, NULL);
+
+    m_dWorstFrame = MAX(m_dWorstFrame, CCTime::timersubCocos2d(&m_tLastFrame, &now));
+    m_tLastFrame = now;
+}
+
+void TextureAsyncLoadTest::imageLoaded(CCObject* pObj)
+{
+    if (++m_nImagesLoaded < m_nImagesToLoad)
+    {
+        return;
+    }
+
+    unscheduleUpdate();
+
+    struct cc_timeval now;
+    CCTime::gettimeofdayCocos2d(&now, NULL);
+
+    char str[128] = {0};
+    sprintf(str, "%d images: %.1f ms total, %.1f ms worst frame", m_nImagesToLoad,
+        CCTime::timersubCocos2d(&m_tStart, &now), m_dWorstFrame);
+    m_pResultLabel->setString(str);
+    CCLog("%s", str);
+}
+
+std::string TextureAsyncLoadTest::title()
+{
+    return "Async Texture Loading";
+}
+
+std::string TextureAsyncLoadTest::subtitle()
+{
+    char str[128] = {0};
+    sprintf(str, "%u loading threads, %.1f ms upload budget per frame",
+        CCTextureCache::getAsyncLoadingThreadCount(), CCTextureCache::getAsyncUploadTimeBudget());
+    return str;
+}
+
+CCScene* TextureAsyncLoadTest::scene()
+{
+    CCScene *pScene = CCScene::create();
+    TextureAsyncLoadTest *layer = new TextureAsyncLoadTest(true, TEST_COUNT, s_nTexCurCase);
+    pScene->addChild(layer);
+    layer->release();
+
+    return pScene;
+}
+
+////////////////////////////////////////////////////////
+//
+// TexturePixelConversionTest
+//
+////////////////////////////////////////////////////////
+
+// the per pixel loops CCTexture2D used before the conversion routines. Used as reference
+static void referenceRGBA8888ToRGB565(const unsigned char* in, unsigned short* out, unsigned int length)
+{
+    const unsigned int *inPixel32 = (const unsigned int*)in;
+    for(unsigned int i = 0; i < length; ++i, ++inPixel32)
+    {
+        *out++ = 
+        ((((*inPixel32 >>  0) & 0xFF) >> 3) << 11) |  // R
+        ((((*inPixel32 >>  8) & 0xFF) >> 2) << 5)  |  // G
+        ((((*inPixel32 >> 16) & 0xFF) >> 3) << 0);    // B
+    }
+}
+
+static void referenceRGBA8888ToRGBA4444(const unsigned char* in, unsigned short* out, unsigned int length)
+{
+    const unsigned int *inPixel32 = (const unsigned int*)in;
+    for(unsigned int i = 0; i < length; ++i, ++inPixel32)
+    {
+        *out++ = 
+        ((((*inPixel32 >> 0) & 0xFF) >> 4) << 12) | // R
+        ((((*inPixel32 >> 8) & 0xFF) >> 4) <<  8) | // G
+        ((((*inPixel32 >> 16) & 0xFF) >> 4) << 4) | // B
+        ((((*inPixel32 >> 24) & 0xFF) >> 4) << 0);  // A
+    }
+}
+
+static void referenceRGBA8888ToRGB5A1(const unsigned char* in, unsigned short* out, unsigned int length)
+{
+    const unsigned int *inPixel32 = (const unsigned int*)in;
+    for(unsigned int i = 0; i < length; ++i, ++inPixel32)
+    {
+        *out++ = 
+        ((((*inPixel32 >> 0) & 0xFF) >> 3) << 11) | // R
+        ((((*inPixel32 >> 8) & 0xFF) >> 3) <<  6) | // G
+        ((((*inPixel32 >> 16) & 0xFF) >> 3) << 1) | // B
+        ((((*inPixel32 >> 24) & 0xFF) >> 7) << 0);  // A
+    }
+}
+
+static void referenceRGBA8888ToA8(const unsigned char* in, unsigned char* out, unsigned int length)
+{
+    const unsigned int *inPixel32 = (const unsigned int*)in;
+    for(unsigned int i = 0; i < length; ++i, ++inPixel32)
+    {
+        *out++ = (*inPixel32 >> 24) & 0xFF;  // A
+    }
+}
+
+static void referenceRGBA8888ToRGB888(const unsigned char* in, unsigned char* out, unsigned int length)
+{
+    const unsigned int *inPixel32 = (const unsigned int*)in;
+    for(unsigned int i = 0; i < length; ++i, ++inPixel32)
+    {
+        *out++ = (*inPixel32 >> 0) & 0xFF; // R
+        *out++ = (*inPixel32 >> 8) & 0xFF; // G
+        *out++ = (*inPixel32 >> 16) & 0xFF; // B
+    }
+}
+
+typedef void (*PixelConversion16)(const unsigned char*, unsigned short*, unsigned int);
+typedef void (*PixelConversion8)(const unsigned char*, unsigned char*, unsigned int);
+
+enum {
+    kConversionSize = 2048,
+    kConversionRuns = 5,
+};
+
+static double pixelsPerSecond(double milliseconds)
+{
+    return (double)kConversionSize * kConversionSize * kConversionRuns / (milliseconds * 1000.0);
+}
+
+void TexturePixelConversionTest::performTests()
+{
+    unsigned int length = kConversionSize * kConversionSize;
+    unsigned char *in = new unsigned char[length * 4];
+    unsigned char *out = new unsigned char[length * 3];
+    unsigned char *reference = new unsigned char[length * 3];
+
+    for (unsigned int i = 0; i < length * 4; i++)
+    {
+        in[i] = (unsigned char)(CCRANDOM_0_1() * 255);
+    }
+
+    const char *names[] = { "RGB565", "RGBA4444", "RGB5A1", "A8", "RGB888" };
+    PixelConversion16 conversions16[] = { ccConvertRGBA8888ToRGB565, ccConvertRGBA8888ToRGBA4444, ccConvertRGBA8888ToRGB5A1 };
+    PixelConversion16 references16[] = { referenceRGBA8888ToRGB565, referenceRGBA8888ToRGBA4444, referenceRGBA8888ToRGB5A1 };
+    PixelConversion8 conversions8[] = { ccConvertRGBA8888ToA8, ccConvertRGBA8888ToRGB888 };
+    PixelConversion8 references8[] = { referenceRGBA8888ToA8, referenceRGBA8888ToRGB888 };
+    unsigned int bytesPerPixel[] = { 2, 2, 2, 1, 3 };
+
+    CCLog("\n\n--- RGBA8888 %dx%d conversion (%s) ---\n", kConversionSize, kConversionSize, ccPixelConversionInstructionSet());
+
+    std::string results;
+    for (int format = 0; format < 5; format++)
+    {
+        struct cc_timeval start, middle, end;
+
+        CCTime::gettimeofdayCocos2d(&start, NULL);
+        for (int run = 0; run < kConversionRuns; run++)
+        {
+            if (format < 3)
+                references16[format](in, (unsigned short*)reference, length);
+            else
+                references8[format - 3](in, reference, length);
+        }
+        CCTime::gettimeofdayCocos2d(&middle, NULL);
+        for (int run = 0; run < kConversionRuns; run++)
+        {
+            if (format < 3)
+                conversions16[format](in, (unsigned short*)out, length);
+            else
+                conversions8[format - 3](in, out, length);
+        }
+        CCTime::gettimeofdayCocos2d(&end, NULL);
+
+        bool bExact = memcmp(out, reference, length * bytesPerPixel[format]) == 0;
+
+        char str[128] = {0};
+        sprintf(str, "%s: %.1f MPixels/s (per pixel loop: %.1f MPixels/s) %s",
+            names[format],
+            pixelsPerSecond(CCTime::timersubCocos2d(&middle, &end)),
+            pixelsPerSecond(CCTime::timersubCocos2d(&start, &middle)),
+            bExact ? "" : "MISMATCH");
+        CCLog("%s", str);
+
+        results += str;
+        results += "\n";
+    }
+
+    delete [] in;
+    delete [] out;
+    delete [] reference;
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+    CCLabelTTF *label = CCLabelTTF::create(results.c_str(), "Arial", 16);
+    label->setPosition(ccp(s.width/2, s.height/2));
+    addChild(label, 1);
+}
+
+std::string TexturePixelConversionTest::title()
+{
+    return "Pixel Format Conversion";
+}
+
+std::string TexturePixelConversionTest::subtitle()
+{
+    char str[64] = {0};
+    sprintf(str, "RGBA8888 %dx%d, %s routines", kConversionSize, kConversionSize, ccPixelConversionInstructionSet());
+    return str;
+}
+
+CCScene* TexturePixelConversionTest::scene()
+{
+    CCScene *pScene = CCScene::create();
+    TexturePixelConversionTest *layer = new TexturePixelConversionTest(true, TEST_COUNT, s_nTexCurCase);
+    pScene->addChild(layer);
+    layer->release();
+
+    return pScene;
+}
+
+////////////////////////////////////////////////////////
+//
+// ZipArchiveLoadTest
+//
+////////////////////////////////////////////////////////
+enum
+{
+    kZipEntries = 5000,
+    kZipEntrySize = 1024,
+    kZipLoads = 2000,
+    kZipMinizipLoads = 100,
+};
+
+static unsigned int zipCrc32(const unsigned char* data, unsigned int length)
+{
+    unsigned int crc = 0xffffffff;
+    for (unsigned int i = 0; i < length; i++)
+    {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static void zipWrite16(FILE* fp, unsigned int value)
+{
+    fputc(value & 0xff, fp);
+    fputc((value >> 8) & 0xff, fp);
+}
+
+static void zipWrite32(FILE* fp, unsigned int value)
+{
+    zipWrite16(fp, value & 0xffff);
+    zipWrite16(fp, value >> 16);
+}
+
+static void zipEntryName(char* name, int index)
+{
+    sprintf(name, "assets/dir%02d/asset%04d.bin", index % 50, index);
+}
+
+// what getFileDataFromZip used to do: open the archive with minizip and scan its directory for every file
+static unsigned char* minizipFileData(const char* path, const char* name, unsigned long* size)
+{
+    unsigned char* data = NULL;
+    unzFile file = unzOpen(path);
+    if (! file)
+    {
+        return NULL;
+    }
+
+    unz_file_info info;
+    if (unzLocateFile(file, name, 1) == UNZ_OK &&
+        unzGetCurrentFileInfo(file, &info, NULL, 0, NULL, 0, NULL, 0) == UNZ_OK &&
+        unzOpenCurrentFile(file) == UNZ_OK)
+    {
+        data = new unsigned char[info.uncompressed_size];
+        *size = unzReadCurrentFile(file, data, info.uncompressed_size);
+        unzCloseCurrentFile(file);
+    }
+    unzClose(file);
+    return data;
+}
+
+// name and content of the entry at index. The last entry is the extra one
+static void zipEntry(int index, char* name, unsigned char* buffer, const char* pszExtraName, const unsigned char* pExtraData, unsigned int uExtraSize,
+                     const unsigned char** data, unsigned int* size)
+{
+    if (index == kZipEntries)
+    {
+        strcpy(name, pszExtraName);
+        *data = pExtraData;
+        *size = uExtraSize;
+        return;
+    }
+
+    for (int j = 0; j < kZipEntrySize; j++)
+    {
+        buffer[j] = (unsigned char)(index + j);
+    }
+    zipEntryName(name, index);
+    *data = buffer;
+    *size = kZipEntrySize;
+}
+
+// writes an archive of kZipEntries stored entries, plus an extra one
+bool ZipArchiveLoadTest::writeArchive(const char* path, const char* pszExtraName, const unsigned char* pExtraData, unsigned int uExtraSize)
+{
+    FILE* fp = fopen(path, "wb");
+    if (! fp)
+    {
+        return false;
+    }
+
+    unsigned char buffer[kZipEntrySize];
+    const unsigned char* data = NULL;
+    unsigned int size = 0;
+    unsigned int* crcs = new unsigned int[kZipEntries + 1];
+    unsigned int* offsets = new unsigned int[kZipEntries + 1];
+    char name[256];
+
+    for (int i = 0; i <= kZipEntries; i++)
+    {
+        zipEntry(i, name, buffer, pszExtraName, pExtraData, uExtraSize, &data, &size);
+        crcs[i] = zipCrc32(data, size);
+        offsets[i] = (unsigned int)ftell(fp);
+
+        // local file header
+        zipWrite32(fp, 0x04034b50);
+        zipWrite16(fp, 10);                 // version needed
+        zipWrite16(fp, 0);                  // flags
+        zipWrite16(fp, 0);                  // stored
+        zipWrite32(fp, 0);                  // time, date
+        zipWrite32(fp, crcs[i]);
+        zipWrite32(fp, size);
+        zipWrite32(fp, size);
+        zipWrite16(fp, strlen(name));
+        zipWrite16(fp, 0);
+        fwrite(name, 1, strlen(name), fp);
+        fwrite(data, 1, size, fp);
+    }
+
+    unsigned int directoryOffset = (unsigned int)ftell(fp);
+    for (int i = 0; i <= kZipEntries; i++)
+    {
+        zipEntry(i, name, buffer, pszExtraName, pExtraData, uExtraSize, &data, &size);
+
+        // central directory header
+        zipWrite32(fp, 0x02014b50);
+        zipWrite16(fp, 10);                 // version made by
+        zipWrite16(fp, 10);                 // version needed
+        zipWrite16(fp, 0);                  // flags
+        zipWrite16(fp, 0);                  // stored
+        zipWrite32(fp, 0);                  // time, date
+        zipWrite32(fp, crcs[i]);
+        zipWrite32(fp, size);
+        zipWrite32(fp, size);
+        zipWrite16(fp, strlen(name));
+        zipWrite16(fp, 0);                  // extra field
+        zipWrite16(fp, 0);                  // comment
+        zipWrite16(fp, 0);                  // disk
+        zipWrite16(fp, 0);                  // internal attributes
+        zipWrite32(fp, 0);                  // external attributes
+        zipWrite32(fp, offsets[i]);
+        fwrite(name, 1, strlen(name), fp);
+    }
+    unsigned int directorySize = (unsigned int)ftell(fp) - directoryOffset;
+
+    // end of central directory
+    zipWrite32(fp, 0x06054b50);
+    zipWrite16(fp, 0);
+    zipWrite16(fp, 0);
+    zipWrite16(fp, kZipEntries + 1);
+    zipWrite16(fp, kZipEntries + 1);
+    zipWrite32(fp, directorySize);
+    zipWrite32(fp, directoryOffset);
+    zipWrite16(fp, 0);
+
+    delete [] crcs;
+    delete [] offsets;
+    return fclose(fp) == 0;
+}
+
+void ZipArchiveLoadTest::performTests()
+{
+    std::string path = CCFileUtils::sharedFileUtils()->getWriteablePath() + "perf_archive.zip";
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    // the archive replaces grossini by his sister
+    unsigned long sisterSize = 0;
+    unsigned char* sisterData = CCFileUtils::sharedFileUtils()->getFileData(CCFileUtils::sharedFileUtils()->fullPathFromRelativePath(s_pPathSister1), "rb", &sisterSize);
+    bool bWritten = sisterData && writeArchive(path.c_str(), "assets/Images/grossini.png", sisterData, sisterSize);
+    CC_SAFE_DELETE_ARRAY(sisterData);
+
+    if (! bWritten)
+    {
+        CCLabelTTF *label = CCLabelTTF::create("Couldn't write the archive", "Arial", 16);
+        label->setPosition(ccp(s.width/2, s.height/2));
+        addChild(label, 1);
+        return;
+    }
+
+    CCLog("\n\n--- random loads out of a %d entries zip: %d with minizip, %d through ZipFile ---\n", kZipEntries, kZipMinizipLoads, kZipLoads);
+
+    struct cc_timeval start, end;
+    char name[64];
+    unsigned long size = 0;
+    bool bExact = true;
+
+    // the old path, it is slow: fewer loads
+    CCTime::gettimeofdayCocos2d(&start, NULL);
+    for (int i = 0; i < kZipMinizipLoads; i++)
+    {
+        zipEntryName(name, (int)(CCRANDOM_0_1() * (kZipEntries - 1)));
+        unsigned char* data = minizipFileData(path.c_str(), name, &size);
+        bExact = bExact && data && size == kZipEntrySize;
+        delete [] data;
+    }
+    CCTime::gettimeofdayCocos2d(&end, NULL);
+    double minizipTime = CCTime::timersubCocos2d(&start, &end) / kZipMinizipLoads;
+
+    // the archive is indexed once by the first load
+    CCTime::gettimeofdayCocos2d(&start, NULL);
+    for (int i = 0; i < kZipLoads; i++)
+    {
+        zipEntryName(name, (int)(CCRANDOM_0_1() * (kZipEntries - 1)));
+        unsigned char* data = CCFileUtils::sharedFileUtils()->getFileDataFromZip(path.c_str(), name, &size);
+        bExact = bExact && data && size == kZipEntrySize && data[1] == (unsigned char)(atoi(name + 18) + 1);
+        delete [] data;
+    }
+    CCTime::gettimeofdayCocos2d(&end, NULL);
+    double indexedTime = CCTime::timersubCocos2d(&start, &end) / kZipLoads;
+
+    // stored entries straight from the mapping
+    ZipFile* pZipFile = ZipFile::sharedZipFile(path.c_str());
+    CCTime::gettimeofdayCocos2d(&start, NULL);
+    for (int i = 0; i < kZipLoads && pZipFile; i++)
+    {
+        zipEntryName(name, (int)(CCRANDOM_0_1() * (kZipEntries - 1)));
+        const unsigned char* data = pZipFile->getMappedFileData(name, &size);
+        bExact = bExact && data && size == kZipEntrySize;
+    }
+    CCTime::gettimeofdayCocos2d(&end, NULL);
+    double mappedTime = CCTime::timersubCocos2d(&start, &end) / kZipLoads;
+
+    char str[256] = {0};
+    sprintf(str, "minizip, reopened per load: %.4f ms / load\nindexed (getFileDataFromZip): %.4f ms / load\nmapped, no copy: %.4f ms / load\n%s",
+        minizipTime, indexedTime, mappedTime, bExact ? "" : "MISMATCH");
+    CCLog("%s", str);
+
+    CCLabelTTF *label = CCLabelTTF::create(str, "Arial", 16);
+    label->setPosition(ccp(s.width/2, s.height/2));
+    addChild(label, 1);
+
+    // a sprite loaded through addSearchArchive: the archive entry wins over the file with the same name
+    CCTextureCache::sharedTextureCache()->removeTextureForKey(s_pPathGrossini);
+    CCFileUtils::sharedFileUtils()->addSearchArchive(path.c_str(), "assets/");
+    CCSprite* pZipped = CCSprite::create(s_pPathGrossini);
+    CCFileUtils::sharedFileUtils()->removeAllSearchArchives();
+    CCTextureCache::sharedTextureCache()->removeTextureForKey(s_pPathGrossini);
+
+    CCSprite* pSister = CCSprite::create(s_pPathSister1);
+    bool bFromArchive = pZipped && pSister && pZipped->getContentSize().equals(pSister->getContentSize());
+    CCLog("sprite loaded through the archive: %s", bFromArchive ? "ok" : "MISMATCH");
+
+    if (pZipped && pSister)
+    {
+        pZipped->setPosition(ccp(s.width/2 - 50, s.height/4));
+        addChild(pZipped, 1);
+        pSister->setPosition(ccp(s.width/2 + 50, s.height/4));
+        addChild(pSister, 1);
+    }
+}
+
+std::string ZipArchiveLoadTest::title()
+{
+    return "Zip Archive Loads";
+}
+
+std::string ZipArchiveLoadTest::subtitle()
+{
+    return "Random loads out of a 5000 entries archive. See console\nThe two sprites must be grossini's sister";
+}
+
+CCScene* ZipArchiveLoadTest::scene()
+{
+    CCScene *pScene = CCScene::create();
+    ZipArchiveLoadTest *layer = new ZipArchiveLoadTest(true, TEST_COUNT, s_nTexCurCase);
     pScene->addChild(layer);
     layer->release();
 
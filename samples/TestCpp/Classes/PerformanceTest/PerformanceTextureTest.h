@@ -35,6 +35,62 @@ public:
     static CCScene* scene();
 };
 
+class TextureAsyncLoadTest : public TextureMenuLayer
+{
+public:
+    TextureAsyncLoadTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title();
+    virtual std::string subtitle();
+    virtual void update(float dt);
+    void imageLoaded(CCObject* pObj);
+
+    static CCScene* scene();
+
+protected:
+    CCLabelTTF          *m_pResultLabel;
+    int                 m_nImagesToLoad;
+    int                 m_nImagesLoaded;
+    struct cc_timeval   m_tStart;
+    struct cc_timeval   m_tLastFrame;
+    double              m_dWorstFrame;
+};
+
+class TexturePixelConversionTest : public TextureMenuLayer
+{
+public:
+    TexturePixelConversionTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title();
+    virtual std::string subtitle();
+
+    static CCScene* scene();
+};
+
+class ZipArchiveLoadTest : public TextureMenuLayer
+{
+public:
+    ZipArchiveLoadTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title();
+    virtual std::string subtitle();
+    bool writeArchive(const char* path, const char* pszExtraName, const unsigned char* pExtraData, unsigned int uExtraSize);
+
+    static CCScene* scene();
+};
+
 void runTextureTest();
 
 #endif
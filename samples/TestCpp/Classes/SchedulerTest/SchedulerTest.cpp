@@ -5,7 +5,7 @@ enum {
     kTagAnimationDance = 1,
 };
 
-#define MAX_TESTS           13
+#define MAX_TESTS           14
 static int sceneIdx = -1;
 
 CCLayer* nextSchedulerTest();
@@ -44,6 +44,8 @@ CCLayer* createSchedulerTest(int nIndex)
         pLayer = new SchedulerUpdateAndCustom(); break;
     case 12:
         pLayer = new SchedulerUpdateFromCustom(); break;
+    case 13:
+        pLayer = new SchedulerFixedTimeStep(); break;
     default:
         break;
     }
@@ -946,6 +948,66 @@ std::string SchedulerTimeScale::subtitle()
     return "Fast-forward and rewind using scheduler.timeScale";
 }
 
+// SchedulerFixedTimeStep
+
+void SchedulerFixedTimeStep::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    m_pStepped = CCSprite::create("Images/grossini.png");
+    m_pStepped->setPosition(ccp(s.width/2, s.height/2 + 50));
+    addChild(m_pStepped);
+
+    m_pInterpolated = CCSprite::create("Images/grossinis_sister1.png");
+    m_pInterpolated->setPosition(ccp(s.width/2, s.height/2 - 50));
+    addChild(m_pInterpolated);
+
+    m_fTime = 0;
+    m_fPreviousX = m_fCurrentX = s.width/2;
+
+    // 10 updates per second, so that the steps can be seen
+    CCDirector::sharedDirector()->setFixedTimeStep(0.1f);
+    scheduleUpdate();
+}
+
+void SchedulerFixedTimeStep::onExit()
+{
+    CCDirector::sharedDirector()->setFixedTimeStep(0);
+    SchedulerTestLayer::onExit();
+}
+
+void SchedulerFixedTimeStep::update(float dt)
+{
+    CCSize s = CCDirector::sharedDirector()->getWinSize();
+
+    m_fTime += dt;
+    m_fPreviousX = m_fCurrentX;
+    m_fCurrentX = s.width/2 + cosf(m_fTime * 2) * s.width/3;
+
+    m_pStepped->setPositionX(m_fCurrentX);
+}
+
+void SchedulerFixedTimeStep::visit()
+{
+    // the bottom sprite is drawn between the last two updates
+    float alpha = CCDirector::sharedDirector()->getFixedTimeStepAlpha();
+    m_pInterpolated->setPositionX(m_fPreviousX + (m_fCurrentX - m_fPreviousX) * alpha);
+
+    SchedulerTestLayer::visit();
+}
+
+std::string SchedulerFixedTimeStep::title()
+{
+    return "Fixed time step";
+}
+
+std::string SchedulerFixedTimeStep::subtitle()
+{
+    return "10 updates per second. The bottom sprite is interpolated";
+}
+
 //TwoSchedulers
 
 CCControlSlider *TwoSchedulers::sliderCtl()
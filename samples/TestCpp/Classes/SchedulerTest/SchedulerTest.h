@@ -248,6 +248,24 @@ public:
     CCControlSlider    *sliderCtl2;
 };
 
+class SchedulerFixedTimeStep : public SchedulerTestLayer
+{
+public:
+    virtual void onEnter();
+    virtual void onExit();
+    virtual std::string title();
+    virtual std::string subtitle();
+    virtual void visit();
+    void update(float dt);
+
+private:
+    CCSprite* m_pStepped;
+    CCSprite* m_pInterpolated;
+    float     m_fTime;
+    float     m_fPreviousX;
+    float     m_fCurrentX;
+};
+
 
 class SchedulerTestScene : public TestScene
 {
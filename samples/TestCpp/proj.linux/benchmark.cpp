@@ -0,0 +1,517 @@
+/*
+ * TestCppBenchmark: runs the PerformanceTest scenes without interaction, for a number of frames
+ * and at several sizes, and writes the frame times, the CCFrameProfiler phase times and the
+ * allocation counts to a JSON file, so that the results of two engine versions can be compared.
+ *
+ * Build it with "make HEADLESS=1 benchmark" (the frame times of a windowed build include the
+ * swap interval of the driver), then from the bin directory:
+ *
+ *   ./TestCppBenchmark [--frames 300] [--warmup 30] [--dt 0.016667] [--case name] [--output benchmark.json]
+ *                      [--trace prefix]
+ *
+ * --case only runs the cases whose name contains the argument.
+ * --trace writes the spans recorded during each measured case to prefix-<case>-<size>.json, which
+ * chrome://tracing and Perfetto open. <case> is the case name with every character other than a
+ * letter or a digit replaced with '_'. The ring buffer of CCFrameProfiler only keeps the last frames.
+ */
+
+#include "main.h"
+
+#include "cocos2d.h"
+#include "CCEGLView.h"
+#include "support/CCProfiling.h"
+#if CC_HEADLESS
+#include "CCNullGL.h"
+#endif
+
+#include "../Classes/PerformanceTest/PerformanceNodeChildrenTest.h"
+#include "../Classes/PerformanceTest/PerformanceSpriteTest.h"
+#include "../Classes/PerformanceTest/PerformanceParticleTest.h"
+#include "../Classes/PerformanceTest/PerformanceTextureTest.h"
+#include "../Classes/PerformanceTest/PerformanceTouchesTest.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <new>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+USING_NS_CC;
+
+// 500 is enough?
+#define MAXPATHLEN 500
+
+// more than the phases recorded by the engine
+#define kMaxPhases 32
+
+/*
+ * Allocation counters. Every C++ allocation of the process goes through these operators,
+ * the ones of libcocos2d included. The allocations of the C libraries (libpng, libxml2...)
+ * aren't counted.
+ */
+
+#if __cplusplus >= 201103L
+#define BENCHMARK_THROW_BAD_ALLOC
+#define BENCHMARK_NO_THROW noexcept
+#else
+#define BENCHMARK_THROW_BAD_ALLOC throw(std::bad_alloc)
+#define BENCHMARK_NO_THROW throw()
+#endif
+
+static volatile unsigned long s_uAllocations = 0;
+static volatile unsigned long s_uAllocatedBytes = 0;
+static volatile unsigned long s_uFrees = 0;
+
+void* operator new(size_t size) BENCHMARK_THROW_BAD_ALLOC
+{
+    __sync_fetch_and_add(&s_uAllocations, 1);
+    __sync_fetch_and_add(&s_uAllocatedBytes, size);
+    void* p = malloc(size ? size : 1);
+    if (! p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) BENCHMARK_THROW_BAD_ALLOC
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) BENCHMARK_NO_THROW
+{
+    if (p)
+    {
+        __sync_fetch_and_add(&s_uFrees, 1);
+        free(p);
+    }
+}
+
+void operator delete[](void* p) BENCHMARK_NO_THROW
+{
+    operator delete(p);
+}
+
+/*
+ * Cases
+ */
+
+template <class T>
+static CCScene* createNodeChildrenScene(int nNodes)
+{
+    NodeChildrenMainScene* pScene = new T();
+    pScene->initWithQuantityOfNodes(nNodes);
+    pScene->autorelease();
+    return pScene;
+}
+
+template <class T, int nSubTest>
+static CCScene* createSpriteScene(int nNodes)
+{
+    SpriteMainScene* pScene = new T();
+    pScene->initWithSubTest(nSubTest, nNodes);
+    pScene->autorelease();
+    return pScene;
+}
+
+template <class T, int nSubTest>
+static CCScene* createParticleScene(int nParticles)
+{
+    ParticleMainScene* pScene = new T();
+    pScene->initWithSubTest(nSubTest, nParticles);
+    pScene->autorelease();
+    return pScene;
+}
+
+template <class T>
+static CCScene* createTextureScene(int)
+{
+    return T::scene();
+}
+
+template <class T>
+static CCScene* createTouchesScene(int)
+{
+    CCScene* pScene = CCScene::create();
+    CCLayer* pLayer = new T(false);
+    pScene->addChild(pLayer);
+    pLayer->release();
+    return pScene;
+}
+
+typedef CCScene* (*BenchmarkSceneFunc)(int nSize);
+
+typedef struct _BenchmarkCase
+{
+    const char*         name;
+    BenchmarkSceneFunc  createScene;
+    // sizes the case is run at, 0 terminated
+    int                 sizes[4];
+    // the frame that creates the scene is measured, instead of being skipped with the warmup frames
+    bool                measureSetup;
+    // the size is a number of touches that begin, move and end every frame
+    bool                touches;
+} BenchmarkCase;
+
+static const BenchmarkCase s_cases[] =
+{
+    { "node children/iterate c array",           createNodeChildrenScene<IterateSpriteSheetCArray>,   { 1000, 5000, 15000, 0 },  false, false },
+    { "node children/iterate fast enum",         createNodeChildrenScene<IterateSpriteSheetFastEnum>, { 1000, 5000, 15000, 0 },  false, false },
+    { "node children/add",                       createNodeChildrenScene<AddSpriteSheet>,             { 500, 2000, 5000, 0 },    false, false },
+    { "node children/remove",                    createNodeChildrenScene<RemoveSpriteSheet>,          { 500, 2000, 5000, 0 },    false, false },
+    { "node children/reorder",                   createNodeChildrenScene<ReorderSpriteSheet>,         { 500, 2000, 5000, 0 },    false, false },
+    { "node children/sort 10%",                  createNodeChildrenScene<SortChildren10>,             { 10000, 0 },              false, false },
+    { "sprites/position, sprites",               createSpriteScene<SpritePerformTest1, 1>,            { 1000, 5000, 20000, 0 },  false, false },
+    { "sprites/position, batch node",            createSpriteScene<SpritePerformTest1, 2>,            { 1000, 5000, 20000, 0 },  false, false },
+    { "sprites/position, batch node 16-bit",     createSpriteScene<SpritePerformTest1, 3>,            { 1000, 5000, 20000, 0 },  false, false },
+    { "sprites/position, render queue",          createSpriteScene<SpritePerformTest1, 10>,           { 1000, 5000, 20000, 0 },  false, false },
+    { "sprites/scale + rotation, batch node",    createSpriteScene<SpritePerformTest3, 2>,            { 1000, 5000, 20000, 0 },  false, false },
+    { "sprites/actions, batch node",             createSpriteScene<SpritePerformTest6, 2>,            { 1000, 5000, 20000, 0 },  false, false },
+    { "sprites/actions, parallel batch node",    createSpriteScene<SpritePerformTest9, 2>,            { 1000, 5000, 20000, 0 },  false, false },
+    { "sprites/culling, sprites",                createSpriteScene<SpritePerformTest8, 1>,            { 1000, 5000, 20000, 0 },  false, false },
+    { "sprites/culling, batch node",             createSpriteScene<SpritePerformTest8, 2>,            { 1000, 5000, 20000, 0 },  false, false },
+    { "particles/size 4",                        createParticleScene<ParticlePerformTest1, 1>,        { 1000, 4000, 14000, 0 },  false, false },
+    { "particles/size 64",                       createParticleScene<ParticlePerformTest4, 1>,        { 1000, 4000, 14000, 0 },  false, false },
+    { "textures/load",                           createTextureScene<TextureTest>,                     { 1, 0 },                  true,  false },
+    { "textures/async load",                     createTextureScene<TextureAsyncLoadTest>,            { 1, 0 },                  true,  false },
+    { "touches/targeted",                        createTouchesScene<TouchesPerformTest1>,             { 1, 5, 0 },               false, true },
+    { "touches/standard",                        createTouchesScene<TouchesPerformTest2>,             { 1, 5, 0 },               false, true },
+};
+
+#define kNumberOfCases ((int)(sizeof(s_cases) / sizeof(s_cases[0])))
+
+/*
+ * Runner, scheduled on the director's scheduler so that it survives the scene replacements
+ */
+
+class BenchmarkRunner : public CCObject
+{
+public:
+    BenchmarkRunner()
+    : m_uFrames(300)
+    , m_uWarmupFrames(30)
+    , m_nCase(-1)
+    , m_nSize(0)
+    , m_uFrame(0)
+    , m_bMeasuring(false)
+    , m_lLastTick(0)
+    , m_pFile(NULL)
+    , m_bFirstResult(true)
+    {
+    }
+
+    void setFrames(unsigned int uFrames) { m_uFrames = MAX(uFrames, 1); }
+    void setWarmupFrames(unsigned int uFrames) { m_uWarmupFrames = uFrames; }
+    void setFilter(const char* pszFilter) { m_sFilter = pszFilter; }
+    void setOutputPath(const char* pszPath) { m_sOutputPath = pszPath; }
+    void setTracePrefix(const char* pszPrefix) { m_sTracePrefix = pszPrefix; }
+
+    bool start()
+    {
+        m_pFile = fopen(m_sOutputPath.c_str(), "w");
+        if (! m_pFile)
+        {
+            CCLog("benchmark: can't write %s", m_sOutputPath.c_str());
+            return false;
+        }
+
+        fprintf(m_pFile, "{\n\"engine\":\"%s\",\n\"headless\":%s,\n\"frames\":%u,\n\"warmup\":%u,\n\"dt\":%f,\n\"results\":[",
+                cocos2dVersion(), CC_HEADLESS ? "true" : "false", m_uFrames, m_uWarmupFrames,
+                CCDirector::sharedDirector()->getSimulatedDeltaTime());
+
+        CCDirector::sharedDirector()->getScheduler()->scheduleSelector(schedule_selector(BenchmarkRunner::tick), this, 0, false);
+        nextCase();
+        return true;
+    }
+
+    void tick(float dt)
+    {
+        long long lNow = CCFrameProfiler::now();
+        const BenchmarkCase& c = s_cases[m_nCase];
+        ++m_uFrame;
+
+        if (m_bMeasuring)
+        {
+            // time between two updates, that is a whole frame as the headless main loop doesn't sleep
+            m_frameTimes.push_back((unsigned int)(lNow - m_lLastTick));
+        }
+        else if (m_uFrame >= m_uWarmupFrames)
+        {
+            beginMeasure();
+        }
+        m_lLastTick = lNow;
+
+        if (c.touches)
+        {
+            injectTouches(c.sizes[m_nSize]);
+        }
+
+        if (m_frameTimes.size() == m_uFrames)
+        {
+            endMeasure();
+            nextCase();
+        }
+    }
+
+private:
+    bool isFiltered(int nCase)
+    {
+        return ! m_sFilter.empty() && ! strstr(s_cases[nCase].name, m_sFilter.c_str());
+    }
+
+    void nextCase()
+    {
+        if (m_nCase >= 0 && s_cases[m_nCase].sizes[m_nSize + 1])
+        {
+            ++m_nSize;
+        }
+        else
+        {
+            do
+            {
+                ++m_nCase;
+            } while (m_nCase < kNumberOfCases && isFiltered(m_nCase));
+            m_nSize = 0;
+        }
+
+        if (m_nCase >= kNumberOfCases)
+        {
+            finish();
+            return;
+        }
+
+        const BenchmarkCase& c = s_cases[m_nCase];
+        m_uFrame = 0;
+        m_frameTimes.clear();
+        m_frameTimes.reserve(m_uFrames);
+        m_bMeasuring = false;
+
+        // the first frame of a case is timed from here, so it includes the creation of the scene
+        // when the setup is measured, and not the end of the previous case
+        m_lLastTick = CCFrameProfiler::now();
+        if (c.measureSetup)
+        {
+            beginMeasure();
+        }
+        CCDirector::sharedDirector()->replaceScene(c.createScene(c.sizes[m_nSize]));
+    }
+
+    void beginMeasure()
+    {
+        CCFrameProfiler* pProfiler = CCFrameProfiler::sharedFrameProfiler();
+        pProfiler->reset();
+        pProfiler->start();
+#if CC_HEADLESS
+        ccNullGLResetCounters();
+#endif
+        m_uStartAllocations = s_uAllocations;
+        m_uStartAllocatedBytes = s_uAllocatedBytes;
+        m_uStartFrees = s_uFrees;
+        m_bMeasuring = true;
+    }
+
+    void endMeasure()
+    {
+        unsigned long uAllocations = s_uAllocations - m_uStartAllocations;
+        unsigned long uAllocatedBytes = s_uAllocatedBytes - m_uStartAllocatedBytes;
+        unsigned long uFrees = s_uFrees - m_uStartFrees;
+
+        const BenchmarkCase& c = s_cases[m_nCase];
+        unsigned int n = m_frameTimes.size();
+        std::vector<unsigned int> sorted(m_frameTimes);
+        std::sort(sorted.begin(), sorted.end());
+        unsigned long long total = 0;
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            total += sorted[i];
+        }
+        unsigned int uP99 = sorted[MAX((n * 99 + 99) / 100, 1) - 1];
+
+        CCLog("benchmark: %-40s %6d  median %8.3f ms  p99 %8.3f ms  %8.1f allocations per frame",
+              c.name, c.sizes[m_nSize], sorted[n / 2] / 1000.0, uP99 / 1000.0, (double)uAllocations / n);
+
+        fprintf(m_pFile, "%s\n{\"case\":\"%s\",\"size\":%d,\"frames\":%u,", m_bFirstResult ? "" : ",", c.name, c.sizes[m_nSize], n);
+        fprintf(m_pFile, "\n \"frame_ms\":{\"min\":%.4f,\"median\":%.4f,\"p99\":%.4f,\"max\":%.4f,\"mean\":%.4f},",
+                sorted[0] / 1000.0, sorted[n / 2] / 1000.0, uP99 / 1000.0, sorted[n - 1] / 1000.0, total / 1000.0 / n);
+        fprintf(m_pFile, "\n \"allocations_per_frame\":%.2f,\"allocated_bytes_per_frame\":%.1f,\"frees_per_frame\":%.2f,",
+                (double)uAllocations / n, (double)uAllocatedBytes / n, (double)uFrees / n);
+
+        // phase times per frame, in ms, and the longest span of each phase
+        CCFrameProfiler* pProfiler = CCFrameProfiler::sharedFrameProfiler();
+        pProfiler->stop();
+        ccProfilerPhase pPhases[kMaxPhases];
+        unsigned int uPhases = pProfiler->getPhaseTimes(pPhases, kMaxPhases);
+        fprintf(m_pFile, "\n \"phases_ms\":{");
+        for (unsigned int i = 0; i < uPhases; ++i)
+        {
+            fprintf(m_pFile, "%s\"%s\":{\"per_frame\":%.4f,\"calls_per_frame\":%.2f,\"longest\":%.4f}", i ? "," : "",
+                    pPhases[i].name, pPhases[i].total / 1000.0 / n, (double)pPhases[i].calls / n, pPhases[i].longest / 1000.0);
+        }
+        fprintf(m_pFile, "}");
+
+        if (! m_sTracePrefix.empty())
+        {
+            std::string sName(c.name);
+            for (std::string::iterator it = sName.begin(); it != sName.end(); ++it)
+            {
+                if (! isalnum((unsigned char)*it))
+                {
+                    *it = '_';
+                }
+            }
+            char szTracePath[MAXPATHLEN];
+            snprintf(szTracePath, sizeof(szTracePath), "%s-%s-%d.json", m_sTracePrefix.c_str(), sName.c_str(), c.sizes[m_nSize]);
+            if (! pProfiler->writeChromeTrace(szTracePath))
+            {
+                CCLog("benchmark: can't write %s", szTracePath);
+            }
+        }
+
+#if CC_HEADLESS
+        const ccNullGLCounters& gl = ccNullGLGetCounters();
+        fprintf(m_pFile, ",\n \"gl_per_frame\":{\"calls\":%.1f,\"draw_calls\":%.1f,\"vertices\":%.1f,\"texture_binds\":%.1f,"
+                "\"program_changes\":%.1f,\"uniform_updates\":%.1f,\"buffer_upload_bytes\":%.1f,\"texture_upload_bytes\":%.1f}",
+                (double)gl.calls / n, (double)gl.drawCalls / n, (double)gl.vertices / n, (double)gl.textureBinds / n,
+                (double)gl.programChanges / n, (double)gl.uniformUpdates / n, (double)gl.bufferUploadBytes / n,
+                (double)gl.textureUploadBytes / n);
+#endif
+        fprintf(m_pFile, "}");
+        fflush(m_pFile);
+        m_bFirstResult = false;
+    }
+
+    void injectTouches(int nTouches)
+    {
+        int ids[CC_MAX_TOUCHES];
+        float xs[CC_MAX_TOUCHES];
+        float ys[CC_MAX_TOUCHES];
+        nTouches = MIN(nTouches, CC_MAX_TOUCHES);
+
+        CCSize s = CCDirector::sharedDirector()->getWinSize();
+        for (int i = 0; i < nTouches; ++i)
+        {
+            ids[i] = i;
+            xs[i] = s.width * (i + 1) / (nTouches + 1);
+            ys[i] = s.height / 2 + (m_uFrame % 20);
+        }
+
+        CCEGLView* pView = CCEGLView::sharedOpenGLView();
+        pView->handleTouchesBegin(nTouches, ids, xs, ys);
+        pView->handleTouchesMove(nTouches, ids, xs, ys);
+        pView->handleTouchesEnd(nTouches, ids, xs, ys);
+    }
+
+    void finish()
+    {
+        fprintf(m_pFile, "\n]\n}\n");
+        bool bFailed = ferror(m_pFile) != 0;
+        fclose(m_pFile);
+        m_pFile = NULL;
+        CCLog("benchmark: %s %s", bFailed ? "failed to write" : "results written to", m_sOutputPath.c_str());
+
+        CCDirector::sharedDirector()->getScheduler()->unscheduleSelector(schedule_selector(BenchmarkRunner::tick), this);
+        CCDirector::sharedDirector()->end();
+    }
+
+private:
+    unsigned int                m_uFrames;
+    unsigned int                m_uWarmupFrames;
+    std::string                 m_sFilter;
+    std::string                 m_sOutputPath;
+    std::string                 m_sTracePrefix;
+
+    int                         m_nCase;
+    int                         m_nSize;
+    unsigned int                m_uFrame;
+    bool                        m_bMeasuring;
+    long long                   m_lLastTick;
+    std::vector<unsigned int>   m_frameTimes;
+    unsigned long               m_uStartAllocations;
+    unsigned long               m_uStartAllocatedBytes;
+    unsigned long               m_uStartFrees;
+
+    FILE*                       m_pFile;
+    bool                        m_bFirstResult;
+};
+
+class BenchmarkApplication : public CCApplication
+{
+public:
+    BenchmarkApplication(BenchmarkRunner* pRunner)
+    : m_pRunner(pRunner)
+    {
+    }
+
+    virtual bool applicationDidFinishLaunching()
+    {
+        CCDirector* pDirector = CCDirector::sharedDirector();
+        pDirector->setOpenGLView(CCEGLView::sharedOpenGLView());
+        // don't wait between frames
+        pDirector->setAnimationInterval(0);
+        pDirector->runWithScene(CCScene::create());
+        return m_pRunner->start();
+    }
+
+    virtual void applicationDidEnterBackground() {}
+    virtual void applicationWillEnterForeground() {}
+
+private:
+    BenchmarkRunner* m_pRunner;
+};
+
+int main(int argc, char **argv)
+{
+    // get application path
+    int length;
+    char fullpath[MAXPATHLEN];
+    length = readlink("/proc/self/exe", fullpath, sizeof(fullpath));
+    fullpath[length] = '\0';
+
+    std::string resourcePath = fullpath;
+    resourcePath = resourcePath.substr(0, resourcePath.find_last_of("/"));
+    resourcePath += "/../../Resources/";
+
+    BenchmarkRunner runner;
+    runner.setOutputPath("benchmark.json");
+    float dt = 1.0f / 60;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--frames") == 0)
+        {
+            runner.setFrames(atoi(argv[i + 1]));
+        }
+        else if (strcmp(argv[i], "--warmup") == 0)
+        {
+            runner.setWarmupFrames(atoi(argv[i + 1]));
+        }
+        else if (strcmp(argv[i], "--dt") == 0)
+        {
+            dt = atof(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--case") == 0)
+        {
+            runner.setFilter(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--output") == 0)
+        {
+            runner.setOutputPath(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--trace") == 0)
+        {
+            runner.setTracePrefix(argv[i + 1]);
+        }
+    }
+
+    BenchmarkApplication app(&runner);
+    CCApplication::sharedApplication()->setResourceRootPath(resourcePath.c_str());
+    CCEGLView* eglView = CCEGLView::sharedOpenGLView();
+    eglView->setFrameSize(480, 320);
+    // every frame simulates the same time, however long it takes, so the scenes do the same work
+    CCDirector::sharedDirector()->setSimulatedDeltaTime(dt);
+    return CCApplication::sharedApplication()->run();
+}
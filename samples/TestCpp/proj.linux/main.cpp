@@ -31,5 +31,22 @@ int main(int argc, char **argv)
     CCApplication::sharedApplication()->setResourceRootPath(resourcePath.c_str());
     CCEGLView* eglView = CCEGLView::sharedOpenGLView();
     eglView->setFrameSize(480, 320);
+
+#if CC_HEADLESS
+    // every frame simulates 1/60 s, however long it takes
+    float dt = 1.0f / 60;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--frames") == 0)
+        {
+            eglView->setFrameLimit(atoi(argv[i + 1]));
+        }
+        else if (strcmp(argv[i], "--dt") == 0)
+        {
+            dt = atof(argv[i + 1]);
+        }
+    }
+    CCDirector::sharedDirector()->setSimulatedDeltaTime(dt);
+#endif
     return CCApplication::sharedApplication()->run();
 }
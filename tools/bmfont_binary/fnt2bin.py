@@ -0,0 +1,85 @@
+#!/usr/bin/python
+# fnt2bin.py
+# Converts AngelCode BMFont text files (.fnt) to the binary format loaded by
+# CCBMFontConfiguration, which is faster to load for fonts with many glyphs.
+#
+# usage: fnt2bin.py input.fnt [output]
+# The default output is the input with its extension replaced by .fntb
+
+import os
+import re
+import struct
+import sys
+
+VERSION = 1
+
+PAIR = re.compile(r'(\w+)=("[^"]*"?|\S*)')
+
+def parse_line(line):
+    tokens = line.split(None, 1)
+    if not tokens:
+        return None, {}
+    values = {}
+    if len(tokens) > 1:
+        for key, value in PAIR.findall(tokens[1]):
+            values[key] = value.strip('"')
+    return tokens[0], values
+
+def to_ints(value):
+    return [int(v) for v in value.split(',') if v != '']
+
+def convert(fnt_file, output_file):
+    common = {'lineHeight': 0, 'base': 0, 'scaleW': 0, 'scaleH': 0, 'pages': 1}
+    padding = [0, 0, 0, 0]
+    atlas_name = ''
+    chars = []
+    kernings = []
+
+    # latin-1 keeps the bytes of the file name as they are
+    for line in open(fnt_file, 'rb').read().decode('latin-1').splitlines():
+        tag, values = parse_line(line)
+        if tag == 'info':
+            if 'padding' in values:
+                padding = (to_ints(values['padding']) + [0, 0, 0, 0])[:4]
+        elif tag == 'common':
+            for key in common:
+                if key in values:
+                    common[key] = int(values[key])
+        elif tag == 'page':
+            if int(values.get('id', 0)) != 0:
+                raise ValueError('only fonts with 1 page are supported')
+            atlas_name = values['file']
+        elif tag == 'char':
+            chars.append([int(values.get(key, 0)) for key in
+                ('id', 'x', 'y', 'width', 'height', 'xoffset', 'yoffset', 'xadvance', 'page')])
+        elif tag == 'kerning':
+            kernings.append([int(values.get(key, 0)) for key in ('first', 'second', 'amount')])
+
+    name = atlas_name.encode('latin-1')
+
+    out = open(output_file, 'wb')
+    # padding is stored top, right, bottom, left, as in the .fnt file
+    out.write(b'BMFB')
+    out.write(struct.pack('<HHHHhh4hIII', VERSION, common['pages'], common['scaleW'], common['scaleH'],
+        common['lineHeight'], common['base'], padding[0], padding[1], padding[2], padding[3],
+        len(chars), len(kernings), len(name)))
+    for c in chars:
+        out.write(struct.pack('<IHHHHhhhH', *c))
+    for k in kernings:
+        out.write(struct.pack('<HHhH', k[0], k[1], k[2], 0))
+    out.write(name)
+    out.close()
+
+    print('%s: %d chars, %d kernings -> %s' % (fnt_file, len(chars), len(kernings), output_file))
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2 or len(sys.argv) > 3:
+        print('usage: %s input.fnt [output]' % sys.argv[0])
+        sys.exit(1)
+
+    fnt_file = sys.argv[1]
+    if len(sys.argv) == 3:
+        output_file = sys.argv[2]
+    else:
+        output_file = os.path.splitext(fnt_file)[0] + '.fntb'
+    convert(fnt_file, output_file)
@@ -0,0 +1,152 @@
+#!/usr/bin/python
+# make_nodes_ccbi.py
+# Writes the .ccbi file instantiated by the CCBReader performance test: a CCLayer
+# with 7 CCLayerColor panels of 6 CCSprites each, 50 nodes in total.
+#
+# usage: make_nodes_ccbi.py [output]
+# The default output is samples/TestCpp/Resources/ccb/official/pub/ccb/PerformanceNodes.ccbi
+
+import os
+import struct
+import sys
+
+VERSION = 2
+
+PROP_POSITION = 0
+PROP_SIZE = 1
+PROP_POINT = 2
+PROP_SCALE_LOCK = 4
+PROP_DEGREES = 5
+PROP_INTEGER = 6
+PROP_CHECK = 9
+PROP_SPRITE_FRAME = 10
+PROP_BYTE = 12
+PROP_COLOR3 = 13
+PROP_FLIP = 15
+PROP_BLEND_FUNC = 16
+
+PANELS = 7
+SPRITES_PER_PANEL = 6
+
+class Writer:
+    def __init__(self):
+        self.data = bytearray()
+        self.bits = []
+        self.strings = []
+
+    def string(self, s):
+        if s not in self.strings:
+            self.strings.append(s)
+        return self.strings.index(s)
+
+    # Integers are Elias gamma coded, least significant bit of each byte first,
+    # and padded to a whole byte.
+    def int(self, value, signed=False):
+        if signed:
+            current = value * 2 + 1 if value >= 0 else -value * 2
+        else:
+            current = value + 1
+        num_bits = current.bit_length() - 1
+        bits = [0] * num_bits + [1]
+        bits += [(current >> a) & 1 for a in range(num_bits - 1, -1, -1)]
+        while len(bits) % 8:
+            bits.append(0)
+        for i in range(0, len(bits), 8):
+            self.data.append(sum(bits[i + b] << b for b in range(8)))
+
+    def byte(self, value):
+        self.data.append(value & 0xff)
+
+    def float(self, value):
+        self.byte(5)
+        self.data += struct.pack('<f', value)
+
+    def cached_string(self, s):
+        self.int(self.string(s))
+
+    def prop(self, type, name):
+        self.int(type)
+        self.cached_string(name)
+        self.byte(0)
+
+def build():
+    w = Writer()
+    body = Writer()
+    body.strings = w.strings
+
+    # root CCLayer
+    body.cached_string('CCLayer')
+    body.int(0)
+    body.int(2)
+    body.prop(PROP_SIZE, 'contentSize')
+    body.float(100.0); body.float(100.0); body.int(1)
+    body.prop(PROP_CHECK, 'isTouchEnabled')
+    body.byte(0)
+    body.int(PANELS)
+
+    tag = 1
+    for panel in range(PANELS):
+        body.cached_string('CCLayerColor')
+        body.int(0)
+        body.int(5)
+        body.prop(PROP_POSITION, 'position')
+        body.float(20.0 + panel * 60.0); body.float(40.0); body.int(0)
+        body.prop(PROP_SIZE, 'contentSize')
+        body.float(56.0); body.float(240.0); body.int(0)
+        body.prop(PROP_COLOR3, 'color')
+        body.byte(40 * panel); body.byte(80); body.byte(160)
+        body.prop(PROP_BYTE, 'opacity')
+        body.byte(128)
+        body.prop(PROP_BLEND_FUNC, 'blendFunc')
+        body.int(770); body.int(771)
+        body.int(SPRITES_PER_PANEL)
+
+        for sprite in range(SPRITES_PER_PANEL):
+            body.cached_string('CCSprite')
+            body.int(0)
+            body.int(9)
+            body.prop(PROP_POSITION, 'position')
+            body.float(28.0); body.float(20.0 + sprite * 40.0); body.int(0)
+            body.prop(PROP_POINT, 'anchorPoint')
+            body.float(0.5); body.float(0.5)
+            body.prop(PROP_SCALE_LOCK, 'scale')
+            body.float(0.75); body.float(0.75); body.int(0)
+            body.prop(PROP_DEGREES, 'rotation')
+            body.float(tag * 3.0)
+            body.prop(PROP_INTEGER, 'tag')
+            body.int(tag, True)
+            body.prop(PROP_SPRITE_FRAME, 'displayFrame')
+            body.cached_string('')
+            body.cached_string('res/btn-back-%d.png' % (sprite % 2))
+            body.prop(PROP_COLOR3, 'color')
+            body.byte(255); body.byte(255 - 20 * sprite); body.byte(255)
+            body.prop(PROP_BYTE, 'opacity')
+            body.byte(255)
+            body.prop(PROP_FLIP, 'flip')
+            body.byte(sprite % 2); body.byte(0)
+            body.int(0)
+            tag += 1
+
+    # header and string cache
+    w.data += b'ibcc'
+    w.int(VERSION)
+    w.int(len(w.strings))
+    for s in w.strings:
+        encoded = s.encode('utf-8')
+        w.data += struct.pack('>H', len(encoded))
+        w.data += encoded
+    return bytes(w.data + body.data)
+
+if __name__ == '__main__':
+    if len(sys.argv) > 2:
+        print('usage: %s [output]' % sys.argv[0])
+        sys.exit(1)
+
+    if len(sys.argv) == 2:
+        output_file = sys.argv[1]
+    else:
+        root = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..')
+        output_file = os.path.join(root, 'samples', 'TestCpp', 'Resources', 'ccb', 'official', 'pub', 'ccb', 'PerformanceNodes.ccbi')
+    data = build()
+    open(output_file, 'wb').write(data)
+    print('%d nodes, %d bytes -> %s' % (1 + PANELS * (1 + SPRITES_PER_PANEL), len(data), output_file))
@@ -0,0 +1,125 @@
+#!/usr/bin/python
+# http_test_server.py
+# A local HTTP/1.1 server for the CCHttpClient tests of TestCpp. It keeps the
+# connections alive and counts them, so the reuse of connections can be checked.
+#
+# usage: http_test_server.py [port]
+# The default port is 8080.
+#
+# GET  /get          small text body
+# GET  /bytes/<n>    n bytes, byte i is i % 251. Supports "Range: bytes=<start>-"
+# GET  /slow/<n>     same as /bytes/<n>, sent in 64KB pieces every 20ms
+# GET  /delay/<ms>   small text body, sent after ms milliseconds
+# POST /post         echoes the body of the request
+# GET  /stats        "connections=<c> requests=<r>" since the server started
+
+import re
+import sys
+import threading
+import time
+
+try:
+    from BaseHTTPServer import BaseHTTPRequestHandler, HTTPServer
+    from SocketServer import ThreadingMixIn
+except ImportError:
+    from http.server import BaseHTTPRequestHandler, HTTPServer
+    from socketserver import ThreadingMixIn
+
+lock = threading.Lock()
+stats = {'connections': 0, 'requests': 0}
+
+def count(key):
+    lock.acquire()
+    stats[key] += 1
+    lock.release()
+
+CYCLE = bytearray(range(251))
+
+def pattern(start, end):
+    offset = start % 251
+    return (CYCLE * ((offset + end - start) // 251 + 1))[offset:offset + end - start]
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+
+    def setup(self):
+        BaseHTTPRequestHandler.setup(self)
+        count('connections')
+
+    def send_pattern(self, size, slow):
+        start = 0
+        match = re.match(r'bytes=(\d+)-$', self.headers.get('Range', ''))
+        if match:
+            start = int(match.group(1))
+            if start >= size:
+                self.send_body(b'', 416, [('Content-Range', 'bytes */%d' % size)])
+                return
+        self.send_response(206 if match else 200)
+        self.send_header('Content-Type', 'application/octet-stream')
+        self.send_header('Content-Length', str(size - start))
+        if match:
+            self.send_header('Content-Range', 'bytes %d-%d/%d' % (start, size - 1, size))
+        self.end_headers()
+        piece = 65536
+        for offset in range(start, size, piece):
+            self.wfile.write(bytes(pattern(offset, min(offset + piece, size))))
+            if slow:
+                self.wfile.flush()
+                time.sleep(0.02)
+
+    def send_body(self, body, code=200, headers=()):
+        self.send_response(code)
+        self.send_header('Content-Type', 'application/octet-stream')
+        self.send_header('Content-Length', str(len(body)))
+        for key, value in headers:
+            self.send_header(key, value)
+        self.end_headers()
+        self.wfile.write(bytes(body))
+
+    def do_GET(self):
+        count('requests')
+        parts = self.path.strip('/').split('/')
+        try:
+            if parts[0] == 'get':
+                self.send_body(b'ok\n')
+            elif parts[0] == 'bytes' or parts[0] == 'slow':
+                self.send_pattern(int(parts[1]), parts[0] == 'slow')
+            elif parts[0] == 'delay':
+                time.sleep(int(parts[1]) / 1000.0)
+                self.send_body(b'ok\n')
+            elif parts[0] == 'stats':
+                lock.acquire()
+                body = 'connections=%d requests=%d\n' % (stats['connections'], stats['requests'])
+                lock.release()
+                self.send_body(body.encode('ascii'))
+            else:
+                self.send_body(b'not found\n', 404)
+        except (IndexError, ValueError):
+            self.send_body(b'bad request\n', 400)
+
+    def do_POST(self):
+        count('requests')
+        length = int(self.headers.get('Content-Length', 0))
+        body = self.rfile.read(length)
+        if self.path.strip('/') == 'post':
+            self.send_body(body)
+        else:
+            self.send_body(b'not found\n', 404)
+
+    def log_message(self, format, *args):
+        pass
+
+class Server(ThreadingMixIn, HTTPServer):
+    daemon_threads = True
+
+def main():
+    port = int(sys.argv[1]) if len(sys.argv) > 1 else 8080
+    server = Server(('', port), Handler)
+    print('serving on port %d' % port)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+if __name__ == '__main__':
+    main()